@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "kvs_value.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace kvs {
+
+namespace {
+// every integer with an absolute value up to 2^53 has an exact double representation
+constexpr std::uint64_t MAX_EXACT_DOUBLE_INTEGER = std::uint64_t{1} << std::numeric_limits<double>::digits;
+
+class JsonVisitor {
+public:
+    json operator()(std::nullptr_t t) const {
+        return nullptr;
+    }
+
+    template <typename T> json operator()(const T& t) const {
+        return t;
+    }
+};
+
+Value from_integer(std::int64_t value) {
+    if (value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max()) {
+        return static_cast<int>(value);
+    }
+    // the magnitude of INT64_MIN is not representable as int64, but it is a power of two
+    if (value == std::numeric_limits<std::int64_t>::min() ||
+        static_cast<std::uint64_t>(value < 0 ? -value : value) > MAX_EXACT_DOUBLE_INTEGER) {
+        throw std::out_of_range("Integer " + std::to_string(value) + " cannot be stored without losing precision");
+    }
+    return static_cast<double>(value);
+}
+
+Value from_unsigned(std::uint64_t value) {
+    if (value <= static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+        return static_cast<int>(value);
+    }
+    if (value > MAX_EXACT_DOUBLE_INTEGER) {
+        throw std::out_of_range("Integer " + std::to_string(value) + " cannot be stored without losing precision");
+    }
+    return static_cast<double>(value);
+}
+} // namespace
+
+Value from_json(const json& value) {
+    switch (value.type()) {
+    case json::value_t::array:
+        return value.get<Array>();
+    case json::value_t::object:
+        return value.get<Object>();
+    case json::value_t::boolean:
+        return value.get<bool>();
+    case json::value_t::number_integer:
+        return from_integer(value.get<std::int64_t>());
+    case json::value_t::number_unsigned:
+        return from_unsigned(value.get<std::uint64_t>());
+    case json::value_t::number_float:
+        return value.get<double>();
+    case json::value_t::string:
+        return value.get<std::string>();
+    default:
+        return nullptr;
+    }
+}
+
+json to_json(const Value& value) {
+    return std::visit(JsonVisitor(), value);
+}
+
+} // namespace kvs
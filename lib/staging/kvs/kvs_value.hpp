@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef KVS_KVS_VALUE_HPP
+#define KVS_KVS_VALUE_HPP
+
+#include <variant>
+
+#include <utils/types.hpp>
+
+namespace kvs {
+
+///
+/// \brief A value as the kvs interface passes it to store and load
+///
+using Value = std::variant<std::nullptr_t, Array, Object, bool, double, int, std::string>;
+
+///
+/// \brief Convert a json value, e.g. one of the entries of store_many, to the value the kvs interface stores
+///
+/// Integers that do not fit an int are widened to double up to a magnitude of 2^53, below which every integer
+/// has an exact double representation.
+/// \throws std::out_of_range for larger integers, which would silently change when stored
+///
+Value from_json(const json& value);
+
+///
+/// \brief Convert a stored value back to json, e.g. for load_many
+///
+json to_json(const Value& value);
+
+} // namespace kvs
+
+#endif // KVS_KVS_VALUE_HPP
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include <kvs_value.hpp>
+
+namespace {
+
+TEST(KvsValueTest, round_trip) {
+    const json values =
+        json::parse(R"({"a": null, "b": [1], "c": {"d": 2}, "e": false, "f": 0.25, "g": -3, "h": "x", "i": 7})");
+    for (const auto& [key, value] : values.items()) {
+        EXPECT_EQ(kvs::to_json(kvs::from_json(value)), value) << key;
+    }
+    EXPECT_TRUE(std::holds_alternative<int>(kvs::from_json(values.at("g"))));
+    EXPECT_TRUE(std::holds_alternative<int>(kvs::from_json(values.at("i"))));
+    EXPECT_TRUE(std::holds_alternative<double>(kvs::from_json(values.at("f"))));
+}
+
+TEST(KvsValueTest, int_limits_stay_int) {
+    for (const json& value : {json(std::numeric_limits<int>::min()), json(std::numeric_limits<int>::max()),
+                              json(static_cast<std::uint64_t>(std::numeric_limits<int>::max()))}) {
+        const auto converted = kvs::from_json(value);
+        ASSERT_TRUE(std::holds_alternative<int>(converted)) << value;
+        EXPECT_EQ(std::get<int>(converted), value.get<std::int64_t>());
+    }
+}
+
+TEST(KvsValueTest, large_integers_are_widened) {
+    const std::int64_t max_exact = std::int64_t{1} << 53;
+    for (const std::int64_t integer : {std::int64_t{std::numeric_limits<int>::max()} + 1,
+                                       std::int64_t{std::numeric_limits<int>::min()} - 1, max_exact, -max_exact,
+                                       std::int64_t{1700000000123}}) {
+        const auto converted = kvs::from_json(json(integer));
+        ASSERT_TRUE(std::holds_alternative<double>(converted)) << integer;
+        EXPECT_EQ(static_cast<std::int64_t>(std::get<double>(converted)), integer);
+        EXPECT_EQ(kvs::to_json(converted).get<std::int64_t>(), integer);
+    }
+    const auto converted = kvs::from_json(json(static_cast<std::uint64_t>(max_exact)));
+    ASSERT_TRUE(std::holds_alternative<double>(converted));
+    EXPECT_EQ(std::get<double>(converted), static_cast<double>(max_exact));
+}
+
+TEST(KvsValueTest, integers_beyond_double_precision_are_rejected) {
+    const std::int64_t max_exact = std::int64_t{1} << 53;
+    EXPECT_THROW(kvs::from_json(json(max_exact + 1)), std::out_of_range);
+    EXPECT_THROW(kvs::from_json(json(-max_exact - 1)), std::out_of_range);
+    EXPECT_THROW(kvs::from_json(json(std::numeric_limits<std::int64_t>::min())), std::out_of_range);
+    EXPECT_THROW(kvs::from_json(json(std::numeric_limits<std::int64_t>::max())), std::out_of_range);
+    EXPECT_THROW(kvs::from_json(json(std::numeric_limits<std::uint64_t>::max())), std::out_of_range);
+    // nested values are stored as json and keep their integers
+    EXPECT_EQ(kvs::to_json(kvs::from_json(json::array({max_exact + 1}))), json::array({max_exact + 1}));
+}
+
+} // namespace
@@ -8,6 +8,7 @@
 #include <slac/slac.hpp>
 
 #include "../fsm.hpp"
+#include "matching_session_index.hpp"
 
 namespace slac::fsm::evse {
 
@@ -47,6 +48,8 @@ struct MatchingSession {
     void set_next_timeout(int delay_ms);
     void ack_timeout();
     bool is_identified_by(const uint8_t* ev_mac, const uint8_t* run_id) const;
+    // adds the attenuation groups of one CM_ATTEN_PROFILE_IND to the captured sums
+    void accumulate_aags(const uint8_t* aag);
     slac::messages::cm_atten_char_ind calculate_avg() const;
 };
 
@@ -59,6 +62,9 @@ struct MatchingState : public FSMSimpleState {
     CallbackReturnType callback() final;
 
     std::vector<MatchingSession> sessions;
+    MatchingSessionIndex session_index;
+
+    MatchingSession* find_session(const uint8_t* ev_mac, const uint8_t* run_id);
 
     // FIXME (aw): this should be const ref, but some of the member functions of HomeplugMessage are not const'd
     void handle_slac_message(slac::messages::HomeplugMessage&);
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef EVSE_SLAC_STATES_MATCHING_SESSION_INDEX_HPP
+#define EVSE_SLAC_STATES_MATCHING_SESSION_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <slac/slac.hpp>
+
+namespace slac::fsm::evse {
+
+// Open addressing hash index from (ev_mac, run_id) and from ev_mac alone to the position of a session in the session
+// list of the matching state.
+//
+// Sessions only get appended or restarted in place while in the matching state, so the index never needs to remove
+// entries. The keys are stored inline in the slots, so a lookup touches a single cache line in the common case and
+// doesn't need to dereference the sessions.
+class MatchingSessionIndex {
+public:
+    static constexpr std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+
+    std::size_t find(const uint8_t* ev_mac, const uint8_t* run_id) const;
+
+    // position of the most recently inserted session for this ev_mac
+    std::size_t find_by_ev_mac(const uint8_t* ev_mac) const;
+
+    void insert(const uint8_t* ev_mac, const uint8_t* run_id, std::size_t position);
+
+private:
+    static constexpr std::size_t KEY_LEN = ETH_ALEN + slac::defs::RUN_ID_LEN;
+
+    struct Slot {
+        uint8_t key[KEY_LEN];
+        // position + 1, 0 marks an empty slot
+        uint32_t value{0};
+    };
+
+    struct Table {
+        std::vector<Slot> slots;
+        std::size_t size{0};
+
+        Slot* lookup(const uint8_t* key, std::size_t key_len);
+        const Slot* lookup(const uint8_t* key, std::size_t key_len) const;
+        void insert(const uint8_t* key, std::size_t key_len, std::size_t position);
+    };
+
+    Table by_session;
+    Table by_ev_mac;
+};
+
+} // namespace slac::fsm::evse
+
+#endif // EVSE_SLAC_STATES_MATCHING_SESSION_INDEX_HPP
@@ -4,6 +4,12 @@
 
 #include <cstring>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "../misc.hpp"
 
 namespace slac::fsm::evse {
@@ -17,15 +23,56 @@ void session_log(Context& ctx, MatchingSession& session, const std::string& text
 //
 // MatchingSession related
 //
-static MatchingSession* find_session(std::vector<MatchingSession>& sessions, const uint8_t* ev_mac,
-                                     const uint8_t* run_id) {
-    for (auto& session : sessions) {
-        if (session.is_identified_by(ev_mac, run_id)) {
-            return &session;
-        }
+MatchingSession* MatchingState::find_session(const uint8_t* ev_mac, const uint8_t* run_id) {
+    const auto position = session_index.find(ev_mac, run_id);
+    if (position == MatchingSessionIndex::NOT_FOUND) {
+        return nullptr;
     }
 
-    return nullptr;
+    return &sessions[position];
+}
+
+void MatchingSession::accumulate_aags(const uint8_t* aag) {
+    int i = 0;
+#if defined(__SSE2__)
+    const auto zero = _mm_setzero_si128();
+    for (; i + 16 <= slac::defs::AAG_LIST_LEN; i += 16) {
+        // widen 16 groups from u8 to u32 and add them to the sums
+        const auto groups = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aag + i));
+        const auto groups_lo = _mm_unpacklo_epi8(groups, zero);
+        const auto groups_hi = _mm_unpackhi_epi8(groups, zero);
+        const __m128i widened[4] = {
+            _mm_unpacklo_epi16(groups_lo, zero),
+            _mm_unpackhi_epi16(groups_lo, zero),
+            _mm_unpacklo_epi16(groups_hi, zero),
+            _mm_unpackhi_epi16(groups_hi, zero),
+        };
+        for (int j = 0; j < 4; ++j) {
+            auto sums = reinterpret_cast<__m128i*>(captured_aags + i + 4 * j);
+            _mm_storeu_si128(sums, _mm_add_epi32(_mm_loadu_si128(sums), widened[j]));
+        }
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= slac::defs::AAG_LIST_LEN; i += 16) {
+        // widen 16 groups from u8 to u32 and add them to the sums
+        const auto groups = vld1q_u8(aag + i);
+        const auto groups_lo = vmovl_u8(vget_low_u8(groups));
+        const auto groups_hi = vmovl_u8(vget_high_u8(groups));
+        const int32x4_t widened[4] = {
+            vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(groups_lo))),
+            vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(groups_lo))),
+            vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(groups_hi))),
+            vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(groups_hi))),
+        };
+        for (int j = 0; j < 4; ++j) {
+            auto sums = captured_aags + i + 4 * j;
+            vst1q_s32(sums, vaddq_s32(vld1q_s32(sums), widened[j]));
+        }
+    }
+#endif
+    for (; i < slac::defs::AAG_LIST_LEN; ++i) {
+        captured_aags[i] += aag[i];
+    }
 }
 
 static auto create_cm_slac_parm_cnf(const MatchingSession& session) {
@@ -124,13 +171,14 @@ void MatchingState::handle_cm_slac_parm_req(const slac::messages::cm_slac_parm_r
     // set this flag to true, to disable the retry timeout
     seen_slac_parm_req = true;
 
-    auto session = find_session(sessions, tmp_ev_mac, msg.run_id);
+    auto session = find_session(tmp_ev_mac, msg.run_id);
     if (session) {
         // the matching session existed already, according to [V2G3-A09-16] we should restart
         *session = MatchingSession(tmp_ev_mac, msg.run_id);
     } else {
         // the session didn't exist, lets create it
         sessions.emplace_back(MatchingSession{tmp_ev_mac, msg.run_id});
+        session_index.insert(tmp_ev_mac, msg.run_id, sessions.size() - 1);
         session = &sessions.back();
     }
 
@@ -146,7 +194,7 @@ void MatchingState::handle_cm_slac_parm_req(const slac::messages::cm_slac_parm_r
 }
 
 void MatchingState::handle_cm_start_atten_char_ind(const slac::messages::cm_start_atten_char_ind& msg) {
-    auto session = find_session(sessions, tmp_ev_mac, msg.run_id);
+    auto session = find_session(tmp_ev_mac, msg.run_id);
 
     if (!session) {
         ctx.log_info("No session found for CM_START_ATTEN_CHAR_IND");
@@ -165,7 +213,7 @@ void MatchingState::handle_cm_start_atten_char_ind(const slac::messages::cm_star
 }
 
 void MatchingState::handle_cm_mnbc_sound_ind(const slac::messages::cm_mnbc_sound_ind& msg) {
-    auto session = find_session(sessions, tmp_ev_mac, msg.run_id);
+    auto session = find_session(tmp_ev_mac, msg.run_id);
 
     if (!session) {
         ctx.log_info("No session found for CM_MNBC_SOUND_IND");
@@ -185,13 +233,8 @@ void MatchingState::handle_cm_mnbc_sound_ind(const slac::messages::cm_mnbc_sound
 void MatchingState::handle_cm_atten_profile_ind(const slac::messages::cm_atten_profile_ind& msg) {
     // cm_atten_profile_ind does not carry a run_id, so we can't exactly identify the session
     // FIXME (aw): for now, we only take the first one found
-    MatchingSession* session = nullptr;
-
-    for (auto& session_i : sessions) {
-        if (memcmp(msg.pev_mac, session_i.ev_mac, sizeof(msg.pev_mac)) == 0) {
-            session = &session_i;
-        }
-    }
+    const auto position = session_index.find_by_ev_mac(msg.pev_mac);
+    MatchingSession* session = (position != MatchingSessionIndex::NOT_FOUND) ? &sessions[position] : nullptr;
 
     if (!session) {
         ctx.log_info("No session found for CM_ATTEN_PROFILE_IND");
@@ -210,9 +253,7 @@ void MatchingState::handle_cm_atten_profile_ind(const slac::messages::cm_atten_p
 
     session_log(ctx, *session, "received CM_ATTEN_PROFILE_IND");
 
-    for (int i = 0; i < slac::defs::AAG_LIST_LEN; ++i) {
-        session->captured_aags[i] += msg.aag[i];
-    }
+    session->accumulate_aags(msg.aag);
 
     session->captured_sounds++;
 
@@ -227,7 +268,7 @@ void MatchingState::handle_cm_atten_profile_ind(const slac::messages::cm_atten_p
 }
 
 void MatchingState::handle_cm_atten_char_rsp(const slac::messages::cm_atten_char_rsp& msg) {
-    auto session = find_session(sessions, tmp_ev_mac, msg.run_id);
+    auto session = find_session(tmp_ev_mac, msg.run_id);
 
     if (!session) {
         ctx.log_info("No session found for CM_ATTEN_CHAR_RSP");
@@ -259,7 +300,7 @@ void MatchingState::handle_cm_validate_req(const slac::messages::cm_validate_req
 }
 
 void MatchingState::handle_cm_slac_match_req(const slac::messages::cm_slac_match_req& msg) {
-    auto session = find_session(sessions, tmp_ev_mac, msg.run_id);
+    auto session = find_session(tmp_ev_mac, msg.run_id);
 
     if (!session) {
         ctx.log_info("No session found for CM_SLAC_MATCH_REQ");
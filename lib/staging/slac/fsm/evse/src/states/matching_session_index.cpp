@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <slac/fsm/evse/states/matching_session_index.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace slac::fsm::evse {
+
+static constexpr std::size_t INITIAL_CAPACITY = 16;
+
+static std::size_t hash_key(const uint8_t* key, std::size_t key_len) {
+    uint64_t words[2] = {0, 0};
+    memcpy(words, key, key_len);
+
+    // multiply and fold, the way murmur3 finalizes
+    uint64_t hash = (words[0] * 0x9e3779b97f4a7c15ULL) ^ (words[1] * 0xc2b2ae3d27d4eb4fULL);
+    hash ^= hash >> 32;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 29;
+
+    return static_cast<std::size_t>(hash);
+}
+
+const MatchingSessionIndex::Slot* MatchingSessionIndex::Table::lookup(const uint8_t* key, std::size_t key_len) const {
+    if (slots.empty()) {
+        return nullptr;
+    }
+
+    // the capacity is a power of two and the load factor at most 1/2, so there is always an empty slot to stop at
+    const auto mask = slots.size() - 1;
+    for (auto index = hash_key(key, key_len) & mask;; index = (index + 1) & mask) {
+        const auto& slot = slots[index];
+        if (slot.value == 0 || memcmp(slot.key, key, key_len) == 0) {
+            return &slot;
+        }
+    }
+}
+
+MatchingSessionIndex::Slot* MatchingSessionIndex::Table::lookup(const uint8_t* key, std::size_t key_len) {
+    return const_cast<Slot*>(static_cast<const Table*>(this)->lookup(key, key_len));
+}
+
+void MatchingSessionIndex::Table::insert(const uint8_t* key, std::size_t key_len, std::size_t position) {
+    if ((size + 1) * 2 > slots.size()) {
+        std::vector<Slot> old_slots(std::max(INITIAL_CAPACITY, slots.size() * 2));
+        old_slots.swap(slots);
+        for (const auto& old_slot : old_slots) {
+            if (old_slot.value != 0) {
+                *lookup(old_slot.key, key_len) = old_slot;
+            }
+        }
+    }
+
+    auto slot = lookup(key, key_len);
+    if (slot->value == 0) {
+        memcpy(slot->key, key, key_len);
+        size++;
+    }
+    slot->value = static_cast<uint32_t>(position + 1);
+}
+
+std::size_t MatchingSessionIndex::find(const uint8_t* ev_mac, const uint8_t* run_id) const {
+    uint8_t key[KEY_LEN];
+    memcpy(key, ev_mac, ETH_ALEN);
+    memcpy(key + ETH_ALEN, run_id, slac::defs::RUN_ID_LEN);
+
+    const auto slot = by_session.lookup(key, sizeof(key));
+    return (slot == nullptr || slot->value == 0) ? NOT_FOUND : slot->value - 1;
+}
+
+std::size_t MatchingSessionIndex::find_by_ev_mac(const uint8_t* ev_mac) const {
+    const auto slot = by_ev_mac.lookup(ev_mac, ETH_ALEN);
+    return (slot == nullptr || slot->value == 0) ? NOT_FOUND : slot->value - 1;
+}
+
+void MatchingSessionIndex::insert(const uint8_t* ev_mac, const uint8_t* run_id, std::size_t position) {
+    uint8_t key[KEY_LEN];
+    memcpy(key, ev_mac, ETH_ALEN);
+    memcpy(key + ETH_ALEN, run_id, slac::defs::RUN_ID_LEN);
+
+    by_session.insert(key, sizeof(key), position);
+    by_ev_mac.insert(ev_mac, ETH_ALEN, position);
+}
+
+} // namespace slac::fsm::evse
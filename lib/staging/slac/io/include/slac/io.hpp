@@ -3,31 +3,50 @@
 #ifndef SLAC_IO_HPP
 #define SLAC_IO_HPP
 
-#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
-#include <mutex>
 #include <string>
 #include <thread>
 
-#include <slac/channel.hpp>
+#include <slac/slac.hpp>
+#include <slac/packet_ring.hpp>
 
 class SlacIO {
 public:
     using InputHandlerFnType = void(slac::messages::HomeplugMessage&);
+    // frame points into the receive ring and is only valid during the call, see slac::io::PacketRing
+    using FrameHandlerFnType = void(const uint8_t* frame, std::size_t length);
+    // called from the loop thread if receiving stopped because of an error
+    using ErrorHandlerFnType = void(const std::string& message);
+
+    ~SlacIO();
+
     void init(const std::string& if_name);
 
     void run(std::function<InputHandlerFnType> callback);
+    // hands received frames over without copying them into a HomeplugMessage first
+    void run_raw(std::function<FrameHandlerFnType> callback);
     void send(slac::messages::HomeplugMessage& msg);
     void quit();
 
+    void set_error_handler(std::function<ErrorHandlerFnType> handler);
+
 private:
     void loop();
-    slac::Channel slac_channel;
+    void report_error(const std::string& message);
+    slac::io::PacketRing ring;
     slac::messages::HomeplugMessage incoming_msg;
     std::function<InputHandlerFnType> input_handler;
+    std::function<FrameHandlerFnType> frame_handler;
+    std::function<ErrorHandlerFnType> error_handler;
     std::thread loop_thread;
 
-    bool running{false};
+    int epoll_fd{-1};
+    int quit_event_fd{-1};
+
+    std::atomic_bool running{false};
 };
 
 #endif // SLAC_IO_HPP
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef SLAC_PACKET_RING_HPP
+#define SLAC_PACKET_RING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace slac::io {
+
+// Raw packet socket with a memory mapped TPACKET_V3 receive ring.
+//
+// The kernel writes received frames into blocks of the ring that are shared with user space, so reading frames needs
+// neither a syscall nor a copy per frame. A block is handed over once it is full or its timeout expired, the socket
+// becomes readable as soon as a block is ready. A classic BPF filter in front of the ring drops everything that isn't
+// of the requested ethertype and truncates frames to the snap length, before they take up room in the ring.
+class PacketRing {
+public:
+    // frame points into the ring and is only valid during the call
+    using FrameHandler = std::function<void(const uint8_t* frame, std::size_t length)>;
+
+    PacketRing() = default;
+    ~PacketRing();
+
+    PacketRing(const PacketRing&) = delete;
+    PacketRing& operator=(const PacketRing&) = delete;
+
+    bool open(const std::string& if_name, uint16_t ethertype, std::size_t snap_length);
+    void close();
+
+    // the socket to wait on for readability
+    int get_fd() const {
+        return fd;
+    }
+
+    const uint8_t* get_mac_addr() const {
+        return mac_addr;
+    }
+
+    const std::string& get_error() const {
+        return error;
+    }
+
+    // passes every frame of all blocks that are ready to the handler and returns the blocks to the kernel
+    std::size_t read(const FrameHandler& handler);
+
+    bool write(const void* frame, std::size_t length);
+
+private:
+    bool fail(const std::string& what);
+
+    int fd{-1};
+    uint8_t* ring{nullptr};
+    std::size_t ring_size{0};
+    std::size_t block_size{0};
+    std::size_t block_count{0};
+    std::size_t current_block{0};
+    uint8_t mac_addr[6]{};
+    std::string error;
+};
+
+// Walks the blocks of a mapped TPACKET_V3 ring, starting at current_block, as long as they are ready for user space.
+// Every frame is passed to the handler and each block is handed back to the kernel afterwards. current_block is
+// advanced to the first block that isn't ready yet. Returns the number of frames.
+std::size_t read_ready_blocks(uint8_t* ring, std::size_t block_size, std::size_t block_count,
+                              std::size_t& current_block, const PacketRing::FrameHandler& handler);
+
+} // namespace slac::io
+
+#endif // SLAC_PACKET_RING_HPP
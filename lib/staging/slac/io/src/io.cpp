@@ -2,18 +2,68 @@
 // Copyright 2022 - 2022 Pionix GmbH and Contributors to EVerest
 #include <slac/io.hpp>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <stdexcept>
 #include <thread>
 
+#include <cstdio>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// upper bound for quit() if the loop thread can't be woken up
+static constexpr int LOOP_TIMEOUT_MS = 1000;
+
+SlacIO::~SlacIO() {
+    quit();
+
+    if (quit_event_fd != -1) {
+        close(quit_event_fd);
+    }
+    if (epoll_fd != -1) {
+        close(epoll_fd);
+    }
+}
+
 void SlacIO::init(const std::string& if_name) {
-    if (!slac_channel.open(if_name)) {
-        throw std::runtime_error(slac_channel.get_error());
+    if (!ring.open(if_name, slac::defs::ETH_P_HOMEPLUG_GREENPHY, sizeof(slac::messages::homeplug_message))) {
+        throw std::runtime_error(ring.get_error());
+    }
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    quit_event_fd = eventfd(0, EFD_CLOEXEC);
+    if (epoll_fd == -1 || quit_event_fd == -1) {
+        throw std::runtime_error(std::string("Couldn't set up the SLAC event loop: ") + strerror(errno));
+    }
+
+    struct epoll_event ring_event {};
+    ring_event.events = EPOLLIN;
+    ring_event.data.fd = ring.get_fd();
+    struct epoll_event quit_event {};
+    quit_event.events = EPOLLIN;
+    quit_event.data.fd = quit_event_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ring.get_fd(), &ring_event) == -1 ||
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, quit_event_fd, &quit_event) == -1) {
+        throw std::runtime_error(std::string("Couldn't set up the SLAC event loop: ") + strerror(errno));
     }
 }
 
 void SlacIO::run(std::function<InputHandlerFnType> callback) {
     input_handler = callback;
 
+    run_raw([this](const uint8_t* frame, std::size_t length) {
+        auto raw_msg = incoming_msg.get_raw_message_ptr();
+        memcpy(raw_msg, frame, std::min(length, sizeof(*raw_msg)));
+        input_handler(incoming_msg);
+    });
+}
+
+void SlacIO::run_raw(std::function<FrameHandlerFnType> callback) {
+    frame_handler = callback;
+
     running = true;
 
     loop_thread = std::thread(&SlacIO::loop, this);
@@ -26,19 +76,62 @@ void SlacIO::quit() {
 
     running = false;
 
+    const uint64_t event_value = 1;
+    ssize_t written;
+    do {
+        written = write(quit_event_fd, &event_value, sizeof(event_value));
+    } while (written == -1 && errno == EINTR);
+    if (written == -1) {
+        // the loop notices running being reset after at most LOOP_TIMEOUT_MS
+        report_error(std::string("Couldn't wake up the SLAC receive loop: ") + strerror(errno));
+    }
+
     loop_thread.join();
 }
 
+void SlacIO::set_error_handler(std::function<ErrorHandlerFnType> handler) {
+    error_handler = std::move(handler);
+}
+
+void SlacIO::report_error(const std::string& message) {
+    if (error_handler) {
+        error_handler(message);
+    } else {
+        fprintf(stderr, "SlacIO: %s\n", message.c_str());
+    }
+}
+
 void SlacIO::loop() {
+    constexpr int MAX_EVENTS = 2;
+    struct epoll_event events[MAX_EVENTS];
 
     while (running) {
-        if (slac_channel.read(incoming_msg, 10)) {
-            input_handler(incoming_msg);
+        // sleeps until a ring block is ready or quit() is called, the timeout is only a safety net
+        const auto event_count = epoll_wait(epoll_fd, events, MAX_EVENTS, LOOP_TIMEOUT_MS);
+        if (event_count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // epoll_wait only fails for good, e.g. if init() failed or wasn't called
+            report_error(std::string("Stopped receiving SLAC frames, epoll_wait failed: ") + strerror(errno));
+            return;
+        }
+
+        for (int i = 0; i < event_count; ++i) {
+            if (events[i].data.fd == quit_event_fd) {
+                return;
+            }
         }
+
+        ring.read(frame_handler);
     }
 }
 
 void SlacIO::send(slac::messages::HomeplugMessage& msg) {
+    // like slac::Channel, send with the mac address of the interface
+    auto raw_msg = msg.get_raw_message_ptr();
+    memcpy(raw_msg->ethernet_header.ether_shost, ring.get_mac_addr(), sizeof(raw_msg->ethernet_header.ether_shost));
+
     // FIXME (aw): handle errors
-    slac_channel.write(msg, 1);
+    ring.write(raw_msg, msg.get_raw_msg_len());
 }
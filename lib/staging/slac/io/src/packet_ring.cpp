@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <slac/packet_ring.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace slac::io {
+
+// a few sounding bursts fit into a single block, while a block retires quickly enough for the SLAC timeouts
+static constexpr std::size_t RING_BLOCK_SIZE = 1 << 15;
+static constexpr std::size_t RING_BLOCK_COUNT = 8;
+static constexpr std::size_t RING_FRAME_SIZE = 1 << 11;
+static constexpr unsigned int RING_BLOCK_TIMEOUT_MS = 2;
+
+PacketRing::~PacketRing() {
+    close();
+}
+
+bool PacketRing::fail(const std::string& what) {
+    error = what + " (" + strerror(errno) + ")";
+    close();
+    return false;
+}
+
+bool PacketRing::open(const std::string& if_name, uint16_t ethertype, std::size_t snap_length) {
+    close();
+
+    // bound to no protocol, so no frame gets queued before the filter and the ring are in place
+    fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        return fail("Couldn't create the packet socket");
+    }
+
+    struct ifreq ifr {};
+    if (if_name.size() >= sizeof(ifr.ifr_name)) {
+        errno = ENAMETOOLONG;
+        return fail("Invalid interface name " + if_name);
+    }
+    strncpy(ifr.ifr_name, if_name.c_str(), sizeof(ifr.ifr_name) - 1);
+    if (ioctl(fd, SIOCGIFINDEX, &ifr) == -1) {
+        return fail("Couldn't get the index of interface " + if_name);
+    }
+    const auto if_index = ifr.ifr_ifindex;
+    if (ioctl(fd, SIOCGIFHWADDR, &ifr) == -1) {
+        return fail("Couldn't get the mac address of interface " + if_name);
+    }
+    memcpy(mac_addr, ifr.ifr_hwaddr.sa_data, sizeof(mac_addr));
+
+    // ldh [12]; jne #ethertype, drop; ret #snap_length; drop: ret #0
+    struct sock_filter filter_code[] = {
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 12),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ethertype, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, static_cast<uint32_t>(snap_length)),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+    };
+    struct sock_fprog filter = {sizeof(filter_code) / sizeof(filter_code[0]), filter_code};
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) == -1) {
+        return fail("Couldn't attach the packet filter");
+    }
+
+    int version = TPACKET_V3;
+    if (setsockopt(fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) == -1) {
+        return fail("TPACKET_V3 isn't supported");
+    }
+
+    struct tpacket_req3 req {};
+    req.tp_block_size = RING_BLOCK_SIZE;
+    req.tp_block_nr = RING_BLOCK_COUNT;
+    req.tp_frame_size = RING_FRAME_SIZE;
+    req.tp_frame_nr = (RING_BLOCK_SIZE / RING_FRAME_SIZE) * RING_BLOCK_COUNT;
+    req.tp_retire_blk_tov = RING_BLOCK_TIMEOUT_MS;
+    if (setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) == -1) {
+        return fail("Couldn't set up the receive ring");
+    }
+
+    ring_size = RING_BLOCK_SIZE * RING_BLOCK_COUNT;
+    auto mapping = mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        // MAP_LOCKED needs CAP_IPC_LOCK or a sufficient RLIMIT_MEMLOCK
+        mapping = mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (mapping == MAP_FAILED) {
+        ring_size = 0;
+        return fail("Couldn't map the receive ring");
+    }
+    ring = static_cast<uint8_t*>(mapping);
+    block_size = RING_BLOCK_SIZE;
+    block_count = RING_BLOCK_COUNT;
+    current_block = 0;
+
+    struct sockaddr_ll sock_addr {};
+    sock_addr.sll_family = AF_PACKET;
+    sock_addr.sll_protocol = htons(ethertype);
+    sock_addr.sll_ifindex = if_index;
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&sock_addr), sizeof(sock_addr)) == -1) {
+        return fail("Couldn't bind the packet socket to interface " + if_name);
+    }
+
+    return true;
+}
+
+void PacketRing::close() {
+    if (ring != nullptr) {
+        munmap(ring, ring_size);
+        ring = nullptr;
+        ring_size = 0;
+    }
+    if (fd != -1) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+std::size_t read_ready_blocks(uint8_t* ring, std::size_t block_size, std::size_t block_count,
+                              std::size_t& current_block, const PacketRing::FrameHandler& handler) {
+    std::size_t frame_count = 0;
+
+    while (true) {
+        auto block = reinterpret_cast<struct tpacket_block_desc*>(ring + current_block * block_size);
+        if ((__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0) {
+            break;
+        }
+
+        const auto num_pkts = block->hdr.bh1.num_pkts;
+        auto packet = reinterpret_cast<struct tpacket3_hdr*>(reinterpret_cast<uint8_t*>(block) +
+                                                             block->hdr.bh1.offset_to_first_pkt);
+        for (uint32_t i = 0; i < num_pkts; ++i) {
+            handler(reinterpret_cast<const uint8_t*>(packet) + packet->tp_mac, packet->tp_snaplen);
+            packet =
+                reinterpret_cast<struct tpacket3_hdr*>(reinterpret_cast<uint8_t*>(packet) + packet->tp_next_offset);
+        }
+        frame_count += num_pkts;
+
+        // hand the block back to the kernel
+        __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        current_block = (current_block + 1) % block_count;
+    }
+
+    return frame_count;
+}
+
+std::size_t PacketRing::read(const FrameHandler& handler) {
+    if (ring == nullptr) {
+        return 0;
+    }
+    return read_ready_blocks(ring, block_size, block_count, current_block, handler);
+}
+
+bool PacketRing::write(const void* frame, std::size_t length) {
+    while (true) {
+        const auto bytes_written = send(fd, frame, length, 0);
+        if (bytes_written == -1 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_written != static_cast<ssize_t>(length)) {
+            error = std::string("Couldn't send frame (") + strerror(errno) + ")";
+            return false;
+        }
+        return true;
+    }
+}
+
+} // namespace slac::io
@@ -0,0 +1,210 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+// Lets many simulated EVs sound concurrently against a single EVSE matching state, the way cross-talk on a shared PLC
+// installation looks from the EVSE side. The EVs are plain message generators, plc_emu attaches a CM_ATTEN_PROFILE.IND
+// to every CM_MNBC_SOUND.IND. Reports the time the EVSE spends per SLAC message and how many sessions got their
+// CM_ATTEN_CHAR.IND.
+//   evse_multi_ev_benchmark [number of EVs]
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <slac/fsm/evse/fsm.hpp>
+#include <slac/fsm/evse/states/others.hpp>
+
+#include "evse_vs_ev/plc_emu.hpp"
+#include "evse_vs_ev/socket_pair_bridge.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+class SimulatedEv {
+public:
+    SimulatedEv(int index, int ev_fd) : ev_fd(ev_fd) {
+        mac = {0x02, 0x00, 0x00, static_cast<uint8_t>(index >> 16), static_cast<uint8_t>(index >> 8),
+               static_cast<uint8_t>(index)};
+        run_id = {0xbe, 0xec, 0x00, 0x00, static_cast<uint8_t>(index >> 24), static_cast<uint8_t>(index >> 16),
+                  static_cast<uint8_t>(index >> 8), static_cast<uint8_t>(index)};
+    }
+
+    void send_cm_slac_parm_req() {
+        slac::messages::cm_slac_parm_req parm_req;
+        std::copy(run_id.begin(), run_id.end(), parm_req.run_id);
+        send(parm_req, slac::defs::MMTYPE_CM_SLAC_PARAM | slac::defs::MMTYPE_MODE_REQ);
+    }
+
+    void send_cm_start_atten_char_ind() {
+        slac::messages::cm_start_atten_char_ind atten_char_ind;
+        std::copy(run_id.begin(), run_id.end(), atten_char_ind.run_id);
+        send(atten_char_ind, slac::defs::MMTYPE_CM_START_ATTEN_CHAR | slac::defs::MMTYPE_MODE_IND);
+    }
+
+    void send_cm_mnbc_sound_ind() {
+        slac::messages::cm_mnbc_sound_ind sound_ind;
+        std::copy(run_id.begin(), run_id.end(), sound_ind.run_id);
+        send(sound_ind, slac::defs::MMTYPE_CM_MNBC_SOUND | slac::defs::MMTYPE_MODE_IND);
+    }
+
+private:
+    template <typename SlacMessageType> void send(const SlacMessageType& payload, uint16_t mmtype) {
+        slac::messages::HomeplugMessage hp_message;
+        hp_message.setup_ethernet_header(slac::defs::BROADCAST_MAC_ADDRESS, mac.data());
+        hp_message.setup_payload(&payload, sizeof(payload), mmtype, slac::defs::MMV::AV_1_1);
+        write(ev_fd, hp_message.get_raw_message_ptr(), hp_message.get_raw_msg_len());
+    }
+
+    int ev_fd;
+    std::array<uint8_t, ETH_ALEN> mac;
+    std::array<uint8_t, slac::defs::RUN_ID_LEN> run_id;
+};
+
+class MeasuredEvse {
+public:
+    explicit MeasuredEvse(int evse_fd) :
+        pollfds({{
+            {evse_fd, POLLIN, 0},
+            {eventfd(0, 0), POLLIN, 0},
+        }}) {
+        ctx.slac_config.chip_reset.enabled = false;
+
+        // the simulated EVs don't evaluate any responses, so only CM_SET_KEY.REQ goes over the bridge, which also
+        // keeps the EVSE from blocking on a full bridge socket while the bridge is blocked on the EVSE socket
+        callbacks.send_raw_slac = [this, evse_fd](slac::messages::HomeplugMessage& msg) {
+            const auto mmtype = msg.get_mmtype();
+            if (mmtype == (slac::defs::MMTYPE_CM_SET_KEY | slac::defs::MMTYPE_MODE_REQ)) {
+                write(evse_fd, msg.get_raw_message_ptr(), msg.get_raw_msg_len());
+            } else if (mmtype == (slac::defs::MMTYPE_CM_ATTEN_CHAR | slac::defs::MMTYPE_MODE_IND)) {
+                atten_char_inds++;
+            }
+        };
+
+        fsm.reset<slac::fsm::evse::ResetState>(ctx);
+    }
+
+    void trigger_enter_bcd() {
+        write(pollfds[1].fd, &ENTER_BCD_EVENT_CODE, sizeof(ENTER_BCD_EVENT_CODE));
+    }
+
+    void stop() {
+        write(pollfds[1].fd, &STOP_EVENT_CODE, sizeof(STOP_EVENT_CODE));
+    }
+
+    void run() {
+        while (true) {
+            auto feed_result = fsm.feed();
+
+            if (feed_result.transition()) {
+                continue;
+            } else if (feed_result.internal_error() || feed_result.unhandled_event()) {
+                throw std::runtime_error("Evse fsm: internal error / unhandled event");
+            }
+            const auto timeout = (feed_result.has_value()) ? *feed_result : -1;
+            if (timeout == 0) {
+                continue;
+            }
+
+            if (poll(pollfds.data(), pollfds.size(), timeout) == 0) {
+                continue;
+            }
+
+            if (pollfds[0].revents & POLLIN) {
+                auto raw_msg = ctx.slac_message_payload.get_raw_message_ptr();
+                read(pollfds[0].fd, raw_msg, sizeof(slac::messages::homeplug_message));
+
+                // the message handling itself and the following feed, which checks the session timeouts
+                const auto start = Clock::now();
+                fsm.handle_event(slac::fsm::evse::Event::SLAC_MESSAGE);
+                fsm.feed();
+                handling_time += Clock::now() - start;
+                handled_messages++;
+            }
+
+            if (pollfds[1].revents & POLLIN) {
+                uint64_t tmp;
+                read(pollfds[1].fd, &tmp, sizeof(tmp));
+                if (tmp == ENTER_BCD_EVENT_CODE) {
+                    fsm.handle_event(slac::fsm::evse::Event::ENTER_BCD);
+                } else {
+                    return;
+                }
+            }
+        }
+    }
+
+    Clock::duration handling_time{0};
+    int handled_messages{0};
+    std::atomic<int> atten_char_inds{0};
+
+private:
+    static constexpr uint64_t ENTER_BCD_EVENT_CODE = 1;
+    static constexpr uint64_t STOP_EVENT_CODE = 2;
+    slac::fsm::evse::ContextCallbacks callbacks;
+    slac::fsm::evse::Context ctx{callbacks};
+    slac::fsm::evse::FSM fsm;
+
+    std::array<struct pollfd, 2> pollfds;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int ev_count = (argc > 1) ? std::atoi(argv[1]) : 64;
+
+    SocketPairBridge spb{handle_shared_ev_input, handle_evse_input};
+    const auto ev_fd = spb.get_ev_socket();
+
+    MeasuredEvse evse{spb.get_evse_socket()};
+    std::thread evse_thread(&MeasuredEvse::run, &evse);
+
+    // give the EVSE some time to get ready
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    evse.trigger_enter_bcd();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::vector<SimulatedEv> evs;
+    evs.reserve(ev_count);
+    for (int i = 0; i < ev_count; ++i) {
+        evs.emplace_back(i, ev_fd);
+    }
+
+    for (auto& ev : evs) {
+        ev.send_cm_slac_parm_req();
+    }
+    for (auto& ev : evs) {
+        ev.send_cm_start_atten_char_ind();
+    }
+    // interleave the soundings of all EVs
+    for (int sound = 0; sound < slac::defs::CM_SLAC_PARM_CNF_NUM_SOUNDS; ++sound) {
+        for (auto& ev : evs) {
+            ev.send_cm_mnbc_sound_ind();
+        }
+    }
+
+    const auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (evse.atten_char_inds < ev_count && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    evse.stop();
+    evse_thread.join();
+
+    const auto handling_us = std::chrono::duration<double, std::micro>(evse.handling_time).count();
+    printf("%d EVs: %d SLAC messages handled in %.1f ms, %.2f us per message\n", ev_count, evse.handled_messages,
+           handling_us / 1e3, evse.handled_messages ? handling_us / evse.handled_messages : 0.0);
+    printf("CM_ATTEN_CHAR.IND received for %d of %d sessions\n", evse.atten_char_inds.load(), ev_count);
+
+    return (evse.atten_char_inds == ev_count) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -40,8 +40,7 @@ static void attach_atten_profile(int evse_bridge_fd) {
     memcpy(atten_profile.pev_mac, homeplug_message.get_src_mac(), sizeof(atten_profile.pev_mac));
     atten_profile.num_groups = slac::defs::AAG_LIST_LEN;
 
-    std::random_device rnd_dev;
-    std::mt19937 rng(rnd_dev());
+    static std::mt19937 rng{std::random_device{}()};
     std::uniform_int_distribution<std::mt19937::result_type> db_dist(20, 27);
 
     for (auto i = 0; i < atten_profile.num_groups; ++i) {
@@ -59,7 +58,7 @@ static void attach_atten_profile(int evse_bridge_fd) {
     write(evse_bridge_fd, raw, homeplug_message.get_raw_msg_len());
 }
 
-void handle_ev_input(int ev_bridge_fd, int evse_bridge_fd) {
+static void forward_ev_input(int ev_bridge_fd, int evse_bridge_fd, const uint8_t* ev_mac_addr) {
     auto raw_hp_message = homeplug_message.get_raw_message_ptr();
     auto bytes_read = read(ev_bridge_fd, raw_hp_message, sizeof(slac::messages::homeplug_message));
 
@@ -67,8 +66,10 @@ void handle_ev_input(int ev_bridge_fd, int evse_bridge_fd) {
 
     // printf("EV send message of size %d and type 0x%hx\n", bytes_read, mmtype);
 
-    // patch in "our" mac address
-    memcpy(raw_hp_message->ethernet_header.ether_shost, EV_MAC_ADDR, sizeof(EV_MAC_ADDR));
+    if (ev_mac_addr) {
+        // patch in "our" mac address
+        memcpy(raw_hp_message->ethernet_header.ether_shost, ev_mac_addr, ETH_ALEN);
+    }
 
     if (mmtype == (slac::defs::MMTYPE_CM_SET_KEY | slac::defs::MMTYPE_MODE_REQ)) {
         handle_set_key_req(ev_bridge_fd);
@@ -83,6 +84,14 @@ void handle_ev_input(int ev_bridge_fd, int evse_bridge_fd) {
     }
 }
 
+void handle_ev_input(int ev_bridge_fd, int evse_bridge_fd) {
+    forward_ev_input(ev_bridge_fd, evse_bridge_fd, EV_MAC_ADDR);
+}
+
+void handle_shared_ev_input(int ev_bridge_fd, int evse_bridge_fd) {
+    forward_ev_input(ev_bridge_fd, evse_bridge_fd, nullptr);
+}
+
 void handle_evse_input(int evse_bridge_fd, int ev_bridge_fd) {
     auto raw_hp_message = homeplug_message.get_raw_message_ptr();
     auto bytes_read = read(evse_bridge_fd, raw_hp_message, sizeof(slac::messages::homeplug_message));
@@ -7,6 +7,9 @@
 
 void handle_ev_input(int ev_bridge_fd, int evse_bridge_fd);
 
+// like handle_ev_input, but for several EVs on the same bridge, which all send with their own mac address
+void handle_shared_ev_input(int ev_bridge_fd, int evse_bridge_fd);
+
 void handle_evse_input(int evse_bridge_fd, int ev_bridge_fd);
 
 #endif // TESTS_EVSE_VS_EV_PLC_EMU_HPP
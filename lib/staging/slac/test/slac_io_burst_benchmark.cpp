@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+// Replays bursts of CM_MNBC_SOUND.IND messages over a veth pair and measures how long they take to reach the
+// receiving side. The receiving side either uses SlacIO (epoll and the TPACKET_V3 ring) or polls a slac::Channel with
+// a 10ms timeout, the way SlacIO used to. Needs CAP_NET_RAW and a veth pair:
+//   ip link add slac-tx type veth peer name slac-rx
+//   ip link set slac-tx up && ip link set slac-rx up
+//   slac_io_burst_benchmark slac-tx slac-rx [ring|channel] [bursts] [burst size]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <slac/channel.hpp>
+#include <slac/io.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct BurstPayload {
+    uint32_t sequence;
+    int64_t sent_ns;
+};
+
+constexpr auto BURST_INTERVAL = std::chrono::milliseconds(20);
+constexpr auto DRAIN_TIMEOUT = std::chrono::milliseconds(500);
+
+void exit_with_error(const char* msg) {
+    fprintf(stderr, "%s\n", msg);
+    exit(EXIT_FAILURE);
+}
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+double cpu_time_ms() {
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e3 +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e3;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    return sorted.at(static_cast<std::size_t>(p * (sorted.size() - 1)));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        exit_with_error("usage: slac_io_burst_benchmark <tx interface> <rx interface> [ring|channel] [bursts] "
+                        "[burst size]");
+    }
+    const std::string tx_interface = argv[1];
+    const std::string rx_interface = argv[2];
+    const bool use_ring = argc <= 3 || std::string(argv[3]) != "channel";
+    const int bursts = argc > 4 ? std::atoi(argv[4]) : 100;
+    const int burst_size = argc > 5 ? std::atoi(argv[5]) : 30;
+
+    std::vector<double> latencies_us;
+    latencies_us.reserve(bursts * burst_size);
+    std::atomic<int> received{0};
+
+    const auto handle_message = [&latencies_us, &received](slac::messages::HomeplugMessage& msg) {
+        if (msg.get_mmtype() != (slac::defs::MMTYPE_CM_MNBC_SOUND | slac::defs::MMTYPE_MODE_IND)) {
+            return;
+        }
+        const auto& payload = msg.get_payload<BurstPayload>();
+        latencies_us.push_back((now_ns() - payload.sent_ns) / 1e3);
+        received++;
+    };
+
+    // receiving side
+    SlacIO rx_io;
+    slac::Channel rx_channel;
+    std::atomic_bool channel_running{true};
+    std::thread channel_thread;
+    slac::messages::HomeplugMessage rx_msg;
+    if (use_ring) {
+        rx_io.init(rx_interface);
+        rx_io.run_raw([&rx_msg, &handle_message](const uint8_t* frame, std::size_t length) {
+            auto raw_msg = rx_msg.get_raw_message_ptr();
+            memcpy(raw_msg, frame, std::min(length, sizeof(*raw_msg)));
+            handle_message(rx_msg);
+        });
+    } else {
+        if (!rx_channel.open(rx_interface)) {
+            exit_with_error(rx_channel.get_error().c_str());
+        }
+        channel_thread = std::thread([&]() {
+            while (channel_running) {
+                if (rx_channel.read(rx_msg, 10)) {
+                    handle_message(rx_msg);
+                }
+            }
+        });
+    }
+
+    // sending side
+    SlacIO tx_io;
+    tx_io.init(tx_interface);
+    const uint8_t broadcast_mac[ETH_ALEN] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+
+    const auto cpu_start = cpu_time_ms();
+    const auto start = Clock::now();
+    uint32_t sequence = 0;
+    for (int burst = 0; burst < bursts; ++burst) {
+        for (int i = 0; i < burst_size; ++i) {
+            BurstPayload payload{sequence++, now_ns()};
+            slac::messages::HomeplugMessage msg;
+            msg.setup_ethernet_header(broadcast_mac);
+            msg.setup_payload(&payload, sizeof(payload),
+                              (slac::defs::MMTYPE_CM_MNBC_SOUND | slac::defs::MMTYPE_MODE_IND),
+                              slac::defs::MMV::AV_1_1);
+            tx_io.send(msg);
+        }
+        std::this_thread::sleep_until(start + (burst + 1) * BURST_INTERVAL);
+    }
+
+    const auto drain_deadline = Clock::now() + DRAIN_TIMEOUT;
+    while (received < bursts * burst_size && Clock::now() < drain_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto cpu_used = cpu_time_ms() - cpu_start;
+
+    if (use_ring) {
+        rx_io.quit();
+    } else {
+        channel_running = false;
+        channel_thread.join();
+    }
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    printf("%s: %d bursts of %d frames, received %d of %d\n", use_ring ? "ring" : "channel", bursts, burst_size,
+           received.load(), bursts * burst_size);
+    printf("latency us: p50 %.1f, p99 %.1f, max %.1f\n", percentile(latencies_us, 0.5),
+           percentile(latencies_us, 0.99), percentile(latencies_us, 1.0));
+    printf("cpu time: %.1f ms\n", cpu_used);
+
+    return 0;
+}
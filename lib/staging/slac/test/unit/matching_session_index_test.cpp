@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include <slac/fsm/evse/states/matching.hpp>
+#include <slac/fsm/evse/states/matching_session_index.hpp>
+
+namespace {
+
+using slac::fsm::evse::MatchingSession;
+using slac::fsm::evse::MatchingSessionIndex;
+
+using EvMac = std::array<uint8_t, ETH_ALEN>;
+using RunId = std::array<uint8_t, slac::defs::RUN_ID_LEN>;
+
+struct SessionKey {
+    EvMac ev_mac;
+    RunId run_id;
+};
+
+// few distinct byte values, so that ev_macs and run_ids collide a lot
+SessionKey random_key(std::mt19937& rng) {
+    SessionKey key;
+    for (auto& byte : key.ev_mac) {
+        byte = rng() % 3;
+    }
+    for (auto& byte : key.run_id) {
+        byte = rng() % 2;
+    }
+    return key;
+}
+
+// the linear scans the matching state did before the index
+std::size_t linear_find(const std::vector<SessionKey>& sessions, const SessionKey& key) {
+    for (std::size_t i = 0; i < sessions.size(); ++i) {
+        if (sessions[i].ev_mac == key.ev_mac and sessions[i].run_id == key.run_id) {
+            return i;
+        }
+    }
+    return MatchingSessionIndex::NOT_FOUND;
+}
+
+std::size_t linear_find_by_ev_mac(const std::vector<SessionKey>& sessions, const EvMac& ev_mac) {
+    auto position = MatchingSessionIndex::NOT_FOUND;
+    for (std::size_t i = 0; i < sessions.size(); ++i) {
+        if (sessions[i].ev_mac == ev_mac) {
+            position = i;
+        }
+    }
+    return position;
+}
+
+TEST(MatchingSessionIndexTest, empty) {
+    const MatchingSessionIndex index;
+    const EvMac ev_mac{};
+    const RunId run_id{};
+
+    EXPECT_EQ(index.find(ev_mac.data(), run_id.data()), MatchingSessionIndex::NOT_FOUND);
+    EXPECT_EQ(index.find_by_ev_mac(ev_mac.data()), MatchingSessionIndex::NOT_FOUND);
+}
+
+TEST(MatchingSessionIndexTest, latest_session_of_ev_mac) {
+    MatchingSessionIndex index;
+    const EvMac ev_mac{1, 2, 3, 4, 5, 6};
+    const RunId first{1};
+    const RunId second{2};
+
+    index.insert(ev_mac.data(), first.data(), 0);
+    index.insert(ev_mac.data(), second.data(), 1);
+
+    EXPECT_EQ(index.find(ev_mac.data(), first.data()), 0u);
+    EXPECT_EQ(index.find(ev_mac.data(), second.data()), 1u);
+    EXPECT_EQ(index.find_by_ev_mac(ev_mac.data()), 1u);
+}
+
+TEST(MatchingSessionIndexTest, matches_linear_scan) {
+    std::mt19937 rng(1);
+
+    for (int round = 0; round < 50; ++round) {
+        MatchingSessionIndex index;
+        std::vector<SessionKey> sessions;
+
+        // grows the tables a couple of times
+        const auto count = rng() % 300 + 1;
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto key = random_key(rng);
+            // a known session gets restarted in place
+            if (linear_find(sessions, key) != MatchingSessionIndex::NOT_FOUND) {
+                continue;
+            }
+            sessions.push_back(key);
+            index.insert(key.ev_mac.data(), key.run_id.data(), sessions.size() - 1);
+        }
+
+        for (int query = 0; query < 2000; ++query) {
+            const auto key = random_key(rng);
+            ASSERT_EQ(index.find(key.ev_mac.data(), key.run_id.data()), linear_find(sessions, key));
+            ASSERT_EQ(index.find_by_ev_mac(key.ev_mac.data()), linear_find_by_ev_mac(sessions, key.ev_mac));
+        }
+    }
+}
+
+TEST(MatchingSessionTest, accumulate_aags_matches_scalar_sum) {
+    std::mt19937 rng(2);
+    const EvMac ev_mac{};
+    const RunId run_id{};
+    MatchingSession session(ev_mac.data(), run_id.data());
+
+    int expected[slac::defs::AAG_LIST_LEN];
+    for (int i = 0; i < slac::defs::AAG_LIST_LEN; ++i) {
+        session.captured_aags[i] = expected[i] = rng() % 3000;
+    }
+
+    // covers the vectorized part as well as the scalar tail, with all values up to 0xff
+    for (int sound = 0; sound < 1000; ++sound) {
+        uint8_t aag[slac::defs::AAG_LIST_LEN];
+        for (int i = 0; i < slac::defs::AAG_LIST_LEN; ++i) {
+            aag[i] = static_cast<uint8_t>(rng());
+            expected[i] += aag[i];
+        }
+        session.accumulate_aags(aag);
+
+        for (int i = 0; i < slac::defs::AAG_LIST_LEN; ++i) {
+            ASSERT_EQ(session.captured_aags[i], expected[i]) << "group " << i << " after sound " << sound;
+        }
+    }
+}
+
+} // namespace
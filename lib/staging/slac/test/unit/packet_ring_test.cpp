@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <slac/packet_ring.hpp>
+#include <slac/slac.hpp>
+
+namespace {
+
+using slac::io::PacketRing;
+using slac::io::read_ready_blocks;
+
+constexpr std::size_t BLOCK_SIZE = 4096;
+constexpr std::size_t BLOCK_COUNT = 4;
+
+// the part of a TPACKET_V3 ring the kernel writes, laid out like the kernel does
+class FakeRing {
+public:
+    FakeRing() : memory(BLOCK_SIZE * BLOCK_COUNT) {
+    }
+
+    // fills a block with frames and hands it over to user space
+    void fill_block(std::size_t index, const std::vector<std::string>& frames) {
+        auto block_start = memory.data() + index * BLOCK_SIZE;
+        std::memset(block_start, 0, BLOCK_SIZE);
+        auto block = reinterpret_cast<struct tpacket_block_desc*>(block_start);
+
+        std::size_t offset = TPACKET_ALIGN(sizeof(struct tpacket_block_desc));
+        block->hdr.bh1.offset_to_first_pkt = offset;
+        block->hdr.bh1.num_pkts = frames.size();
+
+        for (std::size_t i = 0; i < frames.size(); ++i) {
+            auto packet = reinterpret_cast<struct tpacket3_hdr*>(block_start + offset);
+            // the frame doesn't directly follow the header, tp_mac has to be honoured
+            packet->tp_mac = TPACKET_ALIGN(sizeof(struct tpacket3_hdr)) + 16;
+            packet->tp_snaplen = frames[i].size();
+            packet->tp_len = frames[i].size();
+            std::memcpy(block_start + offset + packet->tp_mac, frames[i].data(), frames[i].size());
+
+            const auto packet_size = TPACKET_ALIGN(packet->tp_mac + frames[i].size());
+            packet->tp_next_offset = (i + 1 < frames.size()) ? packet_size : 0;
+            offset += packet_size;
+        }
+        ASSERT_LE(offset, BLOCK_SIZE);
+
+        block->hdr.bh1.block_status = TP_STATUS_USER;
+    }
+
+    uint32_t status(std::size_t index) {
+        return reinterpret_cast<struct tpacket_block_desc*>(memory.data() + index * BLOCK_SIZE)->hdr.bh1.block_status;
+    }
+
+    uint8_t* data() {
+        return memory.data();
+    }
+
+private:
+    std::vector<uint8_t> memory;
+};
+
+std::vector<std::string> collect(FakeRing& ring, std::size_t& current_block, std::size_t& frame_count) {
+    std::vector<std::string> frames;
+    frame_count = read_ready_blocks(ring.data(), BLOCK_SIZE, BLOCK_COUNT, current_block,
+                                    [&frames](const uint8_t* frame, std::size_t length) {
+                                        frames.emplace_back(reinterpret_cast<const char*>(frame), length);
+                                    });
+    return frames;
+}
+
+TEST(PacketRingTest, no_ready_block) {
+    FakeRing ring;
+    std::size_t current_block = 0;
+    std::size_t frame_count = 0;
+    EXPECT_TRUE(collect(ring, current_block, frame_count).empty());
+    EXPECT_EQ(frame_count, 0u);
+    EXPECT_EQ(current_block, 0u);
+}
+
+TEST(PacketRingTest, walks_frames_of_ready_blocks) {
+    FakeRing ring;
+    ring.fill_block(0, {"first", "second frame", std::string(300, 'x')});
+    ring.fill_block(1, {"third"});
+
+    std::size_t current_block = 0;
+    std::size_t frame_count = 0;
+    const auto frames = collect(ring, current_block, frame_count);
+
+    EXPECT_EQ(frames, (std::vector<std::string>{"first", "second frame", std::string(300, 'x'), "third"}));
+    EXPECT_EQ(frame_count, 4u);
+    // stops at the first block the kernel still owns
+    EXPECT_EQ(current_block, 2u);
+    EXPECT_EQ(ring.status(0), static_cast<uint32_t>(TP_STATUS_KERNEL));
+    EXPECT_EQ(ring.status(1), static_cast<uint32_t>(TP_STATUS_KERNEL));
+}
+
+TEST(PacketRingTest, empty_block_is_handed_back) {
+    FakeRing ring;
+    ring.fill_block(0, {});
+
+    std::size_t current_block = 0;
+    std::size_t frame_count = 0;
+    EXPECT_TRUE(collect(ring, current_block, frame_count).empty());
+    EXPECT_EQ(current_block, 1u);
+    EXPECT_EQ(ring.status(0), static_cast<uint32_t>(TP_STATUS_KERNEL));
+}
+
+TEST(PacketRingTest, wraps_around) {
+    FakeRing ring;
+    ring.fill_block(3, {"last"});
+    ring.fill_block(0, {"wrapped"});
+
+    std::size_t current_block = 3;
+    std::size_t frame_count = 0;
+    EXPECT_EQ(collect(ring, current_block, frame_count), (std::vector<std::string>{"last", "wrapped"}));
+    EXPECT_EQ(current_block, 1u);
+}
+
+TEST(PacketRingTest, closed_ring_reads_nothing) {
+    PacketRing ring;
+    EXPECT_EQ(ring.read([](const uint8_t*, std::size_t) { FAIL(); }), 0u);
+}
+
+std::string make_frame(uint16_t ethertype, std::size_t length, char fill) {
+    std::string frame(length, fill);
+    auto header = reinterpret_cast<struct ether_header*>(frame.data());
+    std::memset(header->ether_dhost, 0xff, ETH_ALEN);
+    std::memset(header->ether_shost, 0x02, ETH_ALEN);
+    header->ether_type = htons(ethertype);
+    return frame;
+}
+
+// the real ring on the loopback interface, needs CAP_NET_RAW
+TEST(PacketRingTest, loopback) {
+    constexpr std::size_t SNAP_LENGTH = 100;
+
+    PacketRing ring;
+    if (!ring.open("lo", slac::defs::ETH_P_HOMEPLUG_GREENPHY, SNAP_LENGTH)) {
+        GTEST_SKIP() << ring.get_error();
+    }
+
+    const auto homeplug_frame = make_frame(slac::defs::ETH_P_HOMEPLUG_GREENPHY, 200, 'h');
+    const auto other_frame = make_frame(ETH_P_IP, 200, 'i');
+    ASSERT_TRUE(ring.write(other_frame.data(), other_frame.size())) << ring.get_error();
+    ASSERT_TRUE(ring.write(homeplug_frame.data(), homeplug_frame.size())) << ring.get_error();
+
+    std::vector<std::string> frames;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (frames.empty() && std::chrono::steady_clock::now() < deadline) {
+        struct pollfd fd = {ring.get_fd(), POLLIN, 0};
+        poll(&fd, 1, 100);
+        ring.read([&frames](const uint8_t* frame, std::size_t length) {
+            frames.emplace_back(reinterpret_cast<const char*>(frame), length);
+        });
+    }
+
+    // only the HomePlug frame passes the filter, truncated to the snap length
+    ASSERT_FALSE(frames.empty());
+    for (const auto& frame : frames) {
+        EXPECT_EQ(frame, homeplug_frame.substr(0, SNAP_LENGTH));
+    }
+}
+
+} // namespace
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <slac/io.hpp>
+
+namespace {
+
+// without init() there is neither an epoll instance nor an eventfd, so both error paths are taken
+TEST(SlacIOTest, loop_and_quit_errors_are_reported) {
+    std::mutex errors_mutex;
+    std::condition_variable errors_cv;
+    std::vector<std::string> errors;
+
+    SlacIO slac_io;
+    slac_io.set_error_handler([&](const std::string& message) {
+        std::lock_guard<std::mutex> lock(errors_mutex);
+        errors.push_back(message);
+        errors_cv.notify_all();
+    });
+    slac_io.run_raw([](const uint8_t*, std::size_t) {});
+
+    {
+        // the loop thread gives up on its own
+        std::unique_lock<std::mutex> lock(errors_mutex);
+        ASSERT_TRUE(errors_cv.wait_for(lock, std::chrono::seconds(2), [&errors]() { return !errors.empty(); }));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    slac_io.quit();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+
+    std::lock_guard<std::mutex> lock(errors_mutex);
+    ASSERT_EQ(errors.size(), 2u);
+    EXPECT_NE(errors[0].find("epoll_wait failed"), std::string::npos) << errors[0];
+    EXPECT_NE(errors[1].find("Couldn't wake up"), std::string::npos) << errors[1];
+}
+
+} // namespace
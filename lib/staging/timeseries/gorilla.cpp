@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "gorilla.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace timeseries {
+
+namespace {
+std::uint64_t double_to_bits(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bits_to_double(std::uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// maps signed to unsigned integers so that small magnitudes get small codes: 0, -1, 1, -2, 2, ...
+std::uint64_t zigzag_encode(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t zigzag_decode(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+unsigned int leading_zeros(std::uint64_t value) {
+    return value == 0 ? 64 : __builtin_clzll(value);
+}
+
+unsigned int trailing_zeros(std::uint64_t value) {
+    return value == 0 ? 64 : __builtin_ctzll(value);
+}
+
+// delta-of-delta buckets: control bits and payload width
+struct DodBucket {
+    std::uint64_t control;
+    unsigned int control_bits;
+    unsigned int payload_bits;
+};
+
+constexpr DodBucket DOD_BUCKETS[] = {{0b10, 2, 7}, {0b110, 3, 9}, {0b1110, 4, 12}};
+constexpr DodBucket DOD_BUCKET_RAW = {0b1111, 4, 64};
+
+// the leading zero count is stored in 5 bits
+constexpr unsigned int MAX_LEADING_ZEROS = 31;
+} // namespace
+
+void BitWriter::write(std::uint64_t bits, unsigned int count) {
+    while (count > 0) {
+        if (used_bits_in_last_byte == 8) {
+            buffer.push_back(0);
+            used_bits_in_last_byte = 0;
+        }
+        const unsigned int free_bits = 8 - used_bits_in_last_byte;
+        const unsigned int chunk = count < free_bits ? count : free_bits;
+        const auto chunk_bits = static_cast<std::uint8_t>((bits >> (count - chunk)) & ((1u << chunk) - 1));
+        buffer.back() |= static_cast<std::uint8_t>(chunk_bits << (free_bits - chunk));
+        used_bits_in_last_byte += chunk;
+        count -= chunk;
+    }
+}
+
+void BitWriter::write_bit(bool bit) {
+    write(bit ? 1 : 0, 1);
+}
+
+void BitWriter::clear() {
+    buffer.clear();
+    used_bits_in_last_byte = 8;
+}
+
+BitReader::BitReader(const std::uint8_t* data, std::size_t size) : data(data), size_bits(size * 8) {
+}
+
+std::uint64_t BitReader::read(unsigned int count) {
+    if (position + count > size_bits) {
+        throw std::out_of_range("Read past the end of a time series block");
+    }
+    std::uint64_t result = 0;
+    while (count > 0) {
+        const unsigned int bit_in_byte = position % 8;
+        const unsigned int available = 8 - bit_in_byte;
+        const unsigned int chunk = count < available ? count : available;
+        const std::uint8_t byte = data[position / 8];
+        const auto chunk_bits = static_cast<std::uint64_t>((byte >> (available - chunk)) & ((1u << chunk) - 1));
+        result = (result << chunk) | chunk_bits;
+        position += chunk;
+        count -= chunk;
+    }
+    return result;
+}
+
+bool BitReader::read_bit() {
+    return read(1) != 0;
+}
+
+void GorillaEncoder::append(std::int64_t timestamp_ms, double value) {
+    const std::uint64_t value_bits = double_to_bits(value);
+
+    if (points == 0) {
+        writer.write(static_cast<std::uint64_t>(timestamp_ms), 64);
+        writer.write(value_bits, 64);
+        first_timestamp = timestamp_ms;
+        previous_timestamp = timestamp_ms;
+        previous_delta = 0;
+        previous_value = value_bits;
+        // no previous XOR window yet, force the first changed value to store its own window
+        previous_leading_zeros = 64;
+        previous_trailing_zeros = 0;
+        points = 1;
+        return;
+    }
+
+    // timestamp: delta-of-delta
+    const std::int64_t delta = timestamp_ms - previous_timestamp;
+    const std::int64_t dod = delta - previous_delta;
+    if (dod == 0) {
+        writer.write_bit(false);
+    } else {
+        const std::uint64_t encoded = zigzag_encode(dod);
+        const DodBucket* bucket = &DOD_BUCKET_RAW;
+        for (const auto& candidate : DOD_BUCKETS) {
+            if (encoded < (std::uint64_t{1} << candidate.payload_bits)) {
+                bucket = &candidate;
+                break;
+            }
+        }
+        writer.write(bucket->control, bucket->control_bits);
+        writer.write(encoded, bucket->payload_bits);
+    }
+    previous_delta = delta;
+    previous_timestamp = timestamp_ms;
+
+    // value: XOR against the previous value
+    const std::uint64_t xored = value_bits ^ previous_value;
+    if (xored == 0) {
+        writer.write_bit(false);
+    } else {
+        writer.write_bit(true);
+        unsigned int leading = leading_zeros(xored);
+        const unsigned int trailing = trailing_zeros(xored);
+        if (leading > MAX_LEADING_ZEROS) {
+            leading = MAX_LEADING_ZEROS;
+        }
+        if (previous_leading_zeros != 64 && leading >= previous_leading_zeros &&
+            trailing >= previous_trailing_zeros) {
+            // meaningful bits fit into the previous window
+            writer.write_bit(false);
+            const unsigned int meaningful = 64 - previous_leading_zeros - previous_trailing_zeros;
+            writer.write(xored >> previous_trailing_zeros, meaningful);
+        } else {
+            writer.write_bit(true);
+            const unsigned int meaningful = 64 - leading - trailing;
+            writer.write(leading, 5);
+            // 64 meaningful bits do not fit into 6 bits, they are stored as 0
+            writer.write(meaningful & 0x3f, 6);
+            writer.write(xored >> trailing, meaningful);
+            previous_leading_zeros = leading;
+            previous_trailing_zeros = trailing;
+        }
+    }
+    previous_value = value_bits;
+    points++;
+}
+
+void GorillaEncoder::clear() {
+    writer.clear();
+    points = 0;
+    first_timestamp = 0;
+    previous_timestamp = 0;
+    previous_delta = 0;
+    previous_value = 0;
+    previous_leading_zeros = 0;
+    previous_trailing_zeros = 0;
+}
+
+std::vector<DataPoint> decode_block(const std::uint8_t* data, std::size_t size, std::size_t count) {
+    std::vector<DataPoint> result;
+    if (count == 0) {
+        return result;
+    }
+    result.reserve(count);
+    BitReader reader(data, size);
+
+    std::int64_t timestamp = static_cast<std::int64_t>(reader.read(64));
+    std::uint64_t value_bits = reader.read(64);
+    result.push_back({timestamp, bits_to_double(value_bits)});
+
+    std::int64_t delta = 0;
+    unsigned int leading = 0;
+    unsigned int trailing = 0;
+    for (std::size_t i = 1; i < count; i++) {
+        if (reader.read_bit()) {
+            const DodBucket* bucket = &DOD_BUCKET_RAW;
+            // unary prefix selects the bucket: 10, 110, 1110, 1111
+            for (const auto& candidate : DOD_BUCKETS) {
+                if (!reader.read_bit()) {
+                    bucket = &candidate;
+                    break;
+                }
+            }
+            delta += zigzag_decode(reader.read(bucket->payload_bits));
+        }
+        timestamp += delta;
+
+        if (reader.read_bit()) {
+            if (reader.read_bit()) {
+                leading = static_cast<unsigned int>(reader.read(5));
+                unsigned int meaningful = static_cast<unsigned int>(reader.read(6));
+                if (meaningful == 0) {
+                    meaningful = 64;
+                }
+                trailing = 64 - leading - meaningful;
+            }
+            const unsigned int meaningful = 64 - leading - trailing;
+            value_bits ^= reader.read(meaningful) << trailing;
+        }
+        result.push_back({timestamp, bits_to_double(value_bits)});
+    }
+    return result;
+}
+
+} // namespace timeseries
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef TIMESERIES_GORILLA_HPP
+#define TIMESERIES_GORILLA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace timeseries {
+
+/// \brief a single sample of a time series, timestamp in milliseconds since the epoch
+struct DataPoint {
+    std::int64_t timestamp_ms;
+    double value;
+};
+
+/// \brief append-only bit buffer, bits are written MSB first
+class BitWriter {
+public:
+    void write(std::uint64_t bits, unsigned int count);
+    void write_bit(bool bit);
+
+    const std::vector<std::uint8_t>& bytes() const {
+        return buffer;
+    }
+
+    void clear();
+
+private:
+    std::vector<std::uint8_t> buffer;
+    unsigned int used_bits_in_last_byte{8};
+};
+
+/// \brief reads bits written by a BitWriter, throws std::out_of_range when reading past the end
+class BitReader {
+public:
+    BitReader(const std::uint8_t* data, std::size_t size);
+    std::uint64_t read(unsigned int count);
+    bool read_bit();
+
+private:
+    const std::uint8_t* data;
+    std::size_t size_bits;
+    std::size_t position{0};
+};
+
+///
+/// \brief Compresses a block of data points with the encoding described in the Gorilla paper
+/// (Pelkonen et al., "Gorilla: A Fast, Scalable, In-Memory Time Series Database", VLDB 2015):
+/// timestamps are stored as delta-of-deltas, values as XOR against the previous value.
+/// Regularly sampled, slowly changing telemetry compresses to a few bits per point.
+///
+class GorillaEncoder {
+public:
+    void append(std::int64_t timestamp_ms, double value);
+
+    const std::vector<std::uint8_t>& bytes() const {
+        return writer.bytes();
+    }
+
+    std::size_t count() const {
+        return points;
+    }
+
+    std::int64_t first_timestamp_ms() const {
+        return first_timestamp;
+    }
+
+    std::int64_t last_timestamp_ms() const {
+        return previous_timestamp;
+    }
+
+    void clear();
+
+private:
+    BitWriter writer;
+    std::size_t points{0};
+    std::int64_t first_timestamp{0};
+    std::int64_t previous_timestamp{0};
+    std::int64_t previous_delta{0};
+    std::uint64_t previous_value{0};
+    unsigned int previous_leading_zeros{0};
+    unsigned int previous_trailing_zeros{0};
+};
+
+///
+/// \brief decode a block written by GorillaEncoder
+/// \param count number of points encoded in the block
+///
+std::vector<DataPoint> decode_block(const std::uint8_t* data, std::size_t size, std::size_t count);
+
+} // namespace timeseries
+
+#endif // TIMESERIES_GORILLA_HPP
@@ -0,0 +1,549 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "segment_store.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace timeseries {
+
+namespace {
+constexpr char MAGIC[4] = {'E', 'V', 'T', 'S'};
+constexpr std::uint8_t FORMAT_VERSION = 1;
+constexpr std::uint8_t FLAG_COMPACTED = 0x01;
+constexpr const char* SEGMENT_EXTENSION = ".seg";
+constexpr const char* TEMPORARY_EXTENSION = ".tmp";
+
+// header: magic, version, flags, reserved (u16), segment start (i64), segment duration (i64)
+constexpr std::size_t HEADER_SIZE = 4 + 1 + 1 + 2 + 8 + 8;
+
+// a raw record holds one Gorilla block of samples,
+// a compacted record holds four blocks (min, max, avg, count) sharing the bucket timestamps
+enum class RecordKind : std::uint8_t {
+    Raw = 0,
+    Compacted = 1,
+};
+
+struct Header {
+    std::uint8_t flags;
+    std::int64_t start_ms;
+    std::int64_t duration_ms;
+};
+
+struct Record {
+    std::string_view series;
+    RecordKind kind;
+    std::int64_t first_timestamp_ms;
+    std::int64_t last_timestamp_ms;
+    std::uint32_t count;
+    const std::uint8_t* data;
+    std::uint32_t size;
+};
+
+struct Bucket {
+    double min{std::numeric_limits<double>::max()};
+    double max{std::numeric_limits<double>::lowest()};
+    double sum{0};
+    std::uint64_t count{0};
+
+    void add(double min_value, double max_value, double sum_value, std::uint64_t n) {
+        min = std::min(min, min_value);
+        max = std::max(max, max_value);
+        sum += sum_value;
+        count += n;
+    }
+};
+
+/// \brief read-only memory mapping of a whole file
+class MappedFile {
+public:
+    /// \param missing_ok map a file that does not exist (anymore) as empty instead of throwing
+    explicit MappedFile(const std::filesystem::path& path, bool missing_ok = false) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0 && missing_ok && errno == ENOENT) {
+            return;
+        }
+        if (fd < 0) {
+            throw std::runtime_error("Could not open time series segment " + path.string());
+        }
+        struct stat file_stat {};
+        if (::fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+            length = static_cast<std::size_t>(file_stat.st_size);
+            void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Could not map time series segment " + path.string());
+            }
+            address = static_cast<const std::uint8_t*>(mapping);
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile() {
+        if (address != nullptr) {
+            ::munmap(const_cast<std::uint8_t*>(address), length);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const std::uint8_t* data() const {
+        return address;
+    }
+
+    std::size_t size() const {
+        return length;
+    }
+
+private:
+    const std::uint8_t* address{nullptr};
+    std::size_t length{0};
+};
+
+template <typename T> void write_value(std::ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T> T read_value(const std::uint8_t*& cursor) {
+    T value;
+    std::memcpy(&value, cursor, sizeof(value));
+    cursor += sizeof(value);
+    return value;
+}
+
+void write_header(std::ostream& out, const Header& header) {
+    out.write(MAGIC, sizeof(MAGIC));
+    write_value<std::uint8_t>(out, FORMAT_VERSION);
+    write_value<std::uint8_t>(out, header.flags);
+    write_value<std::uint16_t>(out, 0);
+    write_value<std::int64_t>(out, header.start_ms);
+    write_value<std::int64_t>(out, header.duration_ms);
+}
+
+bool parse_header(const std::uint8_t* data, std::size_t size, Header& header) {
+    if (data == nullptr || size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+    const std::uint8_t* cursor = data + sizeof(MAGIC);
+    if (read_value<std::uint8_t>(cursor) != FORMAT_VERSION) {
+        return false;
+    }
+    header.flags = read_value<std::uint8_t>(cursor);
+    read_value<std::uint16_t>(cursor);
+    header.start_ms = read_value<std::int64_t>(cursor);
+    header.duration_ms = read_value<std::int64_t>(cursor);
+    return header.duration_ms > 0;
+}
+
+void write_record(std::ostream& out, const std::string& series, RecordKind kind, std::int64_t first_timestamp_ms,
+                  std::int64_t last_timestamp_ms, std::uint32_t count, const std::vector<std::uint8_t>& data) {
+    if (series.size() > std::numeric_limits<std::uint16_t>::max()) {
+        throw std::invalid_argument("Time series name too long: " + series);
+    }
+    write_value<std::uint16_t>(out, static_cast<std::uint16_t>(series.size()));
+    out.write(series.data(), static_cast<std::streamsize>(series.size()));
+    write_value<std::uint8_t>(out, static_cast<std::uint8_t>(kind));
+    write_value<std::int64_t>(out, first_timestamp_ms);
+    write_value<std::int64_t>(out, last_timestamp_ms);
+    write_value<std::uint32_t>(out, count);
+    write_value<std::uint32_t>(out, static_cast<std::uint32_t>(data.size()));
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+// Parses all complete records following the header within the first size bytes of the file.
+// A record cut short by a crash while appending ends the segment, everything before it stays readable.
+std::vector<Record> parse_records(const MappedFile& file, std::size_t size = std::numeric_limits<std::size_t>::max()) {
+    std::vector<Record> records;
+    size = std::min(size, file.size());
+    if (size < HEADER_SIZE) {
+        return records;
+    }
+    const std::uint8_t* cursor = file.data() + HEADER_SIZE;
+    const std::uint8_t* end = file.data() + size;
+    constexpr std::size_t fixed_size = 1 + 8 + 8 + 4 + 4;
+    while (static_cast<std::size_t>(end - cursor) >= sizeof(std::uint16_t)) {
+        const auto name_length = read_value<std::uint16_t>(cursor);
+        if (static_cast<std::size_t>(end - cursor) < name_length + fixed_size) {
+            break;
+        }
+        Record record;
+        record.series = std::string_view(reinterpret_cast<const char*>(cursor), name_length);
+        cursor += name_length;
+        record.kind = static_cast<RecordKind>(read_value<std::uint8_t>(cursor));
+        record.first_timestamp_ms = read_value<std::int64_t>(cursor);
+        record.last_timestamp_ms = read_value<std::int64_t>(cursor);
+        record.count = read_value<std::uint32_t>(cursor);
+        record.size = read_value<std::uint32_t>(cursor);
+        if (static_cast<std::size_t>(end - cursor) < record.size) {
+            break;
+        }
+        record.data = cursor;
+        cursor += record.size;
+        records.push_back(record);
+    }
+    return records;
+}
+
+// size of the header and all complete records, the rest of the file is a torn record
+std::size_t complete_size(const MappedFile& file, const std::vector<Record>& records) {
+    if (records.empty()) {
+        return std::min(file.size(), HEADER_SIZE);
+    }
+    return static_cast<std::size_t>(records.back().data + records.back().size - file.data());
+}
+
+struct CompactedBlocks {
+    std::vector<DataPoint> min;
+    std::vector<DataPoint> max;
+    std::vector<DataPoint> avg;
+    std::vector<DataPoint> count;
+};
+
+CompactedBlocks decode_compacted(const Record& record) {
+    const std::uint8_t* cursor = record.data;
+    const std::uint8_t* end = record.data + record.size;
+    auto next_block = [&cursor, end, &record]() {
+        if (static_cast<std::size_t>(end - cursor) < sizeof(std::uint32_t)) {
+            throw std::out_of_range("Truncated compacted time series record");
+        }
+        const auto size = read_value<std::uint32_t>(cursor);
+        if (static_cast<std::size_t>(end - cursor) < size) {
+            throw std::out_of_range("Truncated compacted time series record");
+        }
+        auto points = decode_block(cursor, size, record.count);
+        cursor += size;
+        return points;
+    };
+    CompactedBlocks blocks;
+    blocks.min = next_block();
+    blocks.max = next_block();
+    blocks.avg = next_block();
+    blocks.count = next_block();
+    return blocks;
+}
+
+// floor division, so that timestamps before the epoch land in the correct bucket
+std::int64_t floor_to(std::int64_t value, std::int64_t step) {
+    std::int64_t quotient = value / step;
+    if (value % step != 0 && value < 0) {
+        quotient--;
+    }
+    return quotient * step;
+}
+} // namespace
+
+SegmentStore::SegmentStore(const StoreConfig& config) : config(config) {
+    if (this->config.segment_duration.count() <= 0 || this->config.compacted_resolution.count() <= 0) {
+        throw std::invalid_argument("Segment duration and compacted resolution must be positive");
+    }
+    if (this->config.block_size == 0) {
+        this->config.block_size = 1;
+    }
+    this->load_segments();
+}
+
+SegmentStore::~SegmentStore() {
+    try {
+        this->flush();
+    } catch (...) {
+        // samples in open blocks are lost, nothing else to do while shutting down
+    }
+}
+
+std::int64_t SegmentStore::segment_start(std::int64_t timestamp_ms) const {
+    return floor_to(timestamp_ms, this->config.segment_duration.count());
+}
+
+void SegmentStore::load_segments() {
+    std::filesystem::create_directories(this->config.directory);
+    for (const auto& entry : std::filesystem::directory_iterator(this->config.directory)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        const auto& path = entry.path();
+        if (path.extension() == TEMPORARY_EXTENSION) {
+            // left over from a compaction that did not finish, the original segment is still there
+            std::filesystem::remove(path);
+            continue;
+        }
+        if (path.extension() != SEGMENT_EXTENSION) {
+            continue;
+        }
+        Header header;
+        std::size_t file_size = 0;
+        std::size_t valid_size = 0;
+        {
+            MappedFile file(path);
+            if (!parse_header(file.data(), file.size(), header)) {
+                continue;
+            }
+            const auto records = parse_records(file);
+            for (const auto& record : records) {
+                this->known_series.emplace(record.series);
+            }
+            file_size = file.size();
+            valid_size = complete_size(file, records);
+        }
+        if (valid_size < file_size) {
+            // records are appended after the end of the file, so a torn record would hide all later ones
+            std::filesystem::resize_file(path, valid_size);
+        }
+        this->segments[header.start_ms] = {path, header.duration_ms, (header.flags & FLAG_COMPACTED) != 0};
+    }
+}
+
+SegmentStore::Segment& SegmentStore::segment_for(std::int64_t start_ms) {
+    auto it = this->segments.find(start_ms);
+    if (it != this->segments.end()) {
+        return it->second;
+    }
+    const auto path = this->config.directory / (std::to_string(start_ms) + SEGMENT_EXTENSION);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    write_header(out, {0, start_ms, this->config.segment_duration.count()});
+    if (!out) {
+        throw std::runtime_error("Could not create time series segment " + path.string());
+    }
+    return this->segments.emplace(start_ms, Segment{path, this->config.segment_duration.count(), false})
+        .first->second;
+}
+
+void SegmentStore::seal(const std::string& series, GorillaEncoder& block) {
+    if (block.count() == 0) {
+        return;
+    }
+    Segment& segment = this->segment_for(this->segment_start(block.first_timestamp_ms()));
+    // late samples for a segment that was already downsampled are dropped
+    if (!segment.compacted) {
+        std::ofstream out(segment.path, std::ios::binary | std::ios::app);
+        write_record(out, series, RecordKind::Raw, block.first_timestamp_ms(), block.last_timestamp_ms(),
+                     static_cast<std::uint32_t>(block.count()), block.bytes());
+        if (!out) {
+            throw std::runtime_error("Could not append to time series segment " + segment.path.string());
+        }
+    }
+    block.clear();
+}
+
+void SegmentStore::append(const std::string& series, std::int64_t timestamp_ms, double value) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    auto& block = this->open_blocks[series];
+    if (block.count() > 0 &&
+        (timestamp_ms < block.last_timestamp_ms() ||
+         this->segment_start(timestamp_ms) != this->segment_start(block.first_timestamp_ms()))) {
+        // blocks stay ordered and never span two segments
+        this->seal(series, block);
+    }
+    block.append(timestamp_ms, value);
+    this->known_series.insert(series);
+    if (block.count() >= this->config.block_size) {
+        this->seal(series, block);
+    }
+}
+
+std::vector<Aggregate> SegmentStore::query(const std::string& series, std::int64_t from_ms, std::int64_t to_ms,
+                                           std::int64_t resolution_ms) const {
+    std::vector<std::pair<std::int64_t, Bucket>> samples;
+    auto add_point = [&samples, from_ms, to_ms](const DataPoint& point) {
+        if (point.timestamp_ms >= from_ms && point.timestamp_ms <= to_ms) {
+            Bucket bucket;
+            bucket.add(point.value, point.value, point.value, 1);
+            samples.emplace_back(point.timestamp_ms, bucket);
+        }
+    };
+
+    // Only the segments to read and the open block are taken under the lock, so that a long query does not
+    // stall append(). Records are only ever appended under the lock, so the sizes taken here are the sealed
+    // blocks; anything appended later is still part of the copied open block or newer than the query.
+    struct SegmentSnapshot {
+        std::filesystem::path path;
+        std::size_t size;
+        bool compacted;
+    };
+    std::vector<SegmentSnapshot> snapshots;
+    std::vector<std::uint8_t> open_block_bytes;
+    std::size_t open_block_count = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->store_mutex);
+        for (const auto& [start_ms, segment] : this->segments) {
+            if (start_ms > to_ms) {
+                break;
+            }
+            if (start_ms + segment.duration_ms <= from_ms) {
+                continue;
+            }
+            std::error_code error;
+            const auto size = std::filesystem::file_size(segment.path, error);
+            if (!error) {
+                snapshots.push_back({segment.path, static_cast<std::size_t>(size), segment.compacted});
+            }
+        }
+
+        auto open_block = this->open_blocks.find(series);
+        if (open_block != this->open_blocks.end() && open_block->second.count() > 0) {
+            open_block_bytes = open_block->second.bytes();
+            open_block_count = open_block->second.count();
+        }
+    }
+
+    for (const auto& snapshot : snapshots) {
+        // retention may have removed the segment by now, it reads as empty then
+        MappedFile file(snapshot.path, true);
+        Header header;
+        if (!parse_header(file.data(), file.size(), header)) {
+            continue;
+        }
+        // compact() renames a downsampled copy over the segment, the mapping then holds that file as a whole
+        const bool replaced = ((header.flags & FLAG_COMPACTED) != 0) != snapshot.compacted;
+        for (const auto& record : parse_records(file, replaced ? file.size() : snapshot.size)) {
+                if (record.series != series || record.last_timestamp_ms < from_ms ||
+                    record.first_timestamp_ms > to_ms) {
+                    continue;
+                }
+            if (record.kind == RecordKind::Raw) {
+                for (const auto& point : decode_block(record.data, record.size, record.count)) {
+                    add_point(point);
+                }
+            } else if (record.kind == RecordKind::Compacted) {
+                const auto blocks = decode_compacted(record);
+                for (std::size_t i = 0; i < blocks.avg.size(); i++) {
+                    const std::int64_t timestamp = blocks.avg[i].timestamp_ms;
+                    if (timestamp < from_ms || timestamp > to_ms) {
+                        continue;
+                    }
+                    const auto count = static_cast<std::uint64_t>(blocks.count[i].value);
+                    Bucket bucket;
+                    bucket.add(blocks.min[i].value, blocks.max[i].value, blocks.avg[i].value * count, count);
+                    samples.emplace_back(timestamp, bucket);
+                }
+            }
+        }
+    }
+
+    if (open_block_count > 0) {
+        for (const auto& point : decode_block(open_block_bytes.data(), open_block_bytes.size(), open_block_count)) {
+            add_point(point);
+        }
+    }
+
+    if (resolution_ms > 0) {
+        std::map<std::int64_t, Bucket> buckets;
+        for (const auto& [timestamp, sample] : samples) {
+            buckets[floor_to(timestamp, resolution_ms)].add(sample.min, sample.max, sample.sum, sample.count);
+        }
+        samples.assign(buckets.begin(), buckets.end());
+    } else {
+        std::stable_sort(samples.begin(), samples.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+    }
+
+    std::vector<Aggregate> result;
+    result.reserve(samples.size());
+    for (const auto& [timestamp, bucket] : samples) {
+        result.push_back({timestamp, bucket.min, bucket.max, bucket.sum / static_cast<double>(bucket.count),
+                          bucket.count});
+    }
+    return result;
+}
+
+std::vector<std::string> SegmentStore::series_names() const {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    return {this->known_series.begin(), this->known_series.end()};
+}
+
+void SegmentStore::flush() {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    for (auto& [series, block] : this->open_blocks) {
+        this->seal(series, block);
+    }
+}
+
+void SegmentStore::compact(std::int64_t start_ms, Segment& segment) {
+    const std::int64_t resolution = this->config.compacted_resolution.count();
+    std::map<std::string, std::map<std::int64_t, Bucket>> series_buckets;
+    {
+        MappedFile file(segment.path);
+        for (const auto& record : parse_records(file)) {
+            auto& buckets = series_buckets[std::string(record.series)];
+            if (record.kind == RecordKind::Raw) {
+                for (const auto& point : decode_block(record.data, record.size, record.count)) {
+                    buckets[floor_to(point.timestamp_ms, resolution)].add(point.value, point.value, point.value, 1);
+                }
+            }
+        }
+    }
+
+    auto temporary_path = segment.path;
+    temporary_path += TEMPORARY_EXTENSION;
+    {
+        std::ofstream out(temporary_path, std::ios::binary | std::ios::trunc);
+        write_header(out, {FLAG_COMPACTED, start_ms, segment.duration_ms});
+        for (const auto& [series, buckets] : series_buckets) {
+            if (buckets.empty()) {
+                continue;
+            }
+            GorillaEncoder min, max, avg, count;
+            for (const auto& [timestamp, bucket] : buckets) {
+                min.append(timestamp, bucket.min);
+                max.append(timestamp, bucket.max);
+                avg.append(timestamp, bucket.sum / static_cast<double>(bucket.count));
+                count.append(timestamp, static_cast<double>(bucket.count));
+            }
+            std::vector<std::uint8_t> payload;
+            for (const auto* block : {&min, &max, &avg, &count}) {
+                const auto size = static_cast<std::uint32_t>(block->bytes().size());
+                const auto* size_bytes = reinterpret_cast<const std::uint8_t*>(&size);
+                payload.insert(payload.end(), size_bytes, size_bytes + sizeof(size));
+                payload.insert(payload.end(), block->bytes().begin(), block->bytes().end());
+            }
+            write_record(out, series, RecordKind::Compacted, buckets.begin()->first, buckets.rbegin()->first,
+                         static_cast<std::uint32_t>(buckets.size()), payload);
+        }
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Could not write compacted time series segment " + temporary_path.string());
+        }
+    }
+    std::filesystem::rename(temporary_path, segment.path);
+    segment.compacted = true;
+}
+
+void SegmentStore::maintain(std::int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(this->store_mutex);
+    const std::int64_t retention_cutoff = now_ms - this->config.retention.count();
+    const std::int64_t compaction_cutoff = now_ms - this->config.compact_after.count();
+
+    // series that went quiet still hold open blocks for segments that are about to be compacted
+    for (auto& [series, block] : this->open_blocks) {
+        if (block.count() > 0 &&
+            this->segment_start(block.first_timestamp_ms()) + this->config.segment_duration.count() <=
+                compaction_cutoff) {
+            this->seal(series, block);
+        }
+    }
+
+    for (auto it = this->segments.begin(); it != this->segments.end();) {
+        const std::int64_t end_ms = it->first + it->second.duration_ms;
+        if (end_ms <= retention_cutoff) {
+            std::filesystem::remove(it->second.path);
+            it = this->segments.erase(it);
+            continue;
+        }
+        if (!it->second.compacted && end_ms <= compaction_cutoff) {
+            this->compact(it->first, it->second);
+        }
+        ++it;
+    }
+}
+
+} // namespace timeseries
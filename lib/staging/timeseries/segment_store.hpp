@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef TIMESERIES_SEGMENT_STORE_HPP
+#define TIMESERIES_SEGMENT_STORE_HPP
+
+#include "gorilla.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace timeseries {
+
+struct StoreConfig {
+    std::filesystem::path directory;
+    std::chrono::milliseconds segment_duration{std::chrono::hours(1)};
+    /// segments older than this are deleted
+    std::chrono::milliseconds retention{std::chrono::hours(24 * 7)};
+    /// segments older than this are downsampled to compacted_resolution
+    std::chrono::milliseconds compact_after{std::chrono::hours(24)};
+    std::chrono::milliseconds compacted_resolution{std::chrono::seconds(60)};
+    /// number of points collected in memory before a block is compressed and appended to its segment
+    std::size_t block_size{120};
+};
+
+/// \brief summary of all samples of a series within one bucket of a query
+struct Aggregate {
+    std::int64_t timestamp_ms;
+    double min;
+    double max;
+    double avg;
+    std::uint64_t count;
+};
+
+///
+/// \brief Append-only store for numeric time series
+///
+/// Samples are collected per series into blocks in memory. Full blocks are Gorilla compressed
+/// and appended to the segment file covering their first timestamp; every segment file covers
+/// a fixed time span. Queries memory-map the segment files they need and read them without holding the
+/// lock append() takes.
+/// maintain() deletes segments past the retention and rewrites old segments into a
+/// downsampled (min/max/avg/count per compacted_resolution) form.
+///
+/// Segment files are written in host byte order. Samples still held in open blocks are lost
+/// if the process ends without flush().
+///
+class SegmentStore {
+public:
+    explicit SegmentStore(const StoreConfig& config);
+    ~SegmentStore();
+
+    SegmentStore(const SegmentStore&) = delete;
+    SegmentStore& operator=(const SegmentStore&) = delete;
+
+    void append(const std::string& series, std::int64_t timestamp_ms, double value);
+
+    ///
+    /// \brief query the samples of a series with from_ms <= timestamp <= to_ms
+    /// \param resolution_ms size of the buckets samples are aggregated in, 0 returns the stored
+    /// samples (raw samples or compacted buckets) as they are
+    /// \return aggregates ordered by timestamp
+    ///
+    std::vector<Aggregate> query(const std::string& series, std::int64_t from_ms, std::int64_t to_ms,
+                                 std::int64_t resolution_ms = 0) const;
+
+    std::vector<std::string> series_names() const;
+
+    /// \brief write all open blocks to their segments
+    void flush();
+
+    /// \brief apply retention and compaction relative to now_ms
+    void maintain(std::int64_t now_ms);
+
+private:
+    struct Segment {
+        std::filesystem::path path;
+        std::int64_t duration_ms;
+        bool compacted;
+    };
+
+    std::int64_t segment_start(std::int64_t timestamp_ms) const;
+    void load_segments();
+    void seal(const std::string& series, GorillaEncoder& block);
+    Segment& segment_for(std::int64_t start_ms);
+    void compact(std::int64_t start_ms, Segment& segment);
+
+    StoreConfig config;
+    mutable std::mutex store_mutex;
+    std::map<std::int64_t, Segment> segments;
+    std::unordered_map<std::string, GorillaEncoder> open_blocks;
+    std::set<std::string> known_series;
+};
+
+} // namespace timeseries
+
+#endif // TIMESERIES_SEGMENT_STORE_HPP
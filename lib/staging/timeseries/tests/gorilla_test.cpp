@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include <gorilla.hpp>
+
+namespace {
+
+using namespace timeseries;
+
+std::vector<DataPoint> round_trip(const std::vector<DataPoint>& points) {
+    GorillaEncoder encoder;
+    for (const auto& point : points) {
+        encoder.append(point.timestamp_ms, point.value);
+    }
+    EXPECT_EQ(encoder.count(), points.size());
+    return decode_block(encoder.bytes().data(), encoder.bytes().size(), encoder.count());
+}
+
+void expect_equal(const std::vector<DataPoint>& expected, const std::vector<DataPoint>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(expected[i].timestamp_ms, actual[i].timestamp_ms) << "index " << i;
+        // compare bit patterns, so that -0.0 and NaN round trips are checked as well
+        EXPECT_EQ(std::memcmp(&expected[i].value, &actual[i].value, sizeof(double)), 0) << "index " << i;
+    }
+}
+
+TEST(BitStream, WriteRead) {
+    BitWriter writer;
+    writer.write_bit(true);
+    writer.write(0x5, 3);
+    writer.write(0xdeadbeefcafef00d, 64);
+    writer.write(0, 7);
+    writer.write(0x3ff, 10);
+
+    BitReader reader(writer.bytes().data(), writer.bytes().size());
+    EXPECT_TRUE(reader.read_bit());
+    EXPECT_EQ(reader.read(3), 0x5);
+    EXPECT_EQ(reader.read(64), 0xdeadbeefcafef00d);
+    EXPECT_EQ(reader.read(7), 0);
+    EXPECT_EQ(reader.read(10), 0x3ff);
+    // 85 bits written, the last byte is padded
+    EXPECT_EQ(reader.read(3), 0);
+    EXPECT_THROW(reader.read(1), std::out_of_range);
+}
+
+TEST(Gorilla, EmptyBlock) {
+    EXPECT_TRUE(decode_block(nullptr, 0, 0).empty());
+}
+
+TEST(Gorilla, SinglePoint) {
+    expect_equal({{1700000000000, 230.5}}, round_trip({{1700000000000, 230.5}}));
+}
+
+TEST(Gorilla, RegularConstantSamplesCompressWell) {
+    std::vector<DataPoint> points;
+    for (int i = 0; i < 120; i++) {
+        points.push_back({1700000000000 + i * 1000, 16.0});
+    }
+    GorillaEncoder encoder;
+    for (const auto& point : points) {
+        encoder.append(point.timestamp_ms, point.value);
+    }
+    // 16 bytes for the first sample, 17 bits for the first delta, 2 bits for each further sample
+    EXPECT_LE(encoder.bytes().size(), 16 + (17 + 118 * 2 + 7) / 8);
+    expect_equal(points, decode_block(encoder.bytes().data(), encoder.bytes().size(), encoder.count()));
+}
+
+TEST(Gorilla, JitterAndGaps) {
+    std::vector<DataPoint> points;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> jitter(-60, 60);
+    std::int64_t timestamp = 1700000000000;
+    for (int i = 0; i < 500; i++) {
+        timestamp += 1000 + jitter(generator);
+        if (i % 100 == 99) {
+            // gaps that need the 12 bit and the raw delta-of-delta buckets
+            timestamp += (i == 199) ? 2000 : 3600000;
+        }
+        points.push_back({timestamp, 230.0 + jitter(generator) / 10.0});
+    }
+    expect_equal(points, round_trip(points));
+}
+
+TEST(Gorilla, SpecialValues) {
+    std::vector<DataPoint> points = {
+        {0, 0.0},
+        {10, -0.0},
+        {20, std::numeric_limits<double>::infinity()},
+        {30, -std::numeric_limits<double>::infinity()},
+        {40, std::numeric_limits<double>::quiet_NaN()},
+        {50, std::numeric_limits<double>::max()},
+        {60, std::numeric_limits<double>::denorm_min()},
+        {70, 1.0},
+        {80, -1.0},
+        // timestamps going backwards
+        {75, 3.0},
+        {-1000, 3.0},
+    };
+    expect_equal(points, round_trip(points));
+}
+
+TEST(Gorilla, ClearStartsNewBlock) {
+    GorillaEncoder encoder;
+    encoder.append(1000, 1.0);
+    encoder.append(2000, 2.0);
+    encoder.clear();
+    EXPECT_EQ(encoder.count(), 0);
+    EXPECT_TRUE(encoder.bytes().empty());
+    encoder.append(5000, 5.0);
+    encoder.append(6000, 5.5);
+    EXPECT_EQ(encoder.first_timestamp_ms(), 5000);
+    EXPECT_EQ(encoder.last_timestamp_ms(), 6000);
+    expect_equal({{5000, 5.0}, {6000, 5.5}},
+                 decode_block(encoder.bytes().data(), encoder.bytes().size(), encoder.count()));
+}
+
+TEST(Gorilla, TruncatedBlockThrows) {
+    GorillaEncoder encoder;
+    for (int i = 0; i < 10; i++) {
+        encoder.append(i * 1000, i * 1.5);
+    }
+    EXPECT_THROW(decode_block(encoder.bytes().data(), encoder.bytes().size() / 2, encoder.count()),
+                 std::out_of_range);
+}
+
+} // namespace
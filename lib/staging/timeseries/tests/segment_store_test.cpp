@@ -0,0 +1,262 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <fstream>
+#include <set>
+#include <thread>
+
+#include <segment_store.hpp>
+
+namespace {
+
+using namespace timeseries;
+using namespace std::chrono_literals;
+
+constexpr std::int64_t HOUR_MS = 3600 * 1000;
+constexpr std::int64_t START_MS = 1700000000000 / HOUR_MS * HOUR_MS;
+
+class SegmentStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const std::string test_name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        config.directory = std::filesystem::temp_directory_path() / ("timeseries_test_" + test_name);
+        std::filesystem::remove_all(config.directory);
+        config.segment_duration = 1h;
+        config.retention = 48h;
+        config.compact_after = 2h;
+        config.compacted_resolution = 60s;
+        config.block_size = 16;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(config.directory);
+    }
+
+    std::size_t segment_files() const {
+        std::size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(config.directory)) {
+            if (entry.path().extension() == ".seg") {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    StoreConfig config;
+};
+
+TEST_F(SegmentStoreTest, QueryRawIncludesOpenBlocks) {
+    SegmentStore store(config);
+    for (int i = 0; i < 40; i++) {
+        store.append("evse/power_W", START_MS + i * 1000, i);
+    }
+    const auto result = store.query("evse/power_W", START_MS, START_MS + 39 * 1000);
+    ASSERT_EQ(result.size(), 40);
+    for (int i = 0; i < 40; i++) {
+        EXPECT_EQ(result[i].timestamp_ms, START_MS + i * 1000);
+        EXPECT_EQ(result[i].avg, i);
+        EXPECT_EQ(result[i].count, 1);
+    }
+    EXPECT_EQ(store.query("evse/power_W", START_MS + 5000, START_MS + 9000).size(), 5);
+    EXPECT_TRUE(store.query("unknown", START_MS, START_MS + HOUR_MS).empty());
+}
+
+TEST_F(SegmentStoreTest, Downsampling) {
+    SegmentStore store(config);
+    for (int i = 0; i < 120; i++) {
+        store.append("power", START_MS + i * 1000, i);
+    }
+    const auto result = store.query("power", START_MS, START_MS + HOUR_MS, 60000);
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0].timestamp_ms, START_MS);
+    EXPECT_EQ(result[0].min, 0);
+    EXPECT_EQ(result[0].max, 59);
+    EXPECT_DOUBLE_EQ(result[0].avg, 29.5);
+    EXPECT_EQ(result[0].count, 60);
+    EXPECT_EQ(result[1].timestamp_ms, START_MS + 60000);
+    EXPECT_EQ(result[1].min, 60);
+    EXPECT_EQ(result[1].max, 119);
+}
+
+TEST_F(SegmentStoreTest, BlocksDoNotSpanSegments) {
+    SegmentStore store(config);
+    for (int i = 0; i < 10; i++) {
+        store.append("voltage", START_MS + HOUR_MS - 5000 + i * 1000, 230);
+    }
+    store.flush();
+    EXPECT_EQ(segment_files(), 2);
+    EXPECT_EQ(store.query("voltage", START_MS, START_MS + 2 * HOUR_MS).size(), 10);
+}
+
+TEST_F(SegmentStoreTest, PersistsAcrossReopen) {
+    {
+        SegmentStore store(config);
+        for (int i = 0; i < 50; i++) {
+            store.append("a", START_MS + i * 1000, i * 0.5);
+            store.append("b", START_MS + i * 1000, -i);
+        }
+        // the destructor flushes the open blocks
+    }
+    SegmentStore store(config);
+    const auto names = store.series_names();
+    EXPECT_EQ(names, (std::vector<std::string>{"a", "b"}));
+    const auto result = store.query("a", START_MS, START_MS + HOUR_MS);
+    ASSERT_EQ(result.size(), 50);
+    EXPECT_EQ(result[49].avg, 24.5);
+}
+
+TEST_F(SegmentStoreTest, TruncatedSegmentKeepsCompleteRecords) {
+    {
+        SegmentStore store(config);
+        for (int i = 0; i < 32; i++) {
+            store.append("a", START_MS + i * 1000, i);
+        }
+    }
+    const auto path = config.directory / (std::to_string(START_MS) + ".seg");
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+    SegmentStore store(config);
+    // the first block of 16 samples is complete, the second is cut short
+    EXPECT_EQ(store.query("a", START_MS, START_MS + HOUR_MS).size(), 16);
+}
+
+TEST_F(SegmentStoreTest, AppendAfterTornRecordStaysReadable) {
+    {
+        SegmentStore store(config);
+        for (int i = 0; i < 32; i++) {
+            store.append("a", START_MS + i * 1000, i);
+        }
+    }
+    // a crash while appending the second block leaves part of its record behind
+    const auto path = config.directory / (std::to_string(START_MS) + ".seg");
+    const auto torn_size = std::filesystem::file_size(path) - 3;
+    std::filesystem::resize_file(path, torn_size);
+    {
+        SegmentStore store(config);
+        EXPECT_LT(std::filesystem::file_size(path), torn_size);
+        for (int i = 100; i < 132; i++) {
+            store.append("a", START_MS + i * 1000, i);
+        }
+    }
+
+    SegmentStore store(config);
+    const auto result = store.query("a", START_MS, START_MS + HOUR_MS);
+    ASSERT_EQ(result.size(), 48);
+    EXPECT_EQ(result[15].avg, 15);
+    EXPECT_EQ(result[16].avg, 100);
+    EXPECT_EQ(result[47].avg, 131);
+}
+
+TEST_F(SegmentStoreTest, OutOfOrderSamples) {
+    SegmentStore store(config);
+    store.append("a", START_MS + 2000, 2);
+    store.append("a", START_MS + 1000, 1);
+    store.append("a", START_MS + 3000, 3);
+    const auto result = store.query("a", START_MS, START_MS + HOUR_MS);
+    ASSERT_EQ(result.size(), 3);
+    EXPECT_EQ(result[0].avg, 1);
+    EXPECT_EQ(result[1].avg, 2);
+    EXPECT_EQ(result[2].avg, 3);
+}
+
+TEST_F(SegmentStoreTest, CompactionAndRetention) {
+    SegmentStore store(config);
+    for (int i = 0; i < 3 * 3600; i += 10) {
+        store.append("power", START_MS + i * 1000, i % 60);
+    }
+    store.flush();
+    ASSERT_EQ(segment_files(), 3);
+    const auto size_before = std::filesystem::file_size(config.directory / (std::to_string(START_MS) + ".seg"));
+
+    // the first segment ends more than compact_after ago
+    store.maintain(START_MS + 3 * HOUR_MS);
+    EXPECT_EQ(segment_files(), 3);
+    const auto size_after = std::filesystem::file_size(config.directory / (std::to_string(START_MS) + ".seg"));
+    EXPECT_LT(size_after, size_before);
+
+    const auto compacted = store.query("power", START_MS, START_MS + HOUR_MS - 1);
+    ASSERT_EQ(compacted.size(), 60);
+    EXPECT_EQ(compacted[0].timestamp_ms, START_MS);
+    EXPECT_EQ(compacted[0].min, 0);
+    EXPECT_EQ(compacted[0].max, 50);
+    EXPECT_DOUBLE_EQ(compacted[0].avg, 25);
+    EXPECT_EQ(compacted[0].count, 6);
+
+    // compacted and raw data aggregate the same way
+    const auto hourly = store.query("power", START_MS, START_MS + 3 * HOUR_MS, HOUR_MS);
+    ASSERT_EQ(hourly.size(), 3);
+    EXPECT_EQ(hourly[0].count, 360);
+    EXPECT_EQ(hourly[1].count, 360);
+    EXPECT_DOUBLE_EQ(hourly[0].avg, hourly[1].avg);
+
+    // late samples for a compacted segment are dropped
+    store.append("power", START_MS + 5, 1000);
+    store.flush();
+    EXPECT_EQ(store.query("power", START_MS, START_MS + 59999)[0].max, 50);
+
+    // compaction survives a reopen
+    {
+        SegmentStore reopened(config);
+        EXPECT_EQ(reopened.query("power", START_MS, START_MS + HOUR_MS - 1).size(), 60);
+    }
+
+    store.maintain(START_MS + 49 * HOUR_MS);
+    EXPECT_EQ(segment_files(), 2);
+    EXPECT_TRUE(store.query("power", START_MS, START_MS + HOUR_MS - 1).empty());
+    EXPECT_FALSE(store.query("power", START_MS + HOUR_MS, START_MS + 3 * HOUR_MS).empty());
+}
+
+TEST_F(SegmentStoreTest, QueriesWhileAppendingAndCompacting) {
+    config.block_size = 4;
+    SegmentStore store(config);
+    for (int i = 0; i < 2 * 3600; i += 10) {
+        store.append("old", START_MS + i * 1000, i % 60);
+    }
+    store.flush();
+
+    std::atomic<bool> done{false};
+    std::thread writer([&store, &done]() {
+        for (int i = 0; i < 2000; i++) {
+            store.append("new", START_MS + 3 * HOUR_MS + i * 1000, i);
+        }
+        // both old segments end more than compact_after ago, they are replaced while queries read them
+        store.maintain(START_MS + 4 * HOUR_MS);
+        done = true;
+    });
+
+    std::size_t last_count = 0;
+    while (!done) {
+        // every sample is seen exactly once, either from a sealed block or from the open one
+        const auto result = store.query("new", START_MS + 3 * HOUR_MS, START_MS + 4 * HOUR_MS);
+        std::set<std::int64_t> timestamps;
+        for (const auto& aggregate : result) {
+            timestamps.insert(aggregate.timestamp_ms);
+        }
+        ASSERT_EQ(timestamps.size(), result.size());
+        ASSERT_GE(result.size(), last_count);
+        last_count = result.size();
+
+        // raw and compacted segments hold the same number of samples per hour
+        const auto hourly = store.query("old", START_MS, START_MS + 2 * HOUR_MS - 1, HOUR_MS);
+        ASSERT_EQ(hourly.size(), 2);
+        ASSERT_EQ(hourly[0].count, 360);
+        ASSERT_EQ(hourly[1].count, 360);
+    }
+    writer.join();
+
+    EXPECT_EQ(store.query("new", START_MS + 3 * HOUR_MS, START_MS + 4 * HOUR_MS).size(), 2000);
+    EXPECT_EQ(store.query("old", START_MS, START_MS + 2 * HOUR_MS - 1).size(), 120);
+}
+
+TEST_F(SegmentStoreTest, IgnoresForeignFiles) {
+    std::filesystem::create_directories(config.directory);
+    std::ofstream(config.directory / "garbage.seg") << "not a segment";
+    std::ofstream(config.directory / "123.seg.tmp") << "left over";
+    SegmentStore store(config);
+    EXPECT_TRUE(store.series_names().empty());
+    EXPECT_FALSE(std::filesystem::exists(config.directory / "123.seg.tmp"));
+}
+
+} // namespace
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <virtual_clock.hpp>
+
+namespace {
+
+using namespace virtual_clock;
+using namespace std::chrono_literals;
+
+class SharedClockTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const std::string test_name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        path = std::filesystem::temp_directory_path() / ("virtual_clock_test_" + test_name);
+        std::filesystem::remove(path);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    std::filesystem::path path;
+};
+
+TEST(VirtualClock, real_time_without_environment) {
+    ASSERT_FALSE(is_virtual());
+    const auto start = std::chrono::steady_clock::now();
+    sleep_for(10ms);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 10ms);
+    EXPECT_GE(now(), start + 10ms);
+}
+
+TEST_F(SharedClockTest, sleep_faster_than_real_time) {
+    SharedClock clock(path);
+    const auto start = clock.now();
+    const auto real_start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < 36; ++i) {
+        clock.sleep_until(clock.now() + 100s);
+    }
+
+    EXPECT_EQ(clock.now() - start, 1h);
+    EXPECT_LT(std::chrono::steady_clock::now() - real_start, 5s);
+}
+
+TEST_F(SharedClockTest, time_stands_still_without_sleepers) {
+    SharedClock clock(path);
+    const auto start = clock.now();
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(clock.now(), start);
+}
+
+TEST_F(SharedClockTest, sleepers_wake_in_virtual_time_order) {
+    // two clocks on the same file, as in two processes
+    SharedClock clock_a(path);
+    SharedClock clock_b(path);
+    const auto start = clock_a.now();
+
+    std::mutex mutex;
+    std::vector<std::pair<char, Duration>> wake_ups;
+    const auto run = [&](SharedClock& clock, char name, Duration period, int count) {
+        for (int i = 1; i <= count; ++i) {
+            clock.sleep_until(start + i * period);
+            std::lock_guard<std::mutex> lock(mutex);
+            wake_ups.emplace_back(name, clock.now() - start);
+        }
+    };
+
+    std::thread thread_a(run, std::ref(clock_a), 'a', 100ms, 10);
+    std::thread thread_b(run, std::ref(clock_b), 'b', 250ms, 4);
+    thread_a.join();
+    thread_b.join();
+
+    ASSERT_EQ(wake_ups.size(), 14);
+    for (std::size_t i = 1; i < wake_ups.size(); ++i) {
+        EXPECT_LE(wake_ups[i - 1].second, wake_ups[i].second);
+    }
+    for (const auto& [name, elapsed] : wake_ups) {
+        // every thread wakes exactly at its own time
+        EXPECT_EQ(elapsed % (name == 'a' ? 100ms : 250ms), Duration::zero());
+    }
+    EXPECT_EQ(clock_a.now() - start, 1s);
+    EXPECT_EQ(clock_a.now(), clock_b.now());
+    EXPECT_NE(clock_a.is_driver(), clock_b.is_driver());
+}
+
+TEST_F(SharedClockTest, driver_takes_over) {
+    auto first = std::make_unique<SharedClock>(path);
+    std::this_thread::sleep_for(10ms);
+    SharedClock second(path);
+    ASSERT_TRUE(first->is_driver());
+    ASSERT_FALSE(second.is_driver());
+
+    first.reset();
+    const auto start = second.now();
+    second.sleep_until(start + 10min);
+    EXPECT_EQ(second.now() - start, 10min);
+    EXPECT_TRUE(second.is_driver());
+}
+
+} // namespace
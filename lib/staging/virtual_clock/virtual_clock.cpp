@@ -0,0 +1,285 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "virtual_clock.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace virtual_clock {
+
+namespace {
+
+constexpr uint32_t MAGIC = 0x76636c6b; // "vclk"
+constexpr std::size_t MAX_SLEEPERS = 256;
+
+// a slot is free with pid 0 and claimed but not yet valid with pid -1
+constexpr int32_t PID_FREE = 0;
+constexpr int32_t PID_CLAIMED = -1;
+
+// the driver polls this often for changes, both on the clock and on the lock of the driver
+constexpr auto DRIVER_POLL_INTERVAL = std::chrono::microseconds(500);
+constexpr auto DRIVER_LOCK_RETRY_INTERVAL = std::chrono::milliseconds(100);
+// sleepers wake up this often in real time to notice missed wake ups
+constexpr long FUTEX_TIMEOUT_NS = 100'000'000;
+
+int64_t real_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void futex_wait(std::atomic<uint32_t>* word, uint32_t expected) {
+    struct timespec timeout {
+        0, FUTEX_TIMEOUT_NS
+    };
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+void futex_wake_all(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+bool process_alive(int32_t pid) {
+    return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+} // namespace
+
+struct SharedClock::Shared {
+    struct Sleeper {
+        std::atomic<int32_t> pid;
+        std::atomic<int64_t> wake_ns;
+    };
+
+    std::atomic<uint32_t> magic;
+    // futex word, incremented on every advance of the clock
+    std::atomic<uint32_t> epoch;
+    std::atomic<int64_t> now_ns;
+    // incremented whenever a thread goes to sleep or wakes up
+    std::atomic<uint64_t> activity;
+    Sleeper sleepers[MAX_SLEEPERS];
+};
+
+static_assert(std::atomic<int64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "the shared clock needs address free atomics");
+
+SharedClock::SharedClock(const std::string& path_, std::chrono::microseconds quiescence_) :
+    path(path_), quiescence(quiescence_) {
+    bool created = true;
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd == -1 && errno == EEXIST) {
+        created = false;
+        fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+    }
+    if (fd == -1) {
+        throw std::runtime_error("Could not open virtual clock " + path + ": " + strerror(errno));
+    }
+
+    if (created && ftruncate(fd, sizeof(Shared)) == -1) {
+        const auto error = std::string(strerror(errno));
+        ::close(fd);
+        throw std::runtime_error("Could not size virtual clock " + path + ": " + error);
+    }
+
+    // the creator might still be sizing the file
+    struct stat file_stat {};
+    for (int attempts = 0; fstat(fd, &file_stat) == 0 && file_stat.st_size < static_cast<off_t>(sizeof(Shared));
+         ++attempts) {
+        if (attempts == 1000) {
+            ::close(fd);
+            throw std::runtime_error("Virtual clock " + path + " has not been initialized");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto mapping = mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        const auto error = std::string(strerror(errno));
+        ::close(fd);
+        throw std::runtime_error("Could not map virtual clock " + path + ": " + error);
+    }
+    // the file is zero filled, which is a valid state for all atomics
+    shared = static_cast<Shared*>(mapping);
+
+    if (created) {
+        // start at the real time, so time points look the same as the ones of steady_clock
+        shared->now_ns = real_now_ns();
+        shared->magic.store(MAGIC, std::memory_order_release);
+    } else {
+        for (int attempts = 0; shared->magic.load(std::memory_order_acquire) != MAGIC; ++attempts) {
+            if (attempts == 1000) {
+                munmap(shared, sizeof(Shared));
+                ::close(fd);
+                throw std::runtime_error("Virtual clock " + path + " has not been initialized");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    driver_thread = std::thread(&SharedClock::drive, this);
+}
+
+SharedClock::~SharedClock() {
+    running = false;
+    driver_thread.join();
+    munmap(shared, sizeof(Shared));
+    ::close(fd);
+}
+
+TimePoint SharedClock::now() const {
+    return TimePoint(std::chrono::nanoseconds(shared->now_ns.load(std::memory_order_acquire)));
+}
+
+void SharedClock::sleep_until(TimePoint time_point) {
+    const auto wake_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time_point.time_since_epoch()).count();
+    if (shared->now_ns.load(std::memory_order_acquire) >= wake_ns) {
+        return;
+    }
+
+    Shared::Sleeper* sleeper = nullptr;
+    for (auto& slot : shared->sleepers) {
+        auto expected = PID_FREE;
+        if (slot.pid.compare_exchange_strong(expected, PID_CLAIMED)) {
+            sleeper = &slot;
+            break;
+        }
+    }
+    if (sleeper == nullptr) {
+        throw std::runtime_error("Too many threads sleeping on virtual clock " + path);
+    }
+    sleeper->wake_ns = wake_ns;
+    sleeper->pid.store(getpid(), std::memory_order_release);
+    shared->activity++;
+
+    while (true) {
+        const auto epoch = shared->epoch.load(std::memory_order_acquire);
+        if (shared->now_ns.load(std::memory_order_acquire) >= wake_ns) {
+            break;
+        }
+        futex_wait(&shared->epoch, epoch);
+    }
+
+    sleeper->pid.store(PID_FREE, std::memory_order_release);
+    shared->activity++;
+}
+
+void SharedClock::drive() {
+    // only one process drives the clock, whoever holds the lock on the file, so another one takes over when it dies
+    const auto lock_fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (lock_fd == -1) {
+        return;
+    }
+
+    while (running && flock(lock_fd, LOCK_EX | LOCK_NB) == -1) {
+        std::this_thread::sleep_for(DRIVER_LOCK_RETRY_INTERVAL);
+    }
+    driving = running.load();
+
+    auto last_activity = shared->activity.load();
+    auto quiet_since = std::chrono::steady_clock::now();
+    while (running) {
+        std::this_thread::sleep_for(DRIVER_POLL_INTERVAL);
+
+        const auto activity = shared->activity.load();
+        const auto real_now = std::chrono::steady_clock::now();
+        if (activity != last_activity) {
+            last_activity = activity;
+            quiet_since = real_now;
+            continue;
+        }
+
+        if (real_now - quiet_since < quiescence) {
+            continue;
+        }
+
+        if (advance()) {
+            // give the woken threads the quiescence period again, before advancing any further
+            quiet_since = real_now;
+        }
+    }
+
+    driving = false;
+    ::close(lock_fd);
+}
+
+bool SharedClock::advance() {
+    const auto now_ns = shared->now_ns.load(std::memory_order_acquire);
+    auto next_ns = INT64_MAX;
+
+    for (auto& slot : shared->sleepers) {
+        const auto pid = slot.pid.load(std::memory_order_acquire);
+        if (pid == PID_FREE || pid == PID_CLAIMED) {
+            continue;
+        }
+
+        const auto wake_ns = slot.wake_ns.load();
+        if (wake_ns > now_ns) {
+            next_ns = std::min(next_ns, wake_ns);
+        } else if (!process_alive(pid)) {
+            // due, but nobody left to wake up
+            auto expected = pid;
+            slot.pid.compare_exchange_strong(expected, PID_FREE);
+        }
+    }
+
+    if (next_ns == INT64_MAX) {
+        // nobody sleeps, time stands still
+        return false;
+    }
+
+    shared->now_ns.store(next_ns, std::memory_order_release);
+    shared->epoch.fetch_add(1, std::memory_order_release);
+    futex_wake_all(&shared->epoch);
+    return true;
+}
+
+//
+// process wide clock
+//
+static SharedClock* get_process_clock() {
+    static std::once_flag once;
+    // never destroyed, detached threads might still sleep on it while the process exits
+    static SharedClock* clock = nullptr;
+
+    std::call_once(once, []() {
+        const auto path = std::getenv(ENVIRONMENT_VARIABLE);
+        if (path != nullptr && path[0] != '\0') {
+            clock = new SharedClock(path);
+        }
+    });
+
+    return clock;
+}
+
+TimePoint now() {
+    const auto clock = get_process_clock();
+    return clock ? clock->now() : std::chrono::steady_clock::now();
+}
+
+void sleep_until(TimePoint time_point) {
+    const auto clock = get_process_clock();
+    if (clock) {
+        clock->sleep_until(time_point);
+    } else {
+        std::this_thread::sleep_until(time_point);
+    }
+}
+
+bool is_virtual() {
+    return get_process_clock() != nullptr;
+}
+
+} // namespace virtual_clock
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef VIRTUAL_CLOCK_VIRTUAL_CLOCK_HPP
+#define VIRTUAL_CLOCK_VIRTUAL_CLOCK_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace virtual_clock {
+
+using Duration = std::chrono::steady_clock::duration;
+using TimePoint = std::chrono::steady_clock::time_point;
+
+/// environment variable with the path of the clock file, all processes started with it share one virtual time
+constexpr auto ENVIRONMENT_VARIABLE = "EVEREST_VIRTUAL_CLOCK";
+
+/// \brief steady_clock::now(), or the virtual time if $EVEREST_VIRTUAL_CLOCK is set
+TimePoint now();
+
+/// \brief std::this_thread::sleep_until(), in virtual time if $EVEREST_VIRTUAL_CLOCK is set
+void sleep_until(TimePoint time_point);
+
+/// \brief std::this_thread::sleep_for(), in virtual time if $EVEREST_VIRTUAL_CLOCK is set
+template <typename Rep, typename Period> void sleep_for(const std::chrono::duration<Rep, Period>& duration) {
+    sleep_until(now() + std::chrono::duration_cast<Duration>(duration));
+}
+
+bool is_virtual();
+
+/// \brief Virtual time shared between processes through a memory mapped file.
+///
+/// Every thread that sleeps registers its wake up time in the file. One of the attached processes drives the clock:
+/// once no thread went to sleep or woke up for the quiescence period (in real time), it jumps the virtual time to the
+/// earliest wake up time and wakes the sleepers. Time therefore passes as fast as the sleeping threads allow and
+/// stands still while nobody sleeps. A thread that computes for longer than the quiescence period without sleeping
+/// may see time jump ahead. Threads of processes that died are removed from the file by the driver.
+class SharedClock {
+public:
+    static constexpr auto DEFAULT_QUIESCENCE = std::chrono::milliseconds(2);
+
+    explicit SharedClock(const std::string& path, std::chrono::microseconds quiescence = DEFAULT_QUIESCENCE);
+    ~SharedClock();
+
+    SharedClock(const SharedClock&) = delete;
+    SharedClock& operator=(const SharedClock&) = delete;
+
+    TimePoint now() const;
+    void sleep_until(TimePoint time_point);
+
+    /// \returns true if this instance currently drives the clock
+    bool is_driver() const {
+        return driving;
+    }
+
+private:
+    struct Shared;
+
+    void drive();
+    bool advance();
+
+    std::string path;
+    std::chrono::microseconds quiescence;
+    int fd{-1};
+    Shared* shared{nullptr};
+
+    std::atomic_bool running{true};
+    std::atomic_bool driving{false};
+    std::thread driver_thread;
+};
+
+} // namespace virtual_clock
+
+#endif // VIRTUAL_CLOCK_VIRTUAL_CLOCK_HPP
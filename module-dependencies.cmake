@@ -28,7 +28,7 @@ ev_define_dependency(
 
 ev_define_dependency(
     DEPENDENCY_NAME libcurl
-    DEPENDENT_MODULES_LIST LemDCBM400600)
+    DEPENDENT_MODULES_LIST LemDCBM400600 System)
 
 ev_define_dependency(
     DEPENDENCY_NAME libocpp
@@ -55,7 +55,7 @@ ev_define_dependency(
 
 ev_define_dependency(
     DEPENDENCY_NAME sqlite_cpp
-    DEPENDENT_MODULES_LIST ErrorHistory)
+    DEPENDENT_MODULES_LIST ErrorHistory System)
 
 ev_define_dependency(
     DEPENDENCY_NAME libiso15118
@@ -222,7 +222,7 @@ static void to_json(json& j, const SessionInfo::Error& e) {
     j = json{{"type", e.type}, {"description", e.description}, {"severity", e.severity}};
 }
 
-SessionInfo::operator std::string() {
+json SessionInfo::to_json_without_datetime() {
     std::lock_guard<std::mutex> lock(this->session_info_mutex);
 
     auto charged_energy_wh = this->end_energy_import_wh - this->start_energy_import_wh;
@@ -230,8 +230,6 @@ SessionInfo::operator std::string() {
     if ((this->start_energy_export_wh_was_set == true) && (this->end_energy_export_wh_was_set == true)) {
         discharged_energy_wh = this->end_energy_export_wh - this->start_energy_export_wh;
     }
-    auto now = date::utc_clock::now();
-
     auto charging_duration_s =
         std::chrono::duration_cast<std::chrono::seconds>(this->end_time_point - this->start_time_point);
 
@@ -242,8 +240,6 @@ SessionInfo::operator std::string() {
         {"discharged_energy_wh", discharged_energy_wh},
         {"latest_total_w", this->latest_total_w},
         {"charging_duration_s", charging_duration_s.count()},
-        {"datetime", Everest::Date::to_rfc3339(now)},
-
     });
 
     json active_disable_enable = json::object({{"source", this->active_enable_disable_source},
@@ -260,12 +256,31 @@ SessionInfo::operator std::string() {
         session_info["uk_random_delay"] = random_delay;
     }
 
+    return session_info;
+}
+
+SessionInfo::operator std::string() {
+    json session_info = this->to_json_without_datetime();
+    session_info["datetime"] = Everest::Date::to_rfc3339(date::utc_clock::now());
     return session_info.dump();
 }
 
+void API::publish_session_info(const std::string& topic, SessionInfo& session_info) {
+    // the datetime changes with every call, only publish if anything else changed
+    const json session_info_json = session_info.to_json_without_datetime();
+    this->publisher->publish(topic, session_info_json.dump(), [&session_info_json]() {
+        json payload = session_info_json;
+        payload["datetime"] = Everest::Date::to_rfc3339(date::utc_clock::now());
+        return payload.dump();
+    });
+}
+
 void API::init() {
     invoke_init(*p_main);
     this->limit_decimal_places = std::make_unique<LimitDecimalPlaces>(this->config);
+    this->publisher = std::make_unique<ChangePublisher>(
+        [this](const std::string& topic, const std::string& payload) { this->mqtt.publish(topic, payload); },
+        std::chrono::seconds(this->config.publish_heartbeat_s));
     std::vector<std::string> connectors;
     std::string var_connectors = this->api_base + "connectors";
 
@@ -273,7 +288,6 @@ void API::init() {
 
     for (auto& evse : this->r_evse_manager) {
         auto& session_info = this->info.emplace_back(std::make_unique<SessionInfo>());
-        auto& hw_caps = this->hw_capabilities_str.emplace_back("");
         std::string evse_base = this->api_base + evse->module_id;
         connectors.push_back(evse->module_id);
 
@@ -288,66 +302,60 @@ void API::init() {
 
         std::string var_hw_caps = var_base + "hardware_capabilities";
         evse->subscribe_hw_capabilities(
-            [this, var_hw_caps, &hw_caps](types::evse_board_support::HardwareCapabilities hw_capabilities) {
-                hw_caps = this->limit_decimal_places->limit(hw_capabilities);
-                this->mqtt.publish(var_hw_caps, hw_caps);
+            [this, var_hw_caps](types::evse_board_support::HardwareCapabilities hw_capabilities) {
+                this->publisher->publish(var_hw_caps, this->limit_decimal_places->limit(hw_capabilities));
             });
 
+        std::string var_datetime = var_base + "datetime";
+        std::string var_session_info = var_base + "session_info";
+        std::string var_logging_path = var_base + "logging_path";
+        this->session_info_topics.emplace_back(var_datetime, var_session_info, session_info.get());
+
         std::string var_powermeter = var_base + "powermeter";
-        evse->subscribe_powermeter([this, var_powermeter, &session_info](types::powermeter::Powermeter powermeter) {
-            this->mqtt.publish(var_powermeter, this->limit_decimal_places->limit(powermeter));
-            session_info->set_latest_energy_import_wh(powermeter.energy_Wh_import.total);
-            if (powermeter.energy_Wh_export.has_value()) {
-                session_info->set_latest_energy_export_wh(powermeter.energy_Wh_export.value().total);
-            }
-            if (powermeter.power_W.has_value()) {
-                session_info->set_latest_total_w(powermeter.power_W.value().total);
-            }
-        });
+        evse->subscribe_powermeter(
+            [this, var_powermeter, var_session_info, &session_info](types::powermeter::Powermeter powermeter) {
+                this->publisher->publish(var_powermeter, this->limit_decimal_places->limit(powermeter));
+                session_info->set_latest_energy_import_wh(powermeter.energy_Wh_import.total);
+                if (powermeter.energy_Wh_export.has_value()) {
+                    session_info->set_latest_energy_export_wh(powermeter.energy_Wh_export.value().total);
+                }
+                if (powermeter.power_W.has_value()) {
+                    session_info->set_latest_total_w(powermeter.power_W.value().total);
+                }
+                this->publish_session_info(var_session_info, *session_info);
+            });
 
         std::string var_limits = var_base + "limits";
         evse->subscribe_limits([this, var_limits](types::evse_manager::Limits limits) {
-            this->mqtt.publish(var_limits, this->limit_decimal_places->limit(limits));
+            this->publisher->publish(var_limits, this->limit_decimal_places->limit(limits));
         });
 
         std::string var_telemetry = var_base + "telemetry";
         evse->subscribe_telemetry([this, var_telemetry](types::evse_board_support::Telemetry telemetry) {
-            this->mqtt.publish(var_telemetry, this->limit_decimal_places->limit(telemetry));
+            this->publisher->publish(var_telemetry, this->limit_decimal_places->limit(telemetry));
         });
 
         std::string var_ev_info = var_base + "ev_info";
         evse->subscribe_ev_info([this, var_ev_info](types::evse_manager::EVInfo ev_info) {
             json ev_info_json = ev_info;
-            this->mqtt.publish(var_ev_info, ev_info_json.dump());
+            this->publisher->publish(var_ev_info, ev_info_json.dump());
         });
 
         std::string var_selected_protocol = var_base + "selected_protocol";
         evse->subscribe_selected_protocol([this, var_selected_protocol](const std::string& selected_protocol) {
-            this->selected_protocol = selected_protocol;
+            this->publisher->publish(var_selected_protocol, selected_protocol);
         });
 
         evse->subscribe_error(
             "evse_manager/Inoperative",
-            [this, &session_info](const Everest::error::Error& error) { session_info->set_permanent_fault(true); },
-            [this, &session_info](const Everest::error::Error& error) { session_info->set_permanent_fault(false); });
-
-        std::string var_datetime = var_base + "datetime";
-        std::string var_session_info = var_base + "session_info";
-        std::string var_logging_path = var_base + "logging_path";
-        this->api_threads.push_back(std::thread(
-            [this, var_datetime, var_session_info, var_hw_caps, var_selected_protocol, &session_info, &hw_caps]() {
-                auto next_tick = std::chrono::steady_clock::now();
-                while (this->running) {
-                    std::string datetime_str = Everest::Date::to_rfc3339(date::utc_clock::now());
-                    this->mqtt.publish(var_datetime, datetime_str);
-                    this->mqtt.publish(var_session_info, *session_info);
-                    this->mqtt.publish(var_hw_caps, hw_caps);
-                    this->mqtt.publish(var_selected_protocol, this->selected_protocol);
-
-                    next_tick += NOTIFICATION_PERIOD;
-                    std::this_thread::sleep_until(next_tick);
-                }
-            }));
+            [this, var_session_info, &session_info](const Everest::error::Error& error) {
+                session_info->set_permanent_fault(true);
+                this->publish_session_info(var_session_info, *session_info);
+            },
+            [this, var_session_info, &session_info](const Everest::error::Error& error) {
+                session_info->set_permanent_fault(false);
+                this->publish_session_info(var_session_info, *session_info);
+            });
 
         evse->subscribe_session_event(
             [this, var_session_info, var_logging_path, &session_info](types::evse_manager::SessionEvent session_event) {
@@ -364,7 +372,7 @@ void API::init() {
                     if (session_event.session_started.has_value()) {
                         auto session_started = session_event.session_started.value();
                         if (session_started.logging_path.has_value()) {
-                            this->mqtt.publish(var_logging_path, session_started.logging_path.value());
+                            this->publisher->publish(var_logging_path, session_started.logging_path.value());
                         }
                     }
                 }
@@ -394,9 +402,9 @@ void API::init() {
                             session_info->end_energy_export_wh_was_set = false;
                         }
                     }
-
-                    this->mqtt.publish(var_session_info, *session_info);
                 }
+
+                this->publish_session_info(var_session_info, *session_info);
             });
 
         // API commands
@@ -536,9 +544,11 @@ void API::init() {
         for (auto& random_delay : this->r_random_delay) {
             if (random_delay->module_id == evse->module_id) {
 
-                random_delay->subscribe_countdown([&session_info](const types::uk_random_delay::CountDown& s) {
-                    session_info->set_uk_random_delay_remaining(s);
-                });
+                random_delay->subscribe_countdown(
+                    [this, var_session_info, &session_info](const types::uk_random_delay::CountDown& s) {
+                        session_info->set_uk_random_delay_remaining(s);
+                        this->publish_session_info(var_session_info, *session_info);
+                    });
 
                 std::string cmd_uk_random_delay = cmd_base + "uk_random_delay";
                 this->mqtt.subscribe(cmd_uk_random_delay, [&random_delay](const std::string& data) {
@@ -570,21 +580,16 @@ void API::init() {
     std::string var_ocpp_connection_status = this->api_base + "ocpp/var/connection_status";
     std::string var_ocpp_schedule = this->api_base + "ocpp/var/charging_schedules";
 
+    this->publisher->publish(var_ocpp_connection_status, "unknown");
+
     if (this->r_ocpp.size() == 1) {
 
-        this->r_ocpp.at(0)->subscribe_is_connected([this](bool is_connected) {
-            std::scoped_lock lock(ocpp_data_mutex);
-            if (is_connected) {
-                this->ocpp_connection_status = "connected";
-            } else {
-                this->ocpp_connection_status = "disconnected";
-            }
+        this->r_ocpp.at(0)->subscribe_is_connected([this, var_ocpp_connection_status](bool is_connected) {
+            this->publisher->publish(var_ocpp_connection_status, is_connected ? "connected" : "disconnected");
         });
 
-        this->r_ocpp.at(0)->subscribe_charging_schedules([this, &var_ocpp_schedule](json schedule) {
-            std::scoped_lock lock(ocpp_data_mutex);
-            this->ocpp_charging_schedule = schedule;
-            this->ocpp_charging_schedule_updated = true;
+        this->r_ocpp.at(0)->subscribe_charging_schedules([this, var_ocpp_schedule](json schedule) {
+            this->publisher->publish(var_ocpp_schedule, schedule.dump());
         });
     }
 
@@ -601,28 +606,30 @@ void API::init() {
         }
     }
 
-    this->api_threads.push_back(
-        std::thread([this, var_connectors, connectors, var_info, var_ocpp_connection_status, var_ocpp_schedule]() {
-            auto next_tick = std::chrono::steady_clock::now();
-            while (this->running) {
-                json connectors_array = connectors;
-                this->mqtt.publish(var_connectors, connectors_array.dump());
-                if (not this->charger_information.is_null()) {
-                    this->mqtt.publish(var_info, this->charger_information.dump());
-                }
-                {
-                    std::scoped_lock lock(ocpp_data_mutex);
-                    this->mqtt.publish(var_ocpp_connection_status, this->ocpp_connection_status);
-                    if (this->ocpp_charging_schedule_updated) {
-                        this->ocpp_charging_schedule_updated = false;
-                        this->mqtt.publish(var_ocpp_schedule, ocpp_charging_schedule.dump());
-                    }
-                }
+    json connectors_array = connectors;
+    this->publisher->publish(var_connectors, connectors_array.dump());
+    if (not this->charger_information.is_null()) {
+        this->publisher->publish(var_info, this->charger_information.dump());
+    }
 
-                next_tick += NOTIFICATION_PERIOD;
-                std::this_thread::sleep_until(next_tick);
+    // everything else is published when it changes, this thread publishes the datetime and the heartbeats
+    this->api_threads.push_back(std::thread([this]() {
+        auto next_tick = std::chrono::steady_clock::now();
+        while (this->running) {
+            // clients use the datetime as a clock of the API, so it is published every period regardless of changes
+            const std::string datetime_str = Everest::Date::to_rfc3339(date::utc_clock::now());
+            for (const auto& [var_datetime, var_session_info, session_info] : this->session_info_topics) {
+                this->mqtt.publish(var_datetime, datetime_str);
+                if (this->publisher->heartbeat_due(var_session_info)) {
+                    this->publish_session_info(var_session_info, *session_info);
+                }
             }
-        }));
+            this->publisher->publish_heartbeats();
+
+            next_tick += NOTIFICATION_PERIOD;
+            std::this_thread::sleep_until(next_tick);
+        }
+    }));
 }
 
 void API::ready() {
@@ -632,8 +639,6 @@ void API::ready() {
     this->api_threads.push_back(std::thread([this, var_active_errors]() {
         auto next_tick = std::chrono::steady_clock::now();
         while (this->running) {
-            std::string datetime_str = Everest::Date::to_rfc3339(date::utc_clock::now());
-
             if (not r_error_history.empty()) {
                 // request active errors
                 types::error_history::FilterArguments filter;
@@ -642,7 +647,7 @@ void API::ready() {
                 json errors_json = json(active_errors);
 
                 // publish
-                this->mqtt.publish(var_active_errors, errors_json.dump());
+                this->publisher->publish(var_active_errors, errors_json.dump());
             }
             next_tick += NOTIFICATION_PERIOD;
             std::this_thread::sleep_until(next_tick);
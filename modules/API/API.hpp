@@ -26,10 +26,13 @@
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <tuple>
+#include <vector>
 
 #include <date/date.h>
 #include <date/tz.h>
 
+#include "ChangePublisher.hpp"
 #include "StartupMonitor.hpp"
 #include "limit_decimal_places.hpp"
 
@@ -71,6 +74,9 @@ public:
     /// \brief Converts this struct into a serialized json object
     operator std::string();
 
+    /// \brief Converts this struct into a json object without the current datetime
+    json to_json_without_datetime();
+
 private:
     std::mutex session_info_mutex;
     int32_t start_energy_import_wh; ///< Energy reading (import) at the beginning of this charging session in Wh
@@ -149,6 +155,7 @@ struct Conf {
     double telemetry_supply_voltage_12V_round_to;
     double telemetry_supply_voltage_minus_12V_round_to;
     double telemetry_plug_temperature_C_round_to;
+    int publish_heartbeat_s;
 };
 
 class API : public Everest::ModuleBase {
@@ -197,15 +204,13 @@ private:
     StartupMonitor evse_manager_check;
 
     std::list<std::unique_ptr<SessionInfo>> info;
-    std::list<std::string> hw_capabilities_str;
-    std::string selected_protocol;
+    // datetime and session_info topic of every evse
+    std::vector<std::tuple<std::string, std::string, SessionInfo*>> session_info_topics;
     json charger_information;
     std::unique_ptr<LimitDecimalPlaces> limit_decimal_places;
+    std::unique_ptr<ChangePublisher> publisher;
 
-    std::mutex ocpp_data_mutex;
-    json ocpp_charging_schedule;
-    bool ocpp_charging_schedule_updated = false;
-    std::string ocpp_connection_status = "unknown";
+    void publish_session_info(const std::string& topic, SessionInfo& session_info);
 
     const std::string api_base = "everest_api/";
     // ev@211cfdbe-f69a-4cd6-a4ec-f8aaa3d1b6c8:v1
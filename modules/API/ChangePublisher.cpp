@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "ChangePublisher.hpp"
+
+namespace module {
+
+ChangePublisher::ChangePublisher(PublishFunction publish, std::chrono::milliseconds heartbeat,
+                                 std::function<Clock::time_point()> now) :
+    publish_function(std::move(publish)), heartbeat(heartbeat), now(std::move(now)) {
+}
+
+bool ChangePublisher::is_due(const Topic& topic, Clock::time_point now) const {
+    return this->heartbeat.count() > 0 && now - topic.last_published >= this->heartbeat;
+}
+
+bool ChangePublisher::publish(const std::string& topic, const std::string& payload) {
+    return this->publish(topic, payload, [&payload]() { return payload; });
+}
+
+bool ChangePublisher::publish(const std::string& topic, const std::string& state,
+                              const std::function<std::string()>& make_payload) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    const auto now = this->now();
+    auto [it, inserted] = this->topics.try_emplace(topic);
+    if (!inserted && it->second.state == state && !this->is_due(it->second, now)) {
+        return false;
+    }
+    it->second.state = state;
+    it->second.payload = make_payload();
+    it->second.last_published = now;
+    this->publish_function(topic, it->second.payload);
+    return true;
+}
+
+bool ChangePublisher::heartbeat_due(const std::string& topic) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->topics.find(topic);
+    return it == this->topics.end() || this->is_due(it->second, this->now());
+}
+
+void ChangePublisher::publish_heartbeats() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    const auto now = this->now();
+    for (auto& [topic, entry] : this->topics) {
+        if (this->is_due(entry, now)) {
+            entry.last_published = now;
+            this->publish_function(topic, entry.payload);
+        }
+    }
+}
+
+} // namespace module
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef CHANGEPUBLISHER_HPP
+#define CHANGEPUBLISHER_HPP
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace module {
+
+/**
+ * \brief publish topics only when their payload changes
+ *
+ * Remembers the last payload published on every topic and drops publishes that
+ * would repeat it. Unchanged topics are published again once the heartbeat
+ * interval has passed, so that consumers can tell that the API is alive.
+ */
+class ChangePublisher {
+public:
+    using Clock = std::chrono::steady_clock;
+    using PublishFunction = std::function<void(const std::string& topic, const std::string& payload)>;
+
+    /**
+     * \param[in] publish function doing the actual publish
+     * \param[in] heartbeat interval after which unchanged topics are published again, zero disables it
+     */
+    ChangePublisher(PublishFunction publish, std::chrono::milliseconds heartbeat,
+                    std::function<Clock::time_point()> now = Clock::now);
+
+    /**
+     * \brief publish payload on topic if it changed or the heartbeat of the topic is due
+     * \returns true if the payload was published
+     */
+    bool publish(const std::string& topic, const std::string& payload);
+
+    /**
+     * \brief publish on topic if state changed or the heartbeat of the topic is due
+     *
+     * For payloads containing parts that change without being relevant, e.g. a timestamp:
+     * only state is compared, the payload is only created when it is published.
+     * \returns true if the payload was published
+     */
+    bool publish(const std::string& topic, const std::string& state, const std::function<std::string()>& make_payload);
+
+    /**
+     * \brief check whether the heartbeat of a topic is due
+     * \returns true if topic was never published or not within the heartbeat interval
+     */
+    bool heartbeat_due(const std::string& topic);
+
+    /**
+     * \brief publish the last payload of all topics whose heartbeat is due
+     */
+    void publish_heartbeats();
+
+private:
+    struct Topic {
+        std::string state;
+        std::string payload;
+        Clock::time_point last_published;
+    };
+
+    bool is_due(const Topic& topic, Clock::time_point now) const;
+
+    PublishFunction publish_function;
+    std::chrono::milliseconds heartbeat;
+    std::function<Clock::time_point()> now;
+
+    // held while publishing, so that publishes of one topic cannot overtake each other
+    std::mutex mutex;
+    std::unordered_map<std::string, Topic> topics;
+};
+
+} // namespace module
+
+#endif // CHANGEPUBLISHER_HPP
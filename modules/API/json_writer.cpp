@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "json_writer.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+
+namespace module {
+
+void JsonWriter::clear() {
+    this->buffer.clear();
+    this->needs_comma = false;
+}
+
+void JsonWriter::begin_object() {
+    this->buffer.push_back('{');
+    this->needs_comma = false;
+}
+
+void JsonWriter::end_object() {
+    this->buffer.push_back('}');
+    this->needs_comma = true;
+}
+
+void JsonWriter::key(std::string_view key) {
+    if (this->needs_comma) {
+        this->buffer.push_back(',');
+    }
+    this->value(key);
+    this->buffer.push_back(':');
+    this->needs_comma = false;
+}
+
+void JsonWriter::value(double value, int decimal_places) {
+    if (not std::isfinite(value)) {
+        this->buffer.append("null");
+        this->needs_comma = true;
+        return;
+    }
+    // large enough for every double in fixed notation with a sane number of decimal places
+    std::array<char, 512> chars;
+    auto result = std::to_chars(chars.data(), chars.data() + chars.size(), value, std::chars_format::fixed,
+                                decimal_places < 0 ? 0 : decimal_places);
+    if (result.ec != std::errc()) {
+        // shortest representation that round trips, always fits
+        result = std::to_chars(chars.data(), chars.data() + chars.size(), value);
+    }
+    this->buffer.append(chars.data(), result.ptr);
+    this->needs_comma = true;
+}
+
+void JsonWriter::value(int value) {
+    std::array<char, 16> chars;
+    const auto result = std::to_chars(chars.data(), chars.data() + chars.size(), value);
+    this->buffer.append(chars.data(), result.ptr);
+    this->needs_comma = true;
+}
+
+void JsonWriter::value(bool value) {
+    this->buffer.append(value ? "true" : "false");
+    this->needs_comma = true;
+}
+
+void JsonWriter::value(std::string_view value) {
+    static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+    this->buffer.push_back('"');
+    for (const char c : value) {
+        switch (c) {
+        case '"':
+            this->buffer.append("\\\"");
+            break;
+        case '\\':
+            this->buffer.append("\\\\");
+            break;
+        case '\n':
+            this->buffer.append("\\n");
+            break;
+        case '\r':
+            this->buffer.append("\\r");
+            break;
+        case '\t':
+            this->buffer.append("\\t");
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                this->buffer.append("\\u00");
+                this->buffer.push_back(HEX_DIGITS[(c >> 4) & 0xf]);
+                this->buffer.push_back(HEX_DIGITS[c & 0xf]);
+            } else {
+                this->buffer.push_back(c);
+            }
+        }
+    }
+    this->buffer.push_back('"');
+    this->needs_comma = true;
+}
+
+} // namespace module
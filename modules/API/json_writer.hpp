@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace module {
+
+/**
+ * \brief minimal streaming json object writer
+ *
+ * Writes compact json directly into a string buffer. The buffer keeps its capacity across
+ * clear(), so a writer that is reused for messages of the same shape does not allocate.
+ * Doubles are written in fixed notation with the requested number of decimal places,
+ * non finite doubles are written as null.
+ */
+class JsonWriter {
+public:
+    void clear();
+
+    void begin_object();
+    void end_object();
+
+    void key(std::string_view key);
+    void value(double value, int decimal_places);
+    void value(int value);
+    void value(bool value);
+    void value(std::string_view value);
+    void value(const char* value) {
+        this->value(std::string_view(value));
+    }
+
+    /// \brief begin a member of the current object that is itself an object
+    void begin_object(std::string_view key) {
+        this->key(key);
+        this->begin_object();
+    }
+
+    template <typename... Args> void member(std::string_view key, Args&&... args) {
+        this->key(key);
+        this->value(std::forward<Args>(args)...);
+    }
+
+    const std::string& str() const {
+        return buffer;
+    }
+
+private:
+    std::string buffer;
+    bool needs_comma{false};
+};
+
+} // namespace module
+
+#endif // JSON_WRITER_HPP
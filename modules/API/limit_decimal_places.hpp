@@ -5,7 +5,11 @@
 
 #include <generated/interfaces/evse_manager/Interface.hpp>
 
+#include <optional>
+#include <string_view>
+
 #include "API.hpp"
+#include "json_writer.hpp"
 
 namespace module {
 
@@ -21,6 +25,11 @@ public:
     double round_to_nearest_step(double value, double step);
 
 private:
+    void write_rounded(JsonWriter& writer, std::string_view key, double value, double step, int decimal_places);
+    /// \brief writes nothing if value is not set
+    void write_rounded(JsonWriter& writer, std::string_view key, const std::optional<float>& value, double step,
+                       int decimal_places);
+
     const Conf& config;
 };
 
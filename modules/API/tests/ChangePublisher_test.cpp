@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gtest/gtest.h>
+
+#include "ChangePublisher.hpp"
+
+#include <vector>
+
+namespace {
+using namespace module;
+using namespace std::chrono_literals;
+
+struct ChangePublisherTest : public ::testing::Test {
+    std::vector<std::pair<std::string, std::string>> published;
+    ChangePublisher::Clock::time_point now{};
+
+    ChangePublisher make_publisher(std::chrono::milliseconds heartbeat) {
+        return ChangePublisher(
+            [this](const std::string& topic, const std::string& payload) { published.emplace_back(topic, payload); },
+            heartbeat, [this]() { return now; });
+    }
+};
+
+TEST_F(ChangePublisherTest, publishesOnlyChanges) {
+    auto publisher = make_publisher(10s);
+    EXPECT_TRUE(publisher.publish("a", "1"));
+    EXPECT_FALSE(publisher.publish("a", "1"));
+    EXPECT_TRUE(publisher.publish("b", "1"));
+    EXPECT_TRUE(publisher.publish("a", "2"));
+    EXPECT_FALSE(publisher.publish("a", "2"));
+    ASSERT_EQ(published.size(), 3);
+    EXPECT_EQ(published[2], std::make_pair(std::string("a"), std::string("2")));
+}
+
+TEST_F(ChangePublisherTest, heartbeat) {
+    auto publisher = make_publisher(10s);
+    EXPECT_TRUE(publisher.heartbeat_due("a"));
+    publisher.publish("a", "1");
+    now += 5s;
+    publisher.publish("b", "1");
+    EXPECT_FALSE(publisher.heartbeat_due("a"));
+
+    now += 5s;
+    EXPECT_TRUE(publisher.heartbeat_due("a"));
+    EXPECT_FALSE(publisher.heartbeat_due("b"));
+    publisher.publish_heartbeats();
+    ASSERT_EQ(published.size(), 3);
+    EXPECT_EQ(published[2], std::make_pair(std::string("a"), std::string("1")));
+    EXPECT_FALSE(publisher.publish("a", "1"));
+
+    now += 5s;
+    // an unchanged publish counts as heartbeat once it is due
+    EXPECT_TRUE(publisher.publish("b", "1"));
+    publisher.publish_heartbeats();
+    EXPECT_EQ(published.size(), 4);
+}
+
+TEST_F(ChangePublisherTest, noHeartbeat) {
+    auto publisher = make_publisher(0s);
+    publisher.publish("a", "1");
+    now += 1h;
+    EXPECT_FALSE(publisher.heartbeat_due("a"));
+    EXPECT_FALSE(publisher.publish("a", "1"));
+    publisher.publish_heartbeats();
+    EXPECT_EQ(published.size(), 1);
+}
+
+TEST_F(ChangePublisherTest, stateAndLazyPayload) {
+    auto publisher = make_publisher(10s);
+    int payloads_created = 0;
+    auto make_payload = [&payloads_created, this]() {
+        payloads_created++;
+        return "state+" + std::to_string(now.time_since_epoch().count());
+    };
+    EXPECT_TRUE(publisher.publish("a", "state", make_payload));
+    now += 1s;
+    EXPECT_FALSE(publisher.publish("a", "state", make_payload));
+    EXPECT_EQ(payloads_created, 1);
+
+    now += 9s;
+    EXPECT_TRUE(publisher.publish("a", "state", make_payload));
+    EXPECT_EQ(payloads_created, 2);
+    EXPECT_NE(published[0].second, published[1].second);
+}
+} // namespace
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+// Compares formatting a powermeter shaped message with JsonWriter against the ryml tree
+// that LimitDecimalPlaces used before. Not part of the test suite, run it manually.
+
+#include "json_writer.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#include <c4/format.hpp>
+#include <ryml.hpp>
+#include <ryml_std.hpp>
+
+namespace {
+
+struct Phases {
+    double total;
+    double L1;
+    double L2;
+    double L3;
+};
+
+const std::string TIMESTAMP = "2024-05-14T12:34:56.789Z";
+const std::string METER_ID = "benchmark_meter";
+constexpr int DECIMAL_PLACES = 2;
+
+std::string format_ryml(const Phases& energy, const Phases& power, const Phases& voltage) {
+    ryml::Tree tree;
+    ryml::NodeRef root = tree.rootref();
+    root |= ryml::MAP;
+    root["timestamp"] << TIMESTAMP;
+    root["meter_id"] << METER_ID;
+    const std::pair<const char*, const Phases*> groups[] = {
+        {"energy_Wh_import", &energy}, {"power_W", &power}, {"voltage_V", &voltage}};
+    for (const auto& [name, phases] : groups) {
+        auto node = root[ryml::to_csubstr(name)];
+        node |= ryml::MAP;
+        node["total"] << ryml::fmt::real(phases->total, DECIMAL_PLACES);
+        node["L1"] << ryml::fmt::real(phases->L1, DECIMAL_PLACES);
+        node["L2"] << ryml::fmt::real(phases->L2, DECIMAL_PLACES);
+        node["L3"] << ryml::fmt::real(phases->L3, DECIMAL_PLACES);
+    }
+    std::stringstream stream;
+    stream << ryml::as_json(tree);
+    return stream.str();
+}
+
+std::string format_writer(module::JsonWriter& writer, const Phases& energy, const Phases& power,
+                          const Phases& voltage) {
+    writer.clear();
+    writer.begin_object();
+    writer.member("timestamp", TIMESTAMP);
+    writer.member("meter_id", METER_ID);
+    const std::pair<const char*, const Phases*> groups[] = {
+        {"energy_Wh_import", &energy}, {"power_W", &power}, {"voltage_V", &voltage}};
+    for (const auto& [name, phases] : groups) {
+        writer.begin_object(name);
+        writer.member("total", phases->total, DECIMAL_PLACES);
+        writer.member("L1", phases->L1, DECIMAL_PLACES);
+        writer.member("L2", phases->L2, DECIMAL_PLACES);
+        writer.member("L3", phases->L3, DECIMAL_PLACES);
+        writer.end_object();
+    }
+    writer.end_object();
+    return writer.str();
+}
+
+template <typename Format> void run(const char* name, int iterations, Format format) {
+    std::size_t bytes = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        const double offset = i * 0.001;
+        const Phases energy{12345.678 + offset, 4115.2 + offset, 4115.3 + offset, 4115.1 + offset};
+        const Phases power{11040.5 + offset, 3680.1, 3680.2, 3680.3};
+        const Phases voltage{230.12 + offset, 230.1, 229.9, 230.3};
+        bytes += format(energy, power, voltage).size();
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << static_cast<long>(iterations / elapsed) << " messages/s (" << bytes << " bytes)"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+    std::cout << "ryml:       " << format_ryml({1.005, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}) << std::endl;
+    module::JsonWriter writer;
+    std::cout << "JsonWriter: " << format_writer(writer, {1.005, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12})
+              << std::endl;
+
+    run("ryml", iterations, format_ryml);
+    run("JsonWriter", iterations, [&writer](const Phases& energy, const Phases& power, const Phases& voltage) {
+        return format_writer(writer, energy, power, voltage);
+    });
+    return 0;
+}
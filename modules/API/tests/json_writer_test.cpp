@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gtest/gtest.h>
+
+#include "json_writer.hpp"
+
+#include <limits>
+
+namespace {
+using namespace module;
+
+TEST(JsonWriter, empty_object) {
+    JsonWriter writer;
+    writer.begin_object();
+    writer.end_object();
+    EXPECT_EQ(writer.str(), "{}");
+}
+
+TEST(JsonWriter, members) {
+    JsonWriter writer;
+    writer.begin_object();
+    writer.member("string", "value");
+    writer.member("int", -42);
+    writer.member("bool", true);
+    writer.member("double", 1.0 / 3.0, 2);
+    writer.end_object();
+    EXPECT_EQ(writer.str(), R"({"string":"value","int":-42,"bool":true,"double":0.33})");
+}
+
+TEST(JsonWriter, nested_objects) {
+    JsonWriter writer;
+    writer.begin_object();
+    writer.begin_object("a");
+    writer.member("x", 1);
+    writer.end_object();
+    writer.begin_object("b");
+    writer.end_object();
+    writer.member("c", false);
+    writer.end_object();
+    EXPECT_EQ(writer.str(), R"({"a":{"x":1},"b":{},"c":false})");
+}
+
+TEST(JsonWriter, decimal_places) {
+    JsonWriter writer;
+    writer.begin_object();
+    writer.member("zero", 2.5, 0);
+    writer.member("padded", 1.5, 3);
+    writer.member("rounded", 230.456, 1);
+    writer.member("negative", -0.125, 2);
+    writer.member("large", 123456789.0, 2);
+    writer.end_object();
+    EXPECT_EQ(writer.str(),
+              R"({"zero":2,"padded":1.500,"rounded":230.5,"negative":-0.12,"large":123456789.00})");
+}
+
+TEST(JsonWriter, non_finite_doubles_are_null) {
+    JsonWriter writer;
+    writer.begin_object();
+    writer.member("nan", std::numeric_limits<double>::quiet_NaN(), 2);
+    writer.member("inf", std::numeric_limits<double>::infinity(), 2);
+    writer.end_object();
+    EXPECT_EQ(writer.str(), R"({"nan":null,"inf":null})");
+}
+
+TEST(JsonWriter, escapes_strings) {
+    JsonWriter writer;
+    writer.begin_object();
+    writer.member("quote\"key", std::string("back\\slash\nnew line\x01"));
+    writer.end_object();
+    EXPECT_EQ(writer.str(), R"({"quote\"key":"back\\slash\nnew line\u0001"})");
+}
+
+TEST(JsonWriter, clear_reuses_buffer) {
+    JsonWriter writer;
+    writer.begin_object();
+    writer.member("first", 1);
+    writer.end_object();
+    const auto capacity = writer.str().capacity();
+
+    writer.clear();
+    writer.begin_object();
+    writer.member("second", 2);
+    writer.end_object();
+    EXPECT_EQ(writer.str(), R"({"second":2})");
+    EXPECT_EQ(writer.str().capacity(), capacity);
+}
+
+} // namespace
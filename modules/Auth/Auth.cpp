@@ -16,6 +16,18 @@ void Auth::init() {
         string_to_selection_algorithm(this->config.selection_algorithm), this->config.connection_timeout,
         this->config.prioritize_authorization_over_stopping_transaction, this->config.ignore_connector_faults);
 
+    std::vector<TokenValidatorDispatcher::Validator> validators;
+    for (const auto& token_validator : this->r_token_validator) {
+        validators.push_back([&token_validator](const ProvidedIdToken& provided_token) {
+            return token_validator->call_validate_token(provided_token);
+        });
+    }
+    this->validator_dispatcher = std::make_unique<TokenValidatorDispatcher>(
+        std::move(validators), std::chrono::milliseconds(this->config.validation_timeout_ms),
+        conversions::string_to_validation_policy(this->config.validation_policy));
+    this->validation_cache = std::make_unique<ValidationCache>(
+        this->config.validation_cache_size, std::chrono::seconds(this->config.validation_cache_lifetime_s));
+
     for (const auto& token_provider : this->r_token_provider) {
         token_provider->subscribe_provided_token([this](ProvidedIdToken provided_token) {
             std::thread t([this, provided_token]() { this->auth_handler->on_token(provided_token); });
@@ -60,10 +72,12 @@ void Auth::ready() {
     this->auth_handler->register_withdraw_authorization_callback(
         [this](const int32_t evse_index) { this->r_evse_manager.at(evse_index)->call_withdraw_authorization(); });
     this->auth_handler->register_validate_token_callback([this](const ProvidedIdToken& provided_token) {
-        std::vector<ValidationResult> validation_results;
-        for (const auto& token_validator : this->r_token_validator) {
-            validation_results.push_back(token_validator->call_validate_token(provided_token));
+        if (const auto cached = this->validation_cache->lookup(provided_token)) {
+            EVLOG_debug << "Using cached validation result for token: " << provided_token.id_token.value;
+            return std::vector<ValidationResult>{cached.value()};
         }
+        auto validation_results = this->validator_dispatcher->validate(provided_token);
+        this->validation_cache->insert(provided_token, validation_results);
         return validation_results;
     });
     this->auth_handler->register_stop_transaction_callback(
@@ -22,6 +22,8 @@
 // ev@4bf81b14-a215-475c-a1d3-0a484ae48918:v1
 // insert your custom include headers here
 #include <AuthHandler.hpp>
+#include <TokenValidatorDispatcher.hpp>
+#include <ValidationCache.hpp>
 #include <memory>
 
 using namespace types::evse_manager;
@@ -36,6 +38,10 @@ struct Conf {
     std::string master_pass_group_id;
     bool prioritize_authorization_over_stopping_transaction;
     bool ignore_connector_faults;
+    std::string validation_policy;
+    int validation_timeout_ms;
+    int validation_cache_size;
+    int validation_cache_lifetime_s;
 };
 
 class Auth : public Everest::ModuleBase {
@@ -92,6 +98,8 @@ private:
 
     // ev@211cfdbe-f69a-4cd6-a4ec-f8aaa3d1b6c8:v1
     // insert your private definitions here
+    std::unique_ptr<TokenValidatorDispatcher> validator_dispatcher;
+    std::unique_ptr<ValidationCache> validation_cache;
     // ev@211cfdbe-f69a-4cd6-a4ec-f8aaa3d1b6c8:v1
 };
 
@@ -10,6 +10,8 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <utils/types.hpp>
 
@@ -200,13 +202,21 @@ private:
 
     std::map<int, std::unique_ptr<ConnectorContext>> connectors;
 
-    std::mutex timer_mutex;
+    /* Lock order: the plug_in_mutex of the referenced connectors (ascending connector id), then the event_mutex of a
+     * single connector, then plug_in_queue_mutex and identifier_index_mutex. on_token holds token_in_process_mutex
+     * while is_token_already_in_process takes identifier_index_mutex, so token_in_process_mutex comes before
+     * identifier_index_mutex and is never held while acquiring any of the other locks. */
     std::list<int> plug_in_queue;
     std::mutex plug_in_queue_mutex;
-    std::mutex plug_in_mutex;
-    std::set<std::string> tokens_in_process;
+    std::condition_variable cv; ///< signaled on plug in, waits on plug_in_queue_mutex
+    std::unordered_set<std::string> tokens_in_process;
     std::mutex token_in_process_mutex;
-    std::condition_variable cv;
+
+    // connectors indexed by the id_token and parent_id_token of their current identifier
+    using ConnectorIndex = std::unordered_map<std::string, std::set<int>>;
+    ConnectorIndex id_token_index;
+    ConnectorIndex parent_id_token_index;
+    std::mutex identifier_index_mutex;
 
     // callbacks
     std::function<void(const int evse_index, const ProvidedIdToken& provided_token,
@@ -235,13 +245,26 @@ private:
      * occurs that can be used to determine a connector.
      *
      * @param connectors
+     * @param plug_in_locks receives the plug in locks of \p connectors , which are held until it is destroyed
      * @return int
      */
-    int select_connector(const std::vector<int>& connectors);
+    int select_connector(const std::vector<int>& connectors,
+                         std::vector<std::unique_lock<std::mutex>>& plug_in_locks);
 
-    void lock_plug_in_mutex(const std::vector<int>& connectors);
-    void unlock_plug_in_mutex(const std::vector<int>& connectors);
+    /**
+     * @brief Locks the plug_in_mutex of all given \p connectors in ascending connector id order and stores the locks in
+     * \p plug_in_locks . Does nothing if \p plug_in_locks already holds locks.
+     *
+     * @param connectors
+     * @param plug_in_locks
+     */
+    void lock_plug_in_mutex(const std::vector<int>& connectors,
+                            std::vector<std::unique_lock<std::mutex>>& plug_in_locks);
     int get_latest_plugin(const std::vector<int>& connectors);
+    /// \brief same as get_latest_plugin, but the caller has to hold plug_in_queue_mutex
+    int find_latest_plugin(const std::vector<int>& connectors) const;
+    void set_identifier(int connector_id, const Identifier& identifier);
+    void reset_identifier(int connector_id);
     void notify_evse(int connector_id, const ProvidedIdToken& provided_token,
                      const ValidationResult& validation_result);
     Identifier get_identifier(const ValidationResult& validation_result, const std::string& id_token,
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#ifndef _TOKEN_VALIDATOR_DISPATCHER_HPP_
+#define _TOKEN_VALIDATOR_DISPATCHER_HPP_
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <generated/types/authorization.hpp>
+
+namespace module {
+
+enum class ValidationPolicy {
+    WaitForAll,   ///< wait for the results of all validators
+    FirstAccepted ///< return as soon as one validator accepted the token
+};
+
+namespace conversions {
+ValidationPolicy string_to_validation_policy(const std::string& policy);
+} // namespace conversions
+
+/**
+ * @brief Asks all token validators concurrently, so that a slow validator (e.g. OCPP while the CSMS is offline) does
+ * not delay the results of the others.
+ *
+ */
+class TokenValidatorDispatcher {
+
+public:
+    using Validator =
+        std::function<types::authorization::ValidationResult(const types::authorization::ProvidedIdToken&)>;
+
+    /**
+     * @brief Construct a new Token Validator Dispatcher object
+     *
+     * @param validators the validators, their order is the order of the returned results
+     * @param deadline time after which validators that did not respond are ignored, zero waits without limit
+     * @param policy
+     */
+    TokenValidatorDispatcher(std::vector<Validator> validators, std::chrono::milliseconds deadline,
+                             ValidationPolicy policy);
+
+    /**
+     * @brief Validates the \p provided_token with all validators.
+     *
+     * @param provided_token
+     * @return the results of all validators that responded in time, in the order of the validators. Validators that
+     * did not respond in time or failed are not part of the result.
+     */
+    std::vector<types::authorization::ValidationResult>
+    validate(const types::authorization::ProvidedIdToken& provided_token) const;
+
+private:
+    std::vector<Validator> validators;
+    std::chrono::milliseconds deadline;
+    ValidationPolicy policy;
+};
+
+} // namespace module
+
+#endif // _TOKEN_VALIDATOR_DISPATCHER_HPP_
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#ifndef _VALIDATION_CACHE_HPP_
+#define _VALIDATION_CACHE_HPP_
+
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <date/date.h>
+
+#include <generated/types/authorization.hpp>
+
+namespace module {
+
+/**
+ * @brief Bounded least recently used cache of accepted validation results.
+ *
+ * A result is cached until its expiry_time. Results without expiry_time are cached for the default lifetime, if it is
+ * zero they are not cached. Only accepted results are cached, so that a token that becomes valid in the backend is
+ * not rejected from the cache.
+ *
+ */
+class ValidationCache {
+
+public:
+    using Clock = date::utc_clock;
+
+    /**
+     * @brief Construct a new Validation Cache object
+     *
+     * @param capacity maximum number of cached tokens, zero disables the cache
+     * @param default_lifetime lifetime of results without expiry_time
+     */
+    ValidationCache(std::size_t capacity, std::chrono::seconds default_lifetime);
+
+    /**
+     * @brief Returns the cached result for the \p provided_token if there is one that did not expire.
+     *
+     * @param provided_token
+     * @param now
+     * @return std::optional<types::authorization::ValidationResult>
+     */
+    std::optional<types::authorization::ValidationResult>
+    lookup(const types::authorization::ProvidedIdToken& provided_token, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Caches the first accepted result of \p validation_results for the \p provided_token
+     *
+     * @param provided_token
+     * @param validation_results
+     * @param now
+     */
+    void insert(const types::authorization::ProvidedIdToken& provided_token,
+                const std::vector<types::authorization::ValidationResult>& validation_results,
+                Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Removes all cached results
+     *
+     */
+    void clear();
+
+    std::size_t size();
+
+private:
+    struct Entry {
+        std::string key;
+        types::authorization::ValidationResult validation_result;
+        Clock::time_point expires_at;
+    };
+
+    static std::string key(const types::authorization::ProvidedIdToken& provided_token);
+
+    std::size_t capacity;
+    std::chrono::seconds default_lifetime;
+
+    std::mutex mutex;
+    // most recently used entry first
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+};
+
+} // namespace module
+
+#endif // _VALIDATION_CACHE_HPP_
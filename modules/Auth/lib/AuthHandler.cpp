@@ -16,6 +16,20 @@ std::vector<int> intersect(std::vector<int>& a, std::vector<int>& b) {
     return result;
 }
 
+namespace {
+void erase_from_index(std::unordered_map<std::string, std::set<int>>& index, const std::string& token,
+                      int connector_id) {
+    const auto entry = index.find(token);
+    if (entry == index.end()) {
+        return;
+    }
+    entry->second.erase(connector_id);
+    if (entry->second.empty()) {
+        index.erase(entry);
+    }
+}
+} // namespace
+
 namespace conversions {
 std::string token_handling_result_to_string(const TokenHandlingResult& result) {
     switch (result) {
@@ -68,7 +82,6 @@ TokenHandlingResult AuthHandler::on_token(const ProvidedIdToken& provided_token)
         this->publish_token_validation_status_callback(provided_token, TokenValidationStatus::Processing);
         this->token_in_process_mutex.unlock();
         result = this->handle_token(provided_token);
-        this->unlock_plug_in_mutex(referenced_connectors);
     } else {
         // do nothing if token is currently processed
         EVLOG_info << "Received token " << provided_token.id_token.value << " repeatedly while still processing it";
@@ -105,6 +118,8 @@ TokenHandlingResult AuthHandler::on_token(const ProvidedIdToken& provided_token)
 
 TokenHandlingResult AuthHandler::handle_token(const ProvidedIdToken& provided_token) {
     std::vector<int> referenced_connectors = this->get_referenced_connectors(provided_token);
+    // plug in locks taken during connector selection are released when this request is handled
+    std::vector<std::unique_lock<std::mutex>> plug_in_locks;
 
     // Only provided token with type RFID can be used to stop a transaction
     if (provided_token.authorization_type == AuthorizationType::RFID) {
@@ -138,7 +153,7 @@ TokenHandlingResult AuthHandler::handle_token(const ProvidedIdToken& provided_to
      * deposited for a reservation, we can immediately respond with NO_CONNECTOR_AVAILABLE */
     bool all_connectors_reserved_and_tag_does_not_match = true;
     for (const auto connector_id : referenced_connectors) {
-        const auto connector = this->connectors.at(connector_id)->connector;
+        const auto& connector = this->connectors.at(connector_id)->connector;
         if (!connector.reserved) {
             all_connectors_reserved_and_tag_does_not_match = false;
             break;
@@ -190,7 +205,7 @@ TokenHandlingResult AuthHandler::handle_token(const ProvidedIdToken& provided_to
                     EVLOG_info << "Provided parent_id_token is equal to master_pass_group_id. Stopping all active "
                                   "transactions!";
                     for (const auto connector_id : referenced_connectors) {
-                        const auto connector = this->connectors.at(connector_id)->connector;
+                        const auto& connector = this->connectors.at(connector_id)->connector;
                         if (connector.transaction_active) {
                             StopTransactionRequest req;
                             req.reason = StopTransactionReason::MasterPass;
@@ -206,7 +221,7 @@ TokenHandlingResult AuthHandler::handle_token(const ProvidedIdToken& provided_to
                 const auto connector_used_for_transaction =
                     this->used_for_transaction(referenced_connectors, validation_result.parent_id_token.value().value);
                 if (connector_used_for_transaction != -1) {
-                    const auto connector = this->connectors.at(connector_used_for_transaction)->connector;
+                    const auto& connector = this->connectors.at(connector_used_for_transaction)->connector;
                     // only stop transaction if a transaction is active
                     if (!connector.transaction_active) {
                         return TokenHandlingResult::ALREADY_IN_PROCESS;
@@ -252,7 +267,7 @@ TokenHandlingResult AuthHandler::handle_token(const ProvidedIdToken& provided_to
                     - process it against placed reservations
                     - compare referenced_connectors against the connectors listed in the validation_result
                 */
-                int connector_id = this->select_connector(referenced_connectors); // might block
+                int connector_id = this->select_connector(referenced_connectors, plug_in_locks); // might block
                 EVLOG_debug << "Selected connector#" << connector_id << " for token: " << provided_token.id_token.value;
                 if (connector_id != -1) { // indicates timeout of connector selection
                     if (validation_result.evse_ids.has_value() and
@@ -337,20 +352,22 @@ std::vector<int> AuthHandler::get_referenced_connectors(const ProvidedIdToken& p
 }
 
 int AuthHandler::used_for_transaction(const std::vector<int>& connector_ids, const std::string& token) {
-    for (const auto connector_id : connector_ids) {
-        if (this->connectors.at(connector_id)->connector.identifier.has_value()) {
-            const auto& identifier = this->connectors.at(connector_id)->connector.identifier.value();
-            // check against id_token
-            if (identifier.id_token.value == token) {
-                return connector_id;
-            }
-            // check against parent_id_token
-            else if (identifier.parent_id_token.has_value() && identifier.parent_id_token.value().value == token) {
-                return connector_id;
+    std::lock_guard<std::mutex> lk(this->identifier_index_mutex);
+    // check against id_token and parent_id_token, the first match within connector_ids wins
+    auto first = connector_ids.end();
+    for (const auto* index : {&this->id_token_index, &this->parent_id_token_index}) {
+        const auto entry = index->find(token);
+        if (entry == index->end()) {
+            continue;
+        }
+        for (const auto connector_id : entry->second) {
+            const auto it = std::find(connector_ids.begin(), first, connector_id);
+            if (it != first) {
+                first = it;
             }
         }
     }
-    return -1;
+    return first != connector_ids.end() ? *first : -1;
 }
 
 bool AuthHandler::is_token_already_in_process(const std::string& id_token,
@@ -361,10 +378,15 @@ bool AuthHandler::is_token_already_in_process(const std::string& id_token,
         return true;
     } else {
         // check if id_token was already used to authorize evse but no transaction has been started yet
-        for (const auto connector_id : referenced_connectors) {
-            const auto connector = this->connectors.at(connector_id)->connector;
-            if (connector.identifier.has_value() && connector.identifier.value().id_token.value == id_token &&
-                !connector.transaction_active) {
+        std::lock_guard<std::mutex> lk(this->identifier_index_mutex);
+        const auto entry = this->id_token_index.find(id_token);
+        if (entry == this->id_token_index.end()) {
+            return false;
+        }
+        for (const auto connector_id : entry->second) {
+            if (std::find(referenced_connectors.begin(), referenced_connectors.end(), connector_id) !=
+                    referenced_connectors.end() and
+                !this->connectors.at(connector_id)->connector.transaction_active) {
                 return true;
             }
         }
@@ -412,6 +434,10 @@ bool AuthHandler::equals_master_pass_group_id(const std::optional<types::authori
 
 int AuthHandler::get_latest_plugin(const std::vector<int>& connectors) {
     std::lock_guard<std::mutex> lk(this->plug_in_queue_mutex);
+    return this->find_latest_plugin(connectors);
+}
+
+int AuthHandler::find_latest_plugin(const std::vector<int>& connectors) const {
     for (const auto connector : this->plug_in_queue) {
         if (std::find(connectors.begin(), connectors.end(), connector) != connectors.end()) {
             return connector;
@@ -420,19 +446,53 @@ int AuthHandler::get_latest_plugin(const std::vector<int>& connectors) {
     return -1;
 }
 
-void AuthHandler::lock_plug_in_mutex(const std::vector<int>& connectors) {
-    for (const auto connector_id : connectors) {
-        this->connectors.at(connector_id)->plug_in_mutex.lock();
+void AuthHandler::lock_plug_in_mutex(const std::vector<int>& connectors,
+                                     std::vector<std::unique_lock<std::mutex>>& plug_in_locks) {
+    if (!plug_in_locks.empty()) {
+        return;
+    }
+    // a consistent order prevents deadlocks between requests that reference overlapping sets of connectors
+    std::vector<int> connector_ids = connectors;
+    std::sort(connector_ids.begin(), connector_ids.end());
+    connector_ids.erase(std::unique(connector_ids.begin(), connector_ids.end()), connector_ids.end());
+    plug_in_locks.reserve(connector_ids.size());
+    for (const auto connector_id : connector_ids) {
+        plug_in_locks.emplace_back(this->connectors.at(connector_id)->plug_in_mutex);
     }
 }
 
-void AuthHandler::unlock_plug_in_mutex(const std::vector<int>& connectors) {
-    for (const auto connector_id : connectors) {
-        this->connectors.at(connector_id)->plug_in_mutex.unlock();
+void AuthHandler::set_identifier(int connector_id, const Identifier& identifier) {
+    std::lock_guard<std::mutex> lk(this->identifier_index_mutex);
+    auto& current = this->connectors.at(connector_id)->connector.identifier;
+    if (current.has_value()) {
+        erase_from_index(this->id_token_index, current.value().id_token.value, connector_id);
+        if (current.value().parent_id_token.has_value()) {
+            erase_from_index(this->parent_id_token_index, current.value().parent_id_token.value().value,
+                             connector_id);
+        }
+    }
+    current.emplace(identifier);
+    this->id_token_index[identifier.id_token.value].insert(connector_id);
+    if (identifier.parent_id_token.has_value()) {
+        this->parent_id_token_index[identifier.parent_id_token.value().value].insert(connector_id);
+    }
+}
+
+void AuthHandler::reset_identifier(int connector_id) {
+    std::lock_guard<std::mutex> lk(this->identifier_index_mutex);
+    auto& current = this->connectors.at(connector_id)->connector.identifier;
+    if (!current.has_value()) {
+        return;
+    }
+    erase_from_index(this->id_token_index, current.value().id_token.value, connector_id);
+    if (current.value().parent_id_token.has_value()) {
+        erase_from_index(this->parent_id_token_index, current.value().parent_id_token.value().value, connector_id);
     }
+    current.reset();
 }
 
-int AuthHandler::select_connector(const std::vector<int>& connectors) {
+int AuthHandler::select_connector(const std::vector<int>& connectors,
+                                  std::vector<std::unique_lock<std::mutex>>& plug_in_locks) {
 
     if (connectors.size() == 1) {
         return connectors.at(0);
@@ -441,23 +501,23 @@ int AuthHandler::select_connector(const std::vector<int>& connectors) {
     if (this->selection_algorithm == SelectionAlgorithm::PlugEvents) {
         // locks all referenced connectors for this request. Subsequent requests referencing one or more of the locked
         // connectors are blocked until handle_token returns
-        this->lock_plug_in_mutex(connectors);
-        if (this->get_latest_plugin(connectors) == -1) {
+        this->lock_plug_in_mutex(connectors, plug_in_locks);
+        std::unique_lock<std::mutex> lk(this->plug_in_queue_mutex);
+        if (this->find_latest_plugin(connectors) == -1) {
             // no EV has been plugged in yet at the referenced connectors
             EVLOG_debug << "No connector in authorization queue. Waiting for a plug in...";
-            std::unique_lock<std::mutex> lk(this->plug_in_mutex);
             // blocks until respective plugin for connector occured or until timeout
             if (!this->cv.wait_for(lk, std::chrono::seconds(this->connection_timeout),
-                                   [this, connectors] { return this->get_latest_plugin(connectors) != -1; })) {
+                                   [this, &connectors] { return this->find_latest_plugin(connectors) != -1; })) {
                 return -1;
             }
             EVLOG_debug << "Plug in at connector occured";
         }
-        return this->get_latest_plugin(connectors);
+        return this->find_latest_plugin(connectors);
     } else if (this->selection_algorithm == SelectionAlgorithm::FindFirst) {
         EVLOG_debug
             << "SelectionAlgorithm FindFirst: Selecting first available connector without an active transaction";
-        this->lock_plug_in_mutex(connectors);
+        this->lock_plug_in_mutex(connectors, plug_in_locks);
         const auto selected_connector_id = this->get_latest_plugin(connectors);
         if (selected_connector_id != -1 and !this->connectors.at(selected_connector_id)->connector.transaction_active) {
             // an EV has been plugged in yet at the referenced connectors
@@ -466,7 +526,7 @@ int AuthHandler::select_connector(const std::vector<int>& connectors) {
             // no EV has been plugged in yet at the referenced connectors; choosing the first one where no
             // transaction is active
             for (const auto connector_id : connectors) {
-                const auto connector = this->connectors.at(connector_id)->connector;
+                const auto& connector = this->connectors.at(connector_id)->connector;
                 if (!connector.transaction_active) {
                     return connector_id;
                 }
@@ -487,15 +547,15 @@ void AuthHandler::notify_evse(int connector_id, const ProvidedIdToken& provided_
         Identifier identifier{provided_token.id_token, provided_token.authorization_type,
                               validation_result.authorization_status, validation_result.expiry_time,
                               validation_result.parent_id_token};
-        this->connectors.at(connector_id)->connector.identifier.emplace(identifier);
+        this->set_identifier(connector_id, identifier);
 
-        std::lock_guard<std::mutex> timer_lk(this->timer_mutex);
+        std::lock_guard<std::mutex> event_lk(this->connectors.at(connector_id)->event_mutex);
         this->connectors.at(connector_id)->timeout_timer.stop();
         this->connectors.at(connector_id)
             ->timeout_timer.timeout(
                 [this, evse_index, connector_id, provided_token]() {
                     EVLOG_info << "Authorization timeout for evse#" << evse_index;
-                    this->connectors.at(connector_id)->connector.identifier.reset();
+                    this->reset_identifier(connector_id);
                     this->withdraw_authorization_callback(evse_index);
                     this->publish_token_validation_status_callback(provided_token, TokenValidationStatus::TimedOut);
                 },
@@ -538,8 +598,7 @@ void AuthHandler::handle_permanent_fault_cleared(const int connector_id) {
 
 void AuthHandler::handle_session_event(const int connector_id, const SessionEvent& event) {
 
-    std::lock_guard<std::mutex> lk(this->timer_mutex);
-    this->connectors.at(connector_id)->event_mutex.lock();
+    std::lock_guard<std::mutex> event_lk(this->connectors.at(connector_id)->event_mutex);
     const auto event_type = event.event;
 
     switch (event_type) {
@@ -549,7 +608,8 @@ void AuthHandler::handle_session_event(const int connector_id, const SessionEven
             std::lock_guard<std::mutex> lk(this->plug_in_queue_mutex);
             this->plug_in_queue.push_back(connector_id);
         }
-        this->cv.notify_one();
+        // waiters may reference disjoint sets of connectors, so every one of them has to check the queue
+        this->cv.notify_all();
 
         // only set plug in timeout when SessionStart is caused by plug in
         if (event.session_started.value().reason == StartSessionReason::EVConnected) {
@@ -574,11 +634,11 @@ void AuthHandler::handle_session_event(const int connector_id, const SessionEven
         break;
     case SessionEventEnum::TransactionFinished:
         this->connectors.at(connector_id)->connector.transaction_active = false;
-        this->connectors.at(connector_id)->connector.identifier.reset();
+        this->reset_identifier(connector_id);
         break;
     case SessionEventEnum::SessionFinished:
         this->connectors.at(connector_id)->connector.is_reservable = true;
-        this->connectors.at(connector_id)->connector.identifier.reset();
+        this->reset_identifier(connector_id);
         this->connectors.at(connector_id)->connector.submit_event(ConnectorEvent::SESSION_FINISHED);
         this->connectors.at(connector_id)->timeout_timer.stop();
         {
@@ -632,7 +692,6 @@ void AuthHandler::handle_session_event(const int connector_id, const SessionEven
     case SessionEventEnum::PluginTimeout:
         break;
     }
-    this->connectors.at(connector_id)->event_mutex.unlock();
 }
 
 void AuthHandler::set_connection_timeout(const int connection_timeout) {
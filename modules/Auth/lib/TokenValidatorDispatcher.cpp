@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <TokenValidatorDispatcher.hpp>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+#include <everest/logging.hpp>
+
+namespace module {
+
+namespace conversions {
+ValidationPolicy string_to_validation_policy(const std::string& policy) {
+    if (policy == "WaitForAll") {
+        return ValidationPolicy::WaitForAll;
+    } else if (policy == "FirstAccepted") {
+        return ValidationPolicy::FirstAccepted;
+    }
+    throw std::out_of_range("No known conversion from provided string: " + policy + " to ValidationPolicy");
+}
+} // namespace conversions
+
+namespace {
+/// state shared with the validator threads, which may outlive a validate() call that ran into the deadline
+struct DispatchState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::optional<types::authorization::ValidationResult>> results;
+    std::size_t responses{0};
+    bool accepted{false};
+};
+} // namespace
+
+TokenValidatorDispatcher::TokenValidatorDispatcher(std::vector<Validator> validators,
+                                                   std::chrono::milliseconds deadline, ValidationPolicy policy) :
+    validators(std::move(validators)), deadline(deadline), policy(policy) {
+}
+
+std::vector<types::authorization::ValidationResult>
+TokenValidatorDispatcher::validate(const types::authorization::ProvidedIdToken& provided_token) const {
+    std::vector<types::authorization::ValidationResult> validation_results;
+
+    // nothing to wait for concurrently
+    if (this->validators.size() == 1 && this->deadline.count() == 0) {
+        try {
+            validation_results.push_back(this->validators.front()(provided_token));
+        } catch (const std::exception& e) {
+            EVLOG_warning << "Token validator failed: " << e.what();
+        }
+        return validation_results;
+    }
+
+    auto state = std::make_shared<DispatchState>();
+    state->results.resize(this->validators.size());
+
+    for (std::size_t i = 0; i < this->validators.size(); i++) {
+        std::thread([state, i, validator = this->validators.at(i), provided_token]() {
+            std::optional<types::authorization::ValidationResult> result;
+            try {
+                result = validator(provided_token);
+            } catch (const std::exception& e) {
+                EVLOG_warning << "Token validator #" << i << " failed: " << e.what();
+            }
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (result.has_value() &&
+                result.value().authorization_status == types::authorization::AuthorizationStatus::Accepted) {
+                state->accepted = true;
+            }
+            state->results.at(i) = std::move(result);
+            state->responses++;
+            state->cv.notify_all();
+        }).detach();
+    }
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    const auto done = [this, &state]() {
+        return state->responses == state->results.size() ||
+               (this->policy == ValidationPolicy::FirstAccepted && state->accepted);
+    };
+    if (this->deadline.count() == 0) {
+        state->cv.wait(lock, done);
+    } else if (!state->cv.wait_for(lock, this->deadline, done)) {
+        EVLOG_warning << "Only " << state->responses << " of " << state->results.size()
+                      << " token validators responded within " << this->deadline.count() << "ms";
+    }
+
+    for (const auto& result : state->results) {
+        if (result.has_value()) {
+            validation_results.push_back(result.value());
+        }
+    }
+    return validation_results;
+}
+
+} // namespace module
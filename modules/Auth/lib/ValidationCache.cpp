@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <ValidationCache.hpp>
+
+#include <algorithm>
+
+#include <utils/date.hpp>
+
+namespace module {
+
+ValidationCache::ValidationCache(std::size_t capacity, std::chrono::seconds default_lifetime) :
+    capacity(capacity), default_lifetime(default_lifetime) {
+}
+
+std::string ValidationCache::key(const types::authorization::ProvidedIdToken& provided_token) {
+    return types::authorization::authorization_type_to_string(provided_token.authorization_type) + "/" +
+           types::authorization::id_token_type_to_string(provided_token.id_token.type) + "/" +
+           provided_token.id_token.value;
+}
+
+std::optional<types::authorization::ValidationResult>
+ValidationCache::lookup(const types::authorization::ProvidedIdToken& provided_token, Clock::time_point now) {
+    if (this->capacity == 0) {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    const auto it = this->index.find(key(provided_token));
+    if (it == this->index.end()) {
+        return std::nullopt;
+    }
+
+    if (now >= it->second->expires_at) {
+        this->entries.erase(it->second);
+        this->index.erase(it);
+        return std::nullopt;
+    }
+
+    // mark as most recently used
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    return it->second->validation_result;
+}
+
+void ValidationCache::insert(const types::authorization::ProvidedIdToken& provided_token,
+                             const std::vector<types::authorization::ValidationResult>& validation_results,
+                             Clock::time_point now) {
+    if (this->capacity == 0) {
+        return;
+    }
+
+    const auto accepted = std::find_if(validation_results.begin(), validation_results.end(), [](const auto& result) {
+        return result.authorization_status == types::authorization::AuthorizationStatus::Accepted;
+    });
+    if (accepted == validation_results.end()) {
+        return;
+    }
+
+    Clock::time_point expires_at;
+    if (accepted->expiry_time.has_value()) {
+        try {
+            expires_at = Everest::Date::from_rfc3339(accepted->expiry_time.value());
+        } catch (...) {
+            return;
+        }
+    } else if (this->default_lifetime.count() > 0) {
+        expires_at = now + this->default_lifetime;
+    } else {
+        return;
+    }
+
+    if (expires_at <= now) {
+        return;
+    }
+
+    const auto entry_key = key(provided_token);
+    std::lock_guard<std::mutex> lock(this->mutex);
+    const auto it = this->index.find(entry_key);
+    if (it != this->index.end()) {
+        this->entries.erase(it->second);
+        this->index.erase(it);
+    }
+
+    this->entries.push_front({entry_key, *accepted, expires_at});
+    this->index[entry_key] = this->entries.begin();
+
+    if (this->entries.size() > this->capacity) {
+        this->index.erase(this->entries.back().key);
+        this->entries.pop_back();
+    }
+}
+
+void ValidationCache::clear() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->entries.clear();
+    this->index.clear();
+}
+
+std::size_t ValidationCache::size() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->entries.size();
+}
+
+} // namespace module
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+// Swipes tokens concurrently at many connectors and reports the swipe to authorization latency.
+// Every worker owns a pair of connectors and references both with its token, so connector selection
+// takes the plug in locks. Not part of the test suite, run it manually with stderr redirected to
+// drop the log output:
+//   auth_stress_benchmark [connectors] [rounds] [validation delay in ms] 2>/dev/null
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <utils/date.hpp>
+
+#include <AuthHandler.hpp>
+
+using namespace module;
+
+namespace {
+
+constexpr int CONNECTION_TIMEOUT = 10;
+
+SessionEvent session_event(SessionEventEnum event) {
+    SessionEvent session_event;
+    session_event.event = event;
+    return session_event;
+}
+
+SessionEvent session_started_event() {
+    auto event = session_event(SessionEventEnum::SessionStarted);
+    SessionStarted session_started;
+    session_started.reason = types::evse_manager::StartSessionReason::EVConnected;
+    event.session_started = session_started;
+    return event;
+}
+
+SessionEvent transaction_started_event(const ProvidedIdToken& provided_token) {
+    auto event = session_event(SessionEventEnum::TransactionStarted);
+    TransactionStarted transaction_started;
+    transaction_started.meter_value.energy_Wh_import.total = 0;
+    transaction_started.id_tag = provided_token;
+    event.timestamp = Everest::Date::to_rfc3339(date::utc_clock::now());
+    event.transaction_started = transaction_started;
+    return event;
+}
+
+ProvidedIdToken provided_token(const std::string& id_token, const std::vector<int32_t>& connectors) {
+    ProvidedIdToken provided_token;
+    provided_token.id_token = {id_token, types::authorization::IdTokenType::ISO14443};
+    provided_token.authorization_type = types::authorization::AuthorizationType::RFID;
+    provided_token.connectors.emplace(connectors);
+    return provided_token;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    const auto index = static_cast<std::size_t>(p * (sorted.size() - 1));
+    return sorted.at(index);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int connectors = std::max(2, argc > 1 ? std::atoi(argv[1]) : 40);
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 200;
+    const int validation_delay_ms = argc > 3 ? std::atoi(argv[3]) : 1;
+    const int workers = connectors / 2;
+
+    AuthHandler auth_handler(SelectionAlgorithm::PlugEvents, CONNECTION_TIMEOUT, false, false);
+    for (int connector_id = 1; connector_id <= workers * 2; connector_id++) {
+        auth_handler.init_connector(connector_id, connector_id - 1);
+    }
+
+    std::atomic<int> authorizations{0};
+    auth_handler.register_notify_evse_callback(
+        [&authorizations](const int, const ProvidedIdToken&, const ValidationResult& validation_result) {
+            if (validation_result.authorization_status == AuthorizationStatus::Accepted) {
+                authorizations++;
+            }
+        });
+    auth_handler.register_withdraw_authorization_callback([](const int) {});
+    auth_handler.register_stop_transaction_callback([](const int, const StopTransactionRequest&) {});
+    auth_handler.register_reservation_cancelled_callback([](const int&) {});
+    auth_handler.register_publish_token_validation_status_callback(
+        [](const ProvidedIdToken&, TokenValidationStatus) {});
+    auth_handler.register_validate_token_callback([validation_delay_ms](const ProvidedIdToken&) {
+        // stands in for the round trip to a validator
+        std::this_thread::sleep_for(std::chrono::milliseconds(validation_delay_ms));
+        ValidationResult validation_result;
+        validation_result.authorization_status = AuthorizationStatus::Accepted;
+        return std::vector<ValidationResult>{validation_result};
+    });
+
+    std::vector<std::vector<double>> latencies(workers);
+    std::vector<int> rejected(workers, 0);
+    std::vector<std::thread> threads;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int worker = 0; worker < workers; worker++) {
+        threads.emplace_back([&, worker]() {
+            const int plugged_connector = worker * 2 + 1;
+            const auto token = provided_token("TOKEN_" + std::to_string(worker),
+                                              {plugged_connector, plugged_connector + 1});
+            latencies.at(worker).reserve(rounds);
+            for (int round = 0; round < rounds; round++) {
+                auth_handler.handle_session_event(plugged_connector, session_started_event());
+
+                const auto swiped = std::chrono::steady_clock::now();
+                const auto result = auth_handler.on_token(token);
+                latencies.at(worker).push_back(
+                    std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - swiped).count());
+                if (result != TokenHandlingResult::ACCEPTED) {
+                    rejected.at(worker)++;
+                }
+
+                auth_handler.handle_session_event(plugged_connector, transaction_started_event(token));
+                auth_handler.handle_session_event(plugged_connector,
+                                                  session_event(SessionEventEnum::TransactionFinished));
+                auth_handler.handle_session_event(plugged_connector, session_event(SessionEventEnum::SessionFinished));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for (const auto& worker_latencies : latencies) {
+        all.insert(all.end(), worker_latencies.begin(), worker_latencies.end());
+    }
+    std::sort(all.begin(), all.end());
+    int not_accepted = 0;
+    for (const auto count : rejected) {
+        not_accepted += count;
+    }
+
+    std::cout << workers * 2 << " connectors, " << workers << " workers, " << rounds << " rounds, "
+              << validation_delay_ms << " ms validation delay" << std::endl;
+    std::cout << "swipes: " << all.size() << " (" << static_cast<long>(all.size() / elapsed) << "/s), authorized: "
+              << authorizations << ", not accepted: " << not_accepted << std::endl;
+    std::cout << "latency us: p50 " << percentile(all, 0.5) << ", p90 " << percentile(all, 0.9) << ", p99 "
+              << percentile(all, 0.99) << ", max " << percentile(all, 1.0) << std::endl;
+    return 0;
+}
@@ -1229,4 +1229,79 @@ TEST_F(AuthTest, test_token_timed_out) {
     std::this_thread::sleep_for(std::chrono::seconds(CONNECTION_TIMEOUT + 1));
 }
 
+/// \brief Test if the id_token of a finished session is removed from the identifier index, so that swiping it again
+/// authorizes a new session instead of stopping a transaction
+TEST_F(AuthTest, test_identifier_reset_after_session_finished) {
+    std::vector<int32_t> connectors{1};
+    ProvidedIdToken provided_token = get_provided_token(VALID_TOKEN_2, connectors);
+
+    EXPECT_CALL(mock_publish_token_validation_status_callback,
+                Call(Field(&ProvidedIdToken::id_token, provided_token.id_token), TokenValidationStatus::Processing))
+        .Times(2);
+    EXPECT_CALL(mock_publish_token_validation_status_callback,
+                Call(Field(&ProvidedIdToken::id_token, provided_token.id_token), TokenValidationStatus::Accepted))
+        .Times(2);
+
+    this->auth_handler->handle_session_event(
+        1, get_session_started_event(types::evse_manager::StartSessionReason::EVConnected));
+    auto result = this->auth_handler->on_token(provided_token);
+    ASSERT_TRUE(result == TokenHandlingResult::ACCEPTED);
+    this->auth_handler->handle_session_event(1, get_transaction_started_event(provided_token));
+
+    SessionEvent transaction_finished;
+    transaction_finished.event = SessionEventEnum::TransactionFinished;
+    this->auth_handler->handle_session_event(1, transaction_finished);
+    SessionEvent session_finished;
+    session_finished.event = SessionEventEnum::SessionFinished;
+    this->auth_handler->handle_session_event(1, session_finished);
+    this->auth_receiver->reset();
+
+    this->auth_handler->handle_session_event(
+        1, get_session_started_event(types::evse_manager::StartSessionReason::EVConnected));
+    result = this->auth_handler->on_token(provided_token);
+    ASSERT_TRUE(result == TokenHandlingResult::ACCEPTED);
+    ASSERT_TRUE(this->auth_receiver->get_authorization(0));
+}
+
+/// \brief Test if the parent_id_token of a connector stays indexed when another connector with the same
+/// parent_id_token finishes its transaction
+TEST_F(AuthTest, test_parent_id_index_after_other_connector_finished) {
+    ProvidedIdToken provided_token_1 = get_provided_token(VALID_TOKEN_1, std::vector<int32_t>{1});
+    ProvidedIdToken provided_token_2 = get_provided_token(VALID_TOKEN_3, std::vector<int32_t>{2});
+
+    EXPECT_CALL(mock_publish_token_validation_status_callback,
+                Call(Field(&ProvidedIdToken::id_token, provided_token_1.id_token), TokenValidationStatus::Processing))
+        .Times(2);
+    EXPECT_CALL(mock_publish_token_validation_status_callback,
+                Call(Field(&ProvidedIdToken::id_token, provided_token_1.id_token), TokenValidationStatus::Accepted))
+        .Times(2);
+    EXPECT_CALL(mock_publish_token_validation_status_callback,
+                Call(Field(&ProvidedIdToken::id_token, provided_token_2.id_token), TokenValidationStatus::Processing));
+    EXPECT_CALL(mock_publish_token_validation_status_callback,
+                Call(Field(&ProvidedIdToken::id_token, provided_token_2.id_token), TokenValidationStatus::Accepted));
+
+    const SessionEvent session_event = get_session_started_event(types::evse_manager::StartSessionReason::EVConnected);
+    this->auth_handler->handle_session_event(1, session_event);
+    this->auth_handler->handle_session_event(2, session_event);
+
+    auto result = this->auth_handler->on_token(provided_token_1);
+    ASSERT_TRUE(result == TokenHandlingResult::ACCEPTED);
+    this->auth_handler->handle_session_event(1, get_transaction_started_event(provided_token_1));
+    result = this->auth_handler->on_token(provided_token_2);
+    ASSERT_TRUE(result == TokenHandlingResult::ACCEPTED);
+    this->auth_handler->handle_session_event(2, get_transaction_started_event(provided_token_2));
+    ASSERT_TRUE(this->auth_receiver->get_authorization(0));
+    ASSERT_TRUE(this->auth_receiver->get_authorization(1));
+
+    SessionEvent transaction_finished;
+    transaction_finished.event = SessionEventEnum::TransactionFinished;
+    this->auth_handler->handle_session_event(1, transaction_finished);
+
+    // VALID_TOKEN_1 is no longer used for a transaction, but its parent_id_token still is on connector 2
+    result = this->auth_handler->on_token(get_provided_token(VALID_TOKEN_1, std::vector<int32_t>{1, 2}));
+    ASSERT_TRUE(result == TokenHandlingResult::USED_TO_STOP_TRANSACTION);
+    ASSERT_TRUE(this->auth_receiver->get_authorization(0));
+    ASSERT_FALSE(this->auth_receiver->get_authorization(1));
+}
+
 } // namespace module
@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <utils/date.hpp>
+
+#include <TokenValidatorDispatcher.hpp>
+#include <ValidationCache.hpp>
+
+namespace module {
+
+using namespace std::chrono_literals;
+using types::authorization::AuthorizationStatus;
+using types::authorization::ProvidedIdToken;
+using types::authorization::ValidationResult;
+
+static ProvidedIdToken get_token(const std::string& id_token) {
+    ProvidedIdToken provided_token;
+    provided_token.id_token = {id_token, types::authorization::IdTokenType::ISO14443};
+    provided_token.authorization_type = types::authorization::AuthorizationType::RFID;
+    return provided_token;
+}
+
+static ValidationResult get_result(AuthorizationStatus status, std::optional<std::string> expiry_time = std::nullopt) {
+    ValidationResult validation_result;
+    validation_result.authorization_status = status;
+    validation_result.expiry_time = expiry_time;
+    return validation_result;
+}
+
+static TokenValidatorDispatcher::Validator get_validator(AuthorizationStatus status,
+                                                         std::chrono::milliseconds delay = 0ms) {
+    return [status, delay](const ProvidedIdToken&) {
+        std::this_thread::sleep_for(delay);
+        return get_result(status);
+    };
+}
+
+TEST(ValidationCacheTest, caches_accepted_results_until_expiry) {
+    ValidationCache cache(10, 0s);
+    const auto now = date::utc_clock::now();
+    const auto token = get_token("TOKEN");
+
+    cache.insert(token, {get_result(AuthorizationStatus::Accepted, Everest::Date::to_rfc3339(now + 60s))}, now);
+
+    const auto cached = cache.lookup(token, now + 30s);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached.value().authorization_status, AuthorizationStatus::Accepted);
+
+    EXPECT_FALSE(cache.lookup(token, now + 61s).has_value());
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(ValidationCacheTest, does_not_cache_rejected_results) {
+    ValidationCache cache(10, 60s);
+    const auto token = get_token("TOKEN");
+    cache.insert(token, {get_result(AuthorizationStatus::Invalid), get_result(AuthorizationStatus::Blocked)});
+    EXPECT_FALSE(cache.lookup(token).has_value());
+}
+
+TEST(ValidationCacheTest, caches_first_accepted_result) {
+    ValidationCache cache(10, 60s);
+    const auto token = get_token("TOKEN");
+    auto accepted = get_result(AuthorizationStatus::Accepted);
+    accepted.parent_id_token = {"PARENT", types::authorization::IdTokenType::ISO14443};
+    cache.insert(token,
+                 {get_result(AuthorizationStatus::Invalid), accepted, get_result(AuthorizationStatus::Accepted)});
+
+    const auto cached = cache.lookup(token);
+    ASSERT_TRUE(cached.has_value());
+    ASSERT_TRUE(cached.value().parent_id_token.has_value());
+    EXPECT_EQ(cached.value().parent_id_token.value().value, "PARENT");
+}
+
+TEST(ValidationCacheTest, results_without_expiry_time) {
+    const auto now = date::utc_clock::now();
+    const auto token = get_token("TOKEN");
+
+    ValidationCache no_default_lifetime(10, 0s);
+    no_default_lifetime.insert(token, {get_result(AuthorizationStatus::Accepted)}, now);
+    EXPECT_FALSE(no_default_lifetime.lookup(token, now).has_value());
+
+    ValidationCache default_lifetime(10, 60s);
+    default_lifetime.insert(token, {get_result(AuthorizationStatus::Accepted)}, now);
+    EXPECT_TRUE(default_lifetime.lookup(token, now + 59s).has_value());
+    EXPECT_FALSE(default_lifetime.lookup(token, now + 60s).has_value());
+}
+
+TEST(ValidationCacheTest, evicts_least_recently_used) {
+    ValidationCache cache(2, 60s);
+    const auto token_1 = get_token("TOKEN_1");
+    const auto token_2 = get_token("TOKEN_2");
+    const auto token_3 = get_token("TOKEN_3");
+
+    cache.insert(token_1, {get_result(AuthorizationStatus::Accepted)});
+    cache.insert(token_2, {get_result(AuthorizationStatus::Accepted)});
+    // token_1 becomes the most recently used
+    EXPECT_TRUE(cache.lookup(token_1).has_value());
+    cache.insert(token_3, {get_result(AuthorizationStatus::Accepted)});
+
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_TRUE(cache.lookup(token_1).has_value());
+    EXPECT_FALSE(cache.lookup(token_2).has_value());
+    EXPECT_TRUE(cache.lookup(token_3).has_value());
+}
+
+TEST(ValidationCacheTest, disabled_with_zero_capacity) {
+    ValidationCache cache(0, 60s);
+    const auto token = get_token("TOKEN");
+    cache.insert(token, {get_result(AuthorizationStatus::Accepted)});
+    EXPECT_FALSE(cache.lookup(token).has_value());
+}
+
+TEST(TokenValidatorDispatcherTest, results_in_validator_order) {
+    TokenValidatorDispatcher dispatcher({get_validator(AuthorizationStatus::Invalid, 50ms),
+                                         get_validator(AuthorizationStatus::Accepted)},
+                                        0ms, ValidationPolicy::WaitForAll);
+    const auto results = dispatcher.validate(get_token("TOKEN"));
+    ASSERT_EQ(results.size(), 2);
+    EXPECT_EQ(results.at(0).authorization_status, AuthorizationStatus::Invalid);
+    EXPECT_EQ(results.at(1).authorization_status, AuthorizationStatus::Accepted);
+}
+
+TEST(TokenValidatorDispatcherTest, validators_run_concurrently) {
+    TokenValidatorDispatcher dispatcher({get_validator(AuthorizationStatus::Invalid, 200ms),
+                                         get_validator(AuthorizationStatus::Invalid, 200ms),
+                                         get_validator(AuthorizationStatus::Invalid, 200ms)},
+                                        0ms, ValidationPolicy::WaitForAll);
+    const auto start = std::chrono::steady_clock::now();
+    const auto results = dispatcher.validate(get_token("TOKEN"));
+    EXPECT_EQ(results.size(), 3);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+}
+
+TEST(TokenValidatorDispatcherTest, deadline_ignores_slow_validators) {
+    TokenValidatorDispatcher dispatcher({get_validator(AuthorizationStatus::Accepted, 2s),
+                                         get_validator(AuthorizationStatus::Invalid)},
+                                        100ms, ValidationPolicy::WaitForAll);
+    const auto start = std::chrono::steady_clock::now();
+    const auto results = dispatcher.validate(get_token("TOKEN"));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results.at(0).authorization_status, AuthorizationStatus::Invalid);
+}
+
+TEST(TokenValidatorDispatcherTest, first_accepted_short_circuits) {
+    TokenValidatorDispatcher dispatcher({get_validator(AuthorizationStatus::Invalid, 2s),
+                                         get_validator(AuthorizationStatus::Accepted)},
+                                        0ms, ValidationPolicy::FirstAccepted);
+    const auto start = std::chrono::steady_clock::now();
+    const auto results = dispatcher.validate(get_token("TOKEN"));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results.at(0).authorization_status, AuthorizationStatus::Accepted);
+}
+
+TEST(TokenValidatorDispatcherTest, failing_validator_is_ignored) {
+    TokenValidatorDispatcher dispatcher(
+        {[](const ProvidedIdToken&) -> ValidationResult { throw std::runtime_error("validator timeout"); },
+         get_validator(AuthorizationStatus::Accepted)},
+        0ms, ValidationPolicy::WaitForAll);
+    const auto results = dispatcher.validate(get_token("TOKEN"));
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results.at(0).authorization_status, AuthorizationStatus::Accepted);
+}
+
+TEST(TokenValidatorDispatcherTest, string_to_validation_policy) {
+    EXPECT_EQ(conversions::string_to_validation_policy("WaitForAll"), ValidationPolicy::WaitForAll);
+    EXPECT_EQ(conversions::string_to_validation_policy("FirstAccepted"), ValidationPolicy::FirstAccepted);
+    EXPECT_THROW(conversions::string_to_validation_policy("Unknown"), std::out_of_range);
+}
+
+} // namespace module
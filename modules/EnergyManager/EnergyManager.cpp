@@ -15,9 +15,10 @@ void EnergyManager::init() {
     r_energy_trunk->subscribe_energy_flow_request([this](types::energy::EnergyFlowRequest e) {
         // Received new energy object from a child.
         std::scoped_lock lock(energy_mutex);
-        energy_flow_request = e;
+        const bool priority = is_priority_request(e);
+        energy_flow_request = std::move(e);
 
-        if (is_priority_request(e)) {
+        if (priority) {
             // trigger optimization now
             mainloop_sleep_condvar.notify_all();
         }
@@ -44,8 +45,19 @@ void EnergyManager::ready() {
     }).detach();
 }
 
-// Check if any node set the priority request flag
+// Check if any changed node set the priority request flag
 bool EnergyManager::is_priority_request(const types::energy::EnergyFlowRequest& e) {
+    // subtrees with an unchanged revision have been checked with an earlier update already
+    if (e.revision.has_value()) {
+        auto [it, inserted] = node_revisions.try_emplace(e.uuid, e.revision.value());
+        if (not inserted) {
+            if (it->second == e.revision.value()) {
+                return false;
+            }
+            it->second = e.revision.value();
+        }
+    }
+
     bool prio = e.priority_request.has_value() and e.priority_request.value();
 
     // If this node has priority, no need to travese the tree any longer
@@ -24,6 +24,7 @@
 #include <utils/date.hpp>
 
 #include <mutex>
+#include <unordered_map>
 
 #include "Broker.hpp"
 
@@ -86,6 +87,8 @@ private:
 
     // complete energy tree requests
     types::energy::EnergyFlowRequest energy_flow_request;
+    // last seen revision of every node that publishes one
+    std::unordered_map<std::string, int> node_revisions;
 
     void enforce_limits(const std::vector<types::energy::EnforcedLimits>& limits);
     std::vector<types::energy::EnforcedLimits> run_optimizer(types::energy::EnergyFlowRequest request);
@@ -98,6 +101,7 @@ private:
 #ifdef BUILD_TESTING_MODULE_ENERGY_MANAGER
     FRIEND_TEST(EnergyManagerTest, empty);
     FRIEND_TEST(EnergyManagerTest, noSchedules);
+    FRIEND_TEST(EnergyManagerTest, priorityRequestRevisions);
     FRIEND_TEST(EnergyManagerTest, schedules);
     friend void test::schedule_test(const types::energy::EnergyFlowRequest& energy_flow_request,
                                     const std::string& start_time_str, float expected_limit);
@@ -740,6 +740,62 @@ TEST(EnergyManagerTest, empty) {
     EXPECT_EQ(optimized_values.size(), 0);
 }
 
+TEST(EnergyManagerTest, priorityRequestRevisions) {
+    struct module::Conf config {
+        230.0,     // nominal_ac_voltage
+            1,     // update_interval
+            60,    // schedule_interval_duration
+            1,     // schedule_total_duration
+            0.5,   // slice_ampere
+            500,   // slice_watt
+            false, // debug
+    };
+    std::unique_ptr<energyIntf> energy;
+    auto energy_managerImpl = std::make_unique<module::stub::energy_managerImplStub>();
+
+    module::EnergyManager manager(c_module_info, std::move(energy_managerImpl), std::move(energy), config);
+
+    types::energy::EnergyFlowRequest evse;
+    evse.uuid = "evse";
+    evse.node_type = types::energy::NodeType::Evse;
+    evse.priority_request = true;
+
+    types::energy::EnergyFlowRequest node;
+    node.uuid = "node";
+    node.node_type = types::energy::NodeType::Generic;
+    node.revision = 1;
+    node.children.push_back(evse);
+
+    types::energy::EnergyFlowRequest root;
+    root.uuid = "root";
+    root.node_type = types::energy::NodeType::Generic;
+    root.revision = 1;
+    root.children.push_back(node);
+
+    EXPECT_TRUE(manager.is_priority_request(root));
+    // nothing changed, the priority request has been handled already
+    EXPECT_FALSE(manager.is_priority_request(root));
+
+    // another child of the root changed, the subtree with the priority request did not
+    types::energy::EnergyFlowRequest other;
+    other.uuid = "other";
+    other.node_type = types::energy::NodeType::Generic;
+    other.revision = 1;
+    root.children.push_back(other);
+    root.revision = 2;
+    EXPECT_FALSE(manager.is_priority_request(root));
+
+    // the subtree with the priority request changed
+    node.revision = 2;
+    root.children.front() = node;
+    root.revision = 3;
+    EXPECT_TRUE(manager.is_priority_request(root));
+
+    // nodes without revision are always checked
+    EXPECT_TRUE(manager.is_priority_request(evse));
+    EXPECT_TRUE(manager.is_priority_request(evse));
+}
+
 TEST(EnergyManagerTest, noSchedules) {
     struct module::Conf config {
         230.0,     // nominal_ac_voltage
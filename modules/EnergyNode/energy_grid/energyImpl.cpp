@@ -2,7 +2,10 @@
 // Copyright 2022 - 2022 Pionix GmbH and Contributors to EVerest
 
 #include "energyImpl.hpp"
+#include "../schedule_price_merge.hpp"
 #include <chrono>
+#include <thread>
+
 #include <date/date.h>
 #include <date/tz.h>
 #include <utils/date.hpp>
@@ -10,6 +13,18 @@
 namespace module {
 namespace energy_grid {
 
+static bool has_priority_request(const types::energy::EnergyFlowRequest& e) {
+    if (e.priority_request.value_or(false)) {
+        return true;
+    }
+    for (const auto& child : e.children) {
+        if (has_priority_request(child)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void energyImpl::init() {
 
     // UUID must be unique also beyond this charging station -> will be handled on framework level and above later
@@ -25,20 +40,9 @@ void energyImpl::init() {
         entry->subscribe_energy_flow_request([this](types::energy::EnergyFlowRequest e) {
             // Received new energy_flow_request object from a child. Update in the cached object and republish.
             std::scoped_lock lock(energy_mutex);
-
-            bool child_found = false;
-            for (auto& child : energy_flow_request.children) {
-                if (child.uuid == e.uuid) {
-                    child = e;
-                    child_found = true;
-                }
-            }
-
-            if (!child_found) {
-                energy_flow_request.children.push_back(e);
-            }
-
-            publish_complete_energy_object();
+            const bool priority = has_priority_request(e);
+            update_child(std::move(e));
+            changed(priority);
         });
     }
 
@@ -47,7 +51,7 @@ void energyImpl::init() {
             EVLOG_debug << "Incoming powermeter readings: " << p;
             std::scoped_lock lock(energy_mutex);
             energy_flow_request.energy_usage_root = p;
-            publish_complete_energy_object();
+            changed(false);
         });
     }
 
@@ -57,11 +61,47 @@ void energyImpl::init() {
                 EVLOG_debug << "Incoming price schedule: " << p;
                 std::scoped_lock lock(energy_mutex);
                 energy_pricing = p;
-                publish_complete_energy_object();
+                changed(false);
             });
     }
 }
 
+void energyImpl::update_child(types::energy::EnergyFlowRequest&& child) {
+    const auto index = child_index.find(child.uuid);
+    if (index != child_index.end()) {
+        energy_flow_request.children[index->second] = std::move(child);
+    } else {
+        child_index.emplace(child.uuid, energy_flow_request.children.size());
+        energy_flow_request.children.push_back(std::move(child));
+    }
+}
+
+void energyImpl::changed(bool priority) {
+    revision++;
+    if (priority || mod->config.publish_interval_ms <= 0) {
+        publish_complete_energy_object();
+    } else if (!publish_pending) {
+        publish_pending = true;
+        publish_cv.notify_one();
+    }
+}
+
+void energyImpl::publish_loop() {
+    const auto interval = std::chrono::milliseconds(mod->config.publish_interval_ms);
+    std::unique_lock<std::mutex> lock(energy_mutex);
+    while (true) {
+        publish_cv.wait(lock, [this] { return publish_pending; });
+        // collect all changes arriving within the interval into a single publish
+        lock.unlock();
+        std::this_thread::sleep_for(interval);
+        lock.lock();
+        // a priority request may have published in the meantime
+        if (publish_pending) {
+            publish_complete_energy_object();
+        }
+    }
+}
+
 types::energy::ScheduleReqEntry energyImpl::get_local_schedule() {
     // local schedule of this module
     types::energy::ScheduleReqEntry local_schedule;
@@ -121,72 +161,56 @@ void energyImpl::set_external_limits(types::energy::ExternalLimits& l) {
             energy_flow_request.schedule_export.emplace(std::vector<types::energy::ScheduleReqEntry>({local_schedule}));
         }
     }
+
+    changed(false);
 }
 
 void energyImpl::publish_complete_energy_object() {
-    // join the different schedules to the complete array (with resampling)
-    types::energy::EnergyFlowRequest energy_complete = energy_flow_request;
+    publish_pending = false;
+    energy_flow_request.revision = revision;
 
-    if (energy_flow_request.schedule_import.has_value() && energy_pricing.schedule_import.has_value()) {
-        merge_price_into_schedule(energy_complete.schedule_import.value(), energy_pricing.schedule_import.value());
-    }
+    const bool merge_import =
+        energy_flow_request.schedule_import.has_value() && energy_pricing.schedule_import.has_value();
+    const bool merge_export =
+        energy_flow_request.schedule_export.has_value() && energy_pricing.schedule_export.has_value();
 
-    if (energy_flow_request.schedule_export.has_value() && energy_pricing.schedule_export.has_value()) {
-        merge_price_into_schedule(energy_complete.schedule_export.value(), energy_pricing.schedule_export.value());
+    if (!merge_import && !merge_export) {
+        publish_energy_flow_request(energy_flow_request);
+        return;
     }
 
-    publish_energy_flow_request(energy_complete);
-}
+    // join the different schedules to the complete array (with resampling). Only the own schedules are
+    // modified, so they are merged in place and restored afterwards instead of copying the whole subtree.
+    auto own_schedule_import = energy_flow_request.schedule_import;
+    auto own_schedule_export = energy_flow_request.schedule_export;
 
-void energyImpl::merge_price_into_schedule(std::vector<types::energy::ScheduleReqEntry>& schedule,
-                                           const std::vector<types::energy_price_information::PricePerkWh>& price) {
-    auto it_schedule = schedule.begin();
-    auto it_price = price.begin();
-
-    std::vector<types::energy::ScheduleReqEntry> joined_schedule;
-
-    // The first element is already valid now even if the timestamp is in the future (per agreement)
-    auto next_entry_schedule = *it_schedule;
-    auto next_entry_price = *it_price;
-    auto currently_valid_entry_schedule = next_entry_schedule;
-    auto currently_valid_entry_price = next_entry_price;
-
-    while (it_schedule != schedule.end() && it_price != price.end()) {
-        auto tp_schedule = Everest::Date::from_rfc3339(next_entry_schedule.timestamp);
-        auto tp_price = Everest::Date::from_rfc3339(next_entry_price.timestamp);
+    if (merge_import) {
+        energy_flow_request.schedule_import = merge_price_into_schedule(
+            std::move(energy_flow_request.schedule_import.value()), energy_pricing.schedule_import.value());
+    }
 
-        if ((tp_schedule < tp_price && it_schedule != schedule.end()) || it_price == price.end()) {
-            currently_valid_entry_schedule = next_entry_schedule;
-            auto joined_entry = currently_valid_entry_schedule;
+    if (merge_export) {
+        energy_flow_request.schedule_export = merge_price_into_schedule(
+            std::move(energy_flow_request.schedule_export.value()), energy_pricing.schedule_export.value());
+    }
 
-            joined_entry.price_per_kwh = currently_valid_entry_price;
-            joined_schedule.push_back(joined_entry);
-            it_schedule++;
-            if (it_schedule != schedule.end()) {
-                next_entry_schedule = *it_schedule;
-            }
-            continue;
-        }
+    publish_energy_flow_request(energy_flow_request);
 
-        if ((tp_price < tp_schedule && it_price != price.end()) || it_schedule == schedule.end()) {
-            currently_valid_entry_price = next_entry_price;
-            auto joined_entry = currently_valid_entry_schedule;
-            joined_entry.price_per_kwh = currently_valid_entry_price;
-            joined_entry.timestamp = currently_valid_entry_price.timestamp;
-            joined_schedule.push_back(joined_entry);
-            it_price++;
-            if (it_price != price.end()) {
-                next_entry_price = *it_price;
-            }
-            continue;
-        }
-    }
+    energy_flow_request.schedule_import = std::move(own_schedule_import);
+    energy_flow_request.schedule_export = std::move(own_schedule_export);
 }
 
 void energyImpl::ready() {
-    // publish own limits at least once
-    publish_energy_flow_request(energy_flow_request);
+    {
+        // publish own limits at least once
+        std::scoped_lock lock(energy_mutex);
+        publish_complete_energy_object();
+    }
     mod->signalExternalLimit.connect([this](types::energy::ExternalLimits& l) { set_external_limits(l); });
+
+    if (mod->config.publish_interval_ms > 0) {
+        std::thread([this] { publish_loop(); }).detach();
+    }
 }
 
 void energyImpl::handle_enforce_limits(types::energy::EnforcedLimits& value) {
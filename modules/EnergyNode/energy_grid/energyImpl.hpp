@@ -14,7 +14,9 @@
 
 // ev@75ac1216-19eb-4182-a85c-820f1fc2c091:v1
 // insert your custom include headers here
+#include <condition_variable>
 #include <mutex>
+#include <unordered_map>
 // ev@75ac1216-19eb-4182-a85c-820f1fc2c091:v1
 
 namespace module {
@@ -51,15 +53,23 @@ private:
     std::mutex energy_mutex;
     // subtree including children
     types::energy::EnergyFlowRequest energy_flow_request;
+    // position of every child in energy_flow_request.children by uuid
+    std::unordered_map<std::string, std::size_t> child_index;
+    // incremented whenever this node or its subtree changes
+    int revision{0};
+    // true if a change has not been published yet
+    bool publish_pending{false};
+    std::condition_variable publish_cv;
 
     // contains only the pricing informations last update
     types::energy_price_information::EnergyPriceSchedule energy_pricing;
 
     types::energy::ScheduleReqEntry get_local_schedule();
     void publish_complete_energy_object();
+    void changed(bool priority);
+    void publish_loop();
+    void update_child(types::energy::EnergyFlowRequest&& child);
     void set_external_limits(types::energy::ExternalLimits& l);
-    void merge_price_into_schedule(std::vector<types::energy::ScheduleReqEntry>& schedule,
-                                   const std::vector<types::energy_price_information::PricePerkWh>& price);
     // ev@3370e4dd-95f4-47a9-aaec-ea76f34a66c9:v1
 };
 
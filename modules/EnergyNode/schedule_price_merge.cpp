@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "schedule_price_merge.hpp"
+
+#include <chrono>
+#include <optional>
+
+#include <date/date.h>
+#include <date/tz.h>
+#include <utils/date.hpp>
+
+namespace module {
+
+namespace {
+using TimePoint = std::chrono::time_point<date::utc_clock>;
+
+template <typename Entry> std::vector<TimePoint> parse_time_axis(const std::vector<Entry>& entries) {
+    std::vector<TimePoint> time_axis;
+    time_axis.reserve(entries.size());
+    for (const auto& entry : entries) {
+        time_axis.push_back(Everest::Date::from_rfc3339(entry.timestamp));
+    }
+    return time_axis;
+}
+} // namespace
+
+std::vector<types::energy::ScheduleReqEntry>
+merge_price_into_schedule(std::vector<types::energy::ScheduleReqEntry>&& schedule,
+                          const std::vector<types::energy_price_information::PricePerkWh>& price) {
+    if (schedule.empty() || price.empty()) {
+        return std::move(schedule);
+    }
+
+    const auto schedule_times = parse_time_axis(schedule);
+    const auto price_times = parse_time_axis(price);
+
+    std::vector<types::energy::ScheduleReqEntry> joined_schedule;
+    joined_schedule.reserve(schedule.size() + price.size());
+
+    std::size_t s = 0;
+    std::size_t p = 0;
+    // the first entries are valid already now even if their timestamp is in the future (per agreement)
+    std::size_t valid_price = 0;
+    // index of the schedule entry valid at the current point in joined_schedule, none before the first one
+    std::optional<std::size_t> valid_schedule;
+
+    while (s < schedule.size() || p < price.size()) {
+        const bool take_schedule = s < schedule.size() && (p == price.size() || schedule_times[s] <= price_times[p]);
+        const bool take_price = p < price.size() && (s == schedule.size() || price_times[p] <= schedule_times[s]);
+
+        if (take_price) {
+            valid_price = p++;
+        }
+
+        if (take_schedule) {
+            // a new schedule entry, possibly at the same time as a price change
+            auto& joined_entry = joined_schedule.emplace_back(std::move(schedule[s++]));
+            joined_entry.price_per_kwh = price[valid_price];
+            valid_schedule = joined_schedule.size() - 1;
+        } else {
+            // price change only, repeat the schedule entry valid at that time
+            auto joined_entry = valid_schedule.has_value() ? joined_schedule[valid_schedule.value()] : schedule.front();
+            joined_entry.timestamp = price[valid_price].timestamp;
+            joined_entry.price_per_kwh = price[valid_price];
+            joined_schedule.push_back(std::move(joined_entry));
+        }
+    }
+
+    return joined_schedule;
+}
+
+} // namespace module
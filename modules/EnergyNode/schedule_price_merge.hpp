@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef ENERGY_NODE_SCHEDULE_PRICE_MERGE_HPP
+#define ENERGY_NODE_SCHEDULE_PRICE_MERGE_HPP
+
+#include <vector>
+
+#include <generated/types/energy.hpp>
+#include <generated/types/energy_price_information.hpp>
+
+namespace module {
+
+///
+/// \brief join a schedule and a price time series into one schedule
+///
+/// Every schedule entry gets the price that is valid at its timestamp. Every price change adds an entry
+/// with the schedule entry valid at that time. Entries with equal timestamps are joined into one.
+/// As everywhere in the energy tree, the first entry of both series is valid from now on, even if its
+/// timestamp is in the future. Both series need to be ordered by timestamp.
+///
+/// All timestamps are parsed once up front and schedule entries are moved into the result,
+/// so the merge is linear in the length of both series.
+/// \return the joined schedule, or the unchanged schedule if one of the series is empty
+///
+std::vector<types::energy::ScheduleReqEntry>
+merge_price_into_schedule(std::vector<types::energy::ScheduleReqEntry>&& schedule,
+                          const std::vector<types::energy_price_information::PricePerkWh>& price);
+
+} // namespace module
+
+#endif // ENERGY_NODE_SCHEDULE_PRICE_MERGE_HPP
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+// Merges a day of quarter hour prices into a schedule that is shifted against the price series.
+// Not part of the test suite, run it manually.
+
+#include "schedule_price_merge.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+constexpr int ENTRIES = 96;
+
+std::string quarter_hour_timestamp(int quarter, int offset_min) {
+    const int minutes = quarter * 15 + offset_min;
+    char timestamp[32];
+    std::snprintf(timestamp, sizeof(timestamp), "2024-01-01T%02d:%02d:00.000Z", minutes / 60, minutes % 60);
+    return timestamp;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 10000;
+
+    std::vector<types::energy::ScheduleReqEntry> schedule(ENTRIES);
+    std::vector<types::energy_price_information::PricePerkWh> price(ENTRIES);
+    for (int i = 0; i < ENTRIES; i++) {
+        schedule[i].timestamp = quarter_hour_timestamp(i, 5);
+        schedule[i].limits_to_root.ac_max_current_A = 16;
+        price[i].timestamp = quarter_hour_timestamp(i, 0);
+        price[i].value = 0.25;
+        price[i].currency = "EUR";
+    }
+
+    std::size_t entries = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        auto copy = schedule;
+        entries += module::merge_price_into_schedule(std::move(copy), price).size();
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << ENTRIES << " schedule entries x " << ENTRIES << " prices: " << static_cast<long>(iterations / elapsed)
+              << " merges/s (" << entries / iterations << " entries each)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <gtest/gtest.h>
+
+#include "schedule_price_merge.hpp"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+using module::merge_price_into_schedule;
+using types::energy::ScheduleReqEntry;
+using types::energy_price_information::PricePerkWh;
+
+ScheduleReqEntry schedule_entry(const std::string& timestamp, float max_current_A) {
+    ScheduleReqEntry entry;
+    entry.timestamp = timestamp;
+    entry.limits_to_root.ac_max_current_A = max_current_A;
+    return entry;
+}
+
+PricePerkWh price_entry(const std::string& timestamp, float value) {
+    PricePerkWh entry;
+    entry.timestamp = timestamp;
+    entry.value = value;
+    entry.currency = "EUR";
+    return entry;
+}
+
+void expect_entry(const ScheduleReqEntry& entry, const std::string& timestamp, float max_current_A, float price) {
+    EXPECT_EQ(entry.timestamp, timestamp);
+    EXPECT_EQ(entry.limits_to_root.ac_max_current_A.value(), max_current_A);
+    ASSERT_TRUE(entry.price_per_kwh.has_value());
+    EXPECT_EQ(entry.price_per_kwh.value().value, price);
+}
+
+TEST(ScheduleMergePrice, empty_price_keeps_schedule) {
+    std::vector<ScheduleReqEntry> schedule{schedule_entry("2024-01-01T00:00:00.000Z", 16)};
+    const auto joined = merge_price_into_schedule(std::move(schedule), {});
+    ASSERT_EQ(joined.size(), 1);
+    EXPECT_FALSE(joined[0].price_per_kwh.has_value());
+}
+
+TEST(ScheduleMergePrice, empty_schedule_stays_empty) {
+    const auto joined = merge_price_into_schedule({}, {price_entry("2024-01-01T00:00:00.000Z", 0.3)});
+    EXPECT_TRUE(joined.empty());
+}
+
+TEST(ScheduleMergePrice, aligned_series) {
+    std::vector<ScheduleReqEntry> schedule{schedule_entry("2024-01-01T00:00:00.000Z", 16),
+                                           schedule_entry("2024-01-01T01:00:00.000Z", 32)};
+    const std::vector<PricePerkWh> price{price_entry("2024-01-01T00:00:00.000Z", 0.3),
+                                         price_entry("2024-01-01T01:00:00.000Z", 0.2)};
+
+    const auto joined = merge_price_into_schedule(std::move(schedule), price);
+    ASSERT_EQ(joined.size(), 2);
+    expect_entry(joined[0], "2024-01-01T00:00:00.000Z", 16, 0.3);
+    expect_entry(joined[1], "2024-01-01T01:00:00.000Z", 32, 0.2);
+}
+
+TEST(ScheduleMergePrice, misaligned_series) {
+    std::vector<ScheduleReqEntry> schedule{schedule_entry("2024-01-01T00:00:00.000Z", 16),
+                                           schedule_entry("2024-01-01T00:40:00.000Z", 32),
+                                           schedule_entry("2024-01-01T02:00:00.000Z", 10)};
+    const std::vector<PricePerkWh> price{price_entry("2024-01-01T00:15:00.000Z", 0.3),
+                                         price_entry("2024-01-01T00:30:00.000Z", 0.2),
+                                         price_entry("2024-01-01T01:00:00.000Z", 0.1)};
+
+    const auto joined = merge_price_into_schedule(std::move(schedule), price);
+    ASSERT_EQ(joined.size(), 6);
+    // the first price is valid from now on, even before its timestamp
+    expect_entry(joined[0], "2024-01-01T00:00:00.000Z", 16, 0.3);
+    expect_entry(joined[1], "2024-01-01T00:15:00.000Z", 16, 0.3);
+    expect_entry(joined[2], "2024-01-01T00:30:00.000Z", 16, 0.2);
+    expect_entry(joined[3], "2024-01-01T00:40:00.000Z", 32, 0.2);
+    expect_entry(joined[4], "2024-01-01T01:00:00.000Z", 32, 0.1);
+    expect_entry(joined[5], "2024-01-01T02:00:00.000Z", 10, 0.1);
+}
+
+TEST(ScheduleMergePrice, prices_before_first_schedule_entry) {
+    std::vector<ScheduleReqEntry> schedule{schedule_entry("2024-01-01T01:00:00.000Z", 16)};
+    const std::vector<PricePerkWh> price{price_entry("2024-01-01T00:00:00.000Z", 0.3),
+                                         price_entry("2024-01-01T00:30:00.000Z", 0.2)};
+
+    const auto joined = merge_price_into_schedule(std::move(schedule), price);
+    ASSERT_EQ(joined.size(), 3);
+    // the first schedule entry is valid from now on, even before its timestamp
+    expect_entry(joined[0], "2024-01-01T00:00:00.000Z", 16, 0.3);
+    expect_entry(joined[1], "2024-01-01T00:30:00.000Z", 16, 0.2);
+    expect_entry(joined[2], "2024-01-01T01:00:00.000Z", 16, 0.2);
+}
+
+TEST(ScheduleMergePrice, prices_after_last_schedule_entry) {
+    std::vector<ScheduleReqEntry> schedule{schedule_entry("2024-01-01T00:00:00.000Z", 16)};
+    const std::vector<PricePerkWh> price{price_entry("2024-01-01T00:00:00.000Z", 0.3),
+                                         price_entry("2024-01-01T00:15:00.000Z", 0.2),
+                                         price_entry("2024-01-01T00:30:00.000Z", 0.1)};
+
+    const auto joined = merge_price_into_schedule(std::move(schedule), price);
+    ASSERT_EQ(joined.size(), 3);
+    expect_entry(joined[0], "2024-01-01T00:00:00.000Z", 16, 0.3);
+    expect_entry(joined[1], "2024-01-01T00:15:00.000Z", 16, 0.2);
+    expect_entry(joined[2], "2024-01-01T00:30:00.000Z", 16, 0.1);
+}
+
+TEST(ScheduleMergePrice, day_ahead_prices) {
+    // 96 quarter hour prices against an hourly schedule
+    std::vector<ScheduleReqEntry> schedule;
+    std::vector<PricePerkWh> price;
+    for (int hour = 0; hour < 24; hour++) {
+        char timestamp[32];
+        std::snprintf(timestamp, sizeof(timestamp), "2024-01-01T%02d:00:00.000Z", hour);
+        schedule.push_back(schedule_entry(timestamp, static_cast<float>(hour)));
+        for (int quarter = 0; quarter < 4; quarter++) {
+            std::snprintf(timestamp, sizeof(timestamp), "2024-01-01T%02d:%02d:00.000Z", hour, quarter * 15);
+            price.push_back(price_entry(timestamp, static_cast<float>(hour * 4 + quarter)));
+        }
+    }
+
+    const auto joined = merge_price_into_schedule(std::move(schedule), price);
+    ASSERT_EQ(joined.size(), 96);
+    for (std::size_t i = 0; i < joined.size(); i++) {
+        expect_entry(joined[i], price[i].timestamp, static_cast<float>(i / 4), static_cast<float>(i));
+    }
+}
+
+} // namespace
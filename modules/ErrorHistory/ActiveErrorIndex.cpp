@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "ActiveErrorIndex.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace module {
+
+std::string ActiveErrorIndex::origin_key(const ImplementationIdentifier& origin) {
+    return origin.module_id + "/" + origin.implementation_id;
+}
+
+std::size_t ActiveErrorIndex::severity_index(Everest::error::Severity severity) {
+    switch (severity) {
+    case Everest::error::Severity::Low:
+        return 0;
+    case Everest::error::Severity::Medium:
+        return 1;
+    case Everest::error::Severity::High:
+        return 2;
+    }
+    throw std::out_of_range("No known index for Everest::error::Severity");
+}
+
+void ActiveErrorIndex::add(Everest::error::ErrorPtr error) {
+    std::lock_guard<std::mutex> lock(this->index_mutex);
+    const std::string uuid = error->uuid.to_string();
+    auto it = this->errors_by_uuid.find(uuid);
+    if (it != this->errors_by_uuid.end()) {
+        this->remove_from_indexes(it->second);
+        it->second = error;
+    } else {
+        this->errors_by_uuid.emplace(uuid, error);
+    }
+    this->uuids_by_origin[origin_key(error->origin)].insert(uuid);
+    this->uuids_by_type[error->type].insert(uuid);
+    this->uuids_by_severity.at(severity_index(error->severity)).insert(uuid);
+}
+
+Everest::error::ErrorPtr ActiveErrorIndex::remove(const Everest::error::ErrorHandle& handle) {
+    std::lock_guard<std::mutex> lock(this->index_mutex);
+    auto it = this->errors_by_uuid.find(handle.to_string());
+    if (it == this->errors_by_uuid.end()) {
+        return nullptr;
+    }
+    Everest::error::ErrorPtr error = it->second;
+    this->remove_from_indexes(error);
+    this->errors_by_uuid.erase(it);
+    return error;
+}
+
+void ActiveErrorIndex::remove_from_indexes(const Everest::error::ErrorPtr& error) {
+    const std::string uuid = error->uuid.to_string();
+    auto erase_from = [&uuid](std::unordered_map<std::string, UuidSet>& index, const std::string& key) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            it->second.erase(uuid);
+            if (it->second.empty()) {
+                index.erase(it);
+            }
+        }
+    };
+    erase_from(this->uuids_by_origin, origin_key(error->origin));
+    erase_from(this->uuids_by_type, error->type);
+    this->uuids_by_severity.at(severity_index(error->severity)).erase(uuid);
+}
+
+bool ActiveErrorIndex::covers(const std::list<Everest::error::ErrorFilter>& filters) {
+    return std::any_of(filters.begin(), filters.end(), [](const Everest::error::ErrorFilter& filter) {
+        return filter.get_filter_type() == Everest::error::FilterType::State &&
+               filter.get_state_filter() == Everest::error::StateFilter::Active;
+    });
+}
+
+bool ActiveErrorIndex::matches(const Everest::error::Error& error, const Everest::error::ErrorFilter& filter) {
+    switch (filter.get_filter_type()) {
+    case Everest::error::FilterType::State:
+        return error.state == filter.get_state_filter();
+    case Everest::error::FilterType::Origin:
+        return error.origin.module_id == filter.get_origin_filter().module_id &&
+               error.origin.implementation_id == filter.get_origin_filter().implementation_id;
+    case Everest::error::FilterType::Type:
+        return error.type == filter.get_type_filter().value;
+    case Everest::error::FilterType::Severity:
+        switch (filter.get_severity_filter()) {
+        case Everest::error::SeverityFilter::LOW_GE:
+            return true;
+        case Everest::error::SeverityFilter::MEDIUM_GE:
+            return error.severity != Everest::error::Severity::Low;
+        case Everest::error::SeverityFilter::HIGH_GE:
+            return error.severity == Everest::error::Severity::High;
+        }
+        return false;
+    case Everest::error::FilterType::TimePeriod:
+        return error.timestamp >= filter.get_time_period_filter().from &&
+               error.timestamp <= filter.get_time_period_filter().to;
+    case Everest::error::FilterType::Handle:
+        return error.uuid.to_string() == filter.get_handle_filter().to_string();
+    case Everest::error::FilterType::SubType:
+        return error.sub_type == filter.get_sub_type_filter().value;
+    case Everest::error::FilterType::VendorId:
+        return error.vendor_id == filter.get_vendor_id_filter().value;
+    }
+    return false;
+}
+
+// Returns the smallest set of uuids any of the indexed filters restricts the result to,
+// or nullptr if no indexed filter is given and all errors have to be checked.
+const ActiveErrorIndex::UuidSet* ActiveErrorIndex::candidates(const std::list<Everest::error::ErrorFilter>& filters,
+                                                              UuidSet& storage) const {
+    static const UuidSet empty;
+    const UuidSet* best = nullptr;
+    auto consider = [&best](const UuidSet* set) {
+        if (best == nullptr || set->size() < best->size()) {
+            best = set;
+        }
+    };
+    auto lookup = [&consider](const std::unordered_map<std::string, UuidSet>& index, const std::string& key) {
+        auto it = index.find(key);
+        consider(it != index.end() ? &it->second : &empty);
+    };
+    for (const auto& filter : filters) {
+        switch (filter.get_filter_type()) {
+        case Everest::error::FilterType::Handle: {
+            const std::string uuid = filter.get_handle_filter().to_string();
+            storage.clear();
+            if (this->errors_by_uuid.count(uuid) != 0) {
+                storage.insert(uuid);
+            }
+            // a handle matches at most one error, nothing can be more selective
+            return &storage;
+        }
+        case Everest::error::FilterType::Origin:
+            lookup(this->uuids_by_origin, origin_key(filter.get_origin_filter()));
+            break;
+        case Everest::error::FilterType::Type:
+            lookup(this->uuids_by_type, filter.get_type_filter().value);
+            break;
+        case Everest::error::FilterType::Severity:
+            // only an exact severity maps to a single set; the other severity filters are checked per error
+            if (filter.get_severity_filter() == Everest::error::SeverityFilter::HIGH_GE) {
+                consider(&this->uuids_by_severity.at(severity_index(Everest::error::Severity::High)));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return best;
+}
+
+std::list<Everest::error::ErrorPtr>
+ActiveErrorIndex::get_errors(const std::list<Everest::error::ErrorFilter>& filters) const {
+    std::list<Everest::error::ErrorPtr> result;
+    {
+        std::lock_guard<std::mutex> lock(this->index_mutex);
+        auto matches_all = [&filters](const Everest::error::ErrorPtr& error) {
+            return std::all_of(filters.begin(), filters.end(), [&error](const Everest::error::ErrorFilter& filter) {
+                return ActiveErrorIndex::matches(*error, filter);
+            });
+        };
+        UuidSet storage;
+        const UuidSet* uuids = this->candidates(filters, storage);
+        if (uuids == nullptr) {
+            for (const auto& [uuid, error] : this->errors_by_uuid) {
+                if (matches_all(error)) {
+                    result.push_back(error);
+                }
+            }
+        } else {
+            for (const auto& uuid : *uuids) {
+                const Everest::error::ErrorPtr& error = this->errors_by_uuid.at(uuid);
+                if (matches_all(error)) {
+                    result.push_back(error);
+                }
+            }
+        }
+    }
+    result.sort([](const Everest::error::ErrorPtr& a, const Everest::error::ErrorPtr& b) {
+        return a->timestamp < b->timestamp;
+    });
+    return result;
+}
+
+std::size_t ActiveErrorIndex::size() const {
+    std::lock_guard<std::mutex> lock(this->index_mutex);
+    return this->errors_by_uuid.size();
+}
+
+} // namespace module
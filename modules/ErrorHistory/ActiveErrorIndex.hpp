@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#ifndef ERROR_HISTORY_ACTIVE_ERROR_INDEX_HPP
+#define ERROR_HISTORY_ACTIVE_ERROR_INDEX_HPP
+
+#include <utils/error.hpp>
+#include <utils/error/error_database.hpp>
+
+#include <array>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace module {
+
+///
+/// \brief In-memory set of the currently active errors
+/// Errors are indexed by uuid, origin, type and severity, so that queries for active errors
+/// can be answered without touching the database, in time proportional to the result.
+///
+class ActiveErrorIndex {
+public:
+    ///
+    /// \brief add an active error, replacing an error with the same uuid
+    ///
+    void add(Everest::error::ErrorPtr error);
+
+    ///
+    /// \brief remove the error with the given handle
+    /// \return the removed error, nullptr if no error with this handle is active
+    ///
+    Everest::error::ErrorPtr remove(const Everest::error::ErrorHandle& handle);
+
+    ///
+    /// \brief get all active errors matching all of the given filters
+    /// \return the matching errors, ordered by timestamp
+    ///
+    std::list<Everest::error::ErrorPtr> get_errors(const std::list<Everest::error::ErrorFilter>& filters) const;
+
+    ///
+    /// \brief check whether the result of the given filters only contains active errors,
+    /// i.e. whether they can be answered by this index alone
+    ///
+    static bool covers(const std::list<Everest::error::ErrorFilter>& filters);
+
+    ///
+    /// \brief check whether an error matches a filter
+    ///
+    static bool matches(const Everest::error::Error& error, const Everest::error::ErrorFilter& filter);
+
+    std::size_t size() const;
+
+private:
+    using UuidSet = std::unordered_set<std::string>;
+
+    static std::string origin_key(const ImplementationIdentifier& origin);
+    static std::size_t severity_index(Everest::error::Severity severity);
+    const UuidSet* candidates(const std::list<Everest::error::ErrorFilter>& filters, UuidSet& storage) const;
+    void remove_from_indexes(const Everest::error::ErrorPtr& error);
+
+    mutable std::mutex index_mutex;
+    std::unordered_map<std::string, Everest::error::ErrorPtr> errors_by_uuid;
+    std::unordered_map<std::string, UuidSet> uuids_by_origin;
+    std::unordered_map<std::string, UuidSet> uuids_by_type;
+    std::array<UuidSet, 3> uuids_by_severity;
+};
+
+} // namespace module
+
+#endif // ERROR_HISTORY_ACTIVE_ERROR_INDEX_HPP
@@ -7,12 +7,49 @@
 #include <everest/logging.hpp>
 
 #include <SQLiteCpp/SQLiteCpp.h>
-#include <utils/date.hpp>
 
+#include <chrono>
 #include <set>
 
 namespace module {
 
+namespace {
+// timestamps are stored as integer milliseconds since the epoch, which is the precision of the RFC3339 representation
+std::int64_t to_epoch_ms(const Everest::error::Error::time_point& timestamp) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count();
+}
+
+Everest::error::Error::time_point from_epoch_ms(std::int64_t epoch_ms) {
+    return Everest::error::Error::time_point(
+        std::chrono::duration_cast<Everest::error::Error::time_point::duration>(std::chrono::milliseconds(epoch_ms)));
+}
+
+const std::string SELECT_ERRORS_SQL = "SELECT * FROM errors";
+const std::string DELETE_ERRORS_SQL = "DELETE FROM errors";
+const std::string INSERT_ERROR_SQL =
+    "INSERT INTO errors(uuid, type, description, message, origin_module, origin_implementation, "
+    "timestamp, severity, state, sub_type, vendor_id) VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11);";
+const std::string UPDATE_ERROR_SQL =
+    "UPDATE errors SET uuid = ?1, type = ?2, description = ?3, message = ?4, origin_module = ?5, "
+    "origin_implementation = ?6, timestamp = ?7, severity = ?8, state = ?9, sub_type = ?10, vendor_id = ?11 "
+    "WHERE uuid = ?12;";
+
+// binds the columns of an error to the parameters ?1 to ?11 of an INSERT or UPDATE statement
+void bind_error(SQLite::Statement& stmt, const Everest::error::ErrorPtr& error) {
+    stmt.bind(1, error->uuid.to_string());
+    stmt.bind(2, error->type);
+    stmt.bind(3, error->description);
+    stmt.bind(4, error->message);
+    stmt.bind(5, error->origin.module_id);
+    stmt.bind(6, error->origin.implementation_id);
+    stmt.bind(7, to_epoch_ms(error->timestamp));
+    stmt.bind(8, Everest::error::severity_to_string(error->severity));
+    stmt.bind(9, Everest::error::state_to_string(error->state));
+    stmt.bind(10, error->sub_type);
+    stmt.bind(11, error->vendor_id);
+}
+} // namespace
+
 ErrorDatabaseSqlite::ErrorDatabaseSqlite(const fs::path& db_path_, const bool reset_) :
     db_path(fs::absolute(db_path_)) {
     BOOST_LOG_FUNCTION();
@@ -32,6 +69,61 @@ ErrorDatabaseSqlite::ErrorDatabaseSqlite(const fs::path& db_path_, const bool re
             this->reset_database();
         }
     }
+    this->open_database();
+}
+
+ErrorDatabaseSqlite::~ErrorDatabaseSqlite() {
+    // statements have to be finalized before the connection is closed
+    this->statement_cache.clear();
+    this->db.reset();
+}
+
+void ErrorDatabaseSqlite::open_database() {
+    BOOST_LOG_FUNCTION();
+    try {
+        this->db = std::make_unique<SQLite::Database>(this->db_path.string(), SQLite::OPEN_READWRITE);
+        // WAL keeps readers from blocking the writer and makes each commit a single append to the log,
+        // NORMAL synchronous is durable against application crashes and only syncs on checkpoints in WAL mode
+        this->db->exec("PRAGMA journal_mode = WAL;");
+        this->db->exec("PRAGMA synchronous = NORMAL;");
+        // one index per filter type, so filtered queries and deletes do not scan the whole table
+        this->db->exec("CREATE INDEX IF NOT EXISTS errors_state_idx ON errors(state);"
+                       "CREATE INDEX IF NOT EXISTS errors_origin_idx ON errors(origin_module, origin_implementation);"
+                       "CREATE INDEX IF NOT EXISTS errors_type_idx ON errors(type);"
+                       "CREATE INDEX IF NOT EXISTS errors_severity_idx ON errors(severity);"
+                       "CREATE INDEX IF NOT EXISTS errors_timestamp_idx ON errors(timestamp);"
+                       "CREATE INDEX IF NOT EXISTS errors_sub_type_idx ON errors(sub_type);"
+                       "CREATE INDEX IF NOT EXISTS errors_vendor_id_idx ON errors(vendor_id);");
+    } catch (std::exception& e) {
+        EVLOG_error << "Error opening database: " << e.what();
+        throw;
+    }
+}
+
+SQLite::Statement& ErrorDatabaseSqlite::get_statement(const std::string& sql) const {
+    auto it = this->statement_cache.find(sql);
+    if (it == this->statement_cache.end()) {
+        EVLOG_debug << "Preparing SQL statement: " << sql;
+        it = this->statement_cache.emplace(sql, std::make_unique<SQLite::Statement>(*this->db, sql)).first;
+    }
+    SQLite::Statement& stmt = *it->second;
+    stmt.reset();
+    stmt.clearBindings();
+    return stmt;
+}
+
+SQLite::Statement& ErrorDatabaseSqlite::get_statement(const std::string& sql,
+                                                      const std::optional<SqlCondition>& condition) const {
+    if (!condition.has_value()) {
+        return this->get_statement(sql);
+    }
+    SQLite::Statement& stmt = this->get_statement(sql + " WHERE " + condition.value().sql);
+    int index = 1;
+    for (const auto& parameter : condition.value().parameters) {
+        std::visit([&stmt, index](const auto& value) { stmt.bind(index, value); }, parameter);
+        index++;
+    }
+    return stmt;
 }
 
 void ErrorDatabaseSqlite::check_database() {
@@ -68,7 +160,11 @@ void ErrorDatabaseSqlite::check_database() {
     SQLite::Statement stmt2(*db, sql);
     std::set<std::string> columns;
     while (stmt2.executeStep()) {
-        columns.insert(stmt2.getColumn("name").getText());
+        const std::string column_name = stmt2.getColumn("name").getText();
+        columns.insert(column_name);
+        if (column_name == "timestamp" && std::string(stmt2.getColumn("type").getText()) != "INTEGER") {
+            throw Everest::EverestConfigError("Errors table stores timestamps in an outdated format");
+        }
     }
     std::set<std::string> required_columns = {
         "uuid",      "type",     "description", "message",  "origin_module", "origin_implementation",
@@ -84,8 +180,14 @@ void ErrorDatabaseSqlite::reset_database() {
     if (!fs::exists(database_directory)) {
         fs::create_directories(database_directory);
     }
-    if (fs::exists(this->db_path)) {
-        fs::remove(this->db_path);
+    // close the connection first, sqlite removes or checkpoints the WAL of the old file when it is closed
+    this->statement_cache.clear();
+    this->db.reset();
+    // a WAL left next to the new file would be replayed into it
+    for (const auto* suffix : {"", "-wal", "-shm"}) {
+        fs::path path = this->db_path;
+        path += suffix;
+        fs::remove(path);
     }
     try {
         SQLite::Database db(this->db_path.string(), SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
@@ -96,7 +198,7 @@ void ErrorDatabaseSqlite::reset_database() {
                           "message                TEXT    NOT NULL,"
                           "origin_module          TEXT    NOT NULL,"
                           "origin_implementation  TEXT    NOT NULL,"
-                          "timestamp              TEXT    NOT NULL,"
+                          "timestamp              INTEGER NOT NULL,"
                           "severity               TEXT    NOT NULL,"
                           "state                  TEXT    NOT NULL,"
                           "sub_type               TEXT    NOT NULL,"
@@ -116,22 +218,8 @@ void ErrorDatabaseSqlite::add_error(Everest::error::ErrorPtr error) {
 void ErrorDatabaseSqlite::add_error_without_mutex(Everest::error::ErrorPtr error) {
     BOOST_LOG_FUNCTION();
     try {
-        SQLite::Database db(this->db_path.string(), SQLite::OPEN_READWRITE);
-        std::string sql = "INSERT INTO errors(uuid, type, description, message, origin_module, origin_implementation, "
-                          "timestamp, severity, state, sub_type, vendor_id) VALUES(";
-        sql += "?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11);";
-        SQLite::Statement stmt(db, sql);
-        stmt.bind(1, error->uuid.to_string());
-        stmt.bind(2, error->type);
-        stmt.bind(3, error->description);
-        stmt.bind(4, error->message);
-        stmt.bind(5, error->origin.module_id);
-        stmt.bind(6, error->origin.implementation_id);
-        stmt.bind(7, Everest::Date::to_rfc3339(error->timestamp));
-        stmt.bind(8, Everest::error::severity_to_string(error->severity));
-        stmt.bind(9, Everest::error::state_to_string(error->state));
-        stmt.bind(10, error->sub_type);
-        stmt.bind(11, error->vendor_id);
+        SQLite::Statement& stmt = this->get_statement(INSERT_ERROR_SQL);
+        bind_error(stmt, error);
         stmt.exec();
     } catch (std::exception& e) {
         EVLOG_error << "Error adding error to database: " << e.what();
@@ -139,63 +227,72 @@ void ErrorDatabaseSqlite::add_error_without_mutex(Everest::error::ErrorPtr error
     }
 }
 
-std::string ErrorDatabaseSqlite::filter_to_sql_condition(const Everest::error::ErrorFilter& filter) {
-    std::string condition = "";
+void ErrorDatabaseSqlite::filter_to_sql_condition(const Everest::error::ErrorFilter& filter,
+                                                  SqlCondition& condition) {
     switch (filter.get_filter_type()) {
     case Everest::error::FilterType::State: {
-        condition = "(state = '" + Everest::error::state_to_string(filter.get_state_filter()) + "')";
+        condition.sql += "(state = ?)";
+        condition.parameters.emplace_back(Everest::error::state_to_string(filter.get_state_filter()));
     } break;
     case Everest::error::FilterType::Origin: {
-        condition = "(origin_module = '" + filter.get_origin_filter().module_id + "' AND " +
-                    "origin_implementation = '" + filter.get_origin_filter().implementation_id + "')";
+        condition.sql += "(origin_module = ? AND origin_implementation = ?)";
+        condition.parameters.emplace_back(filter.get_origin_filter().module_id);
+        condition.parameters.emplace_back(filter.get_origin_filter().implementation_id);
     } break;
     case Everest::error::FilterType::Type: {
-        condition = "(type = '" + filter.get_type_filter().value + "')";
+        condition.sql += "(type = ?)";
+        condition.parameters.emplace_back(filter.get_type_filter().value);
     } break;
     case Everest::error::FilterType::Severity: {
         switch (filter.get_severity_filter()) {
         case Everest::error::SeverityFilter::LOW_GE: {
-            condition = "(severity = '" + Everest::error::severity_to_string(Everest::error::Severity::Low) +
-                        "' OR severity = '" + Everest::error::severity_to_string(Everest::error::Severity::Medium) +
-                        "' OR severity = '" + Everest::error::severity_to_string(Everest::error::Severity::High) + "')";
+            condition.sql += "(severity IN (?, ?, ?))";
+            condition.parameters.emplace_back(Everest::error::severity_to_string(Everest::error::Severity::Low));
+            condition.parameters.emplace_back(Everest::error::severity_to_string(Everest::error::Severity::Medium));
+            condition.parameters.emplace_back(Everest::error::severity_to_string(Everest::error::Severity::High));
         } break;
         case Everest::error::SeverityFilter::MEDIUM_GE: {
-            condition = "(severity = '" + Everest::error::severity_to_string(Everest::error::Severity::Medium) +
-                        "' OR severity = '" + Everest::error::severity_to_string(Everest::error::Severity::High) + "')";
+            condition.sql += "(severity IN (?, ?))";
+            condition.parameters.emplace_back(Everest::error::severity_to_string(Everest::error::Severity::Medium));
+            condition.parameters.emplace_back(Everest::error::severity_to_string(Everest::error::Severity::High));
         } break;
         case Everest::error::SeverityFilter::HIGH_GE: {
-            condition = "(severity = '" + Everest::error::severity_to_string(Everest::error::Severity::High) + "')";
+            condition.sql += "(severity = ?)";
+            condition.parameters.emplace_back(Everest::error::severity_to_string(Everest::error::Severity::High));
         } break;
         }
     } break;
     case Everest::error::FilterType::TimePeriod: {
-        condition = "(timestamp BETWEEN '" + Everest::Date::to_rfc3339(filter.get_time_period_filter().from) +
-                    "' AND '" + Everest::Date::to_rfc3339(filter.get_time_period_filter().to) + "')";
+        condition.sql += "(timestamp BETWEEN ? AND ?)";
+        condition.parameters.emplace_back(to_epoch_ms(filter.get_time_period_filter().from));
+        condition.parameters.emplace_back(to_epoch_ms(filter.get_time_period_filter().to));
     } break;
     case Everest::error::FilterType::Handle: {
-        condition = "(uuid = '" + filter.get_handle_filter().to_string() + "')";
+        condition.sql += "(uuid = ?)";
+        condition.parameters.emplace_back(filter.get_handle_filter().to_string());
     } break;
     case Everest::error::FilterType::SubType: {
-        condition = "(sub_type = '" + filter.get_sub_type_filter().value + "')";
+        condition.sql += "(sub_type = ?)";
+        condition.parameters.emplace_back(filter.get_sub_type_filter().value);
     } break;
     case Everest::error::FilterType::VendorId: {
-        condition = "(vendor_id = '" + filter.get_vendor_id_filter().value + "')";
+        condition.sql += "(vendor_id = ?)";
+        condition.parameters.emplace_back(filter.get_vendor_id_filter().value);
     } break;
     }
-    return condition;
 }
 
-std::optional<std::string>
+std::optional<ErrorDatabaseSqlite::SqlCondition>
 ErrorDatabaseSqlite::filters_to_sql_condition(const std::list<Everest::error::ErrorFilter>& filters) {
-    std::optional<std::string> condition = std::nullopt;
-    if (!filters.empty()) {
-        auto it = filters.begin();
-        condition = filter_to_sql_condition(*it);
-        it++;
-        while (it != filters.end()) {
-            condition = condition.value() + " AND " + ErrorDatabaseSqlite::filter_to_sql_condition(*it);
-            it++;
+    if (filters.empty()) {
+        return std::nullopt;
+    }
+    SqlCondition condition;
+    for (auto it = filters.begin(); it != filters.end(); it++) {
+        if (it != filters.begin()) {
+            condition.sql += " AND ";
         }
+        ErrorDatabaseSqlite::filter_to_sql_condition(*it, condition);
     }
     return condition;
 }
@@ -206,17 +303,12 @@ ErrorDatabaseSqlite::get_errors(const std::list<Everest::error::ErrorFilter>& fi
     return this->get_errors(ErrorDatabaseSqlite::filters_to_sql_condition(filters));
 }
 
-std::list<Everest::error::ErrorPtr> ErrorDatabaseSqlite::get_errors(const std::optional<std::string>& condition) const {
+std::list<Everest::error::ErrorPtr>
+ErrorDatabaseSqlite::get_errors(const std::optional<SqlCondition>& condition) const {
     BOOST_LOG_FUNCTION();
     std::list<Everest::error::ErrorPtr> result;
     try {
-        SQLite::Database db(this->db_path.string(), SQLite::OPEN_READONLY);
-        std::string sql = "SELECT * FROM errors";
-        if (condition.has_value()) {
-            sql += " WHERE " + condition.value();
-        }
-        EVLOG_debug << "Executing SQL statement: " << sql;
-        SQLite::Statement stmt(db, sql);
+        SQLite::Statement& stmt = this->get_statement(SELECT_ERRORS_SQL, condition);
         while (stmt.executeStep()) {
             const Everest::error::ErrorType err_type(stmt.getColumn("type").getText());
             const std::string err_description = stmt.getColumn("description").getText();
@@ -225,7 +317,7 @@ std::list<Everest::error::ErrorPtr> ErrorDatabaseSqlite::get_errors(const std::o
             const std::string err_origin_impl_id = stmt.getColumn("origin_implementation").getText();
             const ImplementationIdentifier err_origin(err_origin_module_id, err_origin_impl_id);
             const Everest::error::Error::time_point err_timestamp =
-                Everest::Date::from_rfc3339(stmt.getColumn("timestamp").getText());
+                from_epoch_ms(stmt.getColumn("timestamp").getInt64());
             const Everest::error::Severity err_severity =
                 Everest::error::string_to_severity(stmt.getColumn("severity").getText());
             const Everest::error::State err_state = Everest::error::string_to_state(stmt.getColumn("state").getText());
@@ -237,6 +329,7 @@ std::list<Everest::error::ErrorPtr> ErrorDatabaseSqlite::get_errors(const std::o
                 err_timestamp, err_handle, err_state);
             result.push_back(error);
         }
+        stmt.reset();
     } catch (std::exception& e) {
         EVLOG_error << "Error getting errors from database: " << e.what();
         throw;
@@ -246,11 +339,25 @@ std::list<Everest::error::ErrorPtr> ErrorDatabaseSqlite::get_errors(const std::o
 
 std::list<Everest::error::ErrorPtr>
 ErrorDatabaseSqlite::edit_errors(const std::list<Everest::error::ErrorFilter>& filters, EditErrorFunc edit_func) {
+    BOOST_LOG_FUNCTION();
     std::lock_guard<std::mutex> lock(this->db_mutex);
-    std::list<Everest::error::ErrorPtr> result = this->remove_errors_without_mutex(filters);
-    for (Everest::error::ErrorPtr& error : result) {
-        edit_func(error);
-        this->add_error_without_mutex(error);
+    std::list<Everest::error::ErrorPtr> result =
+        this->get_errors(ErrorDatabaseSqlite::filters_to_sql_condition(filters));
+    try {
+        SQLite::Transaction transaction(*this->db);
+        for (Everest::error::ErrorPtr& error : result) {
+            // the edit function may change the uuid as well, so the row is looked up by its previous one
+            const std::string previous_uuid = error->uuid.to_string();
+            edit_func(error);
+            SQLite::Statement& stmt = this->get_statement(UPDATE_ERROR_SQL);
+            bind_error(stmt, error);
+            stmt.bind(12, previous_uuid);
+            stmt.exec();
+        }
+        transaction.commit();
+    } catch (std::exception& e) {
+        EVLOG_error << "Error editing errors in database: " << e.what();
+        throw;
     }
     return result;
 }
@@ -264,15 +371,13 @@ ErrorDatabaseSqlite::remove_errors(const std::list<Everest::error::ErrorFilter>&
 std::list<Everest::error::ErrorPtr>
 ErrorDatabaseSqlite::remove_errors_without_mutex(const std::list<Everest::error::ErrorFilter>& filters) {
     BOOST_LOG_FUNCTION();
-    std::optional<std::string> condition = ErrorDatabaseSqlite::filters_to_sql_condition(filters);
-    std::list<Everest::error::ErrorPtr> result = this->get_errors(condition);
+    std::optional<SqlCondition> condition = ErrorDatabaseSqlite::filters_to_sql_condition(filters);
+    std::list<Everest::error::ErrorPtr> result;
     try {
-        SQLite::Database db(this->db_path.string(), SQLite::OPEN_READWRITE);
-        std::string sql = "DELETE FROM errors";
-        if (condition.has_value()) {
-            sql += " WHERE " + condition.value();
-        }
-        db.exec(sql);
+        SQLite::Transaction transaction(*this->db);
+        result = this->get_errors(condition);
+        this->get_statement(DELETE_ERRORS_SQL, condition).exec();
+        transaction.commit();
     } catch (std::exception& e) {
         EVLOG_error << "Error removing errors from database: " << e.what();
         throw;
@@ -6,7 +6,18 @@
 
 #include <utils/error/error_database.hpp>
 
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace SQLite {
+class Database;
+class Statement;
+} // namespace SQLite
 
 namespace fs = std::filesystem;
 
@@ -15,6 +26,7 @@ namespace module {
 class ErrorDatabaseSqlite : public Everest::error::ErrorDatabase {
 public:
     explicit ErrorDatabaseSqlite(const fs::path& db_path_, const bool reset_ = false);
+    ~ErrorDatabaseSqlite();
 
     std::list<Everest::error::ErrorPtr>
     get_errors(const std::list<Everest::error::ErrorFilter>& filters) const override;
@@ -25,17 +37,32 @@ public:
     std::list<Everest::error::ErrorPtr> remove_errors(const std::list<Everest::error::ErrorFilter>& filters) override;
 
 private:
+    ///
+    /// \brief SQL condition with anonymous '?' placeholders and the values to bind to them, in order.
+    /// The condition text only depends on the filter types, so statements built from it can be cached.
+    ///
+    struct SqlCondition {
+        std::string sql;
+        std::vector<std::variant<std::string, std::int64_t>> parameters;
+    };
+
     void add_error_without_mutex(Everest::error::ErrorPtr error);
     std::list<Everest::error::ErrorPtr>
     remove_errors_without_mutex(const std::list<Everest::error::ErrorFilter>& filters);
-    std::list<Everest::error::ErrorPtr> get_errors(const std::optional<std::string>& condition) const;
-    static std::string filter_to_sql_condition(const Everest::error::ErrorFilter& filter);
-    static std::optional<std::string> filters_to_sql_condition(const std::list<Everest::error::ErrorFilter>& filters);
+    std::list<Everest::error::ErrorPtr> get_errors(const std::optional<SqlCondition>& condition) const;
+    static void filter_to_sql_condition(const Everest::error::ErrorFilter& filter, SqlCondition& condition);
+    static std::optional<SqlCondition> filters_to_sql_condition(const std::list<Everest::error::ErrorFilter>& filters);
+    SQLite::Statement& get_statement(const std::string& sql) const;
+    SQLite::Statement& get_statement(const std::string& sql, const std::optional<SqlCondition>& condition) const;
 
     void reset_database();
     void check_database();
+    void open_database();
     const fs::path db_path;
     mutable std::mutex db_mutex;
+    // the connection is kept open for the lifetime of the object; statements are prepared once and reused
+    std::unique_ptr<SQLite::Database> db;
+    mutable std::unordered_map<std::string, std::unique_ptr<SQLite::Statement>> statement_cache;
 };
 
 } // namespace module
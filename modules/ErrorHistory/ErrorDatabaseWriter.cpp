@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "ErrorDatabaseWriter.hpp"
+
+#include <everest/logging.hpp>
+
+namespace module {
+
+ErrorDatabaseWriter::ErrorDatabaseWriter(std::shared_ptr<Everest::error::ErrorDatabase> db_) :
+    db(std::move(db_)), writing(false), stop(false) {
+    this->worker = std::thread([this] { this->run(); });
+}
+
+ErrorDatabaseWriter::~ErrorDatabaseWriter() {
+    {
+        std::lock_guard<std::mutex> lock(this->queue_mutex);
+        this->stop = true;
+    }
+    this->queue_cv.notify_all();
+    // the worker writes all remaining changes before it exits
+    this->worker.join();
+}
+
+void ErrorDatabaseWriter::add_error(Everest::error::ErrorPtr error) {
+    this->enqueue([error](Everest::error::ErrorDatabase& db) { db.add_error(error); });
+}
+
+void ErrorDatabaseWriter::set_state(const Everest::error::ErrorHandle& handle, Everest::error::State state) {
+    this->enqueue([handle, state](Everest::error::ErrorDatabase& db) {
+        Everest::error::ErrorFilter error_filter{Everest::error::HandleFilter(handle)};
+        auto edited_errors =
+            db.edit_errors({error_filter}, [state](Everest::error::ErrorPtr error) { error->state = state; });
+        if (edited_errors.empty()) {
+            EVLOG_error << "ErrorHistory: Error with uuid " << handle.to_string() << " not found in database.";
+        }
+    });
+}
+
+void ErrorDatabaseWriter::flush() {
+    std::unique_lock<std::mutex> lock(this->queue_mutex);
+    this->flushed_cv.wait(lock, [this] { return this->queue.empty() && !this->writing; });
+}
+
+void ErrorDatabaseWriter::enqueue(Write write) {
+    {
+        std::lock_guard<std::mutex> lock(this->queue_mutex);
+        this->queue.push_back(std::move(write));
+    }
+    this->queue_cv.notify_one();
+}
+
+void ErrorDatabaseWriter::run() {
+    std::unique_lock<std::mutex> lock(this->queue_mutex);
+    while (true) {
+        this->queue_cv.wait(lock, [this] { return this->stop || !this->queue.empty(); });
+        if (this->queue.empty()) {
+            // stop requested and nothing left to write
+            return;
+        }
+        // take all pending changes at once, so bursts are written without touching the lock in between
+        std::deque<Write> writes;
+        writes.swap(this->queue);
+        this->writing = true;
+        lock.unlock();
+        for (auto& write : writes) {
+            try {
+                write(*this->db);
+            } catch (std::exception& e) {
+                EVLOG_error << "ErrorHistory: Failed to persist error: " << e.what();
+            }
+        }
+        lock.lock();
+        this->writing = false;
+        this->flushed_cv.notify_all();
+    }
+}
+
+} // namespace module
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#ifndef ERROR_HISTORY_ERROR_DATABASE_WRITER_HPP
+#define ERROR_HISTORY_ERROR_DATABASE_WRITER_HPP
+
+#include <utils/error.hpp>
+#include <utils/error/error_database.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace module {
+
+///
+/// \brief Persists changes to an error database on a background thread
+/// Raising and clearing errors only enqueues the change, so the caller does not wait for the database.
+/// Changes are written in the order they were enqueued.
+///
+class ErrorDatabaseWriter {
+public:
+    explicit ErrorDatabaseWriter(std::shared_ptr<Everest::error::ErrorDatabase> db_);
+    ~ErrorDatabaseWriter();
+
+    ErrorDatabaseWriter(const ErrorDatabaseWriter&) = delete;
+    ErrorDatabaseWriter& operator=(const ErrorDatabaseWriter&) = delete;
+
+    ///
+    /// \brief enqueue adding an error to the database
+    ///
+    void add_error(Everest::error::ErrorPtr error);
+
+    ///
+    /// \brief enqueue setting the state of the error with the given handle
+    ///
+    void set_state(const Everest::error::ErrorHandle& handle, Everest::error::State state);
+
+    ///
+    /// \brief block until all enqueued changes are written to the database
+    ///
+    void flush();
+
+private:
+    using Write = std::function<void(Everest::error::ErrorDatabase&)>;
+
+    void enqueue(Write write);
+    void run();
+
+    std::shared_ptr<Everest::error::ErrorDatabase> db;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::condition_variable flushed_cv;
+    std::deque<Write> queue;
+    bool writing;
+    bool stop;
+    std::thread worker;
+};
+
+} // namespace module
+
+#endif // ERROR_HISTORY_ERROR_DATABASE_WRITER_HPP
@@ -18,6 +18,7 @@ void error_historyImpl::init() {
     Everest::error::ErrorFilter error_filter(state_filter);
     this->db->edit_errors(
         {error_filter}, [](Everest::error::ErrorPtr error) { error->state = Everest::error::State::ClearedByReboot; });
+    this->db_writer = std::make_unique<ErrorDatabaseWriter>(this->db);
     subscribe_global_all_errors(
         [this](const Everest::error::Error& error) { this->handle_global_all_errors(error); },
         [this](const Everest::error::Error& error) { this->handle_global_all_errors_cleared(error); });
@@ -82,7 +83,14 @@ error_historyImpl::handle_get_errors(types::error_history::FilterArguments& filt
         Everest::error::HandleFilter handle_filter(filters.handle_filter.value());
         error_filters.push_back(Everest::error::ErrorFilter(handle_filter));
     }
-    std::list<Everest::error::ErrorPtr> errors = this->db->get_errors(error_filters);
+    std::list<Everest::error::ErrorPtr> errors;
+    if (ActiveErrorIndex::covers(error_filters)) {
+        errors = this->active_errors.get_errors(error_filters);
+    } else {
+        // make sure the database has seen all raised and cleared errors before querying it
+        this->db_writer->flush();
+        errors = this->db->get_errors(error_filters);
+    }
     std::vector<types::error_history::ErrorObject> result;
     std::transform(errors.begin(), errors.end(), std::back_inserter(result), [](Everest::error::ErrorPtr error) {
         types::error_history::ErrorObject error_object;
@@ -105,22 +113,19 @@ error_historyImpl::handle_get_errors(types::error_history::FilterArguments& filt
 
 void error_historyImpl::handle_global_all_errors(const Everest::error::Error& error) {
     Everest::error::ErrorPtr error_ptr = std::make_shared<Everest::error::Error>(error);
-    this->db->add_error(error_ptr);
+    if (error_ptr->state == Everest::error::State::Active) {
+        this->active_errors.add(error_ptr);
+    }
+    this->db_writer->add_error(error_ptr);
 }
 
 void error_historyImpl::handle_global_all_errors_cleared(const Everest::error::Error& error) {
-    Everest::error::HandleFilter handle_filter(error.uuid);
-    Everest::error::ErrorFilter error_filter(handle_filter);
-    int edited_errors =
-        this->db
-            ->edit_errors({error_filter},
-                          [](Everest::error::ErrorPtr error) { error->state = Everest::error::State::ClearedByModule; })
-            .size();
-    if (edited_errors == 0) {
-        EVLOG_error << "ErrorHistory: Error with uuid " << error.uuid.to_string() << " not found in database.";
-    } else if (edited_errors > 1) {
-        EVLOG_error << "ErrorHistory: Multiple errors with uuid " << error.uuid.to_string() << " found in database.";
+    Everest::error::ErrorPtr cleared_error = this->active_errors.remove(error.uuid);
+    if (cleared_error == nullptr) {
+        EVLOG_error << "ErrorHistory: Error with uuid " << error.uuid.to_string() << " is not active.";
+        return;
     }
+    this->db_writer->set_state(error.uuid, Everest::error::State::ClearedByModule);
 }
 
 } // namespace error_history
@@ -13,7 +13,9 @@
 #include "../ErrorHistory.hpp"
 
 // ev@75ac1216-19eb-4182-a85c-820f1fc2c091:v1
+#include "../ActiveErrorIndex.hpp"
 #include "../ErrorDatabaseSqlite.hpp"
+#include "../ErrorDatabaseWriter.hpp"
 // ev@75ac1216-19eb-4182-a85c-820f1fc2c091:v1
 
 namespace module {
@@ -55,6 +57,9 @@ private:
     void handle_global_all_errors_cleared(const Everest::error::Error& error);
 
     std::shared_ptr<ErrorDatabaseSqlite> db;
+    // active errors are answered from memory, changes are persisted to db in the background
+    ActiveErrorIndex active_errors;
+    std::unique_ptr<ErrorDatabaseWriter> db_writer;
     // ev@3370e4dd-95f4-47a9-aaec-ea76f34a66c9:v1
 };
 
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <catch2/catch_all.hpp>
+
+#include "../ActiveErrorIndex.hpp"
+#include "helpers.hpp"
+
+namespace {
+std::vector<Everest::error::ErrorPtr> get_active_test_errors() {
+    std::vector<Everest::error::ErrorPtr> active_errors;
+    for (Everest::error::ErrorPtr error : get_test_errors()) {
+        if (error->state == Everest::error::State::Active) {
+            active_errors.push_back(error);
+        }
+    }
+    return active_errors;
+}
+} // namespace
+
+SCENARIO("Check ActiveErrorIndex class", "[!throws]") {
+    GIVEN("An empty ActiveErrorIndex") {
+        module::ActiveErrorIndex index;
+        WHEN("Getting all active errors") {
+            THEN("The result should be empty") {
+                REQUIRE(index.get_errors({Everest::error::ErrorFilter(Everest::error::StateFilter::Active)}).empty());
+            }
+        }
+        WHEN("Removing an unknown error") {
+            THEN("Nothing should be removed") {
+                REQUIRE(index.remove(Everest::error::ErrorHandle()) == nullptr);
+            }
+        }
+    }
+    GIVEN("An ActiveErrorIndex with the active test errors") {
+        module::ActiveErrorIndex index;
+        std::vector<Everest::error::ErrorPtr> test_errors = get_active_test_errors();
+        REQUIRE(test_errors.size() == 3);
+        for (Everest::error::ErrorPtr error : test_errors) {
+            index.add(error);
+        }
+        const Everest::error::ErrorFilter active_filter(Everest::error::StateFilter::Active);
+        WHEN("Getting all active errors") {
+            auto errors = index.get_errors({active_filter});
+            THEN("The result should contain all errors") {
+                check_expected_errors_in_list(test_errors, errors);
+            }
+        }
+        WHEN("Getting active errors with OriginFilter") {
+            auto errors = index.get_errors(
+                {active_filter, Everest::error::ErrorFilter(Everest::error::OriginFilter(
+                                    "test_origin_module_c", "test_origin_implementation_c"))});
+            THEN("The result should contain specific errors") {
+                check_expected_errors_in_list({test_errors[0], test_errors[2]}, errors);
+            }
+        }
+        WHEN("Getting active errors with TypeFilter and SeverityFilter") {
+            auto errors =
+                index.get_errors({active_filter, Everest::error::ErrorFilter(Everest::error::TypeFilter("test_type_c")),
+                                  Everest::error::ErrorFilter(Everest::error::SeverityFilter::MEDIUM_GE)});
+            THEN("The result should contain specific errors") {
+                check_expected_errors_in_list({test_errors[1], test_errors[2]}, errors);
+            }
+        }
+        WHEN("Getting active errors with HandleFilter") {
+            auto errors = index.get_errors(
+                {active_filter, Everest::error::ErrorFilter(Everest::error::HandleFilter(test_errors[1]->uuid))});
+            THEN("The result should contain specific errors") {
+                check_expected_errors_in_list({test_errors[1]}, errors);
+            }
+        }
+        WHEN("Getting active errors with an unknown origin") {
+            auto errors = index.get_errors({active_filter, Everest::error::ErrorFilter(Everest::error::OriginFilter(
+                                                               "unknown_module", "unknown_implementation"))});
+            THEN("The result should be empty") {
+                REQUIRE(errors.empty());
+            }
+        }
+        WHEN("Removing an error") {
+            auto removed = index.remove(test_errors[0]->uuid);
+            THEN("The error should not be active anymore") {
+                REQUIRE(removed == test_errors[0]);
+                REQUIRE(index.size() == 2);
+                check_expected_errors_in_list({test_errors[1], test_errors[2]}, index.get_errors({active_filter}));
+                REQUIRE(index
+                            .get_errors({active_filter, Everest::error::ErrorFilter(Everest::error::OriginFilter(
+                                                            "test_origin_module_c", "test_origin_implementation_c"))})
+                            .size() == 1);
+            }
+        }
+    }
+    GIVEN("Filter lists") {
+        THEN("Only filter lists restricted to active errors should be covered") {
+            REQUIRE(
+                module::ActiveErrorIndex::covers({Everest::error::ErrorFilter(Everest::error::StateFilter::Active)}));
+            REQUIRE_FALSE(module::ActiveErrorIndex::covers(
+                {Everest::error::ErrorFilter(Everest::error::StateFilter::ClearedByModule)}));
+            REQUIRE_FALSE(module::ActiveErrorIndex::covers(
+                {Everest::error::ErrorFilter(Everest::error::TypeFilter("test_type_c"))}));
+            REQUIRE_FALSE(module::ActiveErrorIndex::covers(std::list<Everest::error::ErrorFilter>()));
+        }
+    }
+}
@@ -285,4 +285,76 @@ SCENARIO("Check ErrorDatabaseSqlite class", "[!throws]") {
             }
         }
     }
+    GIVEN("12 Errors in a database that is opened a second time") {
+        const std::string bin_dir = get_bin_dir().string() + "/";
+        const std::string db_name = get_unique_db_name();
+        const fs::path db_path = bin_dir + "/databases/" + db_name;
+        TestDatabase db(db_path, true);
+        std::vector<Everest::error::ErrorPtr> test_errors = get_test_errors();
+        for (Everest::error::ErrorPtr error : test_errors) {
+            db.add_error(error);
+        }
+        WHEN("Getting errors from the second connection") {
+            module::ErrorDatabaseSqlite reopened_db(db_path);
+            THEN("The result should contain all 12 errors") {
+                check_expected_errors_in_list(test_errors,
+                                              reopened_db.get_errors(std::list<Everest::error::ErrorFilter>()));
+            }
+            THEN("Time period filters should work on the stored timestamps") {
+                auto errors = reopened_db.get_errors({Everest::error::ErrorFilter(
+                    Everest::error::TimePeriodFilter{date::utc_clock::now() + std::chrono::minutes(150),
+                                                     date::utc_clock::now() + std::chrono::minutes(270)})});
+                std::vector<Everest::error::ErrorPtr> expected_errors({test_errors[3], test_errors[4]});
+                check_expected_errors_in_list(expected_errors, errors);
+            }
+        }
+        WHEN("Editing errors repeatedly") {
+            std::list<Everest::error::ErrorFilter> filters = {
+                Everest::error::ErrorFilter(Everest::error::HandleFilter(test_errors[4]->uuid))};
+            for (int i = 0; i < 100; i++) {
+                db.edit_errors(filters, [i](Everest::error::ErrorPtr error) {
+                    error->state =
+                        i % 2 == 0 ? Everest::error::State::ClearedByModule : Everest::error::State::Active;
+                });
+            }
+            THEN("The error should exist once with its last state") {
+                auto errors = db.get_errors(filters);
+                REQUIRE(errors.size() == 1);
+                REQUIRE(errors.front()->state == Everest::error::State::Active);
+                REQUIRE(db.get_errors(std::list<Everest::error::ErrorFilter>()).size() == test_errors.size());
+            }
+        }
+    }
+    GIVEN("A database reset while the WAL of the previous database is left next to it") {
+        const std::string bin_dir = get_bin_dir().string() + "/";
+        const std::string db_name = get_unique_db_name();
+        const fs::path db_path = bin_dir + "/databases/" + db_name;
+        const auto with_suffix = [&db_path](const std::string& suffix) {
+            fs::path path = db_path;
+            path += suffix;
+            return path;
+        };
+        {
+            module::ErrorDatabaseSqlite old_db(db_path, true);
+            for (Everest::error::ErrorPtr error : get_test_errors()) {
+                old_db.add_error(error);
+            }
+            // the open connection has not checkpointed its WAL yet, keep a copy as a crash would leave it
+            REQUIRE(fs::exists(with_suffix("-wal")));
+            fs::copy_file(with_suffix("-wal"), with_suffix("-wal.stale"));
+            fs::copy_file(with_suffix("-shm"), with_suffix("-shm.stale"));
+        }
+        fs::rename(with_suffix("-wal.stale"), with_suffix("-wal"));
+        fs::rename(with_suffix("-shm.stale"), with_suffix("-shm"));
+        WHEN("Resetting the database") {
+            TestDatabase db(db_path, true);
+            THEN("The errors of the old database should not come back") {
+                REQUIRE(db.get_errors(std::list<Everest::error::ErrorFilter>()).empty());
+                std::vector<Everest::error::ErrorPtr> test_errors = get_test_errors();
+                db.add_error(test_errors.at(0));
+                check_expected_errors_in_list({test_errors.at(0)},
+                                              db.get_errors(std::list<Everest::error::ErrorFilter>()));
+            }
+        }
+    }
 }
@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <thread>
+
+#include "../ErrorDatabaseWriter.hpp"
+#include "helpers.hpp"
+
+namespace {
+///
+/// \brief proxies a database, but delays every write
+/// This keeps changes queued in the writer long enough to be still pending when it is flushed or destroyed
+///
+class SlowDatabase : public Everest::error::ErrorDatabase {
+public:
+    explicit SlowDatabase(std::shared_ptr<Everest::error::ErrorDatabase> db_) : db(std::move(db_)) {
+    }
+
+    std::list<Everest::error::ErrorPtr>
+    get_errors(const std::list<Everest::error::ErrorFilter>& filters) const override {
+        return db->get_errors(filters);
+    }
+
+    void add_error(Everest::error::ErrorPtr error) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        db->add_error(error);
+    }
+
+    std::list<Everest::error::ErrorPtr> edit_errors(const std::list<Everest::error::ErrorFilter>& filters,
+                                                    EditErrorFunc edit_func) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return db->edit_errors(filters, edit_func);
+    }
+
+    std::list<Everest::error::ErrorPtr> remove_errors(const std::list<Everest::error::ErrorFilter>& filters) override {
+        return db->remove_errors(filters);
+    }
+
+private:
+    std::shared_ptr<Everest::error::ErrorDatabase> db;
+};
+
+///
+/// \brief queue adding all errors, followed by changing the state of each of them
+/// The state changes only succeed if they are written after the errors were added
+/// \return the errors as they are expected in the database
+///
+std::vector<Everest::error::ErrorPtr> add_and_clear_errors(module::ErrorDatabaseWriter& writer) {
+    std::vector<Everest::error::ErrorPtr> test_errors = get_test_errors();
+    for (Everest::error::ErrorPtr error : test_errors) {
+        writer.add_error(error);
+    }
+    std::vector<Everest::error::ErrorPtr> expected_errors;
+    for (Everest::error::ErrorPtr error : test_errors) {
+        writer.set_state(error->uuid, Everest::error::State::ClearedByModule);
+        // the writer only holds the handle, so the expected state can be set on a copy
+        auto expected_error = std::make_shared<Everest::error::Error>(*error);
+        expected_error->state = Everest::error::State::ClearedByModule;
+        expected_errors.push_back(expected_error);
+    }
+    // the last change of an error wins
+    writer.set_state(test_errors.at(0)->uuid, Everest::error::State::ClearedByReboot);
+    writer.set_state(test_errors.at(0)->uuid, Everest::error::State::Active);
+    expected_errors.at(0)->state = Everest::error::State::Active;
+    return expected_errors;
+}
+} // namespace
+
+SCENARIO("Check ErrorDatabaseWriter class", "[!throws]") {
+    GIVEN("An ErrorDatabaseWriter writing to a slow ErrorDatabaseSqlite object") {
+        const std::string bin_dir = get_bin_dir().string() + "/";
+        const std::string db_name = get_unique_db_name();
+        auto db = std::make_shared<TestDatabase>(bin_dir + "/databases/" + db_name, true);
+        WHEN("Flushing queued changes") {
+            module::ErrorDatabaseWriter writer(std::make_shared<SlowDatabase>(db));
+            std::vector<Everest::error::ErrorPtr> expected_errors = add_and_clear_errors(writer);
+            writer.flush();
+            THEN("The changes should be written in the order they were queued") {
+                auto errors = db->get_errors(std::list<Everest::error::ErrorFilter>());
+                REQUIRE(errors.size() == expected_errors.size());
+                check_expected_errors_in_list(expected_errors, errors);
+            }
+            THEN("Changes queued after flushing should be written as well") {
+                writer.set_state(expected_errors.at(1)->uuid, Everest::error::State::Active);
+                writer.flush();
+                auto errors = db->get_errors({Everest::error::ErrorFilter(Everest::error::StateFilter::Active)});
+                REQUIRE(errors.size() == 2);
+            }
+        }
+        WHEN("Destroying the writer with changes still queued") {
+            std::vector<Everest::error::ErrorPtr> expected_errors;
+            {
+                module::ErrorDatabaseWriter writer(std::make_shared<SlowDatabase>(db));
+                expected_errors = add_and_clear_errors(writer);
+            }
+            THEN("All changes should be written in the order they were queued") {
+                auto errors = db->get_errors(std::list<Everest::error::ErrorFilter>());
+                REQUIRE(errors.size() == expected_errors.size());
+                check_expected_errors_in_list(expected_errors, errors);
+            }
+        }
+        WHEN("Changing the state of an unknown error") {
+            module::ErrorDatabaseWriter writer(db);
+            std::vector<Everest::error::ErrorPtr> test_errors = get_test_errors();
+            writer.set_state(test_errors.at(0)->uuid, Everest::error::State::ClearedByModule);
+            writer.add_error(test_errors.at(1));
+            writer.flush();
+            THEN("Later changes should still be written") {
+                auto errors = db->get_errors(std::list<Everest::error::ErrorFilter>());
+                REQUIRE(errors.size() == 1);
+                check_expected_errors_in_list({test_errors.at(1)}, errors);
+            }
+        }
+    }
+}
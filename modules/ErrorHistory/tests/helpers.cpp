@@ -112,6 +112,8 @@ TestDatabase::TestDatabase(const fs::path& db_path_, const bool reset_) :
 }
 
 TestDatabase::~TestDatabase() {
+    // close the connection first, so the WAL is checkpointed and its files are removed
+    db.reset();
     fs::remove(db_path);
 }
 
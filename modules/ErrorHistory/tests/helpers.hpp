@@ -42,15 +42,16 @@ void check_expected_errors_in_list(const std::vector<Everest::error::ErrorPtr>&
 /// It proxies the ErrorDatabaseSqlite class, but
 /// the destructor deletes the database file
 ///
-class TestDatabase {
+class TestDatabase : public Everest::error::ErrorDatabase {
 public:
     explicit TestDatabase(const fs::path& db_path_, const bool reset_ = false);
     ~TestDatabase();
-    void add_error(Everest::error::ErrorPtr error);
-    std::list<Everest::error::ErrorPtr> get_errors(const std::list<Everest::error::ErrorFilter>& filters) const;
+    void add_error(Everest::error::ErrorPtr error) override;
+    std::list<Everest::error::ErrorPtr>
+    get_errors(const std::list<Everest::error::ErrorFilter>& filters) const override;
     std::list<Everest::error::ErrorPtr> edit_errors(const std::list<Everest::error::ErrorFilter>& filters,
-                                                    Everest::error::ErrorDatabase::EditErrorFunc edit_func);
-    std::list<Everest::error::ErrorPtr> remove_errors(const std::list<Everest::error::ErrorFilter>& filters);
+                                                    Everest::error::ErrorDatabase::EditErrorFunc edit_func) override;
+    std::list<Everest::error::ErrorPtr> remove_errors(const std::list<Everest::error::ErrorFilter>& filters) override;
 
 private:
     std::unique_ptr<module::ErrorDatabaseSqlite> db;
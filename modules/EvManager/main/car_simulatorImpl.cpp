@@ -5,6 +5,7 @@
 #include "constants.hpp"
 #include "simulation_command.hpp"
 #include <everest/logging.hpp>
+#include <virtual_clock.hpp>
 
 namespace module::main {
 
@@ -101,7 +102,7 @@ void car_simulatorImpl::run() {
                 }
             }
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(loop_interval_ms));
+        virtual_clock::sleep_for(std::chrono::milliseconds(loop_interval_ms));
     }
 }
 
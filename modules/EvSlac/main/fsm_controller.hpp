@@ -6,6 +6,8 @@
 #include <slac/fsm/ev/fsm.hpp>
 
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
 
 class FSMController {
@@ -13,6 +15,8 @@ public:
     explicit FSMController(slac::fsm::ev::Context& ctx);
 
     void signal_new_slac_message(slac::messages::HomeplugMessage&);
+    // copies the frame straight into the payload of the context, see SlacIO::run_raw
+    void signal_new_slac_frame(const uint8_t* frame, std::size_t length);
     void signal_reset();
     void signal_trigger_matching();
     void run();
@@ -26,6 +26,9 @@ struct Conf {
     std::string device;
     std::string certificate_path;
     std::string logging_path;
+    int logging_max_file_size_kB;
+    int logging_max_files;
+    int logging_session_idle_timeout_s;
     std::string tls_negotiation_strategy;
     std::string private_key_password;
     bool enable_ssl_logging;
@@ -2,7 +2,6 @@
 // Copyright Pionix GmbH and Contributors to EVerest
 #include "ISO15118_chargerImpl.hpp"
 
-#include "session_logger.hpp"
 #include "utils.hpp"
 
 #include <iso15118/io/logging.hpp>
@@ -94,7 +93,13 @@ void ISO15118_chargerImpl::ready() {
         std::this_thread::sleep_for(WAIT_FOR_SETUP_DONE_MS);
     }
 
-    const auto session_logger = std::make_unique<SessionLogger>(mod->config.logging_path);
+    SessionLogger::Config session_logger_config;
+    session_logger_config.max_file_size = static_cast<std::size_t>(mod->config.logging_max_file_size_kB) * 1024;
+    session_logger_config.max_files = mod->config.logging_max_files;
+    session_logger_config.idle_timeout = std::chrono::seconds(mod->config.logging_session_idle_timeout_s);
+    session_logger = std::make_unique<SessionLogger>(mod->config.logging_path, session_logger_config);
+    iso15118::session::logging::set_session_log_callback(
+        [this](std::uintptr_t id, const iso15118::session::logging::Event& event) { session_logger->log(id, event); });
 
     const auto default_cert_path = mod->info.paths.etc / "certs";
     const auto cert_path = construct_cert_path(default_cert_path, mod->config.certificate_path);
@@ -150,12 +155,15 @@ iso15118::session::feedback::Callbacks ISO15118_chargerImpl::create_callbacks()
             break;
         case Signal::DLINK_TERMINATE:
             publish_dlink_terminate(nullptr);
+            session_logger->finish_sessions();
             break;
         case Signal::DLINK_PAUSE:
             publish_dlink_pause(nullptr);
+            session_logger->finish_sessions();
             break;
         case Signal::DLINK_ERROR:
             publish_dlink_error(nullptr);
+            session_logger->finish_sessions();
             break;
         }
     };
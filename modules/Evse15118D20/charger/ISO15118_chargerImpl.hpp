@@ -15,6 +15,7 @@
 // ev@75ac1216-19eb-4182-a85c-820f1fc2c091:v1
 #include <bitset>
 
+#include "session_logger.hpp"
 #include "utils.hpp"
 
 #include <iso15118/d20/config.hpp>
@@ -80,6 +81,7 @@ private:
     iso15118::session::feedback::Callbacks create_callbacks();
 
     std::unique_ptr<iso15118::TbdController> controller;
+    std::unique_ptr<SessionLogger> session_logger;
 
     iso15118::d20::EvseSetupConfig setup_config;
     std::bitset<NUMBER_OF_SETUP_STEPS> setup_steps_done{0};
@@ -2,20 +2,29 @@
 // Copyright Pionix GmbH and Contributors to EVerest
 #include "session_logger.hpp"
 
-#include <chrono>
+#include <algorithm>
+#include <array>
+#include <condition_variable>
 #include <ctime>
+#include <deque>
 #include <fstream>
-#include <iomanip>
-#include <stdexcept>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <date/date.h>
 
-#include <iso15118/session/logger.hpp>
-
 #include <everest/logging.hpp>
 
 using LogEvent = iso15118::session::logging::Event;
 
+namespace {
+
+// events are dropped instead of queued while the writer is this far behind
+constexpr std::size_t MAX_QUEUED_BYTES = 16 * 1024 * 1024;
+constexpr std::size_t MAX_SPARE_BUFFERS = 64;
+
 std::string get_filename_for_current_time() {
     const auto now = std::chrono::system_clock::now();
     const auto now_t = std::chrono::system_clock::to_time_t(now);
@@ -24,118 +33,363 @@ std::string get_filename_for_current_time() {
     gmtime_r(&now_t, &now_tm);
 
     char buffer[64];
-    strftime(buffer, sizeof(buffer), "%y%m%d_%H-%M-%S.yaml", &now_tm);
+    strftime(buffer, sizeof(buffer), "%y%m%d_%H-%M-%S", &now_tm);
     return buffer;
 }
 
-// static auto timepoint_to_string(const iso15118::session::logging::TimePoint& timepoint) {
-//     using namespace date;
-//     return static_cast<std::string>(timepoint);
-// }
+constexpr std::array<char, 512> make_hex_table() {
+    constexpr char digits[] = "0123456789abcdef";
+    std::array<char, 512> table{};
+    for (std::size_t i = 0; i < 256; ++i) {
+        table[2 * i] = digits[i >> 4];
+        table[2 * i + 1] = digits[i & 0xf];
+    }
+    return table;
+}
+
+constexpr auto HEX_TABLE = make_hex_table();
 
-std::ostream& operator<<(std::ostream& os, const iso15118::session::logging::ExiMessageDirection& direction) {
+void append_hex(std::string& out, const uint8_t* data, std::size_t len) {
+    const auto offset = out.size();
+    out.resize(offset + 2 * len);
+    auto dest = &out[offset];
+    for (std::size_t i = 0; i < len; ++i) {
+        dest[2 * i] = HEX_TABLE[2 * data[i]];
+        dest[2 * i + 1] = HEX_TABLE[2 * data[i] + 1];
+    }
+}
+
+void append_zero_padded(std::string& out, long long value, int width) {
+    char buffer[24];
+    auto pos = sizeof(buffer);
+    do {
+        buffer[--pos] = static_cast<char>('0' + value % 10);
+        value /= 10;
+        --width;
+    } while (value > 0 and pos > 0);
+    while (width-- > 0 and pos > 0) {
+        buffer[--pos] = '0';
+    }
+    out.append(buffer + pos, sizeof(buffer) - pos);
+}
+
+const char* to_string(iso15118::session::logging::ExiMessageDirection direction) {
     using Direction = iso15118::session::logging::ExiMessageDirection;
     switch (direction) {
     case Direction::FROM_EV:
-        return os << "FROM_EV";
+        return "FROM_EV";
     case Direction::TO_EV:
-        return os << "TO_EV";
+        return "TO_EV";
     }
 
-    return os;
+    return "";
 }
 
-class SessionLog {
+} // namespace
+
+// Owns the log files, all file system access happens on its thread.
+class SessionLogWriter {
 public:
-    SessionLog(const std::string& file_name) : file(file_name.c_str(), std::ios::out) {
-        if (not file.good()) {
-            throw std::runtime_error("Failed to open file " + file_name + " for writing iso15118 session log");
-        }
+    SessionLogWriter(std::filesystem::path output_dir_, const SessionLogger::Config& config_) :
+        output_dir(std::move(output_dir_)), config(config_), thread(&SessionLogWriter::run, this) {
+    }
 
-        EVLOG_info << "Created logfile at: " << file_name;
+    ~SessionLogWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        cv.notify_one();
+        thread.join();
     }
-    void operator()(const iso15118::session::logging::SimpleEvent& event) {
-        file << "- type: INFO\n";
-        add_timestamp(event.time_point);
-        file << "  info: \"" << event.info << "\"\n";
+
+    std::string get_buffer() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (spare_buffers.empty()) {
+            return {};
+        }
+        auto buffer = std::move(spare_buffers.back());
+        spare_buffers.pop_back();
+        return buffer;
     }
 
-    void operator()(const iso15118::session::logging::ExiMessageEvent& event) {
-        file << "- type: EXI\n";
-        add_timestamp(event.time_point);
-        file << "  direction: " << event.direction << "\n";
-        file << "  sdp_payload_type: " << event.payload_type << "\n";
-        add_hex_encoded_data(event.data, event.len);
+    void write(std::uintptr_t id, std::string&& data) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (queued_bytes + data.size() > MAX_QUEUED_BYTES) {
+                dropped_events++;
+                return;
+            }
+            queued_bytes += data.size();
+            jobs.push_back({id, std::move(data), false});
+        }
+        cv.notify_one();
     }
 
-    void flush() {
-        file.flush();
+    void finish_sessions() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back({0, {}, true});
+        }
+        cv.notify_one();
     }
 
 private:
-    std::fstream file;
-
-    void add_timestamp(const iso15118::session::logging::TimePoint& timestamp) {
-        if (not timestamp_initialized) {
-            last_timestamp = timestamp;
-            timestamp_initialized = true;
+    struct Job {
+        std::uintptr_t id;
+        std::string data;
+        // marks all open sessions as finished instead of writing
+        bool finish;
+    };
+
+    struct OpenLog {
+        std::ofstream file;
+        std::filesystem::path file_name;
+        std::string base_name;
+        std::size_t part{0};
+        std::size_t bytes{0};
+        std::chrono::steady_clock::time_point last_activity;
+        bool finished{false};
+    };
+
+    void run() {
+        std::vector<Job> batch;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running or not jobs.empty()) {
+            cv.wait_for(lock, config.eviction_interval, [this]() { return not running or not jobs.empty(); });
+
+            batch.assign(std::make_move_iterator(jobs.begin()), std::make_move_iterator(jobs.end()));
+            jobs.clear();
+            const auto dropped = std::exchange(dropped_events, 0);
+            lock.unlock();
+
+            if (dropped > 0) {
+                EVLOG_warning << "Dropped " << dropped << " iso15118 session log events, writing the logs is too slow";
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            std::size_t written_bytes = 0;
+            for (auto& job : batch) {
+                if (job.finish) {
+                    for (auto& [id, log] : logs) {
+                        log.finished = true;
+                    }
+                } else {
+                    written_bytes += job.data.size();
+                    append(job.id, job.data, now);
+                }
+            }
+
+            // one flush per batch instead of one per event
+            for (auto& [id, log] : logs) {
+                log.file.flush();
+            }
+            close_idle_logs(now);
+            prune_files();
+
+            lock.lock();
+            queued_bytes -= written_bytes;
+            for (auto& job : batch) {
+                if (not job.finish and spare_buffers.size() < MAX_SPARE_BUFFERS) {
+                    job.data.clear();
+                    spare_buffers.push_back(std::move(job.data));
+                }
+            }
+            batch.clear();
         }
 
-        const auto offset_ms = std::chrono::duration_cast<std::chrono::milliseconds>(timestamp - last_timestamp);
-        file << "  timestamp_offset: " << offset_ms.count() << "\n";
+        logs.clear();
+    }
+
+    void append(std::uintptr_t id, const std::string& data, std::chrono::steady_clock::time_point now) {
+        auto log_it = logs.find(id);
+        if (log_it == logs.end()) {
+            OpenLog log;
+            log.base_name = unique_base_name();
+            if (not open(log)) {
+                return;
+            }
+            log_it = logs.emplace(id, std::move(log)).first;
+        }
 
-        const auto dp = date::floor<date::days>(timestamp);
-        const auto time = date::make_time(timestamp - dp);
-        const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(time.subseconds());
-        file << "  timestamp: \"";
-        file << std::setfill('0') << std::setw(2) << time.hours().count() << ":";
-        file << std::setfill('0') << std::setw(2) << time.minutes().count() << ":";
-        file << std::setfill('0') << std::setw(2) << time.seconds().count() << ".";
-        file << std::setfill('0') << std::setw(4) << milliseconds.count();
-        file << "\"\n";
+        auto& log = log_it->second;
+        if (log.bytes > 0 and log.bytes + data.size() > config.max_file_size) {
+            log.file.close();
+            log.part++;
+            log.bytes = 0;
+            if (not open(log)) {
+                logs.erase(log_it);
+                return;
+            }
+        }
 
-        last_timestamp = timestamp;
+        log.file.write(data.data(), data.size());
+        log.bytes += data.size();
+        log.last_activity = now;
     }
 
-    void add_hex_encoded_data(const uint8_t* data, size_t len) {
-        file << "  data: \"";
+    bool open(OpenLog& log) {
+        log.file_name = output_dir / (log.part == 0 ? log.base_name + ".yaml"
+                                                    : log.base_name + "." + std::to_string(log.part) + ".yaml");
+        log.file.open(log.file_name, std::ios::out);
+        if (not log.file.good()) {
+            EVLOG_error << "Failed to open file " << log.file_name.string() << " for writing iso15118 session log";
+            return false;
+        }
+
+        EVLOG_info << "Created logfile at: " << log.file_name.string();
+        log.last_activity = std::chrono::steady_clock::now();
 
-        const auto flags = file.flags();
+        created_files.push_back(log.file_name);
+        return true;
+    }
 
-        file << std::hex;
+    // deletes the oldest files beyond max_files, the files open sessions are writing to are skipped
+    void prune_files() {
+        if (config.max_files == 0) {
+            return;
+        }
+        for (auto it = created_files.begin(); created_files.size() > config.max_files and it != created_files.end();) {
+            const auto is_open = std::any_of(logs.begin(), logs.end(),
+                                             [&it](const auto& entry) { return entry.second.file_name == *it; });
+            if (is_open) {
+                ++it;
+                continue;
+            }
+            std::error_code ec;
+            std::filesystem::remove(*it, ec);
+            it = created_files.erase(it);
+        }
+    }
 
-        for (int i = 0; i < len; ++i) {
-            file << std::setfill('0') << std::setw(2) << static_cast<int>(data[i]);
+    std::string unique_base_name() const {
+        const auto base_name = get_filename_for_current_time();
+        auto candidate = base_name;
+        // sessions starting within the same second
+        for (int i = 1; std::filesystem::exists(output_dir / (candidate + ".yaml")); ++i) {
+            candidate = base_name + "_" + std::to_string(i);
         }
+        return candidate;
+    }
 
-        file.flags(flags);
-        file << "\"\n";
+    void close_idle_logs(std::chrono::steady_clock::time_point now) {
+        for (auto it = logs.begin(); it != logs.end();) {
+            const auto idle = now - it->second.last_activity;
+            if (idle > config.idle_timeout or (it->second.finished and idle > config.finished_session_linger)) {
+                it = logs.erase(it);
+            } else {
+                ++it;
+            }
+        }
     }
 
-    iso15118::session::logging::TimePoint last_timestamp;
-    bool timestamp_initialized{false};
+    const std::filesystem::path output_dir;
+    const SessionLogger::Config config;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool running{true};
+    std::vector<Job> jobs;
+    std::size_t queued_bytes{0};
+    std::size_t dropped_events{0};
+    std::vector<std::string> spare_buffers;
+
+    // only accessed by the thread
+    std::unordered_map<std::uintptr_t, OpenLog> logs;
+    std::deque<std::filesystem::path> created_files;
+
+    std::thread thread;
 };
 
-SessionLogger::SessionLogger(std::filesystem::path output_dir_) : output_dir(std::filesystem::absolute(output_dir_)) {
+SessionLogger::SessionLogger(std::filesystem::path output_dir_, const Config& config_) :
+    output_dir(std::filesystem::absolute(output_dir_)), config(config_) {
     // FIXME (aw): this is quite brute force ...
     if (not std::filesystem::exists(output_dir)) {
         std::filesystem::create_directory(output_dir);
     }
 
-    iso15118::session::logging::set_session_log_callback([this](std::uintptr_t id, const LogEvent& event) {
-        auto log_it = logs.find(id);
-        if (log_it == logs.end()) {
-            const auto log_file_name = output_dir / get_filename_for_current_time();
-            const auto emplaced = logs.emplace(id, std::make_unique<SessionLog>(log_file_name.string()));
+    writer = std::make_unique<SessionLogWriter>(output_dir, config);
+}
 
-            log_it = emplaced.first;
+SessionLogger::~SessionLogger() = default;
+
+void SessionLogger::finish_sessions() {
+    for (auto& [id, session] : sessions) {
+        session.finished = true;
+    }
+    writer->finish_sessions();
+}
+
+void SessionLogger::log(std::uintptr_t id, const LogEvent& event) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_eviction > config.eviction_interval) {
+        evict_idle_sessions(now);
+        last_eviction = now;
+    }
+
+    auto& session = sessions[id];
+    session.last_activity = now;
+
+    auto buffer = writer->get_buffer();
+    std::visit([this, &session, &buffer](const auto& e) { format(session, e, buffer); }, event);
+    writer->write(id, std::move(buffer));
+}
+
+void SessionLogger::evict_idle_sessions(std::chrono::steady_clock::time_point now) {
+    for (auto it = sessions.begin(); it != sessions.end();) {
+        const auto idle = now - it->second.last_activity;
+        if (idle > config.idle_timeout or (it->second.finished and idle > config.finished_session_linger)) {
+            it = sessions.erase(it);
+        } else {
+            ++it;
         }
+    }
+}
 
-        auto& log = *log_it->second;
+void SessionLogger::format(Session& session, const iso15118::session::logging::SimpleEvent& event, std::string& out) {
+    out += "- type: INFO\n";
+    format_timestamp(session, event.time_point, out);
+    out += "  info: \"";
+    out += event.info;
+    out += "\"\n";
+}
 
-        std::visit(log, event);
-        log.flush();
-    });
+void SessionLogger::format(Session& session, const iso15118::session::logging::ExiMessageEvent& event,
+                           std::string& out) {
+    out += "- type: EXI\n";
+    format_timestamp(session, event.time_point, out);
+    out += "  direction: ";
+    out += to_string(event.direction);
+    out += "\n  sdp_payload_type: ";
+    out += std::to_string(event.payload_type);
+    out += "\n  data: \"";
+    append_hex(out, event.data, event.len);
+    out += "\"\n";
 }
 
-SessionLogger::~SessionLogger() = default;
+void SessionLogger::format_timestamp(Session& session, const iso15118::session::logging::TimePoint& timestamp,
+                                     std::string& out) {
+    if (not session.timestamp_initialized) {
+        session.last_timestamp = timestamp;
+        session.timestamp_initialized = true;
+    }
+
+    const auto offset_ms = std::chrono::duration_cast<std::chrono::milliseconds>(timestamp - session.last_timestamp);
+    out += "  timestamp_offset: ";
+    out += std::to_string(offset_ms.count());
+
+    const auto dp = date::floor<date::days>(timestamp);
+    const auto time = date::make_time(timestamp - dp);
+    const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(time.subseconds());
+    out += "\n  timestamp: \"";
+    append_zero_padded(out, time.hours().count(), 2);
+    out += ':';
+    append_zero_padded(out, time.minutes().count(), 2);
+    out += ':';
+    append_zero_padded(out, time.seconds().count(), 2);
+    out += '.';
+    append_zero_padded(out, milliseconds.count(), 4);
+    out += "\"\n";
+
+    session.last_timestamp = timestamp;
+}
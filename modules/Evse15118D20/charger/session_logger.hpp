@@ -2,20 +2,68 @@
 // Copyright Pionix GmbH and Contributors to EVerest
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
-#include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <iso15118/session/logger.hpp>
 
 // forward declare
-class SessionLog;
+class SessionLogWriter;
 
+// Writes one yaml log file per iso15118 session, log() is meant to be set as the iso15118 session log callback.
+//
+// The events are formatted on the thread that logs them, the files are written by a background thread, so logging
+// never waits for the disk. Sessions get closed and forgotten once they have been idle for the idle timeout, or
+// shortly after finish_sessions(). A file that grows beyond the maximum size is continued in a new one. The oldest
+// files written by the logger are deleted once there are more than max_files, except for the files of open sessions.
 class SessionLogger {
 public:
-    SessionLogger(std::filesystem::path output_dir);
+    struct Config {
+        std::size_t max_file_size{8 * 1024 * 1024};
+        // 0 keeps all files
+        std::size_t max_files{100};
+        std::chrono::milliseconds idle_timeout{std::chrono::minutes(5)};
+        // a finished session is closed after it did not log anything for this long, so the response to the last
+        // request of the EV still goes to the same file
+        std::chrono::milliseconds finished_session_linger{std::chrono::seconds(2)};
+        // how often idle sessions are looked for
+        std::chrono::milliseconds eviction_interval{std::chrono::seconds(1)};
+    };
+
+    SessionLogger(std::filesystem::path output_dir, const Config& config);
     ~SessionLogger();
 
+    void log(std::uintptr_t id, const iso15118::session::logging::Event& event);
+
+    // the currently open sessions have ended, close their files as soon as their last messages are logged
+    void finish_sessions();
+
 private:
+    struct Session {
+        iso15118::session::logging::TimePoint last_timestamp;
+        bool timestamp_initialized{false};
+        std::chrono::steady_clock::time_point last_activity;
+        bool finished{false};
+    };
+
+    void evict_idle_sessions(std::chrono::steady_clock::time_point now);
+
+    void format(Session& session, const iso15118::session::logging::SimpleEvent& event, std::string& out);
+    void format(Session& session, const iso15118::session::logging::ExiMessageEvent& event, std::string& out);
+    static void format_timestamp(Session& session, const iso15118::session::logging::TimePoint& timestamp,
+                                 std::string& out);
+
     std::filesystem::path output_dir;
-    std::map<std::uintptr_t, std::unique_ptr<SessionLog>> logs;
+    Config config;
+
+    // only accessed from the thread that logs, like the timestamps of the sessions
+    std::unordered_map<std::uintptr_t, Session> sessions;
+    std::chrono::steady_clock::time_point last_eviction;
+
+    std::unique_ptr<SessionLogWriter> writer;
 };
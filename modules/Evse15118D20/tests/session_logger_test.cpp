@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+
+#include <date/date.h>
+
+#include <session_logger.hpp>
+
+namespace {
+
+namespace fs = std::filesystem;
+namespace logging = iso15118::session::logging;
+using namespace std::chrono_literals;
+
+std::ostream& operator<<(std::ostream& os, const logging::ExiMessageDirection& direction) {
+    switch (direction) {
+    case logging::ExiMessageDirection::FROM_EV:
+        return os << "FROM_EV";
+    case logging::ExiMessageDirection::TO_EV:
+        return os << "TO_EV";
+    }
+
+    return os;
+}
+
+// the iostream based formatting the session logs were written with before, the output has to stay identical
+class ReferenceLog {
+public:
+    void operator()(const logging::SimpleEvent& event) {
+        out << "- type: INFO\n";
+        add_timestamp(event.time_point);
+        out << "  info: \"" << event.info << "\"\n";
+    }
+
+    void operator()(const logging::ExiMessageEvent& event) {
+        out << "- type: EXI\n";
+        add_timestamp(event.time_point);
+        out << "  direction: " << event.direction << "\n";
+        out << "  sdp_payload_type: " << event.payload_type << "\n";
+        out << "  data: \"";
+        const auto flags = out.flags();
+        out << std::hex;
+        for (std::size_t i = 0; i < event.len; ++i) {
+            out << std::setfill('0') << std::setw(2) << static_cast<int>(event.data[i]);
+        }
+        out.flags(flags);
+        out << "\"\n";
+    }
+
+    std::string str() const {
+        return out.str();
+    }
+
+private:
+    void add_timestamp(const logging::TimePoint& timestamp) {
+        if (not timestamp_initialized) {
+            last_timestamp = timestamp;
+            timestamp_initialized = true;
+        }
+
+        const auto offset_ms = std::chrono::duration_cast<std::chrono::milliseconds>(timestamp - last_timestamp);
+        out << "  timestamp_offset: " << offset_ms.count() << "\n";
+
+        const auto dp = date::floor<date::days>(timestamp);
+        const auto time = date::make_time(timestamp - dp);
+        const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(time.subseconds());
+        out << "  timestamp: \"";
+        out << std::setfill('0') << std::setw(2) << time.hours().count() << ":";
+        out << std::setfill('0') << std::setw(2) << time.minutes().count() << ":";
+        out << std::setfill('0') << std::setw(2) << time.seconds().count() << ".";
+        out << std::setfill('0') << std::setw(4) << milliseconds.count();
+        out << "\"\n";
+
+        last_timestamp = timestamp;
+    }
+
+    std::ostringstream out;
+    logging::TimePoint last_timestamp;
+    bool timestamp_initialized{false};
+};
+
+logging::SimpleEvent info_event(const std::string& info) {
+    return {std::chrono::system_clock::now(), info};
+}
+
+std::string read_file(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+class SessionLoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory = fs::temp_directory_path() /
+                    ("session_logger_test_" + std::to_string(getpid()) + "_" +
+                     ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::remove_all(directory);
+        config.eviction_interval = 10ms;
+    }
+
+    void TearDown() override {
+        fs::remove_all(directory);
+    }
+
+    std::set<std::string> file_names() const {
+        std::set<std::string> names;
+        for (const auto& entry : fs::directory_iterator(directory)) {
+            names.insert(entry.path().filename().string());
+        }
+        return names;
+    }
+
+    fs::path directory;
+    SessionLogger::Config config;
+};
+
+TEST_F(SessionLoggerTest, yaml_matches_iostream_formatting) {
+    std::mt19937 rng(1);
+    std::vector<logging::Event> events;
+    std::vector<std::vector<uint8_t>> payloads;
+    auto time_point = std::chrono::system_clock::now() - 24h;
+    for (int i = 0; i < 200; ++i) {
+        // covers offsets of more than a second as well as sub millisecond steps
+        time_point += std::chrono::microseconds(rng() % 2000000);
+        if (i % 3 == 0) {
+            events.push_back(logging::SimpleEvent{time_point, "info " + std::to_string(i)});
+            continue;
+        }
+        payloads.emplace_back(rng() % 300);
+        for (auto& byte : payloads.back()) {
+            byte = static_cast<uint8_t>(rng());
+        }
+        const auto direction =
+            (i % 2 == 0) ? logging::ExiMessageDirection::FROM_EV : logging::ExiMessageDirection::TO_EV;
+        events.push_back(logging::ExiMessageEvent{time_point, static_cast<uint16_t>(rng() % 0x10000),
+                                                  payloads.back().data(), payloads.back().size(), direction});
+    }
+
+    ReferenceLog reference;
+    {
+        SessionLogger logger(directory, config);
+        for (const auto& event : events) {
+            logger.log(1, event);
+            std::visit(reference, event);
+        }
+    }
+
+    const auto names = file_names();
+    ASSERT_EQ(names.size(), 1u);
+    EXPECT_EQ(read_file(directory / *names.begin()), reference.str());
+}
+
+TEST_F(SessionLoggerTest, one_file_per_session) {
+    {
+        SessionLogger logger(directory, config);
+        logger.log(1, info_event("first"));
+        logger.log(2, info_event("second"));
+        logger.log(1, info_event("first again"));
+    }
+
+    const auto names = file_names();
+    ASSERT_EQ(names.size(), 2u);
+    // sessions starting within the same second get a suffix
+    const std::regex name_pattern(R"(\d{6}_\d{2}-\d{2}-\d{2}(_\d+)?\.yaml)");
+    std::set<std::string> contents;
+    for (const auto& name : names) {
+        EXPECT_TRUE(std::regex_match(name, name_pattern)) << name;
+        contents.insert(read_file(directory / name));
+    }
+    EXPECT_EQ(contents.size(), 2u);
+    for (const auto& content : contents) {
+        const auto is_first = content.find("first") != std::string::npos;
+        EXPECT_NE(content.find(is_first ? "first again" : "second"), std::string::npos);
+        EXPECT_EQ(content.find(is_first ? "second" : "first"), std::string::npos);
+    }
+}
+
+TEST_F(SessionLoggerTest, rotation_naming) {
+    // every event is continued in a new file
+    config.max_file_size = 1;
+    config.max_files = 0;
+    {
+        SessionLogger logger(directory, config);
+        for (int i = 0; i < 3; ++i) {
+            logger.log(1, info_event("event " + std::to_string(i)));
+        }
+    }
+
+    const auto names = file_names();
+    ASSERT_EQ(names.size(), 3u);
+    const auto base_name = names.begin()->substr(0, names.begin()->find('.'));
+    EXPECT_EQ(names, (std::set<std::string>{base_name + ".yaml", base_name + ".1.yaml", base_name + ".2.yaml"}));
+    for (int i = 0; i < 3; ++i) {
+        const auto name = (i == 0) ? base_name + ".yaml" : base_name + "." + std::to_string(i) + ".yaml";
+        EXPECT_NE(read_file(directory / name).find("event " + std::to_string(i)), std::string::npos) << name;
+    }
+}
+
+TEST_F(SessionLoggerTest, max_files_keeps_newest) {
+    config.max_file_size = 1;
+    config.max_files = 2;
+    {
+        SessionLogger logger(directory, config);
+        for (int i = 0; i < 5; ++i) {
+            logger.log(1, info_event("event " + std::to_string(i)));
+            // one batch per event, so that pruning runs in between
+            std::this_thread::sleep_for(50ms);
+        }
+    }
+
+    const auto names = file_names();
+    ASSERT_EQ(names.size(), 2u);
+    const auto base_name = names.begin()->substr(0, names.begin()->find('.'));
+    EXPECT_EQ(names, (std::set<std::string>{base_name + ".3.yaml", base_name + ".4.yaml"}));
+}
+
+TEST_F(SessionLoggerTest, max_files_keeps_open_sessions) {
+    // the short events of the long session fit into one file, every event of the other session needs a new one
+    config.max_file_size = 300;
+    config.max_files = 2;
+    {
+        SessionLogger logger(directory, config);
+        logger.log(1, info_event("long session"));
+        std::this_thread::sleep_for(50ms);
+        for (int i = 0; i < 5; ++i) {
+            logger.log(2, info_event("event " + std::to_string(i) + std::string(250, '.')));
+            std::this_thread::sleep_for(50ms);
+        }
+        logger.log(1, info_event("still open"));
+    }
+
+    const auto names = file_names();
+    ASSERT_EQ(names.size(), 2u);
+    std::string long_session;
+    for (const auto& name : names) {
+        const auto content = read_file(directory / name);
+        if (content.find("long session") != std::string::npos) {
+            long_session = content;
+        } else {
+            EXPECT_NE(content.find("event 4"), std::string::npos);
+        }
+    }
+    EXPECT_NE(long_session.find("still open"), std::string::npos);
+}
+
+TEST_F(SessionLoggerTest, idle_session_is_evicted) {
+    config.idle_timeout = 50ms;
+    {
+        SessionLogger logger(directory, config);
+        logger.log(1, info_event("before"));
+        std::this_thread::sleep_for(200ms);
+        logger.log(1, info_event("after"));
+    }
+
+    const auto names = file_names();
+    ASSERT_EQ(names.size(), 2u);
+    for (const auto& name : names) {
+        // both files start a new session, so their timestamps start over
+        const auto content = read_file(directory / name);
+        EXPECT_EQ(content.find("  timestamp_offset: 0\n"), content.find("  timestamp_offset: "));
+    }
+}
+
+TEST_F(SessionLoggerTest, finished_session_is_closed) {
+    config.finished_session_linger = 50ms;
+    {
+        SessionLogger logger(directory, config);
+        logger.log(1, info_event("before"));
+        logger.finish_sessions();
+        // the last response still goes to the same file
+        logger.log(1, info_event("response"));
+        std::this_thread::sleep_for(200ms);
+        logger.log(1, info_event("after"));
+    }
+
+    const auto names = file_names();
+    ASSERT_EQ(names.size(), 2u);
+    std::set<std::string> contents;
+    for (const auto& name : names) {
+        const auto content = read_file(directory / name);
+        contents.insert(content.find("before") != std::string::npos ? "before" : "after");
+        if (content.find("before") != std::string::npos) {
+            EXPECT_NE(content.find("response"), std::string::npos);
+        }
+    }
+    EXPECT_EQ(contents, (std::set<std::string>{"before", "after"}));
+}
+
+} // namespace
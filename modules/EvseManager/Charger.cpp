@@ -18,6 +18,7 @@
 #include <fmt/core.h>
 
 #include "everest/logging.hpp"
+#include <virtual_clock.hpp>
 #include "scoped_lock_timeout.hpp"
 #include "utils.hpp"
 
@@ -127,7 +128,7 @@ void Charger::main_thread() {
             break;
         }
 
-        std::this_thread::sleep_for(MAINLOOP_UPDATE_RATE);
+        virtual_clock::sleep_for(MAINLOOP_UPDATE_RATE);
 
         {
             Everest::scoped_lock_timeout lock(state_machine_mutex, Everest::MutexDescription::Charger_mainloop);
@@ -263,7 +264,7 @@ void Charger::run_state_machine() {
                 if (hlc_use_5percent_current_session) {
                     // FIXME: wait for SLAC to be ready. Teslas are really fast with sending the first slac packet after
                     // enabling PWM.
-                    std::this_thread::sleep_for(SLEEP_BEFORE_ENABLING_PWM_HLC_MODE);
+                    virtual_clock::sleep_for(SLEEP_BEFORE_ENABLING_PWM_HLC_MODE);
                     update_pwm_now(PWM_5_PERCENT);
                     stopwatch.mark("HLC_PWM_5%_ON");
                 }
@@ -951,7 +952,7 @@ void Charger::process_cp_events_independent(CPEvent cp_event) {
 void Charger::update_pwm_max_every_5seconds_ampere(float ampere) {
     float dc = ampere_to_duty_cycle(ampere);
     if (dc not_eq internal_context.update_pwm_last_dc) {
-        auto now = std::chrono::steady_clock::now();
+        auto now = virtual_clock::now();
         auto time_since_last_update =
             std::chrono::duration_cast<std::chrono::milliseconds>(now - internal_context.last_pwm_update).count();
         if (time_since_last_update >= IEC_PWM_MAX_UPDATE_INTERVAL) {
@@ -971,7 +972,7 @@ void Charger::update_pwm_now(float dc) {
         fmt::format(
             "Set PWM On ({}%) took {} ms", dc * 100.,
             (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)).count()));
-    internal_context.last_pwm_update = std::chrono::steady_clock::now();
+    internal_context.last_pwm_update = virtual_clock::now();
     internal_context.pwm_F_active = false;
     bsp->set_pwm(dc);
 }
@@ -1662,7 +1663,7 @@ void Charger::check_soft_over_current() {
         if (not internal_context.over_current) {
             internal_context.over_current = true;
             // timestamp when over current happend first
-            internal_context.last_over_current_event = std::chrono::steady_clock::now();
+            internal_context.last_over_current_event = virtual_clock::now();
             session_log.evse(false,
                              fmt::format("Soft overcurrent event (L1:{}, L2:{}, L3:{}, limit {}), starting timer.",
                                          shared_context.current_drawn_by_vehicle[0],
@@ -1672,7 +1673,7 @@ void Charger::check_soft_over_current() {
     } else {
         internal_context.over_current = false;
     }
-    auto now = std::chrono::steady_clock::now();
+    auto now = virtual_clock::now();
     auto time_since_over_current_started =
         std::chrono::duration_cast<std::chrono::milliseconds>(now - internal_context.last_over_current_event).count();
     if (internal_context.over_current and
@@ -1834,10 +1835,10 @@ void Charger::bcb_toggle_reset() {
 void Charger::bcb_toggle_detect_start_pulse() {
     // For HLC charging, PWM already off: This is probably a BCB Toggle to wake us up from sleep mode.
     // Remember start of BCB toggle.
-    internal_context.hlc_ev_pause_start_of_bcb = std::chrono::steady_clock::now();
+    internal_context.hlc_ev_pause_start_of_bcb = virtual_clock::now();
     if (internal_context.hlc_ev_pause_bcb_count == 0) {
         // remember sequence start
-        internal_context.hlc_ev_pause_start_of_bcb_sequence = std::chrono::steady_clock::now();
+        internal_context.hlc_ev_pause_start_of_bcb_sequence = virtual_clock::now();
         internal_context.hlc_bcb_sequence_started = true;
     }
 }
@@ -1849,7 +1850,7 @@ void Charger::bcb_toggle_detect_stop_pulse() {
     }
 
     // This is probably and end of BCB toggle, verify it was not too long or too short
-    auto pulse_length = std::chrono::steady_clock::now() - internal_context.hlc_ev_pause_start_of_bcb;
+    auto pulse_length = virtual_clock::now() - internal_context.hlc_ev_pause_start_of_bcb;
 
     if (pulse_length > TP_EV_VALD_STATE_DURATION_MIN and pulse_length < TP_EV_VALD_STATE_DURATION_MAX) {
 
@@ -1871,7 +1872,7 @@ void Charger::bcb_toggle_detect_stop_pulse() {
 // Query if a BCB sequence (of 1-3 pulses) was detected and is finished. If that is true, PWM can be enabled again
 // etc
 bool Charger::bcb_toggle_detected() {
-    auto sequence_length = std::chrono::steady_clock::now() - internal_context.hlc_ev_pause_start_of_bcb_sequence;
+    auto sequence_length = virtual_clock::now() - internal_context.hlc_ev_pause_start_of_bcb_sequence;
     if (internal_context.hlc_bcb_sequence_started and
         (sequence_length > TT_EVSE_VALD_TOGGLE or internal_context.hlc_ev_pause_bcb_count >= 3)) {
         // no need to wait for further BCB toggles
@@ -1894,7 +1895,7 @@ int Charger::time_in_fatal_error_state_ms() {
     if (not internal_context.fatal_error_timer_running) {
         return 0;
     } else {
-        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+        return std::chrono::duration_cast<std::chrono::milliseconds>(virtual_clock::now() -
                                                                      internal_context.fatal_error_became_active)
             .count();
     }
@@ -1904,7 +1905,7 @@ bool Charger::stop_charging_on_fatal_error_internal() {
     bool err = false;
     if (shared_context.error_prevent_charging_flag) {
         if (not shared_context.last_error_prevent_charging_flag) {
-            internal_context.fatal_error_became_active = std::chrono::steady_clock::now();
+            internal_context.fatal_error_became_active = virtual_clock::now();
 
             graceful_stop_charging();
         }
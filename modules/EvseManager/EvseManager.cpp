@@ -9,6 +9,7 @@
 #include "SessionLog.hpp"
 #include "Timeout.hpp"
 #include "scoped_lock_timeout.hpp"
+#include <virtual_clock.hpp>
 
 using namespace std::literals::chrono_literals;
 
@@ -975,7 +976,7 @@ void EvseManager::ready() {
 }
 
 void EvseManager::ready_to_start_charging() {
-    timepoint_ready_for_charging = std::chrono::steady_clock::now();
+    timepoint_ready_for_charging = virtual_clock::now();
     charger->run();
 
     // this will publish a session event Enabled or Disabled that allows other modules the retrieve this state on
@@ -1371,7 +1372,7 @@ void EvseManager::cable_check() {
             if (not contactor_open) {
                 break;
             }
-            std::this_thread::sleep_for(100ms);
+            virtual_clock::sleep_for(100ms);
         }
 
         // If relais are still open after timeout, give up
@@ -1389,7 +1390,7 @@ void EvseManager::cable_check() {
             if (ev_info.maximum_voltage_limit.has_value()) {
                 break;
             }
-            std::this_thread::sleep_for(100ms);
+            virtual_clock::sleep_for(100ms);
         }
 
         float ev_max_voltage = 500.;
@@ -1516,9 +1517,9 @@ void EvseManager::cable_check() {
 
         // Sleep before submitting result to spend more time in cable check. This is needed for some solar inverters
         // used as DC chargers for them to warm up. Don't use it.
-        std::this_thread::sleep_for(std::chrono::seconds(config.hack_sleep_in_cable_check));
+        virtual_clock::sleep_for(std::chrono::seconds(config.hack_sleep_in_cable_check));
         if (car_manufacturer == types::evse_manager::CarManufacturer::VolkswagenGroup) {
-            std::this_thread::sleep_for(std::chrono::seconds(config.hack_sleep_in_cable_check_volkswagen));
+            virtual_clock::sleep_for(std::chrono::seconds(config.hack_sleep_in_cable_check_volkswagen));
         }
         if (config.hack_sleep_in_cable_check > 0 or config.hack_sleep_in_cable_check_volkswagen > 0) {
             charger->get_stopwatch().mark("Sleep");
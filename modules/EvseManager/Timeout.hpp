@@ -5,6 +5,7 @@
 
 #include <chrono>
 #include <sigslot/signal.hpp>
+#include <virtual_clock.hpp>
 
 #include "utils/thread.hpp"
 
@@ -18,7 +19,7 @@ class Timeout {
 public:
     void start(milliseconds _t) {
         t = _t;
-        start_time = steady_clock::now();
+        start_time = virtual_clock::now();
         running = true;
     }
 
@@ -33,7 +34,7 @@ public:
     bool reached() {
         if (!running)
             return false;
-        if ((steady_clock::now() - start_time) > t) {
+        if ((virtual_clock::now() - start_time) > t) {
             running = false;
             return true;
         } else {
@@ -59,12 +60,12 @@ public:
         }
 
         t = _t;
-        start_time = steady_clock::now();
+        start_time = virtual_clock::now();
 
         // start waiting thread
         wait_thread = std::thread([this]() {
             while (not wait_thread.shouldExit()) {
-                std::this_thread::sleep_for(resolution);
+                virtual_clock::sleep_for(resolution);
                 if (reached_nolock()) {
                     // Note the order is important here.
                     // We first signal reached which will call all callbacks.
@@ -104,7 +105,7 @@ private:
     bool reached_nolock() {
         if (!running) {
             return false;
-        } else if ((steady_clock::now() - start_time) > t) {
+        } else if ((virtual_clock::now() - start_time) > t) {
             return true;
         } else {
             return false;
@@ -11,6 +11,7 @@
 #include <string>
 #include <utils/date.hpp>
 #include <utils/formatter.hpp>
+#include <virtual_clock.hpp>
 
 namespace module {
 namespace energy_grid {
@@ -115,7 +116,7 @@ void energyImpl::ready() {
         while (true) {
             hw_caps = mod->get_hw_capabilities();
             request_energy_from_energy_manager(false);
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            virtual_clock::sleep_for(std::chrono::seconds(1));
         }
     }).detach();
 
@@ -329,7 +330,7 @@ bool energyImpl::random_delay_needed(float last_limit, float limit) {
     if ((charger_state == Charger::EvseState::PrepareCharging or charger_state == Charger::EvseState::Charging or
          charger_state == Charger::EvseState::WaitingForAuthentication or
          charger_state == Charger::EvseState::WaitingForEnergy) and
-        std::chrono::steady_clock::now() - mod->timepoint_ready_for_charging.load() <
+        virtual_clock::now() - mod->timepoint_ready_for_charging.load() <
             detect_startup_with_ev_attached_duration) {
         last_enforced_limit = 0.;
         return true;
@@ -405,7 +406,7 @@ void energyImpl::handle_enforce_limits(types::energy::EnforcedLimits& value) {
             }
 
             // Is it running but expired?
-            if (mod->random_delay_running && std::chrono::steady_clock::now() > mod->random_delay_end_time) {
+            if (mod->random_delay_running && virtual_clock::now() > mod->random_delay_end_time) {
                 mod->random_delay_running = false;
             }
 
@@ -415,7 +416,7 @@ void energyImpl::handle_enforce_limits(types::energy::EnforcedLimits& value) {
                 mod->random_delay_running = true;
                 mod->random_delay_start_time = date::utc_clock::now();
                 auto random_delay_s = std::rand() % mod->random_delay_max_duration.load().count();
-                mod->random_delay_end_time = std::chrono::steady_clock::now() + std::chrono::seconds(random_delay_s);
+                mod->random_delay_end_time = virtual_clock::now() + std::chrono::seconds(random_delay_s);
                 EVLOG_info << "UK Smart Charging regulations: Starting random delay of " << random_delay_s << "s";
                 limit_when_random_delay_started = last_enforced_limit;
             }
@@ -425,9 +426,9 @@ void energyImpl::handle_enforce_limits(types::energy::EnforcedLimits& value) {
                 // use limit from the time point when the random delay started
                 limit = limit_when_random_delay_started;
                 // publish the current random delay timer
-                auto seconds_left = std::chrono::duration_cast<std::chrono::seconds>(mod->random_delay_end_time -
-                                                                                     std::chrono::steady_clock::now())
-                                        .count();
+                auto seconds_left =
+                    std::chrono::duration_cast<std::chrono::seconds>(mod->random_delay_end_time - virtual_clock::now())
+                        .count();
                 types::uk_random_delay::CountDown c;
                 c.countdown_s = seconds_left;
                 c.current_limit_after_delay_A = enforced_limit;
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "CertificateIndex.hpp"
+
+#include <cerrno>
+#include <climits>
+#include <set>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <everest/logging.hpp>
+
+namespace module {
+
+namespace {
+// everything that changes the content of a directory or a file in it
+const std::uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB |
+                                 IN_DELETE_SELF | IN_MOVE_SELF;
+} // namespace
+
+CertificateIndex::CertificateIndex(const std::vector<std::filesystem::path>& paths, std::chrono::seconds max_age_) :
+    max_age(max_age_) {
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inotify_fd == -1 or wakeup_fd == -1) {
+        EVLOG_warning << "Could not watch certificate directories, certificates are indexed for at most "
+                      << max_age.count() << "s";
+        watching = false;
+        return;
+    }
+
+    std::set<std::filesystem::path> directories;
+    for (const auto& path : paths) {
+        std::error_code ec;
+        directories.insert(std::filesystem::is_directory(path, ec) ? path : path.parent_path());
+    }
+    for (const auto& directory : directories) {
+        add_watches(directory);
+    }
+
+    watch_thread = std::thread(&CertificateIndex::run, this);
+}
+
+CertificateIndex::~CertificateIndex() {
+    if (watch_thread.joinable()) {
+        const std::uint64_t wakeup = 1;
+        write(wakeup_fd, &wakeup, sizeof(wakeup));
+        watch_thread.join();
+    }
+    if (inotify_fd != -1) {
+        close(inotify_fd);
+    }
+    if (wakeup_fd != -1) {
+        close(wakeup_fd);
+    }
+}
+
+void CertificateIndex::invalidate() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    generation++;
+}
+
+bool CertificateIndex::is_watching() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return watching;
+}
+
+void CertificateIndex::add_watches(const std::filesystem::path& directory) {
+    const auto add_watch = [this](const std::filesystem::path& path) {
+        const auto wd = inotify_add_watch(inotify_fd, path.c_str(), WATCH_MASK | IN_ONLYDIR);
+        if (wd == -1) {
+            EVLOG_warning << "Could not watch " << path.string() << ", certificates are indexed for at most "
+                          << max_age.count() << "s";
+            std::lock_guard<std::mutex> lock(mutex);
+            watching = false;
+            return false;
+        }
+        watched_directories[wd] = path;
+        return true;
+    };
+
+    if (not add_watch(directory)) {
+        return;
+    }
+    // e.g. the ocsp responses are stored in sub directories
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(directory, ec), end; not ec and it != end; it.increment(ec)) {
+        if (it->is_directory(ec)) {
+            add_watch(it->path());
+        }
+    }
+}
+
+void CertificateIndex::run() {
+    // large enough for a couple of events with names
+    alignas(struct inotify_event) char buffer[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+
+    while (true) {
+        struct pollfd fds[2] = {
+            {inotify_fd, POLLIN, 0},
+            {wakeup_fd, POLLIN, 0},
+        };
+        if (poll(fds, 2, -1) == -1 and errno != EINTR) {
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            break;
+        }
+        if (not(fds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        bool changed = false;
+        ssize_t length;
+        while ((length = read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+            for (auto position = buffer; position < buffer + length;) {
+                const auto event = reinterpret_cast<const struct inotify_event*>(position);
+                position += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_IGNORED) {
+                    watched_directories.erase(event->wd);
+                    continue;
+                }
+                changed = true;
+                if ((event->mask & IN_ISDIR) and (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+                    const auto directory = watched_directories.find(event->wd);
+                    if (directory != watched_directories.end()) {
+                        add_watches(directory->second / event->name);
+                    }
+                }
+            }
+        }
+        // a single invalidation for a whole batch, e.g. a certificate and its key written together
+        if (changed) {
+            invalidate();
+        }
+    }
+}
+
+} // namespace module
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#ifndef EVSE_SECURITY_CERTIFICATE_INDEX_HPP
+#define EVSE_SECURITY_CERTIFICATE_INDEX_HPP
+
+#include <any>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace module {
+
+///
+/// \brief In-memory index of the results of certificate queries
+/// Results are parsed from the certificate directories once and kept until inotify reports a change below one of the
+/// watched paths, the index is invalidated explicitly or the result is older than the maximum age. The age limit
+/// covers what changes without touching the files, i.e. certificates becoming valid or expiring.
+///
+class CertificateIndex {
+public:
+    ///
+    /// \brief start watching the given paths, the parent directory is watched for paths that are files or don't
+    /// exist yet
+    ///
+    CertificateIndex(const std::vector<std::filesystem::path>& paths, std::chrono::seconds max_age);
+    ~CertificateIndex();
+
+    CertificateIndex(const CertificateIndex&) = delete;
+    CertificateIndex& operator=(const CertificateIndex&) = delete;
+
+    ///
+    /// \brief get the indexed result of a query, \p load is called if there is none or it is outdated
+    ///
+    template <typename T> T get(const std::string& key, const std::function<T()>& load) {
+        std::uint64_t loaded_generation;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto it = entries.find(key);
+            if (it != entries.end() and std::chrono::steady_clock::now() - it->second.loaded_at < max_age) {
+                return std::any_cast<const T&>(it->second.value);
+            }
+            loaded_generation = generation;
+        }
+
+        auto value = load();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        // a result loaded while the files changed may already be outdated
+        if (loaded_generation == generation) {
+            entries[key] = Entry{value, std::chrono::steady_clock::now()};
+        }
+        return value;
+    }
+
+    ///
+    /// \brief drop all results, e.g. after a certificate was installed
+    ///
+    void invalidate();
+
+    ///
+    /// \brief true if the paths are watched, otherwise results are only kept up to the maximum age
+    ///
+    bool is_watching() const;
+
+private:
+    struct Entry {
+        std::any value;
+        std::chrono::steady_clock::time_point loaded_at;
+    };
+
+    void add_watches(const std::filesystem::path& directory);
+    void run();
+
+    const std::chrono::seconds max_age;
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    std::uint64_t generation{0};
+    bool watching{true};
+
+    int inotify_fd{-1};
+    int wakeup_fd{-1};
+    std::unordered_map<int, std::filesystem::path> watched_directories;
+    std::thread watch_thread;
+};
+
+} // namespace module
+
+#endif // EVSE_SECURITY_CERTIFICATE_INDEX_HPP
@@ -29,6 +29,7 @@ struct Conf {
     std::string secc_leaf_cert_directory;
     std::string secc_leaf_key_directory;
     std::string private_key_password;
+    int certificate_index_max_age_s;
 };
 
 class EvseSecurity : public Everest::ModuleBase {
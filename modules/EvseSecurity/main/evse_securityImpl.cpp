@@ -7,6 +7,13 @@
 namespace module {
 namespace main {
 
+// identifies a leaf certificate query in the certificate index
+static std::string index_key(types::evse_security::LeafCertificateType certificate_type,
+                             types::evse_security::EncodingFormat encoding, bool include_ocsp) {
+    return std::to_string(static_cast<int>(certificate_type)) + ":" + std::to_string(static_cast<int>(encoding)) +
+           ":" + std::to_string(include_ocsp);
+}
+
 void evse_securityImpl::init() {
 
     const auto certs_path = this->mod->info.paths.etc / "certs";
@@ -25,6 +32,12 @@ void evse_securityImpl::init() {
     }
 
     this->evse_security = std::make_unique<evse_security::EvseSecurity>(file_paths, private_key_password);
+    this->certificate_index = std::make_unique<CertificateIndex>(
+        std::vector<std::filesystem::path>{file_paths.csms_ca_bundle, file_paths.mf_ca_bundle, file_paths.mo_ca_bundle,
+                                           file_paths.v2g_ca_bundle, file_paths.csms_leaf_cert_directory,
+                                           file_paths.csms_leaf_key_directory, file_paths.secc_leaf_cert_directory,
+                                           file_paths.secc_leaf_key_directory},
+        std::chrono::seconds(this->mod->config.certificate_index_max_age_s));
 }
 
 void evse_securityImpl::ready() {
@@ -33,21 +46,27 @@ void evse_securityImpl::ready() {
 types::evse_security::InstallCertificateResult
 evse_securityImpl::handle_install_ca_certificate(std::string& certificate,
                                                  types::evse_security::CaCertificateType& certificate_type) {
-    return conversions::to_everest(
+    const auto result = conversions::to_everest(
         this->evse_security->install_ca_certificate(certificate, conversions::from_everest(certificate_type)));
+    this->certificate_index->invalidate();
+    return result;
 }
 
 types::evse_security::DeleteCertificateResult
 evse_securityImpl::handle_delete_certificate(types::evse_security::CertificateHashData& certificate_hash_data) {
-    return conversions::to_everest(
+    const auto result = conversions::to_everest(
         this->evse_security->delete_certificate(conversions::from_everest(certificate_hash_data)));
+    this->certificate_index->invalidate();
+    return result;
 }
 
 types::evse_security::InstallCertificateResult
 evse_securityImpl::handle_update_leaf_certificate(std::string& certificate_chain,
                                                   types::evse_security::LeafCertificateType& certificate_type) {
-    return conversions::to_everest(
+    const auto result = conversions::to_everest(
         this->evse_security->update_leaf_certificate(certificate_chain, conversions::from_everest(certificate_type)));
+    this->certificate_index->invalidate();
+    return result;
 }
 
 types::evse_security::CertificateValidationResult
@@ -60,16 +79,22 @@ evse_securityImpl::handle_verify_certificate(std::string& certificate_chain,
 types::evse_security::GetInstalledCertificatesResult evse_securityImpl::handle_get_installed_certificates(
     std::vector<types::evse_security::CertificateType>& certificate_types) {
     std::vector<evse_security::CertificateType> _certificate_types;
+    std::string key = "installed_certificates";
 
     for (const auto& certificate_type : certificate_types) {
         _certificate_types.push_back(conversions::from_everest(certificate_type));
+        key += ":" + std::to_string(static_cast<int>(certificate_type));
     }
 
-    return conversions::to_everest(this->evse_security->get_installed_certificates(_certificate_types));
+    return this->certificate_index->get<types::evse_security::GetInstalledCertificatesResult>(key, [&]() {
+        return conversions::to_everest(this->evse_security->get_installed_certificates(_certificate_types));
+    });
 }
 
 types::evse_security::OCSPRequestDataList evse_securityImpl::handle_get_v2g_ocsp_request_data() {
-    return conversions::to_everest(this->evse_security->get_v2g_ocsp_request_data());
+    return this->certificate_index->get<types::evse_security::OCSPRequestDataList>("v2g_ocsp_request_data", [this]() {
+        return conversions::to_everest(this->evse_security->get_v2g_ocsp_request_data());
+    });
 }
 
 types::evse_security::OCSPRequestDataList
@@ -80,6 +105,7 @@ evse_securityImpl::handle_get_mo_ocsp_request_data(std::string& certificate_chai
 void evse_securityImpl::handle_update_ocsp_cache(types::evse_security::CertificateHashData& certificate_hash_data,
                                                  std::string& ocsp_response) {
     this->evse_security->update_ocsp_cache(conversions::from_everest(certificate_hash_data), ocsp_response);
+    this->certificate_index->invalidate();
 }
 
 bool evse_securityImpl::handle_is_ca_certificate_installed(types::evse_security::CaCertificateType& certificate_type) {
@@ -108,37 +134,43 @@ types::evse_security::GetCertificateInfoResult
 evse_securityImpl::handle_get_leaf_certificate_info(types::evse_security::LeafCertificateType& certificate_type,
                                                     types::evse_security::EncodingFormat& encoding,
                                                     bool& include_ocsp) {
-    types::evse_security::GetCertificateInfoResult response;
-    const auto leaf_info = this->evse_security->get_leaf_certificate_info(
-        conversions::from_everest(certificate_type), conversions::from_everest(encoding), include_ocsp);
+    const auto key = "leaf_certificate_info:" + index_key(certificate_type, encoding, include_ocsp);
+    return this->certificate_index->get<types::evse_security::GetCertificateInfoResult>(key, [&]() {
+        types::evse_security::GetCertificateInfoResult response;
+        const auto leaf_info = this->evse_security->get_leaf_certificate_info(
+            conversions::from_everest(certificate_type), conversions::from_everest(encoding), include_ocsp);
 
-    response.status = conversions::to_everest(leaf_info.status);
+        response.status = conversions::to_everest(leaf_info.status);
 
-    if (leaf_info.status == evse_security::GetCertificateInfoStatus::Accepted && leaf_info.info.has_value()) {
-        response.info = conversions::to_everest(leaf_info.info.value());
-    }
+        if (leaf_info.status == evse_security::GetCertificateInfoStatus::Accepted && leaf_info.info.has_value()) {
+            response.info = conversions::to_everest(leaf_info.info.value());
+        }
 
-    return response;
+        return response;
+    });
 }
 
 types::evse_security::GetCertificateFullInfoResult
 evse_securityImpl::handle_get_all_valid_certificates_info(types::evse_security::LeafCertificateType& certificate_type,
                                                           types::evse_security::EncodingFormat& encoding,
                                                           bool& include_ocsp) {
-    types::evse_security::GetCertificateFullInfoResult response;
+    const auto key = "all_valid_certificates_info:" + index_key(certificate_type, encoding, include_ocsp);
+    return this->certificate_index->get<types::evse_security::GetCertificateFullInfoResult>(key, [&]() {
+        types::evse_security::GetCertificateFullInfoResult response;
 
-    const auto full_leaf_info = this->evse_security->get_all_valid_certificates_info(
-        conversions::from_everest(certificate_type), conversions::from_everest(encoding), include_ocsp);
+        const auto full_leaf_info = this->evse_security->get_all_valid_certificates_info(
+            conversions::from_everest(certificate_type), conversions::from_everest(encoding), include_ocsp);
 
-    response.status = conversions::to_everest(full_leaf_info.status);
+        response.status = conversions::to_everest(full_leaf_info.status);
 
-    if (full_leaf_info.status == evse_security::GetCertificateInfoStatus::Accepted) {
-        for (const auto& info : full_leaf_info.info) {
-            response.info.push_back(conversions::to_everest(info));
+        if (full_leaf_info.status == evse_security::GetCertificateInfoStatus::Accepted) {
+            for (const auto& info : full_leaf_info.info) {
+                response.info.push_back(conversions::to_everest(info));
+            }
         }
-    }
 
-    return response;
+        return response;
+    });
 }
 
 std::string evse_securityImpl::handle_get_verify_file(types::evse_security::CaCertificateType& certificate_type) {
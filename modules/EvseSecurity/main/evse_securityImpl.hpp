@@ -15,6 +15,8 @@
 // ev@75ac1216-19eb-4182-a85c-820f1fc2c091:v1
 // insert your custom include headers here
 #include <evse_security/evse_security.hpp>
+
+#include "../CertificateIndex.hpp"
 // ev@75ac1216-19eb-4182-a85c-820f1fc2c091:v1
 
 namespace module {
@@ -82,6 +84,8 @@ private:
     // ev@3370e4dd-95f4-47a9-aaec-ea76f34a66c9:v1
     // insert your private definitions here
     std::unique_ptr<evse_security::EvseSecurity> evse_security;
+    // answers the frequent certificate queries without parsing the certificate files
+    std::unique_ptr<CertificateIndex> certificate_index;
     // ev@3370e4dd-95f4-47a9-aaec-ea76f34a66c9:v1
 };
 
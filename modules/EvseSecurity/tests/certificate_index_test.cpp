@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include <CertificateIndex.hpp>
+
+namespace {
+
+using namespace module;
+namespace fs = std::filesystem;
+
+class CertificateIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory = fs::temp_directory_path() /
+                    ("certificate_index_test_" + std::to_string(getpid()) + "_" +
+                     ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::create_directories(directory / "ca" / "v2g");
+        fs::create_directories(directory / "client" / "cso");
+    }
+
+    void TearDown() override {
+        fs::remove_all(directory);
+    }
+
+    int query(CertificateIndex& index) {
+        return index.get<int>("query", [this]() { return ++loads; });
+    }
+
+    // the watch thread invalidates asynchronously
+    bool reloads(CertificateIndex& index) {
+        const auto before = loads;
+        for (int i = 0; i < 200; ++i) {
+            query(index);
+            if (loads != before) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    std::vector<fs::path> paths() const {
+        return {directory / "ca" / "v2g" / "V2G_ROOT_CA.pem", directory / "client" / "cso"};
+    }
+
+    fs::path directory;
+    int loads{0};
+};
+
+TEST_F(CertificateIndexTest, results_are_kept) {
+    CertificateIndex index(paths(), std::chrono::seconds(60));
+    EXPECT_TRUE(index.is_watching());
+
+    EXPECT_EQ(query(index), 1);
+    EXPECT_EQ(query(index), 1);
+    EXPECT_EQ(index.get<std::string>("other", []() { return std::string("other"); }), "other");
+    EXPECT_EQ(loads, 1);
+
+    index.invalidate();
+    EXPECT_EQ(query(index), 2);
+}
+
+TEST_F(CertificateIndexTest, changed_files_invalidate) {
+    CertificateIndex index(paths(), std::chrono::seconds(60));
+    query(index);
+
+    std::ofstream(directory / "client" / "cso" / "SECC_LEAF.pem") << "certificate";
+    EXPECT_TRUE(reloads(index));
+
+    // the bundle is watched through its directory
+    std::ofstream(directory / "ca" / "v2g" / "V2G_ROOT_CA.pem") << "root";
+    EXPECT_TRUE(reloads(index));
+
+    fs::remove(directory / "client" / "cso" / "SECC_LEAF.pem");
+    EXPECT_TRUE(reloads(index));
+}
+
+TEST_F(CertificateIndexTest, new_directories_are_watched) {
+    CertificateIndex index(paths(), std::chrono::seconds(60));
+    query(index);
+
+    fs::create_directories(directory / "ca" / "v2g" / "ocsp");
+    EXPECT_TRUE(reloads(index));
+
+    std::ofstream(directory / "ca" / "v2g" / "ocsp" / "response.der") << "response";
+    EXPECT_TRUE(reloads(index));
+}
+
+TEST_F(CertificateIndexTest, results_expire) {
+    CertificateIndex index(paths(), std::chrono::seconds(0));
+    EXPECT_EQ(query(index), 1);
+    EXPECT_EQ(query(index), 2);
+}
+
+TEST_F(CertificateIndexTest, result_loaded_during_change_is_dropped) {
+    CertificateIndex index(paths(), std::chrono::seconds(60));
+    index.get<int>("query", [&]() {
+        index.invalidate();
+        return ++loads;
+    });
+    EXPECT_EQ(query(index), 2);
+    EXPECT_EQ(query(index), 2);
+}
+
+TEST_F(CertificateIndexTest, missing_directory_is_not_watched) {
+    CertificateIndex index({directory / "missing" / "certs"}, std::chrono::seconds(60));
+    EXPECT_FALSE(index.is_watching());
+    EXPECT_EQ(query(index), 1);
+    EXPECT_EQ(query(index), 1);
+}
+
+} // namespace
@@ -2,6 +2,9 @@
 // Copyright 2023 - 2023 Pionix GmbH and Contributors to EVerest
 #include "fsm_controller.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 #include <slac/fsm/evse/states/others.hpp>
 
 FSMController::FSMController(slac::fsm::evse::Context& context) : ctx(context){};
@@ -20,6 +23,22 @@ void FSMController::signal_new_slac_message(slac::messages::HomeplugMessage& msg
     new_event_cv.notify_all();
 }
 
+void FSMController::signal_new_slac_frame(const uint8_t* frame, std::size_t length) {
+    if (running == false) {
+        return;
+    }
+    {
+        const std::lock_guard<std::mutex> feed_lck(feed_mtx);
+        auto raw_msg = ctx.slac_message_payload.get_raw_message_ptr();
+        memcpy(raw_msg, frame, std::min(length, sizeof(*raw_msg)));
+        fsm.handle_event(slac::fsm::evse::Event::SLAC_MESSAGE);
+
+        new_event = true;
+    }
+
+    new_event_cv.notify_all();
+}
+
 void FSMController::signal_reset() {
     signal_simple_event(slac::fsm::evse::Event::RESET);
 }
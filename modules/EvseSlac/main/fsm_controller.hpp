@@ -6,6 +6,8 @@
 #include <slac/fsm/evse/fsm.hpp>
 
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
 
 class FSMController {
@@ -13,6 +15,8 @@ public:
     explicit FSMController(slac::fsm::evse::Context& ctx);
 
     void signal_new_slac_message(slac::messages::HomeplugMessage&);
+    // copies the frame straight into the payload of the context, see SlacIO::run_raw
+    void signal_new_slac_frame(const uint8_t* frame, std::size_t length);
     void signal_reset();
     bool signal_enter_bcd();
     bool signal_leave_bcd();
@@ -89,7 +89,12 @@ void slacImpl::run() {
 
     fsm_ctrl = std::make_unique<FSMController>(fsm_ctx);
 
-    slac_io.run([](slac::messages::HomeplugMessage& msg) { fsm_ctrl->signal_new_slac_message(msg); });
+    slac_io.set_error_handler([this](const std::string& message) {
+        EVLOG_error << message;
+        raise_error(error_factory->create_error("generic/CommunicationFault", "", message));
+    });
+
+    slac_io.run_raw([](const uint8_t* frame, std::size_t length) { fsm_ctrl->signal_new_slac_frame(frame, length); });
 
     fsm_ctrl->run();
 }
@@ -8,6 +8,14 @@
 namespace module::main {
 const char* CONTENT_TYPE_HEADER = "Content-Type: application/json";
 
+// Number of idle easy handles (and thus open connections) kept around for reuse.
+// Usually only the live measure publisher and a transaction start/stop request run concurrently.
+const std::size_t MAX_IDLE_HANDLES = 2;
+
+// TCP keep-alive probing of idle connections, in seconds
+const long TCP_KEEPALIVE_IDLE_S = 30;
+const long TCP_KEEPALIVE_INTERVAL_S = 10;
+
 struct payloadInTransit {
     const std::string& data;
     size_t position;
@@ -55,7 +63,10 @@ static void setup_connection(CURL* connection, struct payloadInTransit& request_
     curl_easy_setopt(connection, CURLOPT_READDATA, &request_payload);
 
     // Misc. settings come here
-    curl_easy_setopt(connection, CURLOPT_FORBID_REUSE, 1);
+    // Keep the connection open after the request, so the next request on this handle can reuse it
+    curl_easy_setopt(connection, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(connection, CURLOPT_TCP_KEEPIDLE, TCP_KEEPALIVE_IDLE_S);
+    curl_easy_setopt(connection, CURLOPT_TCP_KEEPINTVL, TCP_KEEPALIVE_INTERVAL_S);
     if (curl_easy_setopt(connection, CURLOPT_FOLLOWLOCATION, 0) != CURLE_OK) {
         throw std::runtime_error(
             "libcurl signals that HTTP is unsupported. Your build or linkage might be misconfigured.");
@@ -129,78 +140,150 @@ HttpResponse HttpClient::perform_request(CURL* connection, const std::string& re
     }
 }
 
-CURL* HttpClient::create_curl_handle_and_setup_url(const std::string& path) const {
-    CURL* connection = curl_easy_init();
+HttpClient::HttpClient(const std::string& host_arg, int port_arg, const std::string& tls_certificate) {
+    // initialize libcurl - this is safe to do multiple times, if there are multiple HttpClients
+    // Note: This is only thread-safe after libcurl 7.84.0, but we use 8.4.0, so it should be fine
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    // These are saved in the client to avoid making the controller pass them at every call
+    host = host_arg;
+    port = port_arg;
+    dcbm_tls_certificate = tls_certificate;
+    tls_enabled = !dcbm_tls_certificate.empty();
+    fixup_tls_certificate(dcbm_tls_certificate);
+
+    share_handle = curl_share_init();
+    if (!share_handle) {
+        curl_global_cleanup();
+        throw std::runtime_error("Could not create a CURL share handle: curl_share_init() returned null");
+    }
+    curl_share_setopt(share_handle, CURLSHOPT_LOCKFUNC, HttpClient::lock_share);
+    curl_share_setopt(share_handle, CURLSHOPT_UNLOCKFUNC, HttpClient::unlock_share);
+    curl_share_setopt(share_handle, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    // Whether sharing TLS sessions is supported depends on the SSL backend, so we don't check the error code here.
+    curl_share_setopt(share_handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+}
+
+HttpClient::~HttpClient() {
+    // handles must be cleaned up before the share they are attached to
+    for (CURL* connection : this->idle_handles) {
+        curl_easy_cleanup(connection);
+    }
+    this->idle_handles.clear();
+    curl_share_cleanup(this->share_handle);
+    // release the libcurl resources - this must be done once for every call to curl_global_init().
+    // Note: This is only thread-safe after libcurl 7.84.0, but we use 8.4.0, so it should be fine
+    curl_global_cleanup();
+}
+
+void HttpClient::lock_share(CURL* /*handle*/, curl_lock_data data, curl_lock_access /*access*/, void* userptr) {
+    static_cast<HttpClient*>(userptr)->share_mutexes.at(data).lock();
+}
+
+void HttpClient::unlock_share(CURL* /*handle*/, curl_lock_data data, void* userptr) {
+    static_cast<HttpClient*>(userptr)->share_mutexes.at(data).unlock();
+}
+
+CURL* HttpClient::acquire_curl_handle_and_setup_url(const std::string& path) const {
+    CURL* connection = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(this->handle_pool_mutex);
+        if (!this->idle_handles.empty()) {
+            connection = this->idle_handles.back();
+            this->idle_handles.pop_back();
+        }
+    }
     if (!connection) {
-        throw std::runtime_error("Could not create a CURL handle: curl_easy_init() returned null");
+        connection = curl_easy_init();
+        if (!connection) {
+            throw std::runtime_error("Could not create a CURL handle: curl_easy_init() returned null");
+        }
     }
+    // curl_easy_reset() clears all options, but keeps the connection cache, so the share needs to be set again
+    curl_easy_setopt(connection, CURLOPT_SHARE, this->share_handle);
+
     const char* protocol = this->tls_enabled ? "https" : "http";
     if (curl_easy_setopt(connection, CURLOPT_URL,
                          fmt::format("{}://{}:{}{}", protocol, this->host, this->port, path).c_str()) != CURLE_OK) {
+        this->release_curl_handle(connection);
         throw std::runtime_error("Could not set CURLOPT_URL, likely ran out of memory");
     }
     if (curl_easy_setopt(connection, CURLOPT_PROTOCOLS_STR, protocol) != CURLE_OK) {
+        this->release_curl_handle(connection);
         throw std::runtime_error(std::string("Could not set supported protocol to ") + protocol +
                                  ", is it enabled in libcurl?");
     }
     return connection;
 }
 
+void HttpClient::release_curl_handle(CURL* connection) const {
+    // Reset all options, so no dangling pointers to request-local buffers (error buffer, payload, headers)
+    // are kept in the handle. Open connections and cached TLS sessions survive the reset.
+    curl_easy_reset(connection);
+
+    std::lock_guard<std::mutex> lock(this->handle_pool_mutex);
+    if (this->idle_handles.size() < MAX_IDLE_HANDLES) {
+        this->idle_handles.push_back(connection);
+    } else {
+        curl_easy_cleanup(connection);
+    }
+}
+
 HttpResponse HttpClient::get(const std::string& path) const {
-    CURL* connection = this->create_curl_handle_and_setup_url(path);
+    CURL* connection = this->acquire_curl_handle_and_setup_url(path);
 
     if (curl_easy_setopt(connection, CURLOPT_HTTPGET, 1) != CURLE_OK) {
-        curl_easy_cleanup(connection);
+        this->release_curl_handle(connection);
         throw std::runtime_error(
             "libcurl signals that HTTP is unsupported. Your build or linkage might be misconfigured.");
     }
 
-    // perform_request() does not cleanup the connection on its own.
-    // We do the cleanup here, and make sure to rethrow any exception that might've occurred.
+    // perform_request() does not release the connection on its own.
+    // We hand it back to the pool here, and make sure to rethrow any exception that might've occurred.
     try {
         HttpResponse response = perform_request(connection, "", "GET", path);
-        curl_easy_cleanup(connection);
+        this->release_curl_handle(connection);
         return response;
     } catch (std::exception& e) {
-        curl_easy_cleanup(connection);
+        this->release_curl_handle(connection);
         throw;
     }
 }
 
 HttpResponse HttpClient::put(const std::string& path, const std::string& body) const {
-    CURL* connection = this->create_curl_handle_and_setup_url(path);
+    CURL* connection = this->acquire_curl_handle_and_setup_url(path);
 
     curl_easy_setopt(connection, CURLOPT_UPLOAD, 1);
 
-    // perform_request() does not cleanup the connection on its own.
-    // We do the cleanup here, and make sure to rethrow any exception that might've occurred.
+    // perform_request() does not release the connection on its own.
+    // We hand it back to the pool here, and make sure to rethrow any exception that might've occurred.
     try {
         HttpResponse response = perform_request(connection, body, "PUT", path);
-        curl_easy_cleanup(connection);
+        this->release_curl_handle(connection);
         return response;
     } catch (std::exception& e) {
-        curl_easy_cleanup(connection);
+        this->release_curl_handle(connection);
         throw;
     }
 }
 
 HttpResponse HttpClient::post(const std::string& path, const std::string& body) const {
-    CURL* connection = this->create_curl_handle_and_setup_url(path);
+    CURL* connection = this->acquire_curl_handle_and_setup_url(path);
 
     if (curl_easy_setopt(connection, CURLOPT_POST, 1) != CURLE_OK) {
-        curl_easy_cleanup(connection);
+        this->release_curl_handle(connection);
         throw std::runtime_error(
             "libcurl signals that HTTP is unsupported. Your build or linkage might be misconfigured.");
     }
 
-    // perform_request() does not cleanup the connection on its own.
-    // We do the cleanup here, and make sure to rethrow any exception that might've occurred.
+    // perform_request() does not release the connection on its own.
+    // We hand it back to the pool here, and make sure to rethrow any exception that might've occurred.
     try {
         HttpResponse response = perform_request(connection, body, "POST", path);
-        curl_easy_cleanup(connection);
+        this->release_curl_handle(connection);
         return response;
     } catch (std::exception& e) {
-        curl_easy_cleanup(connection);
+        this->release_curl_handle(connection);
         throw;
     }
 }
@@ -6,11 +6,14 @@
 
 #include "fmt/format.h"
 #include "http_client_interface.hpp"
+#include <array>
 #include <curl/curl.h>
 #include <everest/logging.hpp>
+#include <mutex>
 #include <regex>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace module::main {
 
@@ -29,22 +32,11 @@ class HttpClient : public HttpClientInterface {
 public:
     HttpClient() = delete;
 
-    HttpClient(const std::string& host_arg, int port_arg, const std::string& tls_certificate) {
-        // initialize libcurl - this is safe to do multiple times, if there are multiple HttpClients
-        // Note: This is only thread-safe after libcurl 7.84.0, but we use 8.4.0, so it should be fine
-        curl_global_init(CURL_GLOBAL_DEFAULT);
-        // These are saved in the client to avoid making the controller pass them at every call
-        host = host_arg;
-        port = port_arg;
-        dcbm_tls_certificate = tls_certificate;
-        tls_enabled = !dcbm_tls_certificate.empty();
-        fixup_tls_certificate(dcbm_tls_certificate);
-    }
-    ~HttpClient() override {
-        // release the libcurl resources - this must be done once for every call to curl_global_init().
-        // Note: This is only thread-safe after libcurl 7.84.0, but we use 8.4.0, so it should be fine
-        curl_global_cleanup();
-    }
+    HttpClient(const std::string& host_arg, int port_arg, const std::string& tls_certificate);
+    ~HttpClient() override;
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
 
     [[nodiscard]] HttpResponse get(const std::string& path) const override;
     [[nodiscard]] HttpResponse put(const std::string& path, const std::string& body) const override;
@@ -56,7 +48,21 @@ private:
     bool tls_enabled;
     std::string dcbm_tls_certificate;
 
-    [[nodiscard]] CURL* create_curl_handle_and_setup_url(const std::string& path) const;
+    // Easy handles are kept alive between requests, so that libcurl can reuse their open (keep-alive) connection to
+    // the DCBM instead of doing a new TCP (and TLS) handshake on every poll. A handle is only ever used by one request
+    // at a time; concurrent requests (e.g. a transaction start while live measurements are polled) lease another one.
+    mutable std::mutex handle_pool_mutex;
+    mutable std::vector<CURL*> idle_handles;
+
+    // TLS sessions and DNS results are shared between all handles of the pool, so that a connection opened by
+    // another handle can resume the TLS session instead of doing a full handshake
+    CURLSH* share_handle;
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> share_mutexes;
+    static void lock_share(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void unlock_share(CURL* handle, curl_lock_data data, void* userptr);
+
+    [[nodiscard]] CURL* acquire_curl_handle_and_setup_url(const std::string& path) const;
+    void release_curl_handle(CURL* connection) const;
     HttpResponse perform_request(CURL* connection, const std::string& request_body, const char* method_name,
                                  const std::string& path) const;
 };
@@ -144,6 +144,44 @@ TEST_F(HttpClientIntegrationTest, test_post_legal_tls) {
     EXPECT_EQ(json.at("running").get<bool>(), true);
 }
 
+static int get_mock_connection_count(const HttpClient& client) {
+    auto res = client.get("/mock/connections");
+    EXPECT_EQ(200, res.status_code);
+    return nlohmann::json::parse(res.body).at("connections").get<int>();
+}
+
+/// \brief Test that consecutive requests of one client reuse a single keep-alive connection
+TEST_F(HttpClientIntegrationTest, test_connection_reuse) {
+
+    HttpClient stats_client(HOST, HTTP_PORT, "");
+    auto connections_before = get_mock_connection_count(stats_client);
+
+    HttpClient client(HOST, HTTP_PORT, "");
+    for (int i = 0; i < 5; i++) {
+        auto res = client.get("/v1/livemeasure");
+        EXPECT_EQ(200, res.status_code);
+    }
+    auto res = client.put("/v1/legal?transactionId=test_transaction", R"({"running": false})");
+    EXPECT_EQ(200, res.status_code);
+
+    EXPECT_EQ(connections_before + 1, get_mock_connection_count(stats_client));
+}
+
+/// \brief Test that consecutive TLS requests of one client reuse a single keep-alive connection
+TEST_F(HttpClientIntegrationTest, test_connection_reuse_tls) {
+
+    HttpClient stats_client(HOST, HTTPS_PORT, MOCK_API_TLS_CERT_BOTH_NEWLINES);
+    auto connections_before = get_mock_connection_count(stats_client);
+
+    HttpClient client(HOST, HTTPS_PORT, MOCK_API_TLS_CERT_BOTH_NEWLINES);
+    for (int i = 0; i < 5; i++) {
+        auto res = client.get("/v1/livemeasure");
+        EXPECT_EQ(200, res.status_code);
+    }
+
+    EXPECT_EQ(connections_before + 1, get_mock_connection_count(stats_client));
+}
+
 class HttpClientIntegrationTestWithCert : public ::testing::TestWithParam<std::string> {
 protected:
     std::string cert;
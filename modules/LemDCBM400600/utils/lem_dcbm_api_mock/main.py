@@ -3,13 +3,41 @@ from pathlib import Path
 from multiprocessing import Process
 
 import uvicorn
-from fastapi import FastAPI, APIRouter
+from fastapi import FastAPI, APIRouter, Request
 from fastapi.responses import PlainTextResponse
 from pydantic import BaseModel, Field
 
 app = FastAPI()
 
 v1_api = APIRouter()
+mock_api = APIRouter()
+
+# Client (host, port) pairs seen so far; each distinct pair is one TCP connection opened by a client.
+# This allows tests to check that the http client reuses its connections.
+seen_client_connections = set()
+
+
+@app.middleware("http")
+async def count_connections(request: Request, call_next):
+    if request.client is not None:
+        seen_client_connections.add((request.client.host, request.client.port))
+    return await call_next(request)
+
+
+class MockConnectionStatistics(BaseModel):
+    connections: int
+
+
+@mock_api.get("/connections")
+def get_connections() -> MockConnectionStatistics:
+    return MockConnectionStatistics(connections=len(seen_client_connections))
+
+
+@mock_api.delete("/connections")
+def reset_connections() -> MockConnectionStatistics:
+    seen_client_connections.clear()
+    return MockConnectionStatistics(connections=0)
+
 
 class UTCTimeSetting(BaseModel):
     utc: str
@@ -359,6 +387,7 @@ def get_status() -> LemDCBMStatusResponse:
     })
 
 app.include_router(v1_api, prefix="/v1")
+app.include_router(mock_api, prefix="/mock")
 
 def run_http_api():
     uvicorn.run("main:app",
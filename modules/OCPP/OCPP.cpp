@@ -71,35 +71,22 @@ void create_empty_user_config(const fs::path& user_config_path) {
     }
 }
 
-void OCPP::set_external_limits(const std::map<int32_t, ocpp::v16::EnhancedChargingSchedule>& charging_schedules) {
-    const auto start_time = ocpp::DateTime();
-
-    // iterate over all schedules reported by the libocpp to create ExternalLimits
-    // for each connector
-    for (auto const& [connector_id, schedule] : charging_schedules) {
-        types::energy::ExternalLimits limits;
-        std::vector<types::energy::ScheduleReqEntry> schedule_import;
-        for (const auto period : schedule.chargingSchedulePeriod) {
-            types::energy::ScheduleReqEntry schedule_req_entry;
-            types::energy::LimitsReq limits_req;
-            const auto timestamp = start_time.to_time_point() + std::chrono::seconds(period.startPeriod);
-            schedule_req_entry.timestamp = ocpp::DateTime(timestamp).to_rfc3339();
-            if (period.numberPhases.has_value()) {
-                limits_req.ac_max_phase_count = period.numberPhases.value();
-            }
-            if (schedule.chargingRateUnit == ocpp::v16::ChargingRateUnit::A) {
-                limits_req.ac_max_current_A = period.limit;
-                if (schedule.minChargingRate.has_value()) {
-                    limits_req.ac_min_current_A = schedule.minChargingRate.value();
-                }
-            } else {
-                limits_req.total_power_W = period.limit;
-            }
-            schedule_req_entry.limits_to_leaves = limits_req;
-            schedule_import.push_back(schedule_req_entry);
-        }
-        limits.schedule_import.emplace(schedule_import);
+void OCPP::process_charging_schedules(
+    const std::map<int32_t, ocpp::v16::EnhancedChargingSchedule>& charging_schedules) {
+    // serializes the periodic timer and the CSMS callback, so the sinks always receive the limits of the latest update
+    std::lock_guard<std::mutex> lk(this->charging_schedules_mutex);
+    const auto update = this->charging_schedule_cache.update(charging_schedules, ocpp::DateTime());
+    this->set_external_limits(update.external_limits);
+    if (update.charging_schedules.has_value()) {
+        this->p_ocpp_generic->publish_charging_schedules(update.charging_schedules.value());
+    } else {
+        EVLOG_debug << "Charging schedules did not change";
+    }
+}
 
+void OCPP::set_external_limits(const std::map<int32_t, types::energy::ExternalLimits>& external_limits) {
+    // only connectors whose composite schedule changed are part of external_limits
+    for (auto const& [connector_id, limits] : external_limits) {
         if (connector_id == 0) {
             if (!this->r_connector_zero_sink.empty()) {
                 EVLOG_debug << "OCPP sets the following external limits for connector 0: \n" << limits;
@@ -115,18 +102,6 @@ void OCPP::set_external_limits(const std::map<int32_t, ocpp::v16::EnhancedChargi
     }
 }
 
-void OCPP::publish_charging_schedules(
-    const std::map<int32_t, ocpp::v16::EnhancedChargingSchedule>& charging_schedules) {
-    // publish the schedule over mqtt
-    types::ocpp::ChargingSchedules schedules;
-    for (const auto& charging_schedule : charging_schedules) {
-        types::ocpp::ChargingSchedule sch = conversions::to_charging_schedule(charging_schedule.second);
-        sch.evse = charging_schedule.first;
-        schedules.schedules.emplace_back(std::move(sch));
-    }
-    this->p_ocpp_generic->publish_charging_schedules(schedules);
-}
-
 void OCPP::process_session_event(int32_t evse_id, const types::evse_manager::SessionEvent& session_event) {
     auto everest_connector_id = session_event.connector_id.value_or(1);
     auto ocpp_connector_id = this->evse_connector_map[evse_id][everest_connector_id];
@@ -681,14 +656,12 @@ void OCPP::ready() {
     // publish charging schedules at least once on startup
     const auto charging_schedules = this->charge_point->get_all_enhanced_composite_charging_schedules(
         this->config.PublishChargingScheduleDurationS, composite_schedule_unit);
-    this->set_external_limits(charging_schedules);
-    this->publish_charging_schedules(charging_schedules);
+    this->process_charging_schedules(charging_schedules);
 
     this->charging_schedules_timer = std::make_unique<Everest::SteadyTimer>([this, composite_schedule_unit]() {
         const auto charging_schedules = this->charge_point->get_all_enhanced_composite_charging_schedules(
             this->config.PublishChargingScheduleDurationS, composite_schedule_unit);
-        this->set_external_limits(charging_schedules);
-        this->publish_charging_schedules(charging_schedules);
+        this->process_charging_schedules(charging_schedules);
     });
     if (this->config.PublishChargingScheduleIntervalS > 0) {
         this->charging_schedules_timer->interval(std::chrono::seconds(this->config.PublishChargingScheduleIntervalS));
@@ -700,8 +673,7 @@ void OCPP::ready() {
         EVLOG_info << "Received new Charging Schedules from CSMS";
         const auto charging_schedules = this->charge_point->get_all_enhanced_composite_charging_schedules(
             this->config.PublishChargingScheduleDurationS, composite_schedule_unit);
-        this->set_external_limits(charging_schedules);
-        this->publish_charging_schedules(charging_schedules);
+        this->process_charging_schedules(charging_schedules);
     });
 
     this->charge_point->register_is_reset_allowed_callback([this](ocpp::v16::ResetType type) {
@@ -714,8 +686,15 @@ void OCPP::ready() {
         this->r_system->call_reset(reset_type, false);
     });
 
-    this->charge_point->register_connection_state_changed_callback(
-        [this](bool is_connected) { this->p_ocpp_generic->publish_is_connected(is_connected); });
+    this->charge_point->register_connection_state_changed_callback([this](bool is_connected) {
+        if (!is_connected) {
+            // the next update applies and publishes every schedule again instead of relying on what was applied
+            // before the connection to the CSMS was lost
+            std::lock_guard<std::mutex> lk(this->charging_schedules_mutex);
+            this->charging_schedule_cache.clear();
+        }
+        this->p_ocpp_generic->publish_is_connected(is_connected);
+    });
 
     this->charge_point->register_get_15118_ev_certificate_response_callback(
         [this](const int32_t connector_id, const ocpp::v201::Get15118EVCertificateResponse& certificate_response,
@@ -45,6 +45,8 @@
 #include <ocpp/v16/types.hpp>
 #include <ocpp/v201/ocpp_types.hpp>
 
+#include <charging_schedule_cache.hpp>
+
 using EvseConnectorMap = std::map<int32_t, std::map<int32_t, int32_t>>;
 using ClearedErrorId = std::string;
 using EventQueue =
@@ -140,8 +142,12 @@ private:
     // insert your private definitions here
     std::filesystem::path ocpp_share_path;
     ocpp::v16::ChargingRateUnit composite_schedule_charging_rate_unit;
-    void set_external_limits(const std::map<int32_t, ocpp::v16::EnhancedChargingSchedule>& charging_schedules);
-    void publish_charging_schedules(const std::map<int32_t, ocpp::v16::EnhancedChargingSchedule>& charging_schedules);
+    ChargingScheduleCache charging_schedule_cache;
+    std::mutex charging_schedules_mutex;
+    /// \brief Applies the \p charging_schedules reported by libocpp to the energy sinks and publishes them, skipping
+    /// schedules that did not change since the last call
+    void process_charging_schedules(const std::map<int32_t, ocpp::v16::EnhancedChargingSchedule>& charging_schedules);
+    void set_external_limits(const std::map<int32_t, types::energy::ExternalLimits>& external_limits);
 
     void init_evse_subscriptions(); // initialize subscriptions to all EVSEs provided by r_evse_manager
     void init_evse_connector_map();
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <charging_schedule_cache.hpp>
+
+#include <conversions.hpp>
+
+namespace module {
+
+namespace {
+// libocpp truncates start periods to whole seconds relative to the time of the request
+constexpr auto PERIOD_START_TOLERANCE = std::chrono::seconds(1);
+} // namespace
+
+bool ChargingScheduleCache::Schedule::operator==(const Schedule& other) const {
+    if (this->charging_rate_unit != other.charging_rate_unit or this->min_charging_rate != other.min_charging_rate or
+        this->periods.size() != other.periods.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < this->periods.size(); i++) {
+        const auto& period = this->periods.at(i);
+        const auto& other_period = other.periods.at(i);
+        if (period.limit != other_period.limit or period.number_phases != other_period.number_phases) {
+            return false;
+        }
+        // the first period always starts at the time of the request
+        if (i > 0) {
+            const auto difference = period.start > other_period.start ? period.start - other_period.start
+                                                                      : other_period.start - period.start;
+            if (difference > PERIOD_START_TOLERANCE) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+ChargingScheduleUpdate
+ChargingScheduleCache::update(const std::map<int32_t, ocpp::v16::EnhancedChargingSchedule>& charging_schedules,
+                              const ocpp::DateTime& start_time) {
+    ChargingScheduleUpdate update;
+    const auto start = start_time.to_time_point();
+
+    bool changed = charging_schedules.size() != this->schedules.size();
+    std::map<int32_t, Schedule> schedules;
+    for (const auto& [connector_id, charging_schedule] : charging_schedules) {
+        auto schedule = to_schedule(charging_schedule, start);
+        const auto cached = this->schedules.find(connector_id);
+        if (cached == this->schedules.end() or !(cached->second == schedule)) {
+            update.external_limits.emplace(connector_id, to_external_limits(schedule));
+            changed = true;
+        }
+        schedules.emplace(connector_id, std::move(schedule));
+    }
+    this->schedules = std::move(schedules);
+
+    if (changed) {
+        types::ocpp::ChargingSchedules everest_schedules;
+        everest_schedules.schedules.reserve(charging_schedules.size());
+        for (const auto& [connector_id, charging_schedule] : charging_schedules) {
+            auto everest_schedule = conversions::to_charging_schedule(charging_schedule);
+            everest_schedule.evse = connector_id;
+            everest_schedules.schedules.emplace_back(std::move(everest_schedule));
+        }
+        update.charging_schedules.emplace(std::move(everest_schedules));
+    }
+    return update;
+}
+
+void ChargingScheduleCache::clear() {
+    this->schedules.clear();
+}
+
+ChargingScheduleCache::Schedule
+ChargingScheduleCache::to_schedule(const ocpp::v16::EnhancedChargingSchedule& charging_schedule,
+                                   const TimePoint& start_time) {
+    Schedule schedule{charging_schedule.chargingRateUnit, charging_schedule.minChargingRate, {}};
+    schedule.periods.reserve(charging_schedule.chargingSchedulePeriod.size());
+    for (const auto& period : charging_schedule.chargingSchedulePeriod) {
+        schedule.periods.push_back(
+            {start_time + std::chrono::seconds(period.startPeriod), period.limit, period.numberPhases});
+    }
+    return schedule;
+}
+
+types::energy::ExternalLimits ChargingScheduleCache::to_external_limits(const Schedule& schedule) {
+    types::energy::ExternalLimits limits;
+    std::vector<types::energy::ScheduleReqEntry> schedule_import;
+    schedule_import.reserve(schedule.periods.size());
+    for (const auto& period : schedule.periods) {
+        types::energy::ScheduleReqEntry schedule_req_entry;
+        types::energy::LimitsReq limits_req;
+        schedule_req_entry.timestamp = ocpp::DateTime(period.start).to_rfc3339();
+        if (period.number_phases.has_value()) {
+            limits_req.ac_max_phase_count = period.number_phases.value();
+        }
+        if (schedule.charging_rate_unit == ocpp::v16::ChargingRateUnit::A) {
+            limits_req.ac_max_current_A = period.limit;
+            if (schedule.min_charging_rate.has_value()) {
+                limits_req.ac_min_current_A = schedule.min_charging_rate.value();
+            }
+        } else {
+            limits_req.total_power_W = period.limit;
+        }
+        schedule_req_entry.limits_to_leaves = limits_req;
+        schedule_import.push_back(std::move(schedule_req_entry));
+    }
+    limits.schedule_import.emplace(std::move(schedule_import));
+    return limits;
+}
+
+} // namespace module
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef OCPP_CHARGING_SCHEDULE_CACHE_HPP
+#define OCPP_CHARGING_SCHEDULE_CACHE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include <date/date.h>
+
+#include <generated/types/energy.hpp>
+#include <generated/types/ocpp.hpp>
+
+#include <ocpp/common/types.hpp>
+#include <ocpp/v16/types.hpp>
+
+namespace module {
+
+/// \brief Result of ChargingScheduleCache::update
+struct ChargingScheduleUpdate {
+    /// \brief ExternalLimits of the connectors whose composite schedule changed, by OCPP connector id
+    std::map<int32_t, types::energy::ExternalLimits> external_limits;
+    /// \brief All charging schedules, only present if any of them changed
+    std::optional<types::ocpp::ChargingSchedules> charging_schedules;
+};
+
+/// \brief Remembers the composite schedules that have last been applied to each connector.
+///
+/// libocpp reports composite schedules relative to the time they are requested, so the same schedule has different
+/// start periods every time it is requested. The cache therefore compares schedules on absolute time: two schedules are
+/// equal if their periods start at the same points in time (the first one starts now) with the same limits. Only
+/// changed schedules are converted to ExternalLimits. The cache is not thread safe.
+class ChargingScheduleCache {
+public:
+    /// \brief Compares the given \p charging_schedules , requested at \p start_time , against the cached ones and
+    /// returns the conversions that need to be applied. The cache is updated to the given schedules.
+    ChargingScheduleUpdate update(const std::map<int32_t, ocpp::v16::EnhancedChargingSchedule>& charging_schedules,
+                                  const ocpp::DateTime& start_time);
+
+    /// \brief Forgets all cached schedules, so the next update applies every schedule
+    void clear();
+
+private:
+    using TimePoint = std::chrono::time_point<date::utc_clock>;
+
+    struct Period {
+        TimePoint start;
+        float limit;
+        std::optional<int32_t> number_phases;
+    };
+
+    struct Schedule {
+        ocpp::v16::ChargingRateUnit charging_rate_unit;
+        std::optional<float> min_charging_rate;
+        std::vector<Period> periods;
+
+        bool operator==(const Schedule& other) const;
+    };
+
+    std::map<int32_t, Schedule> schedules;
+
+    static Schedule to_schedule(const ocpp::v16::EnhancedChargingSchedule& charging_schedule,
+                                const TimePoint& start_time);
+    static types::energy::ExternalLimits to_external_limits(const Schedule& schedule);
+};
+
+} // namespace module
+
+#endif // OCPP_CHARGING_SCHEDULE_CACHE_HPP
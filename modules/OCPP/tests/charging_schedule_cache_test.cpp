@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <charging_schedule_cache.hpp>
+
+namespace {
+
+using namespace module;
+using namespace std::chrono_literals;
+using Schedules = std::map<int32_t, ocpp::v16::EnhancedChargingSchedule>;
+
+ocpp::v16::EnhancedChargingSchedulePeriod make_period(int32_t start_period, float limit,
+                                                      std::optional<int32_t> number_phases = std::nullopt) {
+    ocpp::v16::EnhancedChargingSchedulePeriod period;
+    period.startPeriod = start_period;
+    period.limit = limit;
+    period.numberPhases = number_phases;
+    return period;
+}
+
+// 16 A for an hour, then 10 A
+ocpp::v16::EnhancedChargingSchedule make_schedule() {
+    ocpp::v16::EnhancedChargingSchedule schedule;
+    schedule.chargingRateUnit = ocpp::v16::ChargingRateUnit::A;
+    schedule.chargingSchedulePeriod = {make_period(0, 16), make_period(3600, 10)};
+    return schedule;
+}
+
+// the same schedule requested later, libocpp truncates the start periods to whole seconds
+Schedules requested_after(std::chrono::milliseconds elapsed, const Schedules& schedules) {
+    auto later = schedules;
+    for (auto& [connector_id, schedule] : later) {
+        for (std::size_t i = 1; i < schedule.chargingSchedulePeriod.size(); i++) {
+            schedule.chargingSchedulePeriod.at(i).startPeriod -=
+                static_cast<int32_t>(std::chrono::duration_cast<std::chrono::seconds>(elapsed).count());
+        }
+    }
+    return later;
+}
+
+class ChargingScheduleCacheTest : public ::testing::Test {
+protected:
+    ChargingScheduleUpdate update_at(std::chrono::milliseconds elapsed, const Schedules& schedules) {
+        return cache.update(schedules, ocpp::DateTime(start + elapsed));
+    }
+
+    ChargingScheduleCache cache;
+    const date::utc_clock::time_point start = date::utc_clock::now();
+};
+
+TEST_F(ChargingScheduleCacheTest, first_update_applies_everything) {
+    const auto update = update_at(0ms, {{0, make_schedule()}, {1, make_schedule()}});
+
+    EXPECT_EQ(update.external_limits.size(), 2u);
+    ASSERT_TRUE(update.charging_schedules.has_value());
+    EXPECT_EQ(update.charging_schedules->schedules.size(), 2u);
+}
+
+TEST_F(ChargingScheduleCacheTest, same_schedule_requested_later_is_unchanged) {
+    const Schedules schedules{{0, make_schedule()}, {1, make_schedule()}};
+    update_at(0ms, schedules);
+
+    // whole seconds, and the truncated fraction of a second that is within the tolerance
+    for (const auto elapsed : {30000ms, 30400ms, 45999ms}) {
+        const auto update = update_at(elapsed, requested_after(elapsed, schedules));
+        EXPECT_TRUE(update.external_limits.empty()) << elapsed.count();
+        EXPECT_FALSE(update.charging_schedules.has_value()) << elapsed.count();
+    }
+}
+
+TEST_F(ChargingScheduleCacheTest, start_tolerance_is_one_second) {
+    const Schedules schedules{{1, make_schedule()}};
+    update_at(0ms, schedules);
+
+    auto shifted = schedules;
+    shifted.at(1).chargingSchedulePeriod.at(1).startPeriod += 1;
+    EXPECT_TRUE(update_at(0ms, shifted).external_limits.empty());
+    EXPECT_TRUE(update_at(0ms, schedules).external_limits.empty());
+
+    shifted.at(1).chargingSchedulePeriod.at(1).startPeriod += 1;
+    EXPECT_EQ(update_at(0ms, shifted).external_limits.size(), 1u);
+}
+
+TEST_F(ChargingScheduleCacheTest, first_period_start_is_ignored) {
+    Schedules schedules{{1, make_schedule()}};
+    schedules.at(1).chargingSchedulePeriod.resize(1);
+    update_at(0ms, schedules);
+
+    // the first period always starts at the time of the request
+    EXPECT_FALSE(update_at(10000ms, schedules).charging_schedules.has_value());
+}
+
+TEST_F(ChargingScheduleCacheTest, changed_limit_only_applies_that_connector) {
+    Schedules schedules{{0, make_schedule()}, {1, make_schedule()}};
+    update_at(0ms, schedules);
+
+    schedules.at(1).chargingSchedulePeriod.at(1).limit = 8;
+    const auto update = update_at(0ms, schedules);
+
+    ASSERT_EQ(update.external_limits.size(), 1u);
+    const auto& limits = update.external_limits.at(1);
+    ASSERT_TRUE(limits.schedule_import.has_value());
+    ASSERT_EQ(limits.schedule_import->size(), 2u);
+    EXPECT_EQ(limits.schedule_import->at(1).limits_to_leaves.ac_max_current_A, 8.0f);
+    // all schedules are published
+    ASSERT_TRUE(update.charging_schedules.has_value());
+    EXPECT_EQ(update.charging_schedules->schedules.size(), 2u);
+}
+
+TEST_F(ChargingScheduleCacheTest, schedule_properties_are_compared) {
+    const Schedules schedules{{1, make_schedule()}};
+    update_at(0ms, schedules);
+
+    auto changed = schedules;
+    changed.at(1).chargingRateUnit = ocpp::v16::ChargingRateUnit::W;
+    EXPECT_EQ(update_at(0ms, changed).external_limits.size(), 1u);
+
+    changed = schedules;
+    changed.at(1).minChargingRate = 6;
+    EXPECT_EQ(update_at(0ms, changed).external_limits.size(), 1u);
+
+    changed = schedules;
+    changed.at(1).chargingSchedulePeriod.at(1).numberPhases = 1;
+    EXPECT_EQ(update_at(0ms, changed).external_limits.size(), 1u);
+
+    changed = schedules;
+    changed.at(1).chargingSchedulePeriod.push_back(make_period(7200, 6));
+    EXPECT_EQ(update_at(0ms, changed).external_limits.size(), 1u);
+}
+
+TEST_F(ChargingScheduleCacheTest, removed_connector_is_published) {
+    update_at(0ms, {{0, make_schedule()}, {1, make_schedule()}});
+
+    const auto update = update_at(0ms, {{1, make_schedule()}});
+    EXPECT_TRUE(update.external_limits.empty());
+    ASSERT_TRUE(update.charging_schedules.has_value());
+    EXPECT_EQ(update.charging_schedules->schedules.size(), 1u);
+}
+
+TEST_F(ChargingScheduleCacheTest, clear_applies_everything_again) {
+    const Schedules schedules{{0, make_schedule()}, {1, make_schedule()}};
+    update_at(0ms, schedules);
+
+    cache.clear();
+    const auto update = update_at(0ms, schedules);
+    EXPECT_EQ(update.external_limits.size(), 2u);
+    EXPECT_TRUE(update.charging_schedules.has_value());
+}
+
+} // namespace
@@ -753,6 +753,13 @@ void OCPP201::ready() {
     this->transaction_handler =
         std::make_unique<TransactionHandler>(this->r_evse_manager.size(), tx_start_points, tx_stop_points);
 
+    // powermeters may publish faster than OCPP samples, so only the latest value per EVSE is converted at sample time
+    this->meter_value_sampler = std::make_unique<MeterValueSampler>(
+        std::chrono::milliseconds(this->config.MeterValueSampleIntervalMs),
+        [this](const int32_t evse_id, const types::powermeter::Powermeter& power_meter) {
+            this->publish_meter_value(evse_id, power_meter);
+        });
+
     int evse_id = 1;
     for (const auto& evse : this->r_evse_manager) {
         evse->subscribe_session_event([this, evse_id](types::evse_manager::SessionEvent session_event) {
@@ -760,16 +767,7 @@ void OCPP201::ready() {
         });
 
         evse->subscribe_powermeter([this, evse_id](const types::powermeter::Powermeter& power_meter) {
-            auto meter_value = conversions::to_ocpp_meter_value(
-                power_meter, ocpp::v201::ReadingContextEnum::Sample_Periodic, power_meter.signed_meter_value);
-            if (this->evse_soc_map[evse_id].has_value()) {
-                auto sampled_soc_value = conversions::to_ocpp_sampled_value(
-                    ocpp::v201::ReadingContextEnum::Sample_Periodic, ocpp::v201::MeasurandEnum::SoC, "Percent",
-                    std::nullopt, ocpp::v201::LocationEnum::EV);
-                sampled_soc_value.value = this->evse_soc_map[evse_id].value();
-                meter_value.sampledValue.push_back(sampled_soc_value);
-            }
-            this->charge_point->on_meter_value(evse_id, meter_value);
+            this->meter_value_sampler->update(evse_id, power_meter);
         });
 
         evse->subscribe_ev_info([this, evse_id](const types::evse_manager::EVInfo& ev_info) {
@@ -824,6 +822,7 @@ void OCPP201::ready() {
     const auto boot_reason = conversions::to_ocpp_boot_reason(this->r_system->call_get_boot_reason());
     this->charge_point->set_message_queue_resume_delay(std::chrono::seconds(this->config.MessageQueueResumeDelay));
     this->charge_point->start(boot_reason);
+    this->meter_value_sampler->start();
 }
 
 void OCPP201::process_session_event(const int32_t evse_id, const types::evse_manager::SessionEvent& session_event) {
@@ -1189,6 +1188,19 @@ void OCPP201::process_deauthorized(const int32_t evse_id, const int32_t connecto
     this->process_tx_event_effect(evse_id, tx_event_effect, session_event);
 }
 
+void OCPP201::publish_meter_value(const int32_t evse_id, const types::powermeter::Powermeter& power_meter) {
+    auto meter_value = conversions::to_ocpp_meter_value(power_meter, ocpp::v201::ReadingContextEnum::Sample_Periodic,
+                                                        power_meter.signed_meter_value);
+    if (this->evse_soc_map[evse_id].has_value()) {
+        auto sampled_soc_value = conversions::to_ocpp_sampled_value(ocpp::v201::ReadingContextEnum::Sample_Periodic,
+                                                                    ocpp::v201::MeasurandEnum::SoC, "Percent",
+                                                                    std::nullopt, ocpp::v201::LocationEnum::EV);
+        sampled_soc_value.value = this->evse_soc_map[evse_id].value();
+        meter_value.sampledValue.push_back(sampled_soc_value);
+    }
+    this->charge_point->on_meter_value(evse_id, meter_value);
+}
+
 void OCPP201::publish_charging_schedules(const std::vector<ocpp::v201::CompositeSchedule>& composite_schedules) {
     const auto everest_schedules = conversions::to_everest_charging_schedules(composite_schedules);
     this->p_ocpp_generic->publish_charging_schedules(everest_schedules);
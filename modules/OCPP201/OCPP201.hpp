@@ -30,6 +30,7 @@
 // insert your custom include headers here
 #include <tuple>
 
+#include <meter_value_sampler.hpp>
 #include <ocpp/v201/charge_point.hpp>
 #include <transaction_handler.hpp>
 // ev@4bf81b14-a215-475c-a1d3-0a484ae48918:v1
@@ -47,6 +48,7 @@ struct Conf {
     int CompositeScheduleIntervalS;
     int RequestCompositeScheduleDurationS;
     std::string RequestCompositeScheduleUnit;
+    int MeterValueSampleIntervalMs;
 };
 
 class OCPP201 : public Everest::ModuleBase {
@@ -112,6 +114,7 @@ private:
     // ev@211cfdbe-f69a-4cd6-a4ec-f8aaa3d1b6c8:v1
     // insert your private definitions here
     std::unique_ptr<TransactionHandler> transaction_handler;
+    std::unique_ptr<MeterValueSampler> meter_value_sampler;
     Everest::SteadyTimer charging_schedules_timer;
 
     std::filesystem::path ocpp_share_path;
@@ -154,6 +157,10 @@ private:
     void process_deauthorized(const int32_t evse_id, const int32_t connector_id,
                               const types::evse_manager::SessionEvent& session_event);
 
+    /// \brief This function converts the given \p power_meter and passes it to the charge point as meter value of the
+    /// given \p evse_id
+    void publish_meter_value(const int32_t evse_id, const types::powermeter::Powermeter& power_meter);
+
     /// \brief This function publishes the given \p composite_schedules via the ocpp interface
     void publish_charging_schedules(const std::vector<ocpp::v201::CompositeSchedule>& composite_schedules);
 
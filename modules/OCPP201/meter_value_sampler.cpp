@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <meter_value_sampler.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace module {
+
+MeterValueSampler::MeterValueSampler(std::chrono::milliseconds interval, PublishCallback publish) :
+    interval(interval), publish(std::move(publish)) {
+}
+
+MeterValueSampler::~MeterValueSampler() {
+    this->stop();
+}
+
+void MeterValueSampler::start() {
+    if (this->interval.count() <= 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lk(this->thread_mutex);
+    if (this->running) {
+        return;
+    }
+    this->running = true;
+    this->thread = std::thread([this] { this->run(); });
+}
+
+void MeterValueSampler::stop() {
+    {
+        std::lock_guard<std::mutex> lk(this->thread_mutex);
+        this->running = false;
+    }
+    this->thread_cv.notify_all();
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+}
+
+void MeterValueSampler::update(int32_t evse_id, const types::powermeter::Powermeter& powermeter) {
+    if (this->interval.count() <= 0) {
+        this->publish(evse_id, powermeter);
+        return;
+    }
+    std::lock_guard<std::mutex> lk(this->buffer_mutex);
+    this->pending.insert_or_assign(evse_id, powermeter);
+}
+
+std::size_t MeterValueSampler::sample() {
+    std::map<int32_t, types::powermeter::Powermeter> values;
+    {
+        std::lock_guard<std::mutex> lk(this->buffer_mutex);
+        values.swap(this->pending);
+    }
+    // the publish callback may block on the OCPP stack, so it must not be called with the buffer locked
+    for (const auto& [evse_id, powermeter] : values) {
+        this->publish(evse_id, powermeter);
+    }
+    return values.size();
+}
+
+std::chrono::system_clock::time_point MeterValueSampler::next_sample_time(std::chrono::system_clock::time_point now,
+                                                                          std::chrono::milliseconds interval) {
+    const auto since_epoch = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch());
+    const auto next = (since_epoch / interval + 1) * interval;
+    return std::chrono::system_clock::time_point(next);
+}
+
+void MeterValueSampler::run() {
+    std::unique_lock<std::mutex> lk(this->thread_mutex);
+    while (this->running) {
+        // the sample times are aligned to the wall clock, but waiting on the steady clock keeps a clock adjustment
+        // from stalling or rushing the sampler
+        const auto now = std::chrono::system_clock::now();
+        const auto sample_time = next_sample_time(now, this->interval);
+        if (this->thread_cv.wait_for(lk, sample_time - now, [this] { return !this->running; })) {
+            break;
+        }
+        lk.unlock();
+        this->sample();
+        lk.lock();
+    }
+}
+
+} // namespace module
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <generated/types/powermeter.hpp>
+
+namespace module {
+
+/// \brief Buffers the latest powermeter value of every EVSE and hands them on at a fixed sample rate.
+///
+/// Powermeters may publish much faster than OCPP samples meter values. Instead of converting and forwarding every
+/// value on the publishing thread, update() only replaces the buffered value of the EVSE. A sampler thread wakes up at
+/// multiples of the sample interval on the system clock, so samples of all EVSEs line up, and passes every value that
+/// arrived since the previous sample to the publish callback in one batch.
+class MeterValueSampler {
+public:
+    using PublishCallback = std::function<void(int32_t evse_id, const types::powermeter::Powermeter& powermeter)>;
+
+    /// \brief Creates a sampler that calls \p publish for every sampled value. With an \p interval of zero, values
+    /// are passed on directly in update() and no sampler thread is started.
+    MeterValueSampler(std::chrono::milliseconds interval, PublishCallback publish);
+    ~MeterValueSampler();
+
+    MeterValueSampler(const MeterValueSampler&) = delete;
+    MeterValueSampler& operator=(const MeterValueSampler&) = delete;
+
+    /// \brief Starts the sampler thread, does nothing if the interval is zero or the thread is already running
+    void start();
+
+    /// \brief Stops the sampler thread. Values that have not been sampled yet stay buffered.
+    void stop();
+
+    /// \brief Replaces the buffered value of \p evse_id with \p powermeter
+    void update(int32_t evse_id, const types::powermeter::Powermeter& powermeter);
+
+    /// \brief Passes every value that has been updated since the previous sample to the publish callback
+    /// \returns the number of published values
+    std::size_t sample();
+
+    /// \brief Returns the first multiple of \p interval since the epoch that is later than \p now
+    static std::chrono::system_clock::time_point next_sample_time(std::chrono::system_clock::time_point now,
+                                                                  std::chrono::milliseconds interval);
+
+private:
+    const std::chrono::milliseconds interval;
+    const PublishCallback publish;
+
+    std::mutex buffer_mutex;
+    std::map<int32_t, types::powermeter::Powermeter> pending; ///< latest unsampled value by evse_id
+
+    std::mutex thread_mutex;
+    std::condition_variable thread_cv;
+    bool running{false};
+    std::thread thread;
+
+    void run();
+};
+
+} // namespace module
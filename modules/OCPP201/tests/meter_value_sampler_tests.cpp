@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include <meter_value_sampler.hpp>
+
+namespace module {
+
+namespace {
+types::powermeter::Powermeter powermeter(float energy_Wh) {
+    types::powermeter::Powermeter powermeter;
+    powermeter.timestamp = "2024-01-01T00:00:00.000Z";
+    powermeter.energy_Wh_import.total = energy_Wh;
+    return powermeter;
+}
+} // namespace
+
+class MeterValueSamplerTest : public ::testing::Test {
+protected:
+    std::vector<std::pair<int32_t, float>> published;
+
+    MeterValueSampler::PublishCallback publish_callback() {
+        return [this](int32_t evse_id, const types::powermeter::Powermeter& powermeter) {
+            this->published.emplace_back(evse_id, powermeter.energy_Wh_import.total);
+        };
+    }
+};
+
+TEST_F(MeterValueSamplerTest, test_zero_interval_publishes_immediately) {
+    MeterValueSampler sampler(std::chrono::milliseconds(0), publish_callback());
+    sampler.update(1, powermeter(1));
+    sampler.update(1, powermeter(2));
+
+    ASSERT_EQ(published.size(), 2);
+    EXPECT_EQ(published.at(1).second, 2);
+    EXPECT_EQ(sampler.sample(), 0);
+}
+
+TEST_F(MeterValueSamplerTest, test_sample_coalesces_to_latest_value) {
+    MeterValueSampler sampler(std::chrono::milliseconds(1000), publish_callback());
+    sampler.update(1, powermeter(1));
+    sampler.update(2, powermeter(10));
+    sampler.update(1, powermeter(2));
+    sampler.update(1, powermeter(3));
+    EXPECT_TRUE(published.empty());
+
+    EXPECT_EQ(sampler.sample(), 2);
+    ASSERT_EQ(published.size(), 2);
+    EXPECT_EQ(published.at(0), std::make_pair(int32_t{1}, 3.0f));
+    EXPECT_EQ(published.at(1), std::make_pair(int32_t{2}, 10.0f));
+}
+
+TEST_F(MeterValueSamplerTest, test_sample_skips_evses_without_new_values) {
+    MeterValueSampler sampler(std::chrono::milliseconds(1000), publish_callback());
+    sampler.update(1, powermeter(1));
+    sampler.update(2, powermeter(10));
+    EXPECT_EQ(sampler.sample(), 2);
+
+    sampler.update(2, powermeter(11));
+    EXPECT_EQ(sampler.sample(), 1);
+    EXPECT_EQ(sampler.sample(), 0);
+    ASSERT_EQ(published.size(), 3);
+    EXPECT_EQ(published.at(2), std::make_pair(int32_t{2}, 11.0f));
+}
+
+TEST_F(MeterValueSamplerTest, test_next_sample_time_is_aligned) {
+    using namespace std::chrono;
+    const auto interval = milliseconds(1000);
+    const system_clock::time_point now(milliseconds(12345));
+    EXPECT_EQ(MeterValueSampler::next_sample_time(now, interval), system_clock::time_point(milliseconds(13000)));
+
+    const system_clock::time_point on_boundary(milliseconds(13000));
+    EXPECT_EQ(MeterValueSampler::next_sample_time(on_boundary, interval),
+              system_clock::time_point(milliseconds(14000)));
+}
+
+TEST_F(MeterValueSamplerTest, test_sampler_thread_publishes) {
+    std::atomic<int> samples{0};
+    MeterValueSampler sampler(std::chrono::milliseconds(10),
+                              [&samples](int32_t, const types::powermeter::Powermeter&) { samples++; });
+    sampler.start();
+    sampler.update(1, powermeter(1));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (samples == 0 and std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    sampler.stop();
+    EXPECT_EQ(samples, 1);
+}
+
+} // namespace module
@@ -6,74 +6,50 @@
 
 namespace module {
 
-const bool PROMISC_MODE = true;
-const int PACKET_BUFFER_TIMEOUT_MS = 1000;
-const int ALL_PACKETS_PROCESSED = -1;
-const int WAIT_FOR_MS = 10;
-const int BUFFERSIZE = 8192;
+const int SNAP_LENGTH = 8192;
+const std::string CAPTURE_FILE_NAME = "ethernet-traffic.pcapng";
 
 void PacketSniffer::init() {
     invoke_init(*p_main);
 
-    p_handle = pcap_open_live(config.device.c_str(), BUFFERSIZE, PROMISC_MODE, PACKET_BUFFER_TIMEOUT_MS, errbuf);
-    if (p_handle == nullptr) {
-        EVLOG_error << fmt::format("Could not open device {}. Sniffing disabled.", config.device);
-        return;
-    }
-
-    if (pcap_datalink(p_handle) != DLT_EN10MB) {
-        EVLOG_error << fmt::format("Device {} doesn't provide Ethernet headers - not supported. Sniffing disabled.",
-                                   config.device);
+    SessionCapture::Config capture_config;
+    capture_config.device = config.device;
+    capture_config.filter = config.capture_filter;
+    capture_config.snap_length = SNAP_LENGTH;
+    capture_config.buffer_size = config.kernel_buffer_size_kB * 1024;
+    capture_config.ring_size = static_cast<std::size_t>(config.pre_trigger_buffer_size_kB) * 1024;
+    capture_config.pre_trigger = std::chrono::seconds(config.pre_trigger_s);
+    capture_config.max_disk_usage = static_cast<std::uintmax_t>(config.max_disk_usage_MB) * 1024 * 1024;
+
+    try {
+        session_capture = std::make_unique<SessionCapture>(capture_config);
+    } catch (const std::exception& e) {
+        EVLOG_error << fmt::format("{}. Sniffing disabled.", e.what());
         return;
     }
 
     r_evse_manager->subscribe_session_event([this](types::evse_manager::SessionEvent session_event) {
         if (session_event.event == types::evse_manager::SessionEventEnum::SessionStarted) {
-            if (!already_started) {
-
-                capturing_stopped = false;
-                if (session_event.session_started && session_event.session_started->logging_path) {
-                    std::thread(&PacketSniffer::capture, this, session_event.session_started->logging_path.value(),
-                                session_event.uuid)
-                        .detach();
-                }
+            if (session_event.session_started && session_event.session_started->logging_path) {
+                session_capture->start_session(
+                    std::filesystem::path(session_event.session_started->logging_path.value()) / CAPTURE_FILE_NAME);
             } else {
-                EVLOG_warning << fmt::format("Capturing already started. Ignoring this SessionStarted event");
+                session_capture->start_session(std::filesystem::path(config.session_logging_path) /
+                                               fmt::format("{}.pcapng", session_event.uuid));
             }
         } else if (session_event.event == types::evse_manager::SessionEventEnum::SessionFinished) {
-            capturing_stopped = true;
-            pcap_breakloop(p_handle);
+            session_capture->finish_session();
         }
     });
+
+    // a session that fails is written right away, in case it never finishes
+    r_evse_manager->subscribe_all_errors(
+        [this](const Everest::error::Error& error) { session_capture->write_session(); },
+        [](const Everest::error::Error& error) {});
 }
 
 void PacketSniffer::ready() {
     invoke_ready(*p_main);
 }
 
-void PacketSniffer::capture(const std::string& logpath, const std::string& session_id) {
-    already_started = true;
-    EVLOG_info << fmt::format("Start capturing");
-
-    const std::string fn = fmt::format("{}/ethernet-traffic.dump", logpath);
-
-    if ((pdumpfile = pcap_dump_open(p_handle, fn.c_str())) == nullptr) {
-        EVLOG_error << fmt::format("Error opening savefile {} for writing: {}", fn, pcap_geterr(p_handle));
-        return;
-    }
-
-    while (!capturing_stopped) {
-        if (pcap_dispatch(p_handle, ALL_PACKETS_PROCESSED, &pcap_dump, (u_char*)pdumpfile) <= PCAP_ERROR) {
-            EVLOG_error << fmt::format("Error reading packets from interface: {}, error: {}", config.device,
-                                       pcap_geterr(p_handle));
-            break;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_FOR_MS));
-    }
-
-    pcap_dump_close(pdumpfile);
-    EVLOG_info << fmt::format("Capturing stopped.");
-    already_started = false;
-}
-
 } // namespace module
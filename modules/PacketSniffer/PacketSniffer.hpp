@@ -18,7 +18,7 @@
 
 // ev@4bf81b14-a215-475c-a1d3-0a484ae48918:v1
 // insert your custom include headers here
-#include <pcap.h>
+#include "session_capture.hpp"
 // ev@4bf81b14-a215-475c-a1d3-0a484ae48918:v1
 
 namespace module {
@@ -26,6 +26,11 @@ namespace module {
 struct Conf {
     std::string device;
     std::string session_logging_path;
+    std::string capture_filter;
+    int kernel_buffer_size_kB;
+    int pre_trigger_buffer_size_kB;
+    int pre_trigger_s;
+    int max_disk_usage_MB;
 };
 
 class PacketSniffer : public Everest::ModuleBase {
@@ -55,12 +60,7 @@ private:
 
     // ev@211cfdbe-f69a-4cd6-a4ec-f8aaa3d1b6c8:v1
     // insert your private definitions here
-    void capture(const std::string& logpath, const std::string& session_id);
-    pcap_t* p_handle{nullptr};
-    pcap_dumper_t* pdumpfile{nullptr};
-    char errbuf[PCAP_ERRBUF_SIZE];
-    std::atomic_bool capturing_stopped{false};
-    std::atomic_bool already_started{false};
+    std::unique_ptr<SessionCapture> session_capture;
     // ev@211cfdbe-f69a-4cd6-a4ec-f8aaa3d1b6c8:v1
 };
 
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "capture_ring.hpp"
+
+#include <cstring>
+
+namespace packet_capture {
+
+CaptureRing::CaptureRing(std::size_t capacity) : buffer(capacity) {
+}
+
+bool CaptureRing::push(std::int64_t timestamp_ns, const std::uint8_t* data, std::uint32_t length,
+                       std::uint32_t original_length) {
+    if (length == 0 or length > buffer.size()) {
+        return false;
+    }
+
+    std::size_t offset = 0;
+    while (true) {
+        if (records.empty()) {
+            offset = 0;
+            break;
+        }
+
+        const auto tail = records.front().offset;
+        if (head > tail) {
+            // the packets are in [tail, head), the free space is behind them and in front of the oldest packet
+            if (buffer.size() - head >= length) {
+                offset = head;
+                break;
+            }
+            if (tail >= length) {
+                offset = 0;
+                break;
+            }
+        } else if (tail - head >= length) {
+            // wrapped around, the free space is between the newest and the oldest packet
+            offset = head;
+            break;
+        }
+
+        records.pop_front();
+        overwritten++;
+    }
+
+    std::memcpy(&buffer[offset], data, length);
+    records.push_back({offset, timestamp_ns, length, original_length});
+    head = offset + length;
+    return true;
+}
+
+void CaptureRing::drop_older_than(std::int64_t timestamp_ns) {
+    while (not records.empty() and records.front().timestamp_ns < timestamp_ns) {
+        records.pop_front();
+    }
+}
+
+void CaptureRing::clear() {
+    records.clear();
+    head = 0;
+}
+
+} // namespace packet_capture
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef PACKET_CAPTURE_CAPTURE_RING_HPP
+#define PACKET_CAPTURE_CAPTURE_RING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace packet_capture {
+
+struct PacketView {
+    // nanoseconds since the epoch
+    std::int64_t timestamp_ns;
+    const std::uint8_t* data;
+    std::uint32_t length;
+    // length on the wire, before the packet was cut to the snap length
+    std::uint32_t original_length;
+};
+
+// Keeps the most recent packets in one buffer that is allocated up front.
+//
+// Packets are stored back to back and never split at the end of the buffer. If there is no room for a new packet, the
+// oldest packets are dropped until there is, so capturing never allocates and the memory used is fixed.
+class CaptureRing {
+public:
+    explicit CaptureRing(std::size_t capacity);
+
+    // copies the packet into the ring, packets that are empty or larger than the ring are rejected
+    bool push(std::int64_t timestamp_ns, const std::uint8_t* data, std::uint32_t length,
+              std::uint32_t original_length);
+
+    // drops the packets captured before timestamp_ns
+    void drop_older_than(std::int64_t timestamp_ns);
+
+    void clear();
+
+    // calls handler with the packets captured at or after timestamp_ns, oldest first
+    template <typename Handler> void for_each_since(std::int64_t timestamp_ns, Handler&& handler) const {
+        for (const auto& record : records) {
+            if (record.timestamp_ns >= timestamp_ns) {
+                handler(PacketView{record.timestamp_ns, &buffer[record.offset], record.length, record.original_length});
+            }
+        }
+    }
+
+    std::size_t size() const {
+        return records.size();
+    }
+
+    // number of packets that were dropped because the ring was full
+    std::uint64_t get_overwritten() const {
+        return overwritten;
+    }
+
+private:
+    struct Record {
+        std::size_t offset;
+        std::int64_t timestamp_ns;
+        std::uint32_t length;
+        std::uint32_t original_length;
+    };
+
+    std::vector<std::uint8_t> buffer;
+    std::deque<Record> records;
+    // where the next packet goes, one past the newest packet
+    std::size_t head{0};
+    std::uint64_t overwritten{0};
+};
+
+} // namespace packet_capture
+
+#endif // PACKET_CAPTURE_CAPTURE_RING_HPP
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "pcapng.hpp"
+
+#include <cstring>
+
+namespace packet_capture::pcapng {
+
+namespace {
+
+constexpr std::uint32_t SECTION_HEADER_BLOCK = 0x0A0D0D0A;
+constexpr std::uint32_t INTERFACE_DESCRIPTION_BLOCK = 0x00000001;
+constexpr std::uint32_t ENHANCED_PACKET_BLOCK = 0x00000006;
+constexpr std::uint32_t BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+constexpr std::uint16_t OPTION_END = 0;
+constexpr std::uint16_t OPTION_IF_TSRESOL = 9;
+// 10^-9 seconds
+constexpr std::uint8_t TSRESOL_NANOSECONDS = 9;
+
+template <typename T> void append(std::vector<std::uint8_t>& out, T value) {
+    const auto offset = out.size();
+    out.resize(offset + sizeof(T));
+    std::memcpy(&out[offset], &value, sizeof(T));
+}
+
+} // namespace
+
+void append_file_header(std::vector<std::uint8_t>& out, std::uint16_t link_type, std::uint32_t snap_length) {
+    append<std::uint32_t>(out, SECTION_HEADER_BLOCK);
+    append<std::uint32_t>(out, 28);
+    append<std::uint32_t>(out, BYTE_ORDER_MAGIC);
+    append<std::uint16_t>(out, 1);
+    append<std::uint16_t>(out, 0);
+    // section length is not known
+    append<std::int64_t>(out, -1);
+    append<std::uint32_t>(out, 28);
+
+    append<std::uint32_t>(out, INTERFACE_DESCRIPTION_BLOCK);
+    append<std::uint32_t>(out, 32);
+    append<std::uint16_t>(out, link_type);
+    append<std::uint16_t>(out, 0);
+    append<std::uint32_t>(out, snap_length);
+    append<std::uint16_t>(out, OPTION_IF_TSRESOL);
+    append<std::uint16_t>(out, 1);
+    // option value padded to 32 bits
+    append<std::uint8_t>(out, TSRESOL_NANOSECONDS);
+    append<std::uint8_t>(out, 0);
+    append<std::uint16_t>(out, 0);
+    append<std::uint16_t>(out, OPTION_END);
+    append<std::uint16_t>(out, 0);
+    append<std::uint32_t>(out, 32);
+}
+
+void append_packet(std::vector<std::uint8_t>& out, const PacketView& packet) {
+    const auto block_length = static_cast<std::uint32_t>(packet_size(packet.length));
+    const auto timestamp = static_cast<std::uint64_t>(packet.timestamp_ns);
+
+    append<std::uint32_t>(out, ENHANCED_PACKET_BLOCK);
+    append<std::uint32_t>(out, block_length);
+    // interface id
+    append<std::uint32_t>(out, 0);
+    append<std::uint32_t>(out, static_cast<std::uint32_t>(timestamp >> 32));
+    append<std::uint32_t>(out, static_cast<std::uint32_t>(timestamp));
+    append<std::uint32_t>(out, packet.length);
+    append<std::uint32_t>(out, packet.original_length);
+
+    // packet data padded to 32 bits
+    const auto offset = out.size();
+    out.resize(offset + block_length - 32, 0);
+    std::memcpy(&out[offset], packet.data, packet.length);
+
+    append<std::uint32_t>(out, block_length);
+}
+
+} // namespace packet_capture::pcapng
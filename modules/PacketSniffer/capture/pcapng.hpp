@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef PACKET_CAPTURE_PCAPNG_HPP
+#define PACKET_CAPTURE_PCAPNG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "capture_ring.hpp"
+
+// Serialization of pcapng files with a single interface, in host byte order.
+// See https://www.ietf.org/archive/id/draft-ietf-opsawg-pcapng-02.html
+namespace packet_capture::pcapng {
+
+// section header and the description of the one interface, with nanosecond timestamps
+void append_file_header(std::vector<std::uint8_t>& out, std::uint16_t link_type, std::uint32_t snap_length);
+
+void append_packet(std::vector<std::uint8_t>& out, const PacketView& packet);
+
+constexpr std::size_t file_header_size() {
+    return 28 + 32;
+}
+
+constexpr std::size_t packet_size(std::uint32_t length) {
+    return 32 + ((length + 3) & ~std::size_t{3});
+}
+
+} // namespace packet_capture::pcapng
+
+#endif // PACKET_CAPTURE_PCAPNG_HPP
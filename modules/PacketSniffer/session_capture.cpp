@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "session_capture.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <fmt/core.h>
+
+#include <everest/logging.hpp>
+
+#include <pcapng.hpp>
+
+namespace module {
+
+namespace {
+const bool PROMISC_MODE = true;
+// a block of the kernel ring is handed over once it is full or after this timeout
+const int BLOCK_TIMEOUT_MS = 250;
+// long enough for the last packets of a session to leave the kernel ring
+const auto WRITE_DELAY = std::chrono::seconds(2);
+const int POLL_TIMEOUT_MS = 500;
+const int ALL_PACKETS_PROCESSED = -1;
+const std::uint16_t LINKTYPE_ETHERNET = 1;
+
+std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+} // namespace
+
+SessionCapture::SessionCapture(const Config& config_) : config(config_), ring(config_.ring_size) {
+    char errbuf[PCAP_ERRBUF_SIZE];
+    handle = pcap_create(config.device.c_str(), errbuf);
+    if (handle == nullptr) {
+        throw std::runtime_error(fmt::format("Could not open device {}: {}", config.device, errbuf));
+    }
+
+    const auto fail = [this](const std::string& message) {
+        pcap_close(handle);
+        throw std::runtime_error(message);
+    };
+
+    pcap_set_snaplen(handle, config.snap_length);
+    pcap_set_promisc(handle, PROMISC_MODE);
+    pcap_set_timeout(handle, BLOCK_TIMEOUT_MS);
+    pcap_set_buffer_size(handle, config.buffer_size);
+    nanosecond_timestamps = pcap_set_tstamp_precision(handle, PCAP_TSTAMP_PRECISION_NANO) == 0;
+
+    const auto status = pcap_activate(handle);
+    if (status < 0) {
+        fail(fmt::format("Could not activate capturing on device {}: {}", config.device, pcap_geterr(handle)));
+    }
+
+    if (pcap_datalink(handle) != DLT_EN10MB) {
+        fail(fmt::format("Device {} doesn't provide Ethernet headers - not supported.", config.device));
+    }
+
+    struct bpf_program program;
+    if (pcap_compile(handle, &program, config.filter.c_str(), 1, PCAP_NETMASK_UNKNOWN) != 0) {
+        fail(fmt::format("Invalid capture filter '{}': {}", config.filter, pcap_geterr(handle)));
+    }
+    const auto filter_set = pcap_setfilter(handle, &program) == 0;
+    pcap_freecode(&program);
+    if (not filter_set) {
+        fail(fmt::format("Could not set capture filter on device {}: {}", config.device, pcap_geterr(handle)));
+    }
+
+    if (pcap_setnonblock(handle, 1, errbuf) != 0) {
+        fail(fmt::format("Could not set device {} to non blocking: {}", config.device, errbuf));
+    }
+
+    wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd == -1) {
+        fail("Could not create eventfd for the capture thread");
+    }
+
+    capture_thread = std::thread(&SessionCapture::capture_loop, this);
+    writer_thread = std::thread(&SessionCapture::writer_loop, this);
+}
+
+SessionCapture::~SessionCapture() {
+    {
+        std::lock_guard<std::mutex> lock(command_mutex);
+        running = false;
+    }
+    const std::uint64_t wakeup = 1;
+    write(wakeup_fd, &wakeup, sizeof(wakeup));
+    capture_thread.join();
+
+    {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        writer_running = false;
+    }
+    file_cv.notify_one();
+    writer_thread.join();
+
+    pcap_close(handle);
+    close(wakeup_fd);
+}
+
+void SessionCapture::start_session(const std::filesystem::path& file_name) {
+    post({Command::Type::Start, file_name});
+}
+
+void SessionCapture::write_session() {
+    post({Command::Type::Write, {}});
+}
+
+void SessionCapture::finish_session() {
+    post({Command::Type::Finish, {}});
+}
+
+void SessionCapture::post(Command command) {
+    {
+        std::lock_guard<std::mutex> lock(command_mutex);
+        commands.push_back(std::move(command));
+    }
+    const std::uint64_t wakeup = 1;
+    write(wakeup_fd, &wakeup, sizeof(wakeup));
+}
+
+void SessionCapture::capture_loop() {
+    struct pollfd fds[2] = {
+        {pcap_get_selectable_fd(handle), POLLIN, 0},
+        {wakeup_fd, POLLIN, 0},
+    };
+
+    const auto on_packet = [](u_char* user, const struct pcap_pkthdr* header, const u_char* data) {
+        reinterpret_cast<SessionCapture*>(user)->handle_packet(header, data);
+    };
+
+    while (true) {
+        poll(fds, 2, POLL_TIMEOUT_MS);
+        if (fds[1].revents & POLLIN) {
+            std::uint64_t wakeups;
+            read(wakeup_fd, &wakeups, sizeof(wakeups));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(command_mutex);
+            if (not running) {
+                break;
+            }
+        }
+
+        // the packets are read in place from the kernel ring
+        if (pcap_dispatch(handle, ALL_PACKETS_PROCESSED, on_packet, reinterpret_cast<u_char*>(this)) == PCAP_ERROR) {
+            EVLOG_error << fmt::format("Error reading packets from interface: {}, error: {}", config.device,
+                                       pcap_geterr(handle));
+            break;
+        }
+
+        handle_commands();
+
+        if (session.has_value() and session->write_at.has_value() and
+            std::chrono::steady_clock::now() >= session->write_at.value()) {
+            write_session_file(session.value());
+            if (session->finished) {
+                session.reset();
+            } else {
+                session->write_at.reset();
+            }
+        }
+
+        if (not session.has_value()) {
+            ring.drop_older_than(now_ns() - std::chrono::nanoseconds(config.pre_trigger).count());
+        }
+    }
+
+    // don't lose a session that has finished already
+    if (session.has_value() and session->write_at.has_value()) {
+        write_session_file(session.value());
+    }
+}
+
+void SessionCapture::handle_commands() {
+    std::vector<Command> pending;
+    {
+        std::lock_guard<std::mutex> lock(command_mutex);
+        pending.swap(commands);
+    }
+
+    const auto write_at = std::chrono::steady_clock::now() + WRITE_DELAY;
+    for (auto& command : pending) {
+        switch (command.type) {
+        case Command::Type::Start:
+            if (session.has_value() and not session->finished) {
+                EVLOG_warning << "Capturing already started. Ignoring this SessionStarted event";
+                break;
+            }
+            if (session.has_value()) {
+                // the previous session ended just now, it misses at most the packets of the last block
+                write_session_file(session.value());
+            }
+            EVLOG_info << "Start capturing";
+            session.emplace();
+            session->file_name = std::move(command.file_name);
+            session->start_ns = now_ns() - std::chrono::nanoseconds(config.pre_trigger).count();
+            session->overwritten_at_start = ring.get_overwritten();
+            break;
+        case Command::Type::Write:
+            if (session.has_value() and not session->write_at.has_value()) {
+                session->write_at = write_at;
+            }
+            break;
+        case Command::Type::Finish:
+            if (session.has_value() and not session->finished) {
+                EVLOG_info << "Capturing stopped.";
+                session->finished = true;
+                session->write_at = write_at;
+            }
+            break;
+        }
+    }
+}
+
+void SessionCapture::handle_packet(const struct pcap_pkthdr* header, const u_char* data) {
+    const auto fraction_ns = nanosecond_timestamps ? header->ts.tv_usec : header->ts.tv_usec * 1000;
+    const auto timestamp_ns = static_cast<std::int64_t>(header->ts.tv_sec) * 1000000000 + fraction_ns;
+    ring.push(timestamp_ns, data, header->caplen, header->len);
+}
+
+void SessionCapture::write_session_file(const Session& session) {
+    namespace pcapng = packet_capture::pcapng;
+
+    std::size_t packets = 0;
+    std::uintmax_t size = 0;
+    ring.for_each_since(session.start_ns, [&packets, &size](const packet_capture::PacketView& packet) {
+        packets++;
+        size += pcapng::packet_size(packet.length);
+    });
+
+    // keep the end of the session, that is where it failed
+    const std::uintmax_t header_size = pcapng::file_header_size();
+    const auto budget = config.max_disk_usage - std::min(config.max_disk_usage, header_size);
+    const auto skip = size - std::min(size, budget);
+
+    const auto overwritten = ring.get_overwritten() - session.overwritten_at_start;
+    if (overwritten > 0 or skip > 0) {
+        EVLOG_warning << fmt::format("The capture of the session is incomplete, the beginning did not fit into the "
+                                     "capture buffer or the maximum disk usage");
+    }
+
+    FileJob job{session.file_name, {}};
+    job.data.reserve(header_size + size - skip);
+    pcapng::append_file_header(job.data, LINKTYPE_ETHERNET, config.snap_length);
+    std::uintmax_t skipped = 0;
+    ring.for_each_since(session.start_ns, [&job, &skipped, skip](const packet_capture::PacketView& packet) {
+        if (skipped < skip) {
+            skipped += pcapng::packet_size(packet.length);
+            return;
+        }
+        pcapng::append_packet(job.data, packet);
+    });
+
+    EVLOG_debug << fmt::format("Writing {} packets to {}", packets, session.file_name.string());
+    {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        file_jobs.push_back(std::move(job));
+    }
+    file_cv.notify_one();
+}
+
+void SessionCapture::writer_loop() {
+    std::unique_lock<std::mutex> lock(file_mutex);
+    while (true) {
+        file_cv.wait(lock, [this]() { return not writer_running or not file_jobs.empty(); });
+        if (file_jobs.empty()) {
+            break;
+        }
+
+        auto job = std::move(file_jobs.front());
+        file_jobs.pop_front();
+        lock.unlock();
+        write_file(job);
+        lock.lock();
+    }
+}
+
+void SessionCapture::write_file(const FileJob& job) {
+    // a session that is written again replaces its earlier file
+    const auto previous = std::find_if(written_files.begin(), written_files.end(),
+                                       [&job](const auto& file) { return file.first == job.file_name; });
+    if (previous != written_files.end()) {
+        disk_usage -= previous->second;
+        written_files.erase(previous);
+    }
+
+    while (not written_files.empty() and disk_usage + job.data.size() > config.max_disk_usage) {
+        std::error_code ec;
+        std::filesystem::remove(written_files.front().first, ec);
+        disk_usage -= written_files.front().second;
+        written_files.pop_front();
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(job.file_name.parent_path(), ec);
+    std::ofstream file(job.file_name, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(job.data.data()), job.data.size());
+    file.close();
+    if (not file) {
+        EVLOG_error << fmt::format("Error writing capture file {}", job.file_name.string());
+        return;
+    }
+
+    written_files.emplace_back(job.file_name, job.data.size());
+    disk_usage += job.data.size();
+}
+
+} // namespace module
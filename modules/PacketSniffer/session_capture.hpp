@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef SESSION_CAPTURE_HPP
+#define SESSION_CAPTURE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pcap.h>
+
+#include <capture_ring.hpp>
+
+namespace module {
+
+// Captures the traffic of the device all the time and writes the packets of a session to a pcapng file once the
+// session is over.
+//
+// libpcap reads from the memory mapped TPACKET_V3 ring of the kernel and hands out the packets in place, a BPF filter
+// in the kernel keeps everything but the configured traffic out of it. The capture thread copies the packets once, into
+// a ring of fixed size that holds the last pre_trigger seconds while no session is running and everything from
+// pre_trigger before its start during a session. Writing the file happens on a separate thread, the files written are
+// deleted oldest first to stay below the maximum disk usage.
+class SessionCapture {
+public:
+    struct Config {
+        std::string device;
+        std::string filter;
+        int snap_length;
+        // size of the kernel ring
+        int buffer_size;
+        std::size_t ring_size;
+        std::chrono::seconds pre_trigger;
+        std::uintmax_t max_disk_usage;
+    };
+
+    // throws std::runtime_error if the device cannot be captured on
+    explicit SessionCapture(const Config& config);
+    ~SessionCapture();
+
+    void start_session(const std::filesystem::path& file_name);
+    // writes what has been captured of the running session so far, e.g. after an error
+    void write_session();
+    void finish_session();
+
+private:
+    struct Command {
+        enum class Type {
+            Start,
+            Write,
+            Finish,
+        } type;
+        std::filesystem::path file_name;
+    };
+
+    struct FileJob {
+        std::filesystem::path file_name;
+        std::vector<std::uint8_t> data;
+    };
+
+    struct Session {
+        std::filesystem::path file_name;
+        std::int64_t start_ns{0};
+        std::uint64_t overwritten_at_start{0};
+        // set once the session has finished or is to be written because of an error, the file is written at this time
+        std::optional<std::chrono::steady_clock::time_point> write_at;
+        bool finished{false};
+    };
+
+    void post(Command command);
+    void capture_loop();
+    void handle_commands();
+    void handle_packet(const struct pcap_pkthdr* header, const u_char* data);
+    void write_session_file(const Session& session);
+
+    void writer_loop();
+    void write_file(const FileJob& job);
+
+    const Config config;
+    pcap_t* handle{nullptr};
+    bool nanosecond_timestamps{false};
+    int wakeup_fd{-1};
+
+    // only accessed by the capture thread
+    packet_capture::CaptureRing ring;
+    std::optional<Session> session;
+
+    std::mutex command_mutex;
+    std::vector<Command> commands;
+    bool running{true};
+
+    std::mutex file_mutex;
+    std::condition_variable file_cv;
+    std::deque<FileJob> file_jobs;
+    bool writer_running{true};
+    // only accessed by the writer thread, the files written so far and their sizes
+    std::deque<std::pair<std::filesystem::path, std::uintmax_t>> written_files;
+    std::uintmax_t disk_usage{0};
+
+    std::thread capture_thread;
+    std::thread writer_thread;
+};
+
+} // namespace module
+
+#endif // SESSION_CAPTURE_HPP
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include <capture_ring.hpp>
+#include <pcapng.hpp>
+
+namespace {
+
+using namespace packet_capture;
+
+std::vector<std::uint8_t> make_packet(std::size_t length, std::uint8_t fill) {
+    return std::vector<std::uint8_t>(length, fill);
+}
+
+struct Collected {
+    std::int64_t timestamp_ns;
+    std::vector<std::uint8_t> data;
+};
+
+std::vector<Collected> collect(const CaptureRing& ring, std::int64_t since = 0) {
+    std::vector<Collected> packets;
+    ring.for_each_since(since, [&packets](const PacketView& packet) {
+        packets.push_back({packet.timestamp_ns, std::vector<std::uint8_t>(packet.data, packet.data + packet.length)});
+    });
+    return packets;
+}
+
+TEST(CaptureRing, keeps_packets_in_order) {
+    CaptureRing ring(1000);
+    for (int i = 0; i < 5; ++i) {
+        const auto packet = make_packet(100, i);
+        EXPECT_TRUE(ring.push(i, packet.data(), packet.size(), packet.size()));
+    }
+
+    const auto packets = collect(ring);
+    ASSERT_EQ(packets.size(), 5);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(packets[i].timestamp_ns, i);
+        EXPECT_EQ(packets[i].data, make_packet(100, i));
+    }
+    EXPECT_EQ(ring.get_overwritten(), 0);
+}
+
+TEST(CaptureRing, overwrites_oldest_packets_when_full) {
+    CaptureRing ring(1000);
+    for (int i = 0; i < 25; ++i) {
+        // sizes that don't divide the capacity, so packets wrap around at different positions
+        const auto packet = make_packet(90 + i % 3 * 40, i);
+        ASSERT_TRUE(ring.push(i, packet.data(), packet.size(), 1500));
+    }
+
+    const auto packets = collect(ring);
+    ASSERT_FALSE(packets.empty());
+    EXPECT_EQ(packets.size() + ring.get_overwritten(), 25);
+
+    std::size_t used = 0;
+    for (std::size_t i = 0; i < packets.size(); ++i) {
+        const int expected = 25 - packets.size() + i;
+        EXPECT_EQ(packets[i].timestamp_ns, expected);
+        EXPECT_EQ(packets[i].data, make_packet(90 + expected % 3 * 40, expected));
+        used += packets[i].data.size();
+    }
+    EXPECT_LE(used, 1000);
+}
+
+TEST(CaptureRing, rejects_packets_larger_than_ring) {
+    CaptureRing ring(100);
+    const auto packet = make_packet(101, 0);
+    EXPECT_FALSE(ring.push(0, packet.data(), packet.size(), packet.size()));
+    EXPECT_FALSE(ring.push(0, packet.data(), 0, 0));
+    EXPECT_EQ(ring.size(), 0);
+}
+
+TEST(CaptureRing, drops_by_age_and_selects_by_time) {
+    CaptureRing ring(1000);
+    for (int i = 0; i < 6; ++i) {
+        const auto packet = make_packet(10, i);
+        ring.push(i * 10, packet.data(), packet.size(), packet.size());
+    }
+
+    EXPECT_EQ(collect(ring, 30).size(), 3);
+
+    ring.drop_older_than(20);
+    const auto packets = collect(ring);
+    ASSERT_EQ(packets.size(), 4);
+    EXPECT_EQ(packets.front().timestamp_ns, 20);
+    // dropping by age doesn't count as overwritten
+    EXPECT_EQ(ring.get_overwritten(), 0);
+}
+
+TEST(Pcapng, file_layout) {
+    std::vector<std::uint8_t> file;
+    pcapng::append_file_header(file, 1, 8192);
+    ASSERT_EQ(file.size(), pcapng::file_header_size());
+
+    const auto data = make_packet(61, 0xab);
+    const std::int64_t timestamp_ns = 1700000000123456789;
+    pcapng::append_packet(file, {timestamp_ns, data.data(), 61, 1514});
+    ASSERT_EQ(file.size(), pcapng::file_header_size() + pcapng::packet_size(61));
+    EXPECT_EQ(pcapng::packet_size(61), 32 + 64);
+
+    const auto read_u32 = [&file](std::size_t offset) {
+        std::uint32_t value;
+        std::memcpy(&value, &file[offset], sizeof(value));
+        return value;
+    };
+
+    // section header block with byte order magic, interface description block
+    EXPECT_EQ(read_u32(0), 0x0A0D0D0A);
+    EXPECT_EQ(read_u32(8), 0x1A2B3C4D);
+    EXPECT_EQ(read_u32(28), 1);
+    EXPECT_EQ(read_u32(28 + 4), 32);
+    EXPECT_EQ(read_u32(28 + 28), 32);
+
+    // enhanced packet block, with block length repeated at the end
+    const auto block = pcapng::file_header_size();
+    EXPECT_EQ(read_u32(block), 6);
+    EXPECT_EQ(read_u32(block + 4), 96);
+    const auto timestamp = (static_cast<std::uint64_t>(read_u32(block + 12)) << 32) | read_u32(block + 16);
+    EXPECT_EQ(timestamp, timestamp_ns);
+    EXPECT_EQ(read_u32(block + 20), 61);
+    EXPECT_EQ(read_u32(block + 24), 1514);
+    EXPECT_EQ(file[block + 28], 0xab);
+    EXPECT_EQ(file[block + 28 + 60], 0xab);
+    EXPECT_EQ(file[block + 28 + 61], 0);
+    EXPECT_EQ(read_u32(block + 92), 96);
+}
+
+} // namespace
@@ -0,0 +1,403 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "KvsDatabase.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include <everest/logging.hpp>
+
+namespace fs = std::filesystem;
+
+namespace module {
+
+namespace {
+const std::array<std::string, 4> SYNCHRONOUS_LEVELS = {"OFF", "NORMAL", "FULL", "EXTRA"};
+
+class TypeNameVisitor {
+public:
+    std::string operator()(std::nullptr_t t) const {
+        return "nullptr_t";
+    }
+
+    std::string operator()(const Array& t) const {
+        return "Array";
+    }
+
+    std::string operator()(const Object& t) const {
+        return "Object";
+    }
+
+    std::string operator()(const bool& t) const {
+        return "bool";
+    }
+
+    std::string operator()(const double& t) const {
+        return "double";
+    }
+
+    std::string operator()(const int& t) const {
+        return "int";
+    }
+
+    std::string operator()(const std::string& t) const {
+        return "std::string";
+    }
+};
+
+class StringValueVisitor {
+public:
+    std::string operator()(std::nullptr_t t) const {
+        return "";
+    }
+
+    std::string operator()(const Array& t) const {
+        json a = t;
+        return a.dump();
+    }
+
+    std::string operator()(const Object& t) const {
+        json o = t;
+        return o.dump();
+    }
+
+    std::string operator()(bool t) const {
+        if (t) {
+            return "true";
+        }
+        return "false";
+    }
+
+    std::string operator()(double t) const {
+        return std::to_string(t);
+    }
+
+    std::string operator()(int t) const {
+        return std::to_string(t);
+    }
+
+    std::string operator()(const std::string& t) const {
+        return t;
+    }
+};
+
+KvsValue parse_value(const std::string& value_str, const std::string& type_str) {
+    if (type_str == "Array") {
+        Array value_array = json::parse(value_str);
+        return value_array;
+    } else if (type_str == "Object") {
+        Object value_object = json::parse(value_str);
+        return value_object;
+    } else if (type_str == "bool") {
+        return value_str == "true";
+    } else if (type_str == "double") {
+        return std::stod(value_str);
+    } else if (type_str == "int") {
+        return std::stoi(value_str);
+    } else if (type_str == "std::string") {
+        return value_str;
+    }
+    return {};
+}
+
+void step_done(sqlite3* db, sqlite3_stmt* statement, const char* error_message) {
+    const int res = sqlite3_step(statement);
+    if (res != SQLITE_DONE) {
+        EVLOG_error << error_message << ": " << res << " " << sqlite3_errmsg(db);
+        throw std::runtime_error("PersistentStore db access error");
+    }
+}
+} // namespace
+
+KvsDatabase::Statement::Statement(sqlite3* db, const std::string& sql) {
+    if (sqlite3_prepare_v3(db, sql.c_str(), static_cast<int>(sql.size()), SQLITE_PREPARE_PERSISTENT,
+                           &this->statement, nullptr) != SQLITE_OK) {
+        EVLOG_error << "Could not prepare statement '" << sql << "': " << sqlite3_errmsg(db);
+        throw std::runtime_error("PersistentStore db access error");
+    }
+}
+
+KvsDatabase::Statement::~Statement() {
+    (void)sqlite3_finalize(this->statement);
+}
+
+sqlite3_stmt* KvsDatabase::Statement::reuse() {
+    sqlite3_reset(this->statement);
+    sqlite3_clear_bindings(this->statement);
+    return this->statement;
+}
+
+KvsDatabase::KvsDatabase(const fs::path& database_path, const std::string& synchronous,
+                         std::chrono::milliseconds commit_interval, std::size_t cache_size) :
+    commit_interval(commit_interval), cache_size(cache_size) {
+    if (std::find(SYNCHRONOUS_LEVELS.begin(), SYNCHRONOUS_LEVELS.end(), synchronous) == SYNCHRONOUS_LEVELS.end()) {
+        throw std::invalid_argument("Invalid PersistentStore synchronous level: " + synchronous);
+    }
+
+    const fs::path database_directory = database_path.parent_path();
+    if (!fs::exists(database_directory)) {
+        fs::create_directories(database_directory);
+    }
+
+    if (sqlite3_open(database_path.c_str(), &this->db) != SQLITE_OK) {
+        EVLOG_error << "Error opening PersistentStore database '" << database_path << "': " << sqlite3_errmsg(db);
+        sqlite3_close(this->db);
+        throw std::runtime_error("Could not open PersistentStore database at provided path.");
+    }
+
+    EVLOG_debug << "Using SQLite version " << sqlite3_libversion();
+
+    try {
+        // with WAL a commit appends to the log instead of rewriting pages in place,
+        // with synchronous=NORMAL the log is only synced on checkpoints
+        this->execute("PRAGMA journal_mode=WAL");
+        this->execute("PRAGMA synchronous=" + synchronous);
+        this->execute("CREATE TABLE IF NOT EXISTS KVS ("
+                      "KEY   TEXT UNIQUE,"
+                      "VALUE TEXT,"
+                      "TYPE  TEXT);");
+
+        this->insert_statement =
+            std::make_unique<Statement>(this->db, "INSERT OR REPLACE INTO KVS (KEY, VALUE, TYPE) VALUES "
+                                                  "(@key, @value, @type)");
+        this->select_statement = std::make_unique<Statement>(this->db, "SELECT VALUE, TYPE FROM KVS WHERE KEY = @key");
+        this->delete_statement = std::make_unique<Statement>(this->db, "DELETE FROM KVS WHERE KEY = @key");
+        this->begin_statement = std::make_unique<Statement>(this->db, "BEGIN");
+        this->commit_statement = std::make_unique<Statement>(this->db, "COMMIT");
+        this->rollback_statement = std::make_unique<Statement>(this->db, "ROLLBACK");
+    } catch (...) {
+        this->insert_statement.reset();
+        this->select_statement.reset();
+        this->delete_statement.reset();
+        this->begin_statement.reset();
+        this->commit_statement.reset();
+        this->rollback_statement.reset();
+        sqlite3_close(this->db);
+        throw;
+    }
+
+    if (this->commit_interval.count() > 0) {
+        this->writer_thread = std::thread([this]() { this->writer_loop(); });
+    }
+}
+
+KvsDatabase::~KvsDatabase() {
+    {
+        std::lock_guard<std::mutex> lock(this->state_mutex);
+        this->shutting_down = true;
+    }
+    this->writer_cv.notify_all();
+    if (this->writer_thread.joinable()) {
+        this->writer_thread.join();
+    }
+    try {
+        this->commit_pending();
+    } catch (const std::exception& e) {
+        EVLOG_error << "Could not write pending PersistentStore changes: " << e.what();
+    }
+    // statements have to be finalized before the connection can be closed
+    this->insert_statement.reset();
+    this->select_statement.reset();
+    this->delete_statement.reset();
+    this->begin_statement.reset();
+    this->commit_statement.reset();
+    this->rollback_statement.reset();
+    sqlite3_close(this->db);
+}
+
+void KvsDatabase::execute(const std::string& sql) {
+    char* error_message = nullptr;
+    if (sqlite3_exec(this->db, sql.c_str(), nullptr, nullptr, &error_message) != SQLITE_OK) {
+        EVLOG_error << "Could not execute '" << sql << "': " << (error_message != nullptr ? error_message : "");
+        sqlite3_free(error_message);
+        throw std::runtime_error("PersistentStore db access error");
+    }
+}
+
+std::optional<KvsDatabase::CacheEntry> KvsDatabase::lookup_cache(const std::string& key) {
+    std::lock_guard<std::mutex> lock(this->state_mutex);
+    // a write that is not committed yet is newer than anything cached or in the database
+    const auto pending_it = this->pending.find(key);
+    if (pending_it != this->pending.end()) {
+        return pending_it->second;
+    }
+    const auto it = this->cache_index.find(key);
+    if (it == this->cache_index.end()) {
+        return std::nullopt;
+    }
+    this->cache.splice(this->cache.end(), this->cache, it->second);
+    return it->second->second;
+}
+
+void KvsDatabase::cache_value(const std::string& key, const KvsValue& value) {
+    if (this->cache_size == 0) {
+        return;
+    }
+    const auto it = this->cache_index.find(key);
+    if (it != this->cache_index.end()) {
+        it->second->second = value;
+        this->cache.splice(this->cache.end(), this->cache, it->second);
+        return;
+    }
+    this->cache_index.emplace(key, this->cache.emplace(this->cache.end(), key, value));
+    if (this->cache.size() > this->cache_size) {
+        this->cache_index.erase(this->cache.front().first);
+        this->cache.pop_front();
+    }
+}
+
+void KvsDatabase::uncache(const std::string& key) {
+    const auto it = this->cache_index.find(key);
+    if (it != this->cache_index.end()) {
+        this->cache.erase(it->second);
+        this->cache_index.erase(it);
+    }
+}
+
+KvsDatabase::CacheEntry KvsDatabase::read_from_database(const std::string& key) {
+    std::uint64_t write_count_before_read;
+    {
+        std::lock_guard<std::mutex> lock(this->state_mutex);
+        write_count_before_read = this->write_count;
+    }
+
+    std::lock_guard<std::mutex> db_lock(this->db_mutex);
+    sqlite3_stmt* statement = this->select_statement->reuse();
+    sqlite3_bind_text(statement, 1, key.c_str(), -1, SQLITE_STATIC);
+
+    CacheEntry entry;
+    const int res = sqlite3_step(statement);
+    if (res == SQLITE_ROW) {
+        KvsValue value;
+        const auto value_ptr = sqlite3_column_text(statement, 0);
+        const auto type_ptr = sqlite3_column_text(statement, 1);
+        if (value_ptr != nullptr && type_ptr != nullptr) {
+            value = parse_value(reinterpret_cast<const char*>(value_ptr), reinterpret_cast<const char*>(type_ptr));
+        }
+        entry = std::move(value);
+    } else if (res != SQLITE_DONE) {
+        EVLOG_error << "Could not select from KVS table: " << res << " " << sqlite3_errmsg(this->db);
+        throw std::runtime_error("PersistentStore db access error");
+    }
+    sqlite3_reset(statement);
+
+    std::lock_guard<std::mutex> lock(this->state_mutex);
+    // a store or delete of this key that happened meanwhile is newer than what was read
+    const auto pending_it = this->pending.find(key);
+    if (pending_it != this->pending.end()) {
+        return pending_it->second;
+    }
+    // misses aren't cached, so that looking up arbitrary keys can't grow the cache
+    if (entry.has_value() && this->write_count == write_count_before_read) {
+        this->cache_value(key, entry.value());
+    }
+    return entry;
+}
+
+void KvsDatabase::write(const std::string& key, CacheEntry entry) {
+    {
+        std::lock_guard<std::mutex> lock(this->state_mutex);
+        this->write_count++;
+        if (entry.has_value()) {
+            this->cache_value(key, entry.value());
+        } else {
+            this->uncache(key);
+        }
+        this->pending[key] = std::move(entry);
+    }
+    if (this->commit_interval.count() == 0) {
+        this->commit_pending();
+    } else {
+        this->writer_cv.notify_one();
+    }
+}
+
+void KvsDatabase::store(const std::string& key, const KvsValue& value) {
+    this->write(key, value);
+}
+
+KvsValue KvsDatabase::load(const std::string& key) {
+    auto entry = this->lookup_cache(key);
+    if (!entry.has_value()) {
+        entry = this->read_from_database(key);
+    }
+    // no key with that name exists in the database
+    return entry->value_or(KvsValue{});
+}
+
+void KvsDatabase::remove(const std::string& key) {
+    this->write(key, std::nullopt);
+}
+
+bool KvsDatabase::exists(const std::string& key) {
+    auto entry = this->lookup_cache(key);
+    if (!entry.has_value()) {
+        entry = this->read_from_database(key);
+    }
+    return entry->has_value();
+}
+
+void KvsDatabase::flush() {
+    this->commit_pending();
+}
+
+void KvsDatabase::commit_pending() {
+    // holding db_mutex while taking the batch keeps batches committed in the order they were taken
+    std::lock_guard<std::mutex> db_lock(this->db_mutex);
+    std::unordered_map<std::string, CacheEntry> batch;
+    {
+        std::lock_guard<std::mutex> lock(this->state_mutex);
+        batch.swap(this->pending);
+    }
+    if (batch.empty()) {
+        return;
+    }
+
+    try {
+        step_done(this->db, this->begin_statement->reuse(), "Could not begin KVS transaction");
+        for (const auto& [key, entry] : batch) {
+            if (entry.has_value()) {
+                const std::string type = std::visit(TypeNameVisitor(), entry.value());
+                const std::string string_value = std::visit(StringValueVisitor(), entry.value());
+                sqlite3_stmt* statement = this->insert_statement->reuse();
+                sqlite3_bind_text(statement, 1, key.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_text(statement, 2, string_value.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_text(statement, 3, type.c_str(), -1, SQLITE_STATIC);
+                step_done(this->db, statement, "Could not insert into KVS table");
+            } else {
+                sqlite3_stmt* statement = this->delete_statement->reuse();
+                sqlite3_bind_text(statement, 1, key.c_str(), -1, SQLITE_STATIC);
+                step_done(this->db, statement, "Could not delete from KVS table");
+            }
+        }
+        step_done(this->db, this->commit_statement->reuse(), "Could not commit KVS transaction");
+    } catch (...) {
+        (void)sqlite3_step(this->rollback_statement->reuse());
+        std::lock_guard<std::mutex> lock(this->state_mutex);
+        // retry with the next commit, unless the key was written again meanwhile
+        for (auto& [key, entry] : batch) {
+            this->pending.emplace(key, std::move(entry));
+        }
+        throw;
+    }
+}
+
+void KvsDatabase::writer_loop() {
+    std::unique_lock<std::mutex> lock(this->state_mutex);
+    while (!this->shutting_down) {
+        this->writer_cv.wait(lock, [this]() { return this->shutting_down || !this->pending.empty(); });
+        // collect further writes into the same transaction
+        this->writer_cv.wait_for(lock, this->commit_interval, [this]() { return this->shutting_down; });
+        lock.unlock();
+        try {
+            this->commit_pending();
+        } catch (const std::exception& e) {
+            EVLOG_error << "Could not write PersistentStore changes: " << e.what();
+        }
+        lock.lock();
+    }
+}
+
+} // namespace module
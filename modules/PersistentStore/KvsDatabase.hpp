@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef PERSISTENT_STORE_KVS_DATABASE_HPP
+#define PERSISTENT_STORE_KVS_DATABASE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+
+#include <kvs_value.hpp>
+#include <sqlite3.h>
+
+namespace module {
+
+using KvsValue = kvs::Value;
+
+///
+/// \brief SQLite backed key-value store with a read-through cache and group commit
+///
+/// All statements are prepared once when the database is opened. The decoded values of the most recently used
+/// keys are kept in memory, so repeated loads of a key neither touch the database nor parse json again.
+/// Stores and deletes update the cache immediately and are written to the database by a background
+/// thread in one transaction per commit interval, or by flush(). Writes acknowledged within the last
+/// commit interval are lost on power loss.
+///
+class KvsDatabase {
+public:
+    ///
+    /// \param synchronous SQLite synchronous level: OFF, NORMAL, FULL or EXTRA
+    /// \param commit_interval time writes are collected before they are committed, 0 commits every write
+    /// \param cache_size maximum number of decoded values kept in memory
+    ///
+    KvsDatabase(const std::filesystem::path& database_path, const std::string& synchronous,
+                std::chrono::milliseconds commit_interval, std::size_t cache_size);
+    ~KvsDatabase();
+
+    KvsDatabase(const KvsDatabase&) = delete;
+    KvsDatabase& operator=(const KvsDatabase&) = delete;
+
+    void store(const std::string& key, const KvsValue& value);
+    KvsValue load(const std::string& key);
+    void remove(const std::string& key);
+    bool exists(const std::string& key);
+
+    /// \brief commit all pending writes to the database
+    void flush();
+
+private:
+    /// \brief owns a prepared statement for the lifetime of the database connection
+    class Statement {
+    public:
+        Statement(sqlite3* db, const std::string& sql);
+        ~Statement();
+        Statement(const Statement&) = delete;
+        Statement& operator=(const Statement&) = delete;
+
+        /// \brief reset the statement so that it can be bound and stepped again
+        sqlite3_stmt* reuse();
+
+    private:
+        sqlite3_stmt* statement{nullptr};
+    };
+
+    // std::nullopt marks a key that does not exist (or is pending deletion)
+    using CacheEntry = std::optional<KvsValue>;
+    // least recently used first
+    using CacheList = std::list<std::pair<std::string, KvsValue>>;
+
+    void execute(const std::string& sql);
+    std::optional<CacheEntry> lookup_cache(const std::string& key);
+    // the following expect state_mutex to be held
+    void cache_value(const std::string& key, const KvsValue& value);
+    void uncache(const std::string& key);
+    CacheEntry read_from_database(const std::string& key);
+    void write(const std::string& key, CacheEntry entry);
+    void commit_pending();
+    void writer_loop();
+
+    sqlite3* db{nullptr};
+    std::chrono::milliseconds commit_interval;
+    std::size_t cache_size;
+
+    // lock order: db_mutex before state_mutex
+    std::mutex db_mutex;
+    std::unique_ptr<Statement> insert_statement;
+    std::unique_ptr<Statement> select_statement;
+    std::unique_ptr<Statement> delete_statement;
+    std::unique_ptr<Statement> begin_statement;
+    std::unique_ptr<Statement> commit_statement;
+    std::unique_ptr<Statement> rollback_statement;
+
+    std::mutex state_mutex;
+    std::condition_variable writer_cv;
+    // only existing keys are cached, pending holds the writes that are not committed yet
+    CacheList cache;
+    std::unordered_map<std::string, CacheList::iterator> cache_index;
+    std::unordered_map<std::string, CacheEntry> pending;
+    std::uint64_t write_count{0};
+    bool shutting_down{false};
+    std::thread writer_thread;
+};
+
+} // namespace module
+
+#endif // PERSISTENT_STORE_KVS_DATABASE_HPP
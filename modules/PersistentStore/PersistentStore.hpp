@@ -21,6 +21,9 @@ namespace module {
 
 struct Conf {
     std::string sqlite_db_file_path;
+    std::string synchronous;
+    int commit_interval_ms;
+    int cache_size;
 };
 
 class PersistentStore : public Everest::ModuleBase {
@@ -14,8 +14,7 @@
 
 // ev@75ac1216-19eb-4182-a85c-820f1fc2c091:v1
 // insert your custom include headers here
-#include <mutex>
-#include <sqlite3.h>
+#include "../KvsDatabase.hpp"
 // ev@75ac1216-19eb-4182-a85c-820f1fc2c091:v1
 
 namespace module {
@@ -42,6 +41,8 @@ protected:
     handle_load(std::string& key) override;
     virtual void handle_delete(std::string& key) override;
     virtual bool handle_exists(std::string& key) override;
+    virtual void handle_store_many(Object& entries, int& ttl_s) override;
+    virtual Object handle_load_many(Array& keys) override;
 
     // ev@d2d1847a-7b88-41dd-ad07-92785f06f5c4:v1
     // insert your protected definitions here
@@ -56,8 +57,7 @@ private:
 
     // ev@3370e4dd-95f4-47a9-aaec-ea76f34a66c9:v1
     // insert your private definitions here
-    sqlite3* db;
-    std::mutex db_mutex;
+    std::unique_ptr<KvsDatabase> db;
     // ev@3370e4dd-95f4-47a9-aaec-ea76f34a66c9:v1
 };
 
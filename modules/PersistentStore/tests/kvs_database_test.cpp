@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <unistd.h>
+
+#include <KvsDatabase.hpp>
+
+namespace {
+
+using namespace module;
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+// a second connection to the database, as another process would open it
+class RawConnection {
+public:
+    explicit RawConnection(const fs::path& path) {
+        sqlite3_open(path.c_str(), &db);
+    }
+
+    ~RawConnection() {
+        sqlite3_close(db);
+    }
+
+    bool execute(const std::string& sql) {
+        return sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+    }
+
+    bool has_row(const std::string& key) {
+        sqlite3_stmt* statement = nullptr;
+        sqlite3_prepare_v2(db, "SELECT 1 FROM KVS WHERE KEY = ?1", -1, &statement, nullptr);
+        sqlite3_bind_text(statement, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+        const auto found = sqlite3_step(statement) == SQLITE_ROW;
+        sqlite3_finalize(statement);
+        return found;
+    }
+
+private:
+    sqlite3* db{nullptr};
+};
+
+class KvsDatabaseTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory = fs::temp_directory_path() /
+                    ("kvs_database_test_" + std::to_string(getpid()) + "_" +
+                     ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::create_directories(directory);
+        path = directory / "kvs.db";
+    }
+
+    void TearDown() override {
+        fs::remove_all(directory);
+    }
+
+    std::unique_ptr<KvsDatabase> open(std::chrono::milliseconds commit_interval, std::size_t cache_size = 1000) {
+        return std::make_unique<KvsDatabase>(path, "NORMAL", commit_interval, cache_size);
+    }
+
+    fs::path directory;
+    fs::path path;
+};
+
+TEST_F(KvsDatabaseTest, values_survive_reopening) {
+    {
+        auto db = open(0ms);
+        db->store("null", nullptr);
+        db->store("array", Array{1, "two"});
+        db->store("object", Object{{"key", "value"}});
+        db->store("bool", true);
+        db->store("double", 1.5);
+        db->store("int", -42);
+        db->store("string", std::string("text"));
+    }
+
+    auto db = open(0ms);
+    EXPECT_EQ(db->load("null"), KvsValue(nullptr));
+    EXPECT_EQ(db->load("array"), KvsValue(Array{1, "two"}));
+    EXPECT_EQ(db->load("object"), KvsValue(Object{{"key", "value"}}));
+    EXPECT_EQ(db->load("bool"), KvsValue(true));
+    EXPECT_EQ(db->load("double"), KvsValue(1.5));
+    EXPECT_EQ(db->load("int"), KvsValue(-42));
+    EXPECT_EQ(db->load("string"), KvsValue(std::string("text")));
+    EXPECT_TRUE(db->exists("null"));
+}
+
+TEST_F(KvsDatabaseTest, store_load_remove_exists_across_flush) {
+    auto db = open(1h);
+
+    EXPECT_FALSE(db->exists("key"));
+    EXPECT_EQ(db->load("key"), KvsValue(nullptr));
+
+    db->store("key", 1);
+    EXPECT_TRUE(db->exists("key"));
+    EXPECT_EQ(db->load("key"), KvsValue(1));
+    db->flush();
+    EXPECT_TRUE(db->exists("key"));
+    EXPECT_EQ(db->load("key"), KvsValue(1));
+
+    db->remove("key");
+    EXPECT_FALSE(db->exists("key"));
+    db->flush();
+    EXPECT_FALSE(db->exists("key"));
+
+    db->store("key", 2);
+    db->flush();
+    db.reset();
+    EXPECT_EQ(open(0ms)->load("key"), KvsValue(2));
+}
+
+TEST_F(KvsDatabaseTest, group_commit) {
+    auto db = open(500ms);
+    RawConnection raw(path);
+
+    db->store("first", 1);
+    db->store("second", 2);
+    // visible right away, but only written once the commit interval passed
+    EXPECT_EQ(db->load("first"), KvsValue(1));
+    EXPECT_FALSE(raw.has_row("first"));
+
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (not raw.has_row("second") and std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_TRUE(raw.has_row("first"));
+    EXPECT_TRUE(raw.has_row("second"));
+}
+
+TEST_F(KvsDatabaseTest, pending_writes_are_committed_on_destruction) {
+    auto db = open(1h);
+    db->store("key", std::string("value"));
+    db->remove("removed");
+    db.reset();
+
+    db = open(1h);
+    EXPECT_EQ(db->load("key"), KvsValue(std::string("value")));
+    EXPECT_FALSE(db->exists("removed"));
+}
+
+TEST_F(KvsDatabaseTest, failed_commit_is_retried) {
+    auto db = open(1h);
+    db->store("kept", 1);
+    db->store("overwritten", 1);
+
+    RawConnection raw(path);
+    ASSERT_TRUE(raw.execute("BEGIN EXCLUSIVE"));
+    EXPECT_THROW(db->flush(), std::runtime_error);
+    // the failed batch is pending again, a newer write of the same key wins over it
+    EXPECT_EQ(db->load("kept"), KvsValue(1));
+    db->store("overwritten", 2);
+    ASSERT_TRUE(raw.execute("COMMIT"));
+
+    db->flush();
+    EXPECT_TRUE(raw.has_row("kept"));
+    db.reset();
+
+    db = open(0ms);
+    EXPECT_EQ(db->load("kept"), KvsValue(1));
+    EXPECT_EQ(db->load("overwritten"), KvsValue(2));
+}
+
+TEST_F(KvsDatabaseTest, cache_is_bounded) {
+    auto db = open(0ms, 2);
+    for (int i = 0; i < 10; ++i) {
+        db->store("key" + std::to_string(i), i);
+    }
+    // most of the values were evicted and have to be read back from the database
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(db->load("key" + std::to_string(i)), KvsValue(i));
+    }
+}
+
+TEST_F(KvsDatabaseTest, misses_are_not_cached) {
+    auto db = open(0ms, 2);
+    EXPECT_FALSE(db->exists("key"));
+
+    // written by another connection, the miss must not hide it
+    RawConnection raw(path);
+    ASSERT_TRUE(raw.execute("INSERT INTO KVS (KEY, VALUE, TYPE) VALUES ('key', '7', 'int')"));
+    EXPECT_EQ(db->load("key"), KvsValue(7));
+}
+
+TEST_F(KvsDatabaseTest, pending_remove_without_cache) {
+    auto db = open(1h, 0);
+    db->store("key", 1);
+    db->flush();
+
+    db->remove("key");
+    EXPECT_FALSE(db->exists("key"));
+    EXPECT_EQ(db->load("key"), KvsValue(nullptr));
+}
+
+} // namespace
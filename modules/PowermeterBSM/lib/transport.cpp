@@ -5,6 +5,7 @@
 
 #include <chrono>
 #include <everest/logging.hpp>
+#include <string>
 #include <thread>
 #include <type_traits>
 
@@ -92,50 +93,36 @@ transport::DataVector ModbusTransport::fetch(protocol_related_types::SunspecData
 transport::DataVector SerialCommHubTransport::fetch(protocol_related_types::SunspecDataModelAddress model_address,
                                                     protocol_related_types::SunspecRegisterCount model_length) {
 
-    transport::DataVector response;
-    response.reserve(model_length * 2); // this is a uint 8 vector
-    std::size_t max_regiser_read = everest::modbus::consts::rtu::MAX_REGISTER_PER_MESSAGE;
-    protocol_related_types::SunspecRegisterCount remaining_register_to_read{model_length};
     protocol_related_types::ModbusRegisterAddress read_address{m_base_address + model_address};
 
-    while (remaining_register_to_read > 0) {
-        std::size_t register_to_read =
-            remaining_register_to_read > max_regiser_read ? max_regiser_read : remaining_register_to_read;
-
-        types::serial_comm_hub_requests::Result serial_com_hub_result =
-            m_serial_hub.call_modbus_read_holding_registers(m_unit_id, read_address.val, register_to_read);
-
-        if (not serial_com_hub_result.value.has_value())
-            throw std::runtime_error("no result from serial com hub!");
+    // The SerialCommHub splits the read into chunks fitting its max_packet_size on its own and sends them
+    // back-to-back while holding the serial port. So the whole model is fetched with a single call over the module bus,
+    // and other clients of the hub cannot interleave their requests between the chunks of a (signed) snapshot.
+    types::serial_comm_hub_requests::Result serial_com_hub_result =
+        m_serial_hub.call_modbus_read_holding_registers(m_unit_id, read_address.val, model_length);
 
-        // make sure that returned vector is a int32 vector
-        static_assert(
-            std::is_same_v<int32_t, decltype(types::serial_comm_hub_requests::Result::value)::value_type::value_type>);
+    if (not serial_com_hub_result.value.has_value())
+        throw std::runtime_error("no result from serial com hub!");
 
-        union {
-            int32_t val_32;
-            struct {
-                uint8_t v3;
-                uint8_t v2;
-                uint8_t v1;
-                uint8_t v0;
-            } val_8;
-        } swapit;
+    // make sure that returned vector is a int32 vector
+    static_assert(
+        std::is_same_v<int32_t, decltype(types::serial_comm_hub_requests::Result::value)::value_type::value_type>);
 
-        static_assert(sizeof(swapit.val_32) == sizeof(swapit.val_8));
+    const auto& registers = serial_com_hub_result.value.value();
 
-        transport::DataVector tmp{};
+    if (registers.size() != model_length)
+        throw std::runtime_error("serial com hub returned " + std::to_string(registers.size()) +
+                                 " registers, expected " + std::to_string(model_length));
 
-        for (auto item : serial_com_hub_result.value.value()) {
-            swapit.val_32 = item;
-            tmp.push_back(swapit.val_8.v2);
-            tmp.push_back(swapit.val_8.v3);
-        }
+    // Each int32 carries one 16 bit register; store it big endian (modbus byte order) into the preallocated buffer.
+    // The loop has no dependencies between iterations, so the compiler can vectorize it.
+    transport::DataVector response(registers.size() * 2); // this is a uint 8 vector
+    std::uint8_t* out = response.data();
 
-        response.insert(response.end(), tmp.begin(), tmp.end());
-
-        read_address.val += register_to_read;
-        remaining_register_to_read -= register_to_read;
+    for (std::size_t i = 0; i < registers.size(); ++i) {
+        const auto reg = static_cast<std::uint16_t>(registers[i]);
+        out[2 * i] = static_cast<std::uint8_t>(reg >> 8);
+        out[2 * i + 1] = static_cast<std::uint8_t>(reg);
     }
 
     return response;
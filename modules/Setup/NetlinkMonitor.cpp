@@ -0,0 +1,270 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "NetlinkMonitor.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include <arpa/inet.h>
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace module {
+
+namespace {
+// large enough for the multipart messages of a dump, the kernel doesn't split a single message
+constexpr std::size_t RECEIVE_BUFFER_SIZE = 32768;
+
+std::string attribute_string(const rtattr* attribute) {
+    const auto* data = static_cast<const char*>(RTA_DATA(attribute));
+    return std::string(data, strnlen(data, RTA_PAYLOAD(attribute)));
+}
+
+std::string attribute_hardware_address(const rtattr* attribute) {
+    const auto* data = static_cast<const unsigned char*>(RTA_DATA(attribute));
+    std::string address;
+    for (std::size_t i = 0; i < RTA_PAYLOAD(attribute); i++) {
+        char octet[4];
+        std::snprintf(octet, sizeof(octet), i == 0 ? "%02x" : ":%02x", data[i]);
+        address += octet;
+    }
+    return address;
+}
+
+std::string attribute_link_kind(const rtattr* link_info) {
+    int length = RTA_PAYLOAD(link_info);
+    for (const auto* attribute = static_cast<const rtattr*>(RTA_DATA(link_info)); RTA_OK(attribute, length);
+         attribute = RTA_NEXT(attribute, length)) {
+        if (attribute->rta_type == IFLA_INFO_KIND) {
+            return attribute_string(attribute);
+        }
+    }
+    return {};
+}
+
+template <typename T, typename Parse>
+std::optional<std::vector<T>> dump(std::uint16_t type, std::uint8_t family, Parse parse) {
+    const int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    struct {
+        nlmsghdr header;
+        rtgenmsg message;
+    } request{};
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(rtgenmsg));
+    request.header.nlmsg_type = type;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = 1;
+    request.message.rtgen_family = family;
+
+    sockaddr_nl kernel{};
+    kernel.nl_family = AF_NETLINK;
+    if (sendto(fd, &request, request.header.nlmsg_len, 0, reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) < 0) {
+        close(fd);
+        return std::nullopt;
+    }
+
+    std::vector<T> result;
+    std::vector<char> buffer(RECEIVE_BUFFER_SIZE);
+    bool done = false;
+    bool error = false;
+    while (!done and !error) {
+        const auto received = recv(fd, buffer.data(), buffer.size(), 0);
+        if (received < 0) {
+            error = errno != EINTR;
+            continue;
+        }
+        int length = static_cast<int>(received);
+        for (const auto* header = reinterpret_cast<const nlmsghdr*>(buffer.data()); NLMSG_OK(header, length);
+             header = NLMSG_NEXT(header, length)) {
+            if (header->nlmsg_type == NLMSG_DONE) {
+                done = true;
+                break;
+            }
+            if (header->nlmsg_type == NLMSG_ERROR) {
+                error = true;
+                break;
+            }
+            if (auto parsed = parse(header)) {
+                result.push_back(std::move(parsed.value()));
+            }
+        }
+    }
+
+    close(fd);
+    if (error) {
+        return std::nullopt;
+    }
+    return result;
+}
+} // namespace
+
+NetlinkMonitor::NetlinkMonitor(ChangeCallback callback, std::chrono::milliseconds debounce) :
+    callback(std::move(callback)), debounce(debounce) {
+}
+
+NetlinkMonitor::~NetlinkMonitor() {
+    this->stop();
+}
+
+bool NetlinkMonitor::start() {
+    if (this->running) {
+        return true;
+    }
+
+    this->socket_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (this->socket_fd < 0) {
+        return false;
+    }
+    sockaddr_nl local{};
+    local.nl_family = AF_NETLINK;
+    local.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+    this->stop_fd = eventfd(0, EFD_CLOEXEC);
+    if (this->stop_fd < 0 or bind(this->socket_fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0) {
+        this->stop();
+        return false;
+    }
+
+    this->running = true;
+    this->thread = std::thread([this] { this->run(); });
+    return true;
+}
+
+void NetlinkMonitor::stop() {
+    this->running = false;
+    if (this->thread.joinable()) {
+        const std::uint64_t wake_up = 1;
+        if (write(this->stop_fd, &wake_up, sizeof(wake_up)) < 0) {
+            // the thread notices the stop with its next netlink message
+        }
+        this->thread.join();
+    }
+    if (this->socket_fd >= 0) {
+        close(this->socket_fd);
+        this->socket_fd = -1;
+    }
+    if (this->stop_fd >= 0) {
+        close(this->stop_fd);
+        this->stop_fd = -1;
+    }
+}
+
+void NetlinkMonitor::run() {
+    std::vector<char> buffer(RECEIVE_BUFFER_SIZE);
+    pollfd fds[] = {{this->socket_fd, POLLIN, 0}, {this->stop_fd, POLLIN, 0}};
+    bool changed = false;
+
+    while (this->running) {
+        const auto result = poll(fds, 2, changed ? static_cast<int>(this->debounce.count()) : -1);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if ((fds[1].revents & POLLIN) != 0) {
+            break;
+        }
+        if (result == 0) {
+            // quiet for the debounce time
+            changed = false;
+            this->callback();
+            continue;
+        }
+        if ((fds[0].revents & POLLIN) != 0) {
+            // only the fact that something changed matters, an overrun (ENOBUFS) means changes got lost
+            recv(this->socket_fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+            changed = true;
+        }
+    }
+}
+
+std::optional<std::vector<NetlinkLink>> NetlinkMonitor::get_links() {
+    return dump<NetlinkLink>(RTM_GETLINK, AF_UNSPEC, &NetlinkMonitor::parse_link);
+}
+
+std::optional<std::vector<NetlinkAddress>> NetlinkMonitor::get_addresses() {
+    return dump<NetlinkAddress>(RTM_GETADDR, AF_UNSPEC, &NetlinkMonitor::parse_address);
+}
+
+std::optional<NetlinkLink> NetlinkMonitor::parse_link(const nlmsghdr* message) {
+    if (message->nlmsg_type != RTM_NEWLINK or message->nlmsg_len < NLMSG_LENGTH(sizeof(ifinfomsg))) {
+        return std::nullopt;
+    }
+
+    const auto* info = static_cast<const ifinfomsg*>(NLMSG_DATA(message));
+    NetlinkLink link{info->ifi_index, {}, info->ifi_type, {}, {}, (info->ifi_flags & IFF_UP) != 0};
+
+    int length = IFLA_PAYLOAD(message);
+    for (const auto* attribute = IFLA_RTA(info); RTA_OK(attribute, length); attribute = RTA_NEXT(attribute, length)) {
+        switch (attribute->rta_type) {
+        case IFLA_IFNAME:
+            link.name = attribute_string(attribute);
+            break;
+        case IFLA_ADDRESS:
+            link.mac = attribute_hardware_address(attribute);
+            break;
+        case IFLA_LINKINFO:
+            link.kind = attribute_link_kind(attribute);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (link.name.empty()) {
+        return std::nullopt;
+    }
+    return link;
+}
+
+std::optional<NetlinkAddress> NetlinkMonitor::parse_address(const nlmsghdr* message) {
+    if (message->nlmsg_type != RTM_NEWADDR or message->nlmsg_len < NLMSG_LENGTH(sizeof(ifaddrmsg))) {
+        return std::nullopt;
+    }
+
+    const auto* info = static_cast<const ifaddrmsg*>(NLMSG_DATA(message));
+    const std::size_t address_size = info->ifa_family == AF_INET ? 4 : info->ifa_family == AF_INET6 ? 16 : 0;
+    if (address_size == 0) {
+        return std::nullopt;
+    }
+
+    // IFA_ADDRESS is the peer address on point to point links, IFA_LOCAL the own one (like "local" in ip address)
+    const rtattr* address = nullptr;
+    const rtattr* local = nullptr;
+    int length = IFA_PAYLOAD(message);
+    for (const auto* attribute = IFA_RTA(info); RTA_OK(attribute, length); attribute = RTA_NEXT(attribute, length)) {
+        if (RTA_PAYLOAD(attribute) != address_size) {
+            continue;
+        }
+        if (attribute->rta_type == IFA_ADDRESS) {
+            address = attribute;
+        } else if (attribute->rta_type == IFA_LOCAL) {
+            local = attribute;
+        }
+    }
+
+    const auto* own_address = local != nullptr ? local : address;
+    if (own_address == nullptr) {
+        return std::nullopt;
+    }
+
+    char text[INET6_ADDRSTRLEN];
+    if (inet_ntop(info->ifa_family, RTA_DATA(own_address), text, sizeof(text)) == nullptr) {
+        return std::nullopt;
+    }
+    return NetlinkAddress{static_cast<int>(info->ifa_index), info->ifa_family, text};
+}
+
+} // namespace module
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef NETLINKMONITOR_HPP
+#define NETLINKMONITOR_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct nlmsghdr;
+
+namespace module {
+
+/// \brief network interface as reported by RTM_NEWLINK
+struct NetlinkLink {
+    int index;
+    std::string name;
+    std::uint16_t type; ///< ARPHRD_* device type, same as /sys/class/net/<interface>/type
+    std::string mac;
+    std::string kind; ///< IFLA_INFO_KIND of virtual interfaces, e.g. "wireguard" or "tun"
+    bool up;
+};
+
+/// \brief interface address as reported by RTM_NEWADDR
+struct NetlinkAddress {
+    int index;
+    int family; ///< AF_INET or AF_INET6
+    std::string address;
+};
+
+/// \brief Reads network interfaces and their addresses from the kernel via rtnetlink, and watches them for changes.
+///
+/// The monitor subscribes to the link and address multicast groups and calls its callback on a separate thread
+/// whenever an interface or address is added, removed or changed. Changes usually come in bursts, e.g. a link going
+/// up followed by its addresses, so the callback is only called once the burst has been quiet for the debounce time.
+class NetlinkMonitor {
+public:
+    using ChangeCallback = std::function<void()>;
+
+    NetlinkMonitor(ChangeCallback callback, std::chrono::milliseconds debounce);
+    ~NetlinkMonitor();
+
+    NetlinkMonitor(const NetlinkMonitor&) = delete;
+    NetlinkMonitor& operator=(const NetlinkMonitor&) = delete;
+
+    /// \returns false if the netlink socket could not be set up
+    bool start();
+    void stop();
+
+    /// \brief dumps all network interfaces, std::nullopt on netlink errors
+    static std::optional<std::vector<NetlinkLink>> get_links();
+    /// \brief dumps all IPv4 and IPv6 addresses, std::nullopt on netlink errors
+    static std::optional<std::vector<NetlinkAddress>> get_addresses();
+
+    /// \brief parses a RTM_NEWLINK message
+    static std::optional<NetlinkLink> parse_link(const nlmsghdr* message);
+    /// \brief parses a RTM_NEWADDR message
+    static std::optional<NetlinkAddress> parse_address(const nlmsghdr* message);
+
+private:
+    const ChangeCallback callback;
+    const std::chrono::milliseconds debounce;
+
+    int socket_fd{-1};
+    int stop_fd{-1};
+    std::atomic<bool> running{false};
+    std::thread thread;
+
+    void run();
+};
+
+} // namespace module
+
+#endif // NETLINKMONITOR_HPP
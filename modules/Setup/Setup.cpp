@@ -8,12 +8,21 @@
 #include <fstream>
 #include <locale>
 
+#include <climits>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include <fmt/core.h>
 
 namespace module {
 
 // set WifiConfigureClass to the class to use for configuring WiFi
-typedef WpaCliSetup WifiConfigureClass;
+typedef WpaCtrlSetup WifiConfigureClass;
+
+// changes of network interfaces come in bursts, e.g. a link going up followed by its addresses
+constexpr auto network_change_debounce = std::chrono::milliseconds(500);
 
 void to_json(json& j, const NetworkDeviceInfo& k) {
     j = json::object({{"interface", k.interface},
@@ -98,6 +107,18 @@ void Setup::init() {
 void Setup::ready() {
     invoke_ready(*p_main);
 
+    this->refresh_ap_state();
+
+    if (this->config.setup_wifi) {
+        // network device info and the ap state are published when the kernel reports a change instead of polling
+        this->netlink_monitor =
+            std::make_unique<NetlinkMonitor>([this]() { this->handle_network_change(); }, network_change_debounce);
+        if (!this->netlink_monitor->start()) {
+            EVLOG_warning << "Could not monitor network interfaces, network device info is only published on scans";
+        }
+        this->handle_network_change();
+    }
+
     this->discover_network_thread = std::thread([this]() {
         while (true) {
             if ((this->config.setup_wifi) && (wifi_scan_enabled)) {
@@ -152,7 +173,7 @@ void Setup::ready() {
         std::string add_network_cmd = this->cmd_base + "add_network";
         this->mqtt.subscribe(add_network_cmd, [this](const std::string& data) {
             WifiCredentials wifi_credentials = json::parse(data);
-            WifiConfigureClass wifi;
+            WifiConfigureClass wifi(this->config.wpa_ctrl_dir);
             this->add_and_enable_network(wifi_credentials.interface, wifi_credentials.ssid, wifi_credentials.psk,
                                          wifi_credentials.hidden);
             wifi.save_config(wifi_credentials.interface);
@@ -162,7 +183,7 @@ void Setup::ready() {
         std::string enable_network_cmd = this->cmd_base + "enable_network";
         this->mqtt.subscribe(enable_network_cmd, [this](const std::string& data) {
             InterfaceAndNetworkId wifi_details = json::parse(data);
-            WifiConfigureClass wifi;
+            WifiConfigureClass wifi(this->config.wpa_ctrl_dir);
             wifi.enable_network(wifi_details.interface, wifi_details.network_id);
             wifi.save_config(wifi_details.interface);
             this->publish_configured_networks();
@@ -171,7 +192,7 @@ void Setup::ready() {
         std::string disable_network_cmd = this->cmd_base + "disable_network";
         this->mqtt.subscribe(disable_network_cmd, [this](const std::string& data) {
             InterfaceAndNetworkId wifi_details = json::parse(data);
-            WifiConfigureClass wifi;
+            WifiConfigureClass wifi(this->config.wpa_ctrl_dir);
             wifi.disable_network(wifi_details.interface, wifi_details.network_id);
             wifi.save_config(wifi_details.interface);
             this->publish_configured_networks();
@@ -180,7 +201,7 @@ void Setup::ready() {
         std::string select_network_cmd = this->cmd_base + "select_network";
         this->mqtt.subscribe(select_network_cmd, [this](const std::string& data) {
             InterfaceAndNetworkId wifi_details = json::parse(data);
-            WifiConfigureClass wifi;
+            WifiConfigureClass wifi(this->config.wpa_ctrl_dir);
             wifi.select_network(wifi_details.interface, wifi_details.network_id);
             wifi.save_config(wifi_details.interface);
             this->publish_configured_networks();
@@ -189,7 +210,7 @@ void Setup::ready() {
         std::string remove_network_cmd = this->cmd_base + "remove_network";
         this->mqtt.subscribe(remove_network_cmd, [this](const std::string& data) {
             InterfaceAndNetworkId wifi_details = json::parse(data);
-            WifiConfigureClass wifi;
+            WifiConfigureClass wifi(this->config.wpa_ctrl_dir);
             wifi.remove_network(wifi_details.interface, wifi_details.network_id);
             wifi.save_config(wifi_details.interface);
             this->publish_configured_networks();
@@ -263,14 +284,24 @@ void Setup::publish_hostname() {
 void Setup::publish_ap_state() {
     std::string ap_state_var = this->var_base + "ap_state";
 
+    std::string ap_state;
+    {
+        std::lock_guard<std::mutex> lock(this->ap_state_mutex);
+        ap_state = this->ap_state;
+    }
+
+    this->mqtt.publish(ap_state_var, ap_state);
+}
+
+void Setup::refresh_ap_state() {
     auto hostapd_enabled_output = run_application("systemctl", {"is-active", "--quiet", "hostapd"});
+
+    std::lock_guard<std::mutex> lock(this->ap_state_mutex);
     if (hostapd_enabled_output.exit_code == 0) {
         this->ap_state = "enabled";
     } else {
         this->ap_state = "disabled";
     }
-
-    this->mqtt.publish(ap_state_var, this->ap_state);
 }
 
 void Setup::set_default_language(std::string language) {
@@ -325,6 +356,19 @@ bool Setup::get_initialized() {
 }
 
 void Setup::discover_network() {
+    std::vector<NetworkDeviceInfo> device_info = this->publish_network_device_info();
+
+    auto wifi_info = this->scan_wifi(device_info);
+
+    std::string wifi_info_var = this->var_base + "wifi_info";
+    json wifi_info_json = json::array();
+    wifi_info_json = wifi_info;
+    this->mqtt.publish(wifi_info_var, wifi_info_json.dump());
+
+    this->publish_configured_networks();
+}
+
+std::vector<NetworkDeviceInfo> Setup::publish_network_device_info() {
     std::vector<NetworkDeviceInfo> device_info = this->get_network_devices();
 
     this->populate_rfkill_status(device_info);
@@ -335,14 +379,37 @@ void Setup::discover_network() {
     device_info_json = device_info;
     this->mqtt.publish(network_device_info_var, device_info_json.dump());
 
-    auto wifi_info = this->scan_wifi(device_info);
+    return device_info;
+}
 
-    std::string wifi_info_var = this->var_base + "wifi_info";
-    json wifi_info_json = json::array();
-    wifi_info_json = wifi_info;
-    this->mqtt.publish(wifi_info_var, wifi_info_json.dump());
+void Setup::handle_network_change() {
+    auto device_info = this->publish_network_device_info();
+    // hostapd taking over or releasing the ap interface shows up as a change of the interface
+    this->refresh_ap_state();
+    this->monitor_wpa_supplicant(device_info);
+}
 
-    this->publish_configured_networks();
+void Setup::monitor_wpa_supplicant(const std::vector<NetworkDeviceInfo>& device_info) {
+    std::lock_guard<std::mutex> lock(this->wpa_ctrl_monitors_mutex);
+    for (const auto& device : device_info) {
+        if (!device.wireless or this->wpa_ctrl_monitors.count(device.interface) > 0) {
+            continue;
+        }
+        auto monitor = std::make_unique<WpaCtrlMonitor>(
+            this->config.wpa_ctrl_dir, device.interface,
+            [this](const std::string& interface, const std::string& event) {
+                this->handle_wpa_event(interface, event);
+            });
+        monitor->start();
+        this->wpa_ctrl_monitors.emplace(device.interface, std::move(monitor));
+    }
+}
+
+void Setup::handle_wpa_event(const std::string& interface, const std::string& event) {
+    if (event.rfind("CTRL-EVENT-CONNECTED", 0) == 0 or event.rfind("CTRL-EVENT-DISCONNECTED", 0) == 0) {
+        EVLOG_debug << "wpa_supplicant on " << interface << ": " << event;
+        this->publish_configured_networks();
+    }
 }
 
 std::string Setup::read_type_file(const fs::path& type_path) {
@@ -364,26 +431,24 @@ std::vector<NetworkDeviceInfo> Setup::get_network_devices() {
 
     std::vector<NetworkDeviceInfo> device_info;
 
-    for (auto&& net_it : fs::directory_iterator(sys_net_path)) {
-        auto net_path = net_it.path();
-        auto type_path = net_path / "type";
-        if (!fs::exists(type_path)) {
-            continue;
-        }
-
-        std::string type_file = this->read_type_file(type_path);
+    const auto links = NetlinkMonitor::get_links();
+    if (!links.has_value()) {
+        EVLOG_warning << "Could not read network interfaces";
+        return device_info;
+    }
 
-        auto interface = net_path.filename();
-        auto virtual_interface = sys_virtual_net_path / interface;
+    for (const auto& link : links.value()) {
+        auto net_path = sys_net_path / link.name;
 
         // check if type is ethernet:
-        if (type_file == "1") {
-            if (fs::exists(virtual_interface)) {
+        if (link.type == ARPHRD_ETHER) {
+            if (fs::exists(sys_virtual_net_path / link.name)) {
                 continue;
             }
 
             auto device = NetworkDeviceInfo();
-            device.interface = interface.string();
+            device.interface = link.name;
+            device.mac = link.mac;
             device.link_type = "ether";
 
             // check if its wireless or not:
@@ -403,35 +468,14 @@ std::vector<NetworkDeviceInfo> Setup::get_network_devices() {
             }
 
             device_info.push_back(device);
-        } else if (type_file == "65534") {
-            if (!fs::exists(virtual_interface)) {
-                continue;
-            }
-
-            auto virtual_type_path = virtual_interface / "type";
-
-            if (!fs::exists(virtual_type_path)) {
-                continue;
-            }
-
-            std::string virtual_type_file = this->read_type_file(virtual_type_path);
-            if (virtual_type_file == type_file) {
-                // assume it's a vpn, but check ip link
-                auto ip_output = run_application("ip", {"--json", "-details", "link", "show", interface});
-                if (ip_output.exit_code != 0) {
-                    continue;
-                }
-                const auto ip_json = json::parse(ip_output.output);
-                if (ip_json.size() < 1) {
-                    continue;
-                }
-                const auto& entry = ip_json.at(0);
-                if (entry.contains("linkinfo") and entry.at("linkinfo").contains("info_kind")) {
-                    auto device = NetworkDeviceInfo();
-                    device.interface = interface.string();
-                    device.link_type = entry.at("linkinfo").at("info_kind");
-                    device_info.push_back(device);
-                }
+        } else if (link.type == ARPHRD_NONE) {
+            // assume it's a vpn if the kernel reports the kind of link
+            if (!link.kind.empty()) {
+                auto device = NetworkDeviceInfo();
+                device.interface = link.name;
+                device.mac = link.mac;
+                device.link_type = link.kind;
+                device_info.push_back(device);
             }
         }
     }
@@ -440,23 +484,15 @@ std::vector<NetworkDeviceInfo> Setup::get_network_devices() {
 }
 
 void Setup::populate_rfkill_status(std::vector<NetworkDeviceInfo>& device_info) {
-    auto rfkill_output = run_application("rfkill", {"--json"});
-    if (rfkill_output.exit_code != 0) {
-        return;
-    }
-    auto rfkill_json = json::parse(rfkill_output.output);
-    for (auto rfkill_object : rfkill_json.items()) {
-        for (auto rfkill_device : rfkill_object.value()) {
-            for (auto& device : device_info) {
-                int device_id = rfkill_device.at("id");
-                if (!device.rfkill_id.empty() && std::to_string(device_id) == device.rfkill_id) {
-                    if (rfkill_device.at("soft") == "blocked") {
-                        device.blocked = true;
-                    }
-                    break;
-                }
-            }
+    auto sys_rfkill_path = fs::path("/sys/class/rfkill");
+
+    for (auto& device : device_info) {
+        if (device.rfkill_id.empty()) {
+            continue;
         }
+        // the "soft" state rfkill reports, 1 if blocked
+        auto soft_path = sys_rfkill_path / ("rfkill" + device.rfkill_id) / "soft";
+        device.blocked = this->read_type_file(soft_path) == "1";
     }
 }
 
@@ -521,7 +557,7 @@ void Setup::publish_configured_networks() {
         if (!device.wireless) {
             continue;
         }
-        WifiConfigureClass wifi;
+        WifiConfigureClass wifi(this->config.wpa_ctrl_dir);
         auto network_list = wifi.list_networks_status(device.interface);
         for (auto& i : network_list) {
             all_wifi_networks.push_back(std::move(i));
@@ -536,7 +572,7 @@ void Setup::publish_configured_networks() {
 
 bool Setup::add_and_enable_network(const std::string& interface, const std::string& ssid, const std::string& psk,
                                    bool hidden) {
-    WifiConfigureClass wifi;
+    WifiConfigureClass wifi(this->config.wpa_ctrl_dir);
 
     std::string net_if = interface;
     if (net_if.empty()) {
@@ -566,7 +602,7 @@ bool Setup::remove_all_networks() {
             continue;
         }
 
-        WifiConfigureClass wifi;
+        WifiConfigureClass wifi(this->config.wpa_ctrl_dir);
         auto networks = wifi.list_networks(device.interface);
 
         for (auto network : networks) {
@@ -610,8 +646,8 @@ void Setup::check_online_status() {
 }
 
 void Setup::enable_ap() {
-    auto wpa_cli_output = run_application("wpa_cli", {"-i", this->config.ap_interface, "disconnect"});
-    if (wpa_cli_output.exit_code != 0) {
+    WifiConfigureClass wifi(this->config.wpa_ctrl_dir);
+    if (!wifi.disconnect(this->config.ap_interface)) {
         EVLOG_error << "Could not disconnect from wireless LAN";
     }
     auto start_hostapd_output = run_application("systemctl", {"start", "hostapd"});
@@ -627,6 +663,7 @@ void Setup::enable_ap() {
     if (add_static_ip_output.exit_code != 0) {
         EVLOG_error << "Could not add static ip to interface " << this->config.ap_interface;
     }
+    this->refresh_ap_state();
 }
 
 void Setup::disable_ap() {
@@ -645,45 +682,36 @@ void Setup::disable_ap() {
         EVLOG_error << "Could not stop hostapd";
     }
 
-    auto wpa_cli_output = run_application("wpa_cli", {"-i", this->config.ap_interface, "reconnect"});
-    if (wpa_cli_output.exit_code != 0) {
+    WifiConfigureClass wifi(this->config.wpa_ctrl_dir);
+    if (!wifi.reconnect(this->config.ap_interface)) {
         EVLOG_error << "Could not reconnect to wireless LAN";
     }
-}
-
-static void add_addr_infos_to_device(const json& addr_infos, NetworkDeviceInfo& device) {
-    for (const auto& addr_info : addr_infos) {
-        if (addr_info.at("family") == "inet") {
-            device.ipv4.push_back(addr_info.at("local"));
-        } else if (addr_info.at("family") == "inet6") {
-            device.ipv6.push_back(addr_info.at("local"));
-        }
-    }
+    this->refresh_ap_state();
 }
 
 void Setup::populate_ip_addresses(std::vector<NetworkDeviceInfo>& device_info) {
-    auto ip_output = run_application("ip", {"--json", "address", "show"});
-    if (ip_output.exit_code != 0) {
+    const auto addresses = NetlinkMonitor::get_addresses();
+    if (!addresses.has_value()) {
         return;
     }
-    const auto ip_json = json::parse(ip_output.output);
-    for (const auto& ip_object : ip_json) {
-        const std::string ifname = ip_object.at("ifname");
-        auto device = std::find_if(device_info.begin(), device_info.end(),
-                                   [&ifname](NetworkDeviceInfo& device) { return device.interface == ifname; });
-        if (device == device_info.end()) {
-            continue;
-        }
-        if (ip_object.contains("address")) {
-            device->mac = ip_object.at("address");
+    for (auto& device : device_info) {
+        const auto index = static_cast<int>(if_nametoindex(device.interface.c_str()));
+        for (const auto& address : addresses.value()) {
+            if (address.index != index) {
+                continue;
+            }
+            if (address.family == AF_INET) {
+                device.ipv4.push_back(address.address);
+            } else if (address.family == AF_INET6) {
+                device.ipv6.push_back(address.address);
+            }
         }
-        add_addr_infos_to_device(ip_object.at("addr_info"), *device);
     }
 }
 
 WifiConfigureClass::WifiScanList Setup::scan_wifi(const std::vector<NetworkDeviceInfo>& device_info) {
     WifiConfigureClass::WifiScanList wifi_info;
-    WifiConfigureClass wifi;
+    WifiConfigureClass wifi(this->config.wpa_ctrl_dir);
 
     for (auto device : device_info) {
         if (!device.wireless) {
@@ -698,11 +726,11 @@ WifiConfigureClass::WifiScanList Setup::scan_wifi(const std::vector<NetworkDevic
 }
 
 std::string Setup::get_hostname() {
-    auto hostname_output = run_application("hostname", {});
-    if (hostname_output.exit_code == 0 && hostname_output.split_output.size() > 0) {
-        return hostname_output.split_output.at(0);
+    char hostname[HOST_NAME_MAX + 1] = {};
+    if (gethostname(hostname, sizeof(hostname)) != 0) {
+        return "";
     }
-    return "";
+    return hostname;
 }
 
 } // namespace module
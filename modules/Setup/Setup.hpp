@@ -18,7 +18,12 @@
 
 // ev@4bf81b14-a215-475c-a1d3-0a484ae48918:v1
 // insert your custom include headers here
+#include "NetlinkMonitor.hpp"
 #include "WiFiSetup.hpp"
+#include "WpaCtrl.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
 #include <regex>
 
 namespace module {
@@ -112,6 +117,7 @@ struct Conf {
     std::string release_metadata_file;
     std::string ap_interface;
     std::string ap_ipv4;
+    std::string wpa_ctrl_dir;
 };
 
 class Setup : public Everest::ModuleBase {
@@ -148,11 +154,16 @@ private:
     std::thread discover_network_thread;
     std::thread publish_application_info_thread;
     bool wifi_scan_enabled = false;
+    std::mutex ap_state_mutex;
     std::string ap_state = "unknown";
+    std::unique_ptr<NetlinkMonitor> netlink_monitor;
+    std::mutex wpa_ctrl_monitors_mutex;
+    std::map<std::string, std::unique_ptr<WpaCtrlMonitor>> wpa_ctrl_monitors; ///< by interface
     void publish_supported_features();
     void publish_application_info();
     void publish_hostname();
     void publish_ap_state();
+    void refresh_ap_state();
     void set_default_language(std::string language);
     std::string get_default_language();
     std::string current_language;
@@ -163,6 +174,10 @@ private:
     void set_initialized(bool initialized);
     bool get_initialized();
     void discover_network();
+    std::vector<NetworkDeviceInfo> publish_network_device_info();
+    void handle_network_change();
+    void monitor_wpa_supplicant(const std::vector<NetworkDeviceInfo>& device_info);
+    void handle_wpa_event(const std::string& interface, const std::string& event);
     std::string read_type_file(const fs::path& type_path);
     std::vector<NetworkDeviceInfo> get_network_devices();
     void populate_rfkill_status(std::vector<NetworkDeviceInfo>& device_info);
@@ -71,18 +71,29 @@ namespace module {
 constexpr const char* wpa_cli = "/usr/sbin/wpa_cli";
 constexpr const int not_connected_rssi = -100; // -100 dBm is the minimum for wifi
 
+CmdOutput WpaCliSetup::run_command(const std::string& interface, const std::vector<std::string>& command) {
+    std::vector<std::string> args{"-i", interface};
+    args.insert(args.end(), command.begin(), command.end());
+    return run_application(wpa_cli, args);
+}
+
+void WpaCliSetup::wait_for_scan_results(const std::string& /*interface*/) {
+    // wpa_cli has no way to wait for the end of the scan
+    std::this_thread::sleep_for(std::chrono::seconds(3));
+}
+
 bool WpaCliSetup::do_scan(const std::string& interface) {
     if (!is_wifi_interface(interface)) {
         return false;
     }
 
-    auto output = run_application(wpa_cli, {"-i", interface, "scan"});
+    auto output = run_command(interface, {"scan"});
     return output.exit_code == 0;
 }
 
 WpaCliSetup::WifiScanList WpaCliSetup::do_scan_results(const std::string& interface) {
     WifiScanList result = {};
-    auto output = run_application(wpa_cli, {"-i", interface, "scan_results"});
+    auto output = run_command(interface, {"scan_results"});
     if (output.exit_code == 0) {
         auto scan_results = output.split_output;
         if (scan_results.size() >= 2) {
@@ -114,7 +125,7 @@ WpaCliSetup::WifiScanList WpaCliSetup::do_scan_results(const std::string& interf
 WpaCliSetup::Status WpaCliSetup::do_status(const std::string& interface) {
     Status result = {};
     if (is_wifi_interface(interface)) {
-        auto output = run_application(wpa_cli, {"-i", interface, "status"});
+        auto output = run_command(interface, {"status"});
         if (output.exit_code == 0) {
             auto scan_results = output.split_output;
             for (auto& scan_result : scan_results) {
@@ -136,7 +147,7 @@ WpaCliSetup::Status WpaCliSetup::do_status(const std::string& interface) {
 WpaCliSetup::Poll WpaCliSetup::do_signal_poll(const std::string& interface) {
     Poll result = {};
     if (is_wifi_interface(interface)) {
-        auto output = run_application(wpa_cli, {"-i", interface, "signal_poll"});
+        auto output = run_command(interface, {"signal_poll"});
         if (output.exit_code == 0) {
             auto scan_results = output.split_output;
             for (auto& scan_result : scan_results) {
@@ -172,7 +183,7 @@ int WpaCliSetup::add_network(const std::string& interface) {
         return -1;
     }
 
-    auto output = run_application(wpa_cli, {"-i", interface, "add_network"});
+    auto output = run_command(interface, {"add_network"});
 
     if ((output.exit_code != 0) || (output.split_output.size() != 1)) {
         return -1;
@@ -266,23 +277,22 @@ bool WpaCliSetup::set_network(const std::string& interface, int network_id, cons
     // hence providing the SSID as a string of hex digits
     auto ssid_parameter = ssid_to_hex(ssid);
 
-    auto output = run_application(wpa_cli, {"-i", interface, "set_network", network_id_string, "ssid", ssid_parameter});
+    auto output = run_command(interface, {"set_network", network_id_string, "ssid", ssid_parameter});
 
     if ((output.exit_code == 0) && (psk_name != nullptr)) {
-        output = run_application(wpa_cli, {"-i", interface, "set_network", network_id_string, psk_name, psk});
+        output = run_command(interface, {"set_network", network_id_string, psk_name, psk});
     }
 
     if (output.exit_code == 0) {
-        output = run_application(wpa_cli, {"-i", interface, "set_network", network_id_string, "key_mgmt", key_mgt});
+        output = run_command(interface, {"set_network", network_id_string, "key_mgmt", key_mgt});
     }
 
     if ((output.exit_code == 0) && (ieee80211w != nullptr)) {
-        output =
-            run_application(wpa_cli, {"-i", interface, "set_network", network_id_string, "ieee80211w", ieee80211w});
+        output = run_command(interface, {"set_network", network_id_string, "ieee80211w", ieee80211w});
     }
 
     if (hidden && (output.exit_code == 0)) {
-        output = run_application(wpa_cli, {"-i", interface, "set_network", network_id_string, "scan_ssid", "1"});
+        output = run_command(interface, {"set_network", network_id_string, "scan_ssid", "1"});
     }
 
     return output.exit_code == 0;
@@ -294,7 +304,7 @@ bool WpaCliSetup::enable_network(const std::string& interface, int network_id) {
     }
 
     auto network_id_string = std::to_string(network_id);
-    auto output = run_application(wpa_cli, {"-i", interface, "enable_network", network_id_string});
+    auto output = run_command(interface, {"enable_network", network_id_string});
     return output.exit_code == 0;
 }
 
@@ -304,7 +314,7 @@ bool WpaCliSetup::disable_network(const std::string& interface, int network_id)
     }
 
     auto network_id_string = std::to_string(network_id);
-    auto output = run_application(wpa_cli, {"-i", interface, "disable_network", network_id_string});
+    auto output = run_command(interface, {"disable_network", network_id_string});
     return output.exit_code == 0;
 }
 
@@ -314,7 +324,7 @@ bool WpaCliSetup::select_network(const std::string& interface, int network_id) {
     }
 
     auto network_id_string = std::to_string(network_id);
-    auto output = run_application(wpa_cli, {"-i", interface, "select_network", network_id_string});
+    auto output = run_command(interface, {"select_network", network_id_string});
     return output.exit_code == 0;
 }
 
@@ -324,7 +334,7 @@ bool WpaCliSetup::remove_network(const std::string& interface, int network_id) {
     }
 
     auto network_id_string = std::to_string(network_id);
-    auto output = run_application(wpa_cli, {"-i", interface, "remove_network", network_id_string});
+    auto output = run_command(interface, {"remove_network", network_id_string});
     return output.exit_code == 0;
 }
 
@@ -333,7 +343,17 @@ bool WpaCliSetup::save_config(const std::string& interface) {
         return false;
     }
 
-    auto output = run_application(wpa_cli, {"-i", interface, "save_config"});
+    auto output = run_command(interface, {"save_config"});
+    return output.exit_code == 0;
+}
+
+bool WpaCliSetup::disconnect(const std::string& interface) {
+    auto output = run_command(interface, {"disconnect"});
+    return output.exit_code == 0;
+}
+
+bool WpaCliSetup::reconnect(const std::string& interface) {
+    auto output = run_command(interface, {"reconnect"});
     return output.exit_code == 0;
 }
 
@@ -341,8 +361,7 @@ WpaCliSetup::WifiScanList WpaCliSetup::scan_wifi(const std::string& interface) {
     WifiScanList result = {};
 
     if (do_scan(interface)) {
-        // FIXME: is there a proper signal to check if the scan is ready? Maybe in the socket based interface
-        std::this_thread::sleep_for(std::chrono::seconds(3));
+        wait_for_scan_results(interface);
         result = std::move(do_scan_results(interface));
     }
 
@@ -352,7 +371,7 @@ WpaCliSetup::WifiScanList WpaCliSetup::scan_wifi(const std::string& interface) {
 WpaCliSetup::WifiNetworkList WpaCliSetup::list_networks(const std::string& interface) {
     WifiNetworkList result = {};
     if (is_wifi_interface(interface)) {
-        auto output = run_application(wpa_cli, {"-i", interface, "list_networks"});
+        auto output = run_command(interface, {"list_networks"});
         if (output.exit_code == 0) {
             auto scan_results = output.split_output;
             if (scan_results.size() >= 2) {
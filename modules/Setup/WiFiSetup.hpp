@@ -9,6 +9,8 @@
 #include <string>
 #include <vector>
 
+#include "RunApplication.hpp"
+
 /**
  * SSID encoding
  * From Wikipedia:
@@ -88,6 +90,10 @@ public:
     using Poll = std::map<std::string, std::string>;
 
 protected:
+    /// \brief runs a wpa_supplicant \p command with its arguments on \p interface, e.g. {"enable_network", "0"}
+    virtual CmdOutput run_command(const std::string& interface, const std::vector<std::string>& command);
+    /// \brief blocks until the scan requested by do_scan() has finished
+    virtual void wait_for_scan_results(const std::string& interface);
     virtual bool do_scan(const std::string& interface);
     virtual WifiScanList do_scan_results(const std::string& interface);
     virtual Status do_status(const std::string& interface);
@@ -108,6 +114,8 @@ public:
     virtual bool select_network(const std::string& interface, int network_id);
     virtual bool remove_network(const std::string& interface, int network_id);
     virtual bool save_config(const std::string& interface);
+    virtual bool disconnect(const std::string& interface);
+    virtual bool reconnect(const std::string& interface);
     virtual WifiScanList scan_wifi(const std::string& interface);
     virtual WifiNetworkList list_networks(const std::string& interface);
     virtual WifiNetworkStatusList list_networks_status(const std::string& interface);
@@ -0,0 +1,334 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "WpaCtrl.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace module {
+
+namespace {
+constexpr auto DETACH_TIMEOUT = std::chrono::seconds(1);
+constexpr auto SCAN_TIMEOUT = std::chrono::seconds(10);
+constexpr auto MONITOR_POLL_INTERVAL = std::chrono::milliseconds(500);
+constexpr auto MONITOR_PING_INTERVAL = std::chrono::seconds(10);
+constexpr auto MONITOR_RECONNECT_INTERVAL = std::chrono::seconds(5);
+
+std::atomic<unsigned int> local_path_counter{0};
+
+bool set_socket_path(sockaddr_un& address, const std::string& path) {
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    return true;
+}
+
+bool starts_with(const std::string& str, const std::string& prefix) {
+    return str.compare(0, prefix.size(), prefix) == 0;
+}
+} // namespace
+
+WpaCtrl::WpaCtrl(const std::string& ctrl_path) {
+    sockaddr_un local{};
+    sockaddr_un remote{};
+    // same naming scheme as wpa_ctrl.c, the pid and a counter keep the path unique
+    this->local_path =
+        "/tmp/everest_wpa_ctrl_" + std::to_string(getpid()) + "-" + std::to_string(local_path_counter++);
+    if (!set_socket_path(local, this->local_path) or !set_socket_path(remote, ctrl_path)) {
+        return;
+    }
+
+    this->socket_fd = socket(PF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (this->socket_fd < 0) {
+        return;
+    }
+
+    unlink(this->local_path.c_str());
+    if (bind(this->socket_fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0 or
+        connect(this->socket_fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) < 0) {
+        close(this->socket_fd);
+        this->socket_fd = -1;
+        unlink(this->local_path.c_str());
+    }
+}
+
+WpaCtrl::~WpaCtrl() {
+    if (this->socket_fd < 0) {
+        return;
+    }
+    if (this->attached) {
+        this->detach();
+    }
+    close(this->socket_fd);
+    unlink(this->local_path.c_str());
+}
+
+bool WpaCtrl::is_open() const {
+    return this->socket_fd >= 0;
+}
+
+std::optional<std::string> WpaCtrl::receive(std::chrono::steady_clock::time_point deadline) {
+    if (!this->is_open()) {
+        return std::nullopt;
+    }
+
+    pollfd pfd{this->socket_fd, POLLIN, 0};
+    while (true) {
+        const auto remaining =
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        const auto result = poll(&pfd, 1, std::max<int>(0, static_cast<int>(remaining.count())));
+        if (result < 0 and errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return std::nullopt;
+        }
+        break;
+    }
+
+    // replies like SCAN_RESULTS can be larger than any fixed buffer, so peek at the size of the datagram first
+    const auto size = recv(this->socket_fd, nullptr, 0, MSG_PEEK | MSG_TRUNC);
+    if (size < 0) {
+        return std::nullopt;
+    }
+    std::string message(static_cast<std::size_t>(size), '\0');
+    const auto received = recv(this->socket_fd, message.data(), message.size(), 0);
+    if (received < 0) {
+        return std::nullopt;
+    }
+    message.resize(static_cast<std::size_t>(received));
+    return message;
+}
+
+std::optional<std::string> WpaCtrl::request(const std::string& command, std::chrono::milliseconds timeout) {
+    if (!this->is_open() or send(this->socket_fd, command.data(), command.size(), 0) < 0) {
+        return std::nullopt;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+        auto message = this->receive(deadline);
+        if (!message.has_value()) {
+            return std::nullopt;
+        }
+        if (this->attached and !message->empty() and message->front() == '<') {
+            // unsolicited event arriving before the reply
+            this->events.push_back(strip_level(message.value()));
+            continue;
+        }
+        return message;
+    }
+}
+
+bool WpaCtrl::attach() {
+    const auto reply = this->request("ATTACH");
+    this->attached = reply.has_value() and starts_with(reply.value(), "OK");
+    return this->attached;
+}
+
+bool WpaCtrl::detach() {
+    this->attached = false;
+    this->events.clear();
+    const auto reply = this->request("DETACH", DETACH_TIMEOUT);
+    return reply.has_value() and starts_with(reply.value(), "OK");
+}
+
+std::optional<std::string> WpaCtrl::receive_event(std::chrono::milliseconds timeout) {
+    if (!this->events.empty()) {
+        auto event = std::move(this->events.front());
+        this->events.pop_front();
+        return event;
+    }
+
+    auto message = this->receive(std::chrono::steady_clock::now() + timeout);
+    if (!message.has_value()) {
+        return std::nullopt;
+    }
+    return strip_level(message.value());
+}
+
+std::string WpaCtrl::strip_level(const std::string& message) {
+    if (message.empty() or message.front() != '<') {
+        return message;
+    }
+    const auto end = message.find('>');
+    if (end == std::string::npos) {
+        return message;
+    }
+    return message.substr(end + 1);
+}
+
+//------------------------------------------------------------------------------
+WpaCtrlSetup::WpaCtrlSetup(std::string ctrl_dir) : ctrl_dir(std::move(ctrl_dir)) {
+}
+
+std::string WpaCtrlSetup::to_request(const std::vector<std::string>& command) {
+    std::string request;
+    for (const auto& arg : command) {
+        if (request.empty()) {
+            // wpa_cli sends the command name in upper case and its arguments verbatim
+            std::transform(arg.begin(), arg.end(), std::back_inserter(request),
+                           [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        } else {
+            request += " " + arg;
+        }
+    }
+    return request;
+}
+
+CmdOutput WpaCtrlSetup::to_cmd_output(const std::string& reply) {
+    CmdOutput output{reply, {}, 0};
+    std::istringstream stream(reply);
+    for (std::string line; std::getline(stream, line);) {
+        output.split_output.push_back(std::move(line));
+    }
+    if (starts_with(reply, "FAIL") or starts_with(reply, "UNKNOWN COMMAND")) {
+        output.exit_code = 1;
+    }
+    return output;
+}
+
+WpaCtrl* WpaCtrlSetup::get_connection(const std::string& interface) {
+    auto& connection = this->connections[interface];
+    if (connection == nullptr or !connection->is_open()) {
+        connection = std::make_unique<WpaCtrl>(this->ctrl_dir + "/" + interface);
+    }
+    return connection->is_open() ? connection.get() : nullptr;
+}
+
+CmdOutput WpaCtrlSetup::run_command(const std::string& interface, const std::vector<std::string>& command) {
+    auto* connection = this->get_connection(interface);
+    if (connection == nullptr) {
+        return WpaCliSetup::run_command(interface, command);
+    }
+
+    const auto reply = connection->request(to_request(command));
+    if (!reply.has_value()) {
+        // wpa_supplicant might have been restarted, connect again with the next command
+        this->connections.erase(interface);
+        return CmdOutput{{}, {}, -1};
+    }
+    return to_cmd_output(reply.value());
+}
+
+bool WpaCtrlSetup::do_scan(const std::string& interface) {
+    if (!is_wifi_interface(interface)) {
+        return false;
+    }
+
+    // attach before requesting the scan, so the event announcing its results can't be missed
+    this->scan_events = std::make_unique<WpaCtrl>(this->ctrl_dir + "/" + interface);
+    if (!this->scan_events->attach()) {
+        this->scan_events.reset();
+        return WpaCliSetup::do_scan(interface);
+    }
+
+    const auto output = this->run_command(interface, {"scan"});
+    // a scan that is already running ends with results just the same
+    if (output.exit_code == 0 or starts_with(output.output, "FAIL-BUSY")) {
+        return true;
+    }
+    // no results will be waited for, so the events are detached right away
+    this->scan_events.reset();
+    return false;
+}
+
+void WpaCtrlSetup::wait_for_scan_results(const std::string& interface) {
+    if (this->scan_events == nullptr) {
+        WpaCliSetup::wait_for_scan_results(interface);
+        return;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + SCAN_TIMEOUT;
+    while (true) {
+        const auto remaining =
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            break;
+        }
+        const auto event = this->scan_events->receive_event(remaining);
+        if (!event.has_value() or starts_with(event.value(), "CTRL-EVENT-SCAN-RESULTS") or
+            starts_with(event.value(), "CTRL-EVENT-SCAN-FAILED")) {
+            break;
+        }
+    }
+    this->scan_events.reset();
+}
+
+//------------------------------------------------------------------------------
+WpaCtrlMonitor::WpaCtrlMonitor(std::string ctrl_dir, std::string interface, EventCallback callback) :
+    ctrl_dir(std::move(ctrl_dir)), interface(std::move(interface)), callback(std::move(callback)) {
+}
+
+WpaCtrlMonitor::~WpaCtrlMonitor() {
+    this->stop();
+}
+
+void WpaCtrlMonitor::start() {
+    std::lock_guard<std::mutex> lk(this->thread_mutex);
+    if (this->running) {
+        return;
+    }
+    this->running = true;
+    this->thread = std::thread([this] { this->run(); });
+}
+
+void WpaCtrlMonitor::stop() {
+    {
+        std::lock_guard<std::mutex> lk(this->thread_mutex);
+        this->running = false;
+    }
+    this->thread_cv.notify_all();
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+}
+
+void WpaCtrlMonitor::run() {
+    std::unique_ptr<WpaCtrl> ctrl;
+    auto last_message = std::chrono::steady_clock::now();
+
+    while (this->running) {
+        if (ctrl == nullptr) {
+            ctrl = std::make_unique<WpaCtrl>(this->ctrl_dir + "/" + this->interface);
+            if (!ctrl->attach()) {
+                ctrl.reset();
+                // wpa_supplicant isn't running on this interface (yet)
+                std::unique_lock<std::mutex> lk(this->thread_mutex);
+                this->thread_cv.wait_for(lk, MONITOR_RECONNECT_INTERVAL, [this] { return !this->running; });
+                continue;
+            }
+            last_message = std::chrono::steady_clock::now();
+        }
+
+        const auto event = ctrl->receive_event(MONITOR_POLL_INTERVAL);
+        if (event.has_value()) {
+            last_message = std::chrono::steady_clock::now();
+            if (starts_with(event.value(), "CTRL-EVENT-TERMINATING")) {
+                ctrl.reset();
+            }
+            this->callback(this->interface, event.value());
+        } else if (std::chrono::steady_clock::now() - last_message > MONITOR_PING_INTERVAL) {
+            // a restarted wpa_supplicant doesn't know this connection anymore, like wpa_cli check with a PING
+            const auto reply = ctrl->request("PING");
+            if (!reply.has_value() or !starts_with(reply.value(), "PONG")) {
+                ctrl.reset();
+            }
+            last_message = std::chrono::steady_clock::now();
+        }
+    }
+}
+
+} // namespace module
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef WPACTRL_HPP
+#define WPACTRL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "WiFiSetup.hpp"
+
+/**
+ * wpa_supplicant control interface
+ *
+ * wpa_supplicant listens on a unix datagram socket per interface, by default
+ * /var/run/wpa_supplicant/<interface>. This is the socket wpa_cli talks to:
+ * - every request is a single datagram, e.g. "SET_NETWORK 0 ssid 4142"
+ * - every request is answered with a single datagram, e.g. "OK" or "FAIL"
+ * - after "ATTACH" the connection additionally receives unsolicited events,
+ *   which start with the message level, e.g. "<3>CTRL-EVENT-SCAN-RESULTS "
+ *
+ * The client binds its end of the connection to a unique path, otherwise
+ * wpa_supplicant could not address its replies.
+ */
+
+namespace module {
+
+constexpr const char* WPA_CTRL_DEFAULT_DIR = "/var/run/wpa_supplicant";
+
+class WpaCtrl {
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT{10000};
+
+    /// \brief connects to the control socket at \p ctrl_path, check is_open() for success
+    explicit WpaCtrl(const std::string& ctrl_path);
+    ~WpaCtrl();
+
+    WpaCtrl(const WpaCtrl&) = delete;
+    WpaCtrl& operator=(const WpaCtrl&) = delete;
+
+    bool is_open() const;
+
+    /// \brief sends \p command and waits for its reply
+    /// \returns the reply or std::nullopt on timeout or socket errors
+    std::optional<std::string> request(const std::string& command,
+                                       std::chrono::milliseconds timeout = DEFAULT_TIMEOUT);
+
+    /// \brief registers the connection for unsolicited events
+    bool attach();
+    bool detach();
+
+    /// \brief waits for the next event, without its message level
+    /// \returns the event or std::nullopt on timeout or socket errors
+    std::optional<std::string> receive_event(std::chrono::milliseconds timeout);
+
+    /// \brief removes the message level from an event, "<3>CTRL-EVENT-CONNECTED" becomes "CTRL-EVENT-CONNECTED"
+    static std::string strip_level(const std::string& message);
+
+private:
+    int socket_fd{-1};
+    std::string local_path;
+    bool attached{false};
+    std::deque<std::string> events; ///< events received while waiting for a reply
+
+    std::optional<std::string> receive(std::chrono::steady_clock::time_point deadline);
+};
+
+/// \brief WiFi setup using the wpa_supplicant control socket instead of spawning wpa_cli for every command.
+/// Falls back to wpa_cli when the control socket of an interface can't be opened.
+class WpaCtrlSetup : public WpaCliSetup {
+public:
+    explicit WpaCtrlSetup(std::string ctrl_dir = WPA_CTRL_DEFAULT_DIR);
+
+    /// \brief turns a wpa_cli style \p command into a control interface request, {"scan"} becomes "SCAN"
+    static std::string to_request(const std::vector<std::string>& command);
+    /// \brief turns a control interface \p reply into the output wpa_cli would have produced. Contrary to wpa_cli,
+    /// replies starting with FAIL or UNKNOWN COMMAND result in a non-zero exit code.
+    static CmdOutput to_cmd_output(const std::string& reply);
+
+protected:
+    CmdOutput run_command(const std::string& interface, const std::vector<std::string>& command) override;
+    bool do_scan(const std::string& interface) override;
+    void wait_for_scan_results(const std::string& interface) override;
+
+private:
+    std::string ctrl_dir;
+    std::map<std::string, std::unique_ptr<WpaCtrl>> connections;
+    std::unique_ptr<WpaCtrl> scan_events;
+
+    WpaCtrl* get_connection(const std::string& interface);
+};
+
+/// \brief Receives the events of the wpa_supplicant instance of one interface on a separate thread.
+/// Reconnects when wpa_supplicant isn't running yet or restarts.
+class WpaCtrlMonitor {
+public:
+    using EventCallback = std::function<void(const std::string& interface, const std::string& event)>;
+
+    WpaCtrlMonitor(std::string ctrl_dir, std::string interface, EventCallback callback);
+    ~WpaCtrlMonitor();
+
+    WpaCtrlMonitor(const WpaCtrlMonitor&) = delete;
+    WpaCtrlMonitor& operator=(const WpaCtrlMonitor&) = delete;
+
+    void start();
+    void stop();
+
+private:
+    const std::string ctrl_dir;
+    const std::string interface;
+    const EventCallback callback;
+
+    std::mutex thread_mutex;
+    std::condition_variable thread_cv;
+    std::atomic<bool> running{false};
+    std::thread thread;
+
+    void run();
+};
+
+} // namespace module
+
+#endif // WPACTRL_HPP
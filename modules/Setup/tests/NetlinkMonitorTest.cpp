@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include <NetlinkMonitor.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <linux/if_arp.h>
+#include <linux/if_link.h>
+#include <linux/rtnetlink.h>
+
+namespace {
+using namespace module;
+
+// builds netlink messages the way the kernel sends them
+class Message {
+public:
+    template <typename T> Message(std::uint16_t type, const T& header) : buffer(NLMSG_SPACE(sizeof(T))) {
+        std::memcpy(NLMSG_DATA(get()), &header, sizeof(T));
+        get()->nlmsg_type = type;
+        update_length();
+    }
+
+    void add_attribute(std::uint16_t type, const void* data, std::size_t size) {
+        const auto offset = buffer.size();
+        buffer.resize(offset + RTA_SPACE(size));
+        auto* attribute = reinterpret_cast<rtattr*>(buffer.data() + offset);
+        attribute->rta_type = type;
+        attribute->rta_len = RTA_LENGTH(size);
+        std::memcpy(RTA_DATA(attribute), data, size);
+        update_length();
+    }
+
+    void add_attribute(std::uint16_t type, const std::string& value) {
+        add_attribute(type, value.c_str(), value.size() + 1);
+    }
+
+    nlmsghdr* get() {
+        return reinterpret_cast<nlmsghdr*>(buffer.data());
+    }
+
+private:
+    std::vector<char> buffer;
+
+    void update_length() {
+        get()->nlmsg_len = buffer.size();
+    }
+};
+
+TEST(NetlinkMonitor, parse_link) {
+    ifinfomsg info{};
+    info.ifi_index = 3;
+    info.ifi_type = ARPHRD_ETHER;
+    info.ifi_flags = IFF_UP;
+    Message message(RTM_NEWLINK, info);
+    message.add_attribute(IFLA_IFNAME, "wlan0");
+    const unsigned char mac[] = {0xc0, 0xee, 0x40, 0xb0, 0x57, 0xb8};
+    message.add_attribute(IFLA_ADDRESS, mac, sizeof(mac));
+
+    const auto link = NetlinkMonitor::parse_link(message.get());
+    ASSERT_TRUE(link.has_value());
+    EXPECT_EQ(link->index, 3);
+    EXPECT_EQ(link->name, "wlan0");
+    EXPECT_EQ(link->type, ARPHRD_ETHER);
+    EXPECT_EQ(link->mac, "c0:ee:40:b0:57:b8");
+    EXPECT_TRUE(link->kind.empty());
+    EXPECT_TRUE(link->up);
+}
+
+TEST(NetlinkMonitor, parse_link_kind) {
+    ifinfomsg info{};
+    info.ifi_index = 7;
+    info.ifi_type = ARPHRD_NONE;
+    Message message(RTM_NEWLINK, info);
+    message.add_attribute(IFLA_IFNAME, "wg0");
+
+    // IFLA_LINKINFO nests IFLA_INFO_KIND
+    std::vector<char> link_info(RTA_SPACE(sizeof("wireguard")));
+    auto* kind = reinterpret_cast<rtattr*>(link_info.data());
+    kind->rta_type = IFLA_INFO_KIND;
+    kind->rta_len = RTA_LENGTH(sizeof("wireguard"));
+    std::memcpy(RTA_DATA(kind), "wireguard", sizeof("wireguard"));
+    message.add_attribute(IFLA_LINKINFO, link_info.data(), link_info.size());
+
+    const auto link = NetlinkMonitor::parse_link(message.get());
+    ASSERT_TRUE(link.has_value());
+    EXPECT_EQ(link->name, "wg0");
+    EXPECT_EQ(link->type, ARPHRD_NONE);
+    EXPECT_EQ(link->kind, "wireguard");
+    EXPECT_FALSE(link->up);
+}
+
+TEST(NetlinkMonitor, parse_address_prefers_local) {
+    ifaddrmsg info{};
+    info.ifa_family = AF_INET;
+    info.ifa_index = 5;
+    Message message(RTM_NEWADDR, info);
+    in_addr peer{};
+    in_addr local{};
+    inet_pton(AF_INET, "192.0.2.1", &peer);
+    inet_pton(AF_INET, "192.0.2.23", &local);
+    message.add_attribute(IFA_ADDRESS, &peer, sizeof(peer));
+    message.add_attribute(IFA_LOCAL, &local, sizeof(local));
+
+    const auto address = NetlinkMonitor::parse_address(message.get());
+    ASSERT_TRUE(address.has_value());
+    EXPECT_EQ(address->index, 5);
+    EXPECT_EQ(address->family, AF_INET);
+    EXPECT_EQ(address->address, "192.0.2.23");
+}
+
+TEST(NetlinkMonitor, parse_address_ipv6) {
+    ifaddrmsg info{};
+    info.ifa_family = AF_INET6;
+    info.ifa_index = 5;
+    Message message(RTM_NEWADDR, info);
+    in6_addr address_data{};
+    inet_pton(AF_INET6, "2001:db8::23", &address_data);
+    message.add_attribute(IFA_ADDRESS, &address_data, sizeof(address_data));
+
+    const auto address = NetlinkMonitor::parse_address(message.get());
+    ASSERT_TRUE(address.has_value());
+    EXPECT_EQ(address->family, AF_INET6);
+    EXPECT_EQ(address->address, "2001:db8::23");
+}
+
+TEST(NetlinkMonitor, parse_wrong_type) {
+    ifaddrmsg info{};
+    info.ifa_family = AF_INET;
+    Message message(RTM_DELADDR, info);
+    EXPECT_FALSE(NetlinkMonitor::parse_address(message.get()).has_value());
+    EXPECT_FALSE(NetlinkMonitor::parse_link(message.get()).has_value());
+}
+
+TEST(NetlinkMonitor, loopback) {
+    const auto links = NetlinkMonitor::get_links();
+    ASSERT_TRUE(links.has_value());
+    const auto loopback = std::find_if(links->begin(), links->end(),
+                                       [](const NetlinkLink& link) { return link.type == ARPHRD_LOOPBACK; });
+    ASSERT_NE(loopback, links->end());
+
+    EXPECT_TRUE(NetlinkMonitor::get_addresses().has_value());
+}
+
+} // namespace
@@ -0,0 +1,235 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "RunApplicationStub.hpp"
+#include <WpaCtrl.hpp>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+using namespace module;
+
+class WpaCtrlSetupTest : public WpaCtrlSetup {
+public:
+    using WpaCtrlSetup::WpaCtrlSetup;
+
+    // override to support testing
+    virtual bool is_wifi_interface(const std::string& interface) override {
+        return interface != "eth0";
+    };
+};
+
+// answers requests like wpa_supplicant on <directory>/wlan0
+class FakeWpaSupplicant {
+public:
+    std::map<std::string, std::string> replies{
+        {"ADD_NETWORK", "0\n"},
+        {"SCAN", "OK\n"},
+        {"SCAN_RESULTS", "bssid / frequency / signal level / flags / ssid\n"
+                         "14:49:bc:06:81:19\t2412\t-72\t[WPA2-PSK-CCMP][ESS]\tPlusnetWireless\n"},
+    };
+    // events sent to attached clients after the reply to a request
+    std::map<std::string, std::vector<std::string>> events{
+        {"SCAN", {"<3>CTRL-EVENT-SCAN-STARTED ", "<3>CTRL-EVENT-SCAN-RESULTS "}},
+    };
+
+    FakeWpaSupplicant() {
+        char directory_template[] = "/tmp/wpa_ctrl_test_XXXXXX";
+        directory = mkdtemp(directory_template);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, (directory + "/wlan0").c_str(), sizeof(address.sun_path) - 1);
+        fd = socket(PF_UNIX, SOCK_DGRAM, 0);
+        bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        thread = std::thread([this] { run(); });
+    }
+
+    ~FakeWpaSupplicant() {
+        running = false;
+        thread.join();
+        close(fd);
+        std::filesystem::remove_all(directory);
+    }
+
+    std::vector<std::string> get_requests() {
+        std::lock_guard<std::mutex> lk(mutex);
+        return requests;
+    }
+
+    void send_event(const std::string& event) {
+        std::lock_guard<std::mutex> lk(mutex);
+        for (const auto& client : attached) {
+            sendto(fd, event.data(), event.size(), 0, reinterpret_cast<const sockaddr*>(&client), sizeof(client));
+        }
+    }
+
+    std::string directory;
+
+private:
+    int fd;
+    bool running{true};
+    std::thread thread;
+    std::mutex mutex;
+    std::vector<std::string> requests;
+    std::vector<sockaddr_un> attached;
+
+    void run() {
+        pollfd pfd{fd, POLLIN, 0};
+        while (running) {
+            if (poll(&pfd, 1, 50) <= 0) {
+                continue;
+            }
+            char buffer[4096];
+            sockaddr_un client{};
+            socklen_t client_size = sizeof(client);
+            const auto size =
+                recvfrom(fd, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr*>(&client), &client_size);
+            const std::string request(buffer, size);
+            const auto command = request.substr(0, request.find(' '));
+
+            std::string reply = "OK\n";
+            {
+                std::lock_guard<std::mutex> lk(mutex);
+                requests.push_back(request);
+                if (command == "ATTACH") {
+                    attached.push_back(client);
+                } else if (command == "PING") {
+                    reply = "PONG\n";
+                } else if (auto it = replies.find(command); it != replies.end()) {
+                    reply = it->second;
+                }
+            }
+            sendto(fd, reply.data(), reply.size(), 0, reinterpret_cast<sockaddr*>(&client), client_size);
+            if (auto it = events.find(command); it != events.end()) {
+                for (const auto& event : it->second) {
+                    send_event(event);
+                }
+            }
+        }
+    }
+};
+
+//-----------------------------------------------------------------------------
+// request and reply conversions
+TEST(WpaCtrlSetup, to_request) {
+    EXPECT_EQ(WpaCtrlSetup::to_request({"scan"}), "SCAN");
+    EXPECT_EQ(WpaCtrlSetup::to_request({"set_network", "0", "key_mgmt", "WPA-PSK WPA-PSK-SHA256 SAE"}),
+              "SET_NETWORK 0 key_mgmt WPA-PSK WPA-PSK-SHA256 SAE");
+}
+
+TEST(WpaCtrlSetup, to_cmd_output) {
+    auto output = WpaCtrlSetup::to_cmd_output("id=0\nssid=test\n");
+    EXPECT_EQ(output.exit_code, 0);
+    ASSERT_EQ(output.split_output.size(), 2);
+    EXPECT_EQ(output.split_output[1], "ssid=test");
+
+    EXPECT_EQ(WpaCtrlSetup::to_cmd_output("FAIL\n").exit_code, 1);
+    EXPECT_EQ(WpaCtrlSetup::to_cmd_output("FAIL-BUSY\n").exit_code, 1);
+    EXPECT_EQ(WpaCtrlSetup::to_cmd_output("UNKNOWN COMMAND\n").exit_code, 1);
+}
+
+TEST(WpaCtrl, strip_level) {
+    EXPECT_EQ(WpaCtrl::strip_level("<3>CTRL-EVENT-CONNECTED - Connection to 00:11:22:33:44:55 completed"),
+              "CTRL-EVENT-CONNECTED - Connection to 00:11:22:33:44:55 completed");
+    EXPECT_EQ(WpaCtrl::strip_level("OK"), "OK");
+}
+
+//-----------------------------------------------------------------------------
+// commands over the control socket
+TEST(WpaCtrlSetup, set_network) {
+    FakeWpaSupplicant wpa_supplicant;
+    WpaCtrlSetupTest obj(wpa_supplicant.directory);
+
+    EXPECT_EQ(obj.add_network("wlan0"), 0);
+    EXPECT_TRUE(obj.set_network("wlan0", 0, "AB", "LetMeIn2", WpaCliSetup::network_security_t::wpa2_only, false));
+
+    const auto requests = wpa_supplicant.get_requests();
+    ASSERT_EQ(requests.size(), 4);
+    EXPECT_EQ(requests[0], "ADD_NETWORK");
+    EXPECT_EQ(requests[1], "SET_NETWORK 0 ssid 4142");
+    EXPECT_EQ(requests[2], "SET_NETWORK 0 psk LetMeIn2");
+    EXPECT_EQ(requests[3], "SET_NETWORK 0 key_mgmt WPA-PSK");
+}
+
+TEST(WpaCtrlSetup, failure) {
+    FakeWpaSupplicant wpa_supplicant;
+    wpa_supplicant.replies["ENABLE_NETWORK"] = "FAIL\n";
+    WpaCtrlSetupTest obj(wpa_supplicant.directory);
+    // unlike wpa_cli the failure is detected
+    EXPECT_FALSE(obj.enable_network("wlan0", 1));
+}
+
+TEST(WpaCtrlSetup, scan_wifi) {
+    FakeWpaSupplicant wpa_supplicant;
+    WpaCtrlSetupTest obj(wpa_supplicant.directory);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto res = obj.scan_wifi("wlan0");
+    // returns with the CTRL-EVENT-SCAN-RESULTS event instead of waiting for a fixed time
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    ASSERT_EQ(res.size(), 1);
+    EXPECT_EQ(res[0].ssid, "PlusnetWireless");
+    EXPECT_EQ(res[0].signal_level, -72);
+}
+
+TEST(WpaCtrlSetup, scan_failure_detaches) {
+    FakeWpaSupplicant wpa_supplicant;
+    wpa_supplicant.replies["SCAN"] = "FAIL\n";
+    WpaCtrlSetupTest obj(wpa_supplicant.directory);
+
+    EXPECT_TRUE(obj.scan_wifi("wlan0").empty());
+    // the events of a failed scan are not waited for, so they are detached before scan_wifi returns
+    const auto requests = wpa_supplicant.get_requests();
+    ASSERT_FALSE(requests.empty());
+    EXPECT_EQ(requests.back(), "DETACH");
+}
+
+TEST(WpaCtrlSetup, fallback_to_wpa_cli) {
+    stub::RunApplication ra;
+    WpaCtrlSetupTest obj("/nonexistent");
+    EXPECT_EQ(obj.add_network("wlan0"), 0);
+}
+
+//-----------------------------------------------------------------------------
+// events
+TEST(WpaCtrlMonitor, events) {
+    FakeWpaSupplicant wpa_supplicant;
+    std::mutex mutex;
+    std::vector<std::string> events;
+    WpaCtrlMonitor monitor(wpa_supplicant.directory, "wlan0",
+                           [&mutex, &events](const std::string& interface, const std::string& event) {
+                               EXPECT_EQ(interface, "wlan0");
+                               std::lock_guard<std::mutex> lk(mutex);
+                               events.push_back(event);
+                           });
+    monitor.start();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        wpa_supplicant.send_event("<3>CTRL-EVENT-CONNECTED - Connection to 00:11:22:33:44:55 completed");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::lock_guard<std::mutex> lk(mutex);
+        if (!events.empty()) {
+            break;
+        }
+    }
+    monitor.stop();
+
+    ASSERT_FALSE(events.empty());
+    EXPECT_EQ(events[0], "CTRL-EVENT-CONNECTED - Connection to 00:11:22:33:44:55 completed");
+}
+
+} // namespace
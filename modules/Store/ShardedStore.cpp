@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "ShardedStore.hpp"
+
+#include <mutex>
+
+namespace module {
+
+namespace {
+// expired entries of a shard are swept every this many writes to it
+constexpr std::size_t SWEEP_INTERVAL = 64;
+} // namespace
+
+ShardedStore::ShardedStore(std::size_t shard_count, std::function<Clock::time_point()> now) :
+    shard_count(shard_count > 0 ? shard_count : 1),
+    shards(std::make_unique<Shard[]>(this->shard_count)),
+    now(std::move(now)) {
+}
+
+ShardedStore::Shard& ShardedStore::shard_for(const std::string& key) const {
+    return this->shards[std::hash<std::string>{}(key) % this->shard_count];
+}
+
+bool ShardedStore::expired(const Entry& entry) const {
+    // only entries with a time to live need the clock
+    return entry.expires_at != Clock::time_point::max() && entry.expires_at <= this->now();
+}
+
+void ShardedStore::sweep(Shard& shard, Clock::time_point now) {
+    for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+        if (it->second.expires_at <= now) {
+            it = shard.entries.erase(it);
+            shard.expiring_entries--;
+        } else {
+            ++it;
+        }
+    }
+    shard.writes_since_sweep = 0;
+}
+
+void ShardedStore::store(const std::string& key, StoreValue value, std::chrono::milliseconds ttl) {
+    const auto now = this->now();
+    const auto expires_at = ttl.count() > 0 ? now + ttl : Clock::time_point::max();
+    auto& shard = this->shard_for(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end()) {
+        shard.entries.emplace(key, Entry{std::move(value), expires_at});
+    } else {
+        if (it->second.expires_at != Clock::time_point::max()) {
+            shard.expiring_entries--;
+        }
+        it->second.value = std::move(value);
+        it->second.expires_at = expires_at;
+    }
+    if (expires_at != Clock::time_point::max()) {
+        shard.expiring_entries++;
+    }
+
+    if (shard.expiring_entries > 0 && ++shard.writes_since_sweep >= SWEEP_INTERVAL) {
+        this->sweep(shard, now);
+    }
+}
+
+std::optional<StoreValue> ShardedStore::load(const std::string& key) const {
+    const auto& shard = this->shard_for(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end() || this->expired(it->second)) {
+        return std::nullopt;
+    }
+    return it->second.value;
+}
+
+bool ShardedStore::remove(const std::string& key) {
+    auto& shard = this->shard_for(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end()) {
+        return false;
+    }
+    const bool expired = this->expired(it->second);
+    if (it->second.expires_at != Clock::time_point::max()) {
+        shard.expiring_entries--;
+    }
+    shard.entries.erase(it);
+    return !expired;
+}
+
+bool ShardedStore::exists(const std::string& key) const {
+    const auto& shard = this->shard_for(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    return it != shard.entries.end() && !this->expired(it->second);
+}
+
+std::size_t ShardedStore::size() const {
+    const auto now = this->now();
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < this->shard_count; i++) {
+        const auto& shard = this->shards[i];
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        if (shard.expiring_entries == 0) {
+            count += shard.entries.size();
+            continue;
+        }
+        for (const auto& [key, entry] : shard.entries) {
+            if (entry.expires_at > now) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+} // namespace module
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef STORE_SHARDED_STORE_HPP
+#define STORE_SHARDED_STORE_HPP
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <variant>
+
+#include <kvs_value.hpp>
+
+namespace module {
+
+using StoreValue = kvs::Value;
+
+///
+/// \brief Thread safe in-memory key-value map
+///
+/// Keys are distributed over a fixed number of shards by hash, every shard has its own
+/// reader/writer lock, so concurrent calls only contend when they hit the same shard and
+/// concurrent loads never block each other.
+/// Values can be given a time to live. Expired values are invisible immediately and removed
+/// lazily when the shard is written to.
+///
+class ShardedStore {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ShardedStore(std::size_t shard_count = 16, std::function<Clock::time_point()> now = Clock::now);
+
+    /// \param ttl time to live of the value, zero if it does not expire
+    void store(const std::string& key, StoreValue value,
+               std::chrono::milliseconds ttl = std::chrono::milliseconds::zero());
+
+    /// \return the value stored under key, std::nullopt if there is none or it expired
+    std::optional<StoreValue> load(const std::string& key) const;
+
+    /// \return true if a value was removed
+    bool remove(const std::string& key);
+
+    bool exists(const std::string& key) const;
+
+    /// \return number of values that did not expire yet
+    std::size_t size() const;
+
+private:
+    struct Entry {
+        StoreValue value;
+        // Clock::time_point::max() if the entry does not expire
+        Clock::time_point expires_at;
+    };
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, Entry> entries;
+        std::size_t expiring_entries{0};
+        std::size_t writes_since_sweep{0};
+    };
+
+    Shard& shard_for(const std::string& key) const;
+    bool expired(const Entry& entry) const;
+    void sweep(Shard& shard, Clock::time_point now);
+
+    std::size_t shard_count;
+    std::unique_ptr<Shard[]> shards;
+    std::function<Clock::time_point()> now;
+};
+
+} // namespace module
+
+#endif // STORE_SHARDED_STORE_HPP
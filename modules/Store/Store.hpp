@@ -19,7 +19,9 @@
 
 namespace module {
 
-struct Conf {};
+struct Conf {
+    int shards;
+};
 
 class Store : public Everest::ModuleBase {
 public:
@@ -2,10 +2,14 @@
 // Copyright 2020 - 2021 Pionix GmbH and Contributors to EVerest
 #include "kvsImpl.hpp"
 
+#include <stdexcept>
+#include <vector>
+
 namespace module {
 namespace main {
 
 void kvsImpl::init() {
+    this->kvs = std::make_unique<ShardedStore>(static_cast<std::size_t>(mod->config.shards));
 }
 
 void kvsImpl::ready() {
@@ -13,19 +17,45 @@ void kvsImpl::ready() {
 
 void kvsImpl::handle_store(std::string& key,
                            std::variant<std::nullptr_t, Array, Object, bool, double, int, std::string>& value) {
-    kvs[key] = value;
+    this->kvs->store(key, value);
 };
 
 std::variant<std::nullptr_t, Array, Object, bool, double, int, std::string> kvsImpl::handle_load(std::string& key) {
-    return kvs[key];
+    return this->kvs->load(key).value_or(nullptr);
 };
 
 void kvsImpl::handle_delete(std::string& key) {
-    kvs.erase(key);
+    this->kvs->remove(key);
 };
 
 bool kvsImpl::handle_exists(std::string& key) {
-    return kvs.count(key) != 0;
+    return this->kvs->exists(key);
+};
+
+void kvsImpl::handle_store_many(Object& entries, int& ttl_s) {
+    // convert all entries first, so that a rejected value does not leave the others half stored
+    std::vector<std::pair<std::string, StoreValue>> values;
+    values.reserve(entries.size());
+    try {
+        for (const auto& [key, value] : entries) {
+            values.emplace_back(key, kvs::from_json(value));
+        }
+    } catch (const std::out_of_range& e) {
+        EVLOG_error << "Store: Not storing any of " << entries.size() << " values: " << e.what();
+        return;
+    }
+    for (auto& [key, value] : values) {
+        this->kvs->store(key, std::move(value), std::chrono::seconds(ttl_s));
+    }
+};
+
+Object kvsImpl::handle_load_many(Array& keys) {
+    Object values;
+    for (const auto& key : keys) {
+        const auto value = this->kvs->load(key.get<std::string>());
+        values[key.get<std::string>()] = value.has_value() ? kvs::to_json(value.value()) : json(nullptr);
+    }
+    return values;
 };
 
 } // namespace main
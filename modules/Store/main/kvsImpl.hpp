@@ -13,7 +13,7 @@
 #include "../Store.hpp"
 
 // ev@75ac1216-19eb-4182-a85c-820f1fc2c091:v1
-#include <map>
+#include "../ShardedStore.hpp"
 // ev@75ac1216-19eb-4182-a85c-820f1fc2c091:v1
 
 namespace module {
@@ -40,6 +40,8 @@ protected:
     handle_load(std::string& key) override;
     virtual void handle_delete(std::string& key) override;
     virtual bool handle_exists(std::string& key) override;
+    virtual void handle_store_many(Object& entries, int& ttl_s) override;
+    virtual Object handle_load_many(Array& keys) override;
 
     // ev@d2d1847a-7b88-41dd-ad07-92785f06f5c4:v1
     // insert your protected definitions here
@@ -53,7 +55,7 @@ private:
     virtual void ready() override;
 
     // ev@3370e4dd-95f4-47a9-aaec-ea76f34a66c9:v1
-    std::map<std::string, std::variant<std::nullptr_t, Array, Object, bool, double, int, std::string>> kvs{};
+    std::unique_ptr<ShardedStore> kvs;
     // ev@3370e4dd-95f4-47a9-aaec-ea76f34a66c9:v1
 };
 
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+// Compares ShardedStore with the std::map the Store module used before.
+// Benchmarks are hidden by default, run them with: <test binary> "[!benchmark]"
+
+#include <catch2/catch_all.hpp>
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../ShardedStore.hpp"
+
+using namespace module;
+
+namespace {
+constexpr int KEY_COUNT = 500;
+constexpr int THREAD_COUNT = 4;
+constexpr int OPERATIONS_PER_THREAD = 10000;
+
+std::vector<std::string> make_keys() {
+    std::vector<std::string> keys;
+    for (int i = 0; i < KEY_COUNT; i++) {
+        // key shapes similar to the ones EvseManager and OCPP use
+        keys.push_back("EvseManager_connector_1.session_" + std::to_string(i));
+    }
+    return keys;
+}
+
+class LockedMap {
+public:
+    void store(const std::string& key, const StoreValue& value) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->map[key] = value;
+    }
+
+    StoreValue load(const std::string& key) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto it = this->map.find(key);
+        return it != this->map.end() ? it->second : StoreValue{};
+    }
+
+private:
+    std::mutex mutex;
+    std::map<std::string, StoreValue> map;
+};
+
+// 9 loads per store, run by THREAD_COUNT threads in parallel
+template <typename StoreType> void mixed_workload(StoreType& store, const std::vector<std::string>& keys) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        threads.emplace_back([&store, &keys, t]() {
+            for (int i = 0; i < OPERATIONS_PER_THREAD; i++) {
+                const auto& key = keys[(i * 7 + t) % KEY_COUNT];
+                if (i % 10 == 0) {
+                    store.store(key, i);
+                } else {
+                    store.load(key);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+} // namespace
+
+TEST_CASE("Store lookups", "[!benchmark][ShardedStore]") {
+    const auto keys = make_keys();
+    std::map<std::string, StoreValue> map;
+    ShardedStore sharded;
+    for (const auto& key : keys) {
+        map[key] = 1;
+        sharded.store(key, 1);
+    }
+
+    BENCHMARK("std::map load") {
+        int found = 0;
+        for (const auto& key : keys) {
+            // the previous handle_load returned a copy of the value
+            const StoreValue value = map[key];
+            found += std::holds_alternative<int>(value);
+        }
+        return found;
+    };
+
+    BENCHMARK("ShardedStore load") {
+        int found = 0;
+        for (const auto& key : keys) {
+            found += sharded.load(key).has_value();
+        }
+        return found;
+    };
+}
+
+TEST_CASE("Concurrent store access", "[!benchmark][ShardedStore]") {
+    const auto keys = make_keys();
+
+    BENCHMARK("std::map with mutex, 4 threads") {
+        LockedMap map;
+        mixed_workload(map, keys);
+    };
+
+    BENCHMARK("ShardedStore, 4 threads") {
+        ShardedStore sharded;
+        mixed_workload(sharded, keys);
+    };
+}
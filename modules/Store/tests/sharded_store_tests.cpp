@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <catch2/catch_all.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "../ShardedStore.hpp"
+
+using namespace module;
+using namespace std::chrono_literals;
+
+SCENARIO("Values can be stored, loaded and removed", "[ShardedStore]") {
+    ShardedStore store(4);
+    WHEN("Nothing is stored") {
+        THEN("Loads miss without inserting the key") {
+            REQUIRE_FALSE(store.load("missing").has_value());
+            REQUIRE_FALSE(store.exists("missing"));
+            REQUIRE(store.size() == 0);
+        }
+    }
+    WHEN("Values of all types are stored") {
+        Object object;
+        object["a"] = 1;
+        store.store("null", nullptr);
+        store.store("array", Array{1, 2, 3});
+        store.store("object", object);
+        store.store("bool", true);
+        store.store("double", 1.5);
+        store.store("int", 42);
+        store.store("string", std::string("value"));
+        THEN("They are loaded with their type") {
+            REQUIRE(store.size() == 7);
+            REQUIRE(std::holds_alternative<std::nullptr_t>(store.load("null").value()));
+            REQUIRE(std::get<Array>(store.load("array").value()).size() == 3);
+            REQUIRE(std::get<Object>(store.load("object").value()).at("a") == 1);
+            REQUIRE(std::get<bool>(store.load("bool").value()));
+            REQUIRE(std::get<double>(store.load("double").value()) == 1.5);
+            REQUIRE(std::get<int>(store.load("int").value()) == 42);
+            REQUIRE(std::get<std::string>(store.load("string").value()) == "value");
+        }
+        THEN("Storing again replaces the value") {
+            store.store("int", std::string("replaced"));
+            REQUIRE(std::get<std::string>(store.load("int").value()) == "replaced");
+            REQUIRE(store.size() == 7);
+        }
+        THEN("Removed values are gone") {
+            REQUIRE(store.remove("int"));
+            REQUIRE_FALSE(store.remove("int"));
+            REQUIRE_FALSE(store.exists("int"));
+            REQUIRE(store.size() == 6);
+        }
+    }
+}
+
+SCENARIO("Values expire after their time to live", "[ShardedStore]") {
+    ShardedStore::Clock::time_point now{};
+    ShardedStore store(2, [&now]() { return now; });
+    store.store("volatile", 1, 10s);
+    store.store("permanent", 2);
+
+    REQUIRE(store.exists("volatile"));
+    now += 9s;
+    REQUIRE(std::get<int>(store.load("volatile").value()) == 1);
+    now += 1s;
+    REQUIRE_FALSE(store.load("volatile").has_value());
+    REQUIRE_FALSE(store.exists("volatile"));
+    REQUIRE(store.exists("permanent"));
+    REQUIRE(store.size() == 1);
+    REQUIRE_FALSE(store.remove("volatile"));
+
+    WHEN("An expiring key is stored again without time to live") {
+        store.store("volatile", 3, 1s);
+        store.store("volatile", 4);
+        now += 1h;
+        THEN("It does not expire anymore") {
+            REQUIRE(std::get<int>(store.load("volatile").value()) == 4);
+        }
+    }
+    WHEN("Many values are written") {
+        for (int i = 0; i < 1000; i++) {
+            store.store("key" + std::to_string(i), i, 1s);
+        }
+        now += 2s;
+        for (int i = 0; i < 200; i++) {
+            store.store("other" + std::to_string(i), i);
+        }
+        THEN("Only the values without time to live remain") {
+            REQUIRE(store.size() == 201);
+        }
+    }
+}
+
+SCENARIO("Values are converted from and to json", "[ShardedStore]") {
+    const json values =
+        json::parse(R"({"a": null, "b": [1], "c": {"d": 2}, "e": false, "f": 0.25, "g": -3, "h": "x"})");
+    for (const auto& [key, value] : values.items()) {
+        REQUIRE(kvs::to_json(kvs::from_json(value)) == value);
+    }
+    REQUIRE(std::holds_alternative<int>(kvs::from_json(values.at("g"))));
+    REQUIRE(std::holds_alternative<double>(kvs::from_json(values.at("f"))));
+}
+
+SCENARIO("The store can be used from several threads", "[ShardedStore]") {
+    ShardedStore store(8);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&store, t]() {
+            for (int i = 0; i < 2000; i++) {
+                const std::string key = "key" + std::to_string(i % 100);
+                store.store(key, t, (i % 3 == 0) ? 1h : 0ms);
+                store.load("key" + std::to_string((i + 50) % 100));
+                if (i % 7 == 0) {
+                    store.remove(key);
+                }
+            }
+            store.store("thread" + std::to_string(t), t);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < 8; t++) {
+        REQUIRE(std::get<int>(store.load("thread" + std::to_string(t)).value()) == t);
+    }
+}
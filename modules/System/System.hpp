@@ -23,6 +23,10 @@ struct Conf {
     double DefaultRetries;
     double DefaultRetryInterval;
     int ResetDelay;
+    std::string SignedFirmwareInstallTarget;
+    std::string DiagnosticsLogPaths;
+    bool DiagnosticsJournal;
+    std::string DiagnosticsErrorDatabase;
 };
 
 class System : public Everest::ModuleBase {
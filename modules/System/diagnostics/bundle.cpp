@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "bundle.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <zstd.h>
+
+namespace diagnostics {
+
+namespace {
+const std::size_t BLOCK_SIZE = 512;
+// the largest size the 11 octal digits of the size field can hold
+const std::uint64_t MAX_ENTRY_SIZE = 077777777777ULL;
+const std::size_t NAME_LENGTH = 100;
+const char* LONG_NAME = "././@LongLink";
+
+void write_octal(std::uint8_t* field, std::size_t width, std::uint64_t value) {
+    // width - 1 digits and a terminating NUL
+    char buffer[24];
+    std::snprintf(buffer, sizeof(buffer), "%0*llo", static_cast<int>(width - 1),
+                  static_cast<unsigned long long>(value));
+    std::memcpy(field, buffer, width);
+}
+
+// appends a ustar header block
+void append_header(std::vector<std::uint8_t>& out, const std::string& name, std::uint64_t size, std::time_t mtime,
+                   char type) {
+    const auto offset = out.size();
+    out.resize(offset + BLOCK_SIZE, 0);
+    auto block = &out[offset];
+
+    std::memcpy(block, name.data(), std::min(name.size(), NAME_LENGTH));
+    write_octal(block + 100, 8, 0644);
+    write_octal(block + 108, 8, 0);
+    write_octal(block + 116, 8, 0);
+    write_octal(block + 124, 12, size);
+    write_octal(block + 136, 12, std::max<std::time_t>(mtime, 0));
+    block[156] = type;
+    std::memcpy(block + 257, "ustar", 6);
+    std::memcpy(block + 263, "00", 2);
+
+    // the checksum is calculated with the checksum field set to spaces
+    std::memset(block + 148, ' ', 8);
+    unsigned int checksum = 0;
+    for (std::size_t i = 0; i < BLOCK_SIZE; ++i) {
+        checksum += block[i];
+    }
+    write_octal(block + 148, 7, checksum);
+}
+
+std::size_t padding(std::uint64_t size) {
+    return (BLOCK_SIZE - size % BLOCK_SIZE) % BLOCK_SIZE;
+}
+} // namespace
+
+TarStream::TarStream(std::vector<std::unique_ptr<Source>> sources_) : sources(std::move(sources_)) {
+}
+
+std::size_t TarStream::read(std::uint8_t* data, std::size_t length) {
+    std::size_t produced = 0;
+    while (produced < length) {
+        switch (state) {
+        case State::NextEntry:
+            if (next_entry()) {
+                make_header();
+                state = State::Header;
+            } else {
+                // end of archive
+                header.assign(2 * BLOCK_SIZE, 0);
+                header_position = 0;
+                state = State::Trailer;
+            }
+            break;
+
+        case State::Header:
+        case State::Trailer: {
+            const auto count = std::min(header.size() - header_position, length - produced);
+            std::memcpy(data + produced, &header[header_position], count);
+            header_position += count;
+            produced += count;
+            if (header_position == header.size()) {
+                if (state == State::Trailer) {
+                    state = State::Done;
+                } else {
+                    remaining = entry.size;
+                    state = State::Data;
+                }
+            }
+            break;
+        }
+
+        case State::Data: {
+            if (remaining == 0) {
+                remaining = padding(entry.size);
+                state = State::Padding;
+                break;
+            }
+            const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, length - produced));
+            auto read = entry.read(data + produced, count);
+            if (read == 0) {
+                // the entry is shorter than announced
+                std::memset(data + produced, 0, count);
+                read = count;
+            }
+            produced += read;
+            remaining -= read;
+            break;
+        }
+
+        case State::Padding: {
+            const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, length - produced));
+            std::memset(data + produced, 0, count);
+            produced += count;
+            remaining -= count;
+            if (remaining == 0) {
+                // releases whatever the entry has opened
+                entry = Entry();
+                state = State::NextEntry;
+            }
+            break;
+        }
+
+        case State::Done:
+            return produced;
+        }
+    }
+    return produced;
+}
+
+bool TarStream::next_entry() {
+    while (current_source < sources.size()) {
+        if (sources[current_source]->next(entry)) {
+            if (entry.size > MAX_ENTRY_SIZE) {
+                continue;
+            }
+            entry_count++;
+            return true;
+        }
+        sources[current_source].reset();
+        current_source++;
+    }
+    return false;
+}
+
+void TarStream::make_header() {
+    header.clear();
+    header_position = 0;
+
+    if (entry.name.size() > NAME_LENGTH) {
+        // GNU extension, the name is the content of an entry of its own in front of the actual entry
+        append_header(header, LONG_NAME, entry.name.size() + 1, 0, 'L');
+        header.insert(header.end(), entry.name.begin(), entry.name.end());
+        header.resize(header.size() + 1 + padding(entry.name.size() + 1), 0);
+    }
+    append_header(header, entry.name, entry.size, entry.modification_time, '0');
+}
+
+ZstdStream::ZstdStream(ByteStream& input_, int compression_level) :
+    input(input_),
+    context(ZSTD_createCCtx()),
+    input_buffer(ZSTD_CStreamInSize()),
+    output_buffer(ZSTD_CStreamOutSize()) {
+    if (context == nullptr) {
+        throw std::runtime_error("Could not create zstd context");
+    }
+    ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, compression_level);
+    ZSTD_CCtx_setParameter(context, ZSTD_c_checksumFlag, 1);
+}
+
+ZstdStream::~ZstdStream() {
+    ZSTD_freeCCtx(context);
+}
+
+std::size_t ZstdStream::read(std::uint8_t* data, std::size_t length) {
+    std::size_t produced = 0;
+    while (produced < length) {
+        if (output_position < output_size) {
+            const auto count = std::min(output_size - output_position, length - produced);
+            std::memcpy(data + produced, &output_buffer[output_position], count);
+            output_position += count;
+            produced += count;
+            continue;
+        }
+        if (frame_ended) {
+            break;
+        }
+
+        if (input_position == input_size and not input_ended) {
+            input_position = 0;
+            input_size = 0;
+            while (input_size < input_buffer.size()) {
+                const auto read = input.read(&input_buffer[input_size], input_buffer.size() - input_size);
+                if (read == 0) {
+                    input_ended = true;
+                    break;
+                }
+                input_size += read;
+            }
+        }
+
+        ZSTD_inBuffer in{input_buffer.data(), input_size, input_position};
+        ZSTD_outBuffer out{output_buffer.data(), output_buffer.size(), 0};
+        const auto left = ZSTD_compressStream2(context, &out, &in, input_ended ? ZSTD_e_end : ZSTD_e_continue);
+        if (ZSTD_isError(left)) {
+            throw std::runtime_error(std::string("zstd compression failed: ") + ZSTD_getErrorName(left));
+        }
+        input_position = in.pos;
+        output_position = 0;
+        output_size = out.pos;
+        if (input_ended and left == 0) {
+            frame_ended = true;
+        }
+    }
+    return produced;
+}
+
+} // namespace diagnostics
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef DIAGNOSTICS_BUNDLE_HPP
+#define DIAGNOSTICS_BUNDLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// forward declare
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+
+namespace diagnostics {
+
+// Bytes that are produced while they are read.
+class ByteStream {
+public:
+    virtual ~ByteStream() = default;
+    // fills up to length bytes, returns 0 once the stream has ended
+    virtual std::size_t read(std::uint8_t* data, std::size_t length) = 0;
+};
+
+struct Entry {
+    std::string name;
+    std::uint64_t size{0};
+    std::time_t modification_time{0};
+    // reads the content of the entry, size bytes in total
+    std::function<std::size_t(std::uint8_t* data, std::size_t length)> read;
+};
+
+// Lazily provides the entries of the bundle, one at a time.
+class Source {
+public:
+    virtual ~Source() = default;
+    // returns false once there are no more entries
+    virtual bool next(Entry& entry) = 0;
+};
+
+// Writes the entries of the sources as ustar archive, entry by entry as the archive is read.
+//
+// Only the current entry is open at any time. Its size is taken from the entry: content that is missing because a file
+// shrank meanwhile is filled with zeros, anything beyond the size is cut off.
+class TarStream : public ByteStream {
+public:
+    explicit TarStream(std::vector<std::unique_ptr<Source>> sources);
+
+    std::size_t read(std::uint8_t* data, std::size_t length) override;
+
+    std::size_t get_entry_count() const {
+        return entry_count;
+    }
+
+private:
+    enum class State {
+        NextEntry,
+        Header,
+        Data,
+        Padding,
+        Trailer,
+        Done,
+    };
+
+    bool next_entry();
+    void make_header();
+
+    std::vector<std::unique_ptr<Source>> sources;
+    std::size_t current_source{0};
+    Entry entry;
+    std::size_t entry_count{0};
+
+    State state{State::NextEntry};
+    // header blocks of the current entry, with a long name block if needed
+    std::vector<std::uint8_t> header;
+    std::size_t header_position{0};
+    std::uint64_t remaining{0};
+};
+
+// Compresses another stream to a zstd frame while it is read, with buffers of constant size.
+class ZstdStream : public ByteStream {
+public:
+    ZstdStream(ByteStream& input, int compression_level);
+    ~ZstdStream() override;
+
+    ZstdStream(const ZstdStream&) = delete;
+    ZstdStream& operator=(const ZstdStream&) = delete;
+
+    std::size_t read(std::uint8_t* data, std::size_t length) override;
+
+private:
+    ByteStream& input;
+    ZSTD_CCtx* context{nullptr};
+
+    std::vector<std::uint8_t> input_buffer;
+    std::size_t input_position{0};
+    std::size_t input_size{0};
+    bool input_ended{false};
+
+    std::vector<std::uint8_t> output_buffer;
+    std::size_t output_position{0};
+    std::size_t output_size{0};
+    bool frame_ended{false};
+};
+
+} // namespace diagnostics
+
+#endif // DIAGNOSTICS_BUNDLE_HPP
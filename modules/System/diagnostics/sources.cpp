@@ -0,0 +1,250 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "sources.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <SQLiteCpp/SQLiteCpp.h>
+
+namespace diagnostics {
+
+namespace {
+using TimePoint = std::chrono::system_clock::time_point;
+
+TimePoint to_time_point(const struct statx_timestamp& timestamp) {
+    return TimePoint(std::chrono::duration_cast<TimePoint::duration>(std::chrono::seconds(timestamp.tv_sec) +
+                                                                     std::chrono::nanoseconds(timestamp.tv_nsec)));
+}
+
+std::int64_t to_epoch_ms(const TimePoint& time_point) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time_point.time_since_epoch()).count();
+}
+
+std::int64_t to_epoch_s(const TimePoint& time_point) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time_point.time_since_epoch()).count();
+}
+
+class CommandStream : public ByteStream {
+public:
+    explicit CommandStream(const std::string& command) : pipe(popen(command.c_str(), "r")) {
+        if (pipe == nullptr) {
+            throw std::runtime_error("Could not run " + command);
+        }
+    }
+
+    ~CommandStream() override {
+        pclose(pipe);
+    }
+
+    std::size_t read(std::uint8_t* data, std::size_t length) override {
+        return std::fread(data, 1, length, pipe);
+    }
+
+private:
+    FILE* pipe;
+};
+
+// RFC3339 in UTC with milliseconds
+std::string format_epoch_ms(std::int64_t epoch_ms) {
+    const std::time_t seconds = epoch_ms / 1000;
+    std::tm time;
+    gmtime_r(&seconds, &time);
+    char buffer[32];
+    const auto length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &time);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%03dZ", static_cast<int>(epoch_ms % 1000));
+    return buffer;
+}
+
+void append_csv_field(std::string& line, const char* value) {
+    if (std::strpbrk(value, ",\"\r\n") == nullptr) {
+        line += value;
+        return;
+    }
+    line += '"';
+    for (auto c = value; *c != '\0'; ++c) {
+        if (*c == '"') {
+            line += '"';
+        }
+        line += *c;
+    }
+    line += '"';
+}
+
+class ErrorHistoryStream : public ByteStream {
+public:
+    ErrorHistoryStream(const std::filesystem::path& database_path, const TimeWindow& window) :
+        database(database_path.string(), SQLite::OPEN_READONLY),
+        statement(database, "SELECT timestamp, type, sub_type, severity, state, origin_module, origin_implementation, "
+                            "message, description, vendor_id, uuid FROM errors WHERE timestamp BETWEEN ?1 AND ?2 "
+                            "ORDER BY timestamp") {
+        statement.bind(1, window.oldest.has_value() ? to_epoch_ms(window.oldest.value())
+                                                    : std::numeric_limits<std::int64_t>::min());
+        statement.bind(2, window.latest.has_value() ? to_epoch_ms(window.latest.value())
+                                                    : std::numeric_limits<std::int64_t>::max());
+        line = "timestamp,type,sub_type,severity,state,origin_module,origin_implementation,message,description,"
+               "vendor_id,uuid\n";
+    }
+
+    std::size_t read(std::uint8_t* data, std::size_t length) override {
+        std::size_t produced = 0;
+        while (produced < length) {
+            if (line_position < line.size()) {
+                const auto count = std::min(line.size() - line_position, length - produced);
+                std::memcpy(data + produced, line.data() + line_position, count);
+                line_position += count;
+                produced += count;
+            } else if (done or not statement.executeStep()) {
+                done = true;
+                break;
+            } else {
+                // one row at a time
+                line = format_epoch_ms(statement.getColumn(0).getInt64());
+                for (int column = 1; column < statement.getColumnCount(); ++column) {
+                    line += ',';
+                    append_csv_field(line, statement.getColumn(column).getText());
+                }
+                line += '\n';
+                line_position = 0;
+            }
+        }
+        return produced;
+    }
+
+private:
+    SQLite::Database database;
+    SQLite::Statement statement;
+    std::string line;
+    std::size_t line_position{0};
+    bool done{false};
+};
+} // namespace
+
+bool TimeWindow::overlaps(TimePoint begin, TimePoint end) const {
+    return (not oldest.has_value() or end >= oldest.value()) and (not latest.has_value() or begin <= latest.value());
+}
+
+DirectorySource::DirectorySource(std::filesystem::path root_, std::string prefix_, TimeWindow window_) :
+    root(std::move(root_)), prefix(std::move(prefix_)), window(window_) {
+}
+
+bool DirectorySource::next(Entry& entry) {
+    namespace fs = std::filesystem;
+
+    std::error_code ec;
+    if (not iterator.has_value()) {
+        iterator.emplace(root, fs::directory_options::skip_permission_denied, ec);
+        if (ec) {
+            iterator.emplace();
+        }
+    }
+
+    auto& it = iterator.value();
+    while (it != fs::recursive_directory_iterator()) {
+        const auto path = it->path();
+        const auto regular_file = it->is_regular_file(ec);
+        it.increment(ec);
+        if (ec) {
+            it = fs::recursive_directory_iterator();
+        }
+        if (not regular_file) {
+            continue;
+        }
+
+        // follows symlinks like is_regular_file, so a linked log is sized like the file that is read
+        struct statx info;
+        if (statx(AT_FDCWD, path.c_str(), 0, STATX_SIZE | STATX_MTIME | STATX_BTIME, &info) != 0) {
+            continue;
+        }
+        const auto modified = to_time_point(info.stx_mtime);
+        // without the creation time the file may have been written at any time before its last modification
+        auto created = TimePoint::min();
+        if (info.stx_mask & STATX_BTIME) {
+            // a copy that kept the modification time is created after it was last modified
+            created = std::min(to_time_point(info.stx_btime), modified);
+        }
+        if (not window.overlaps(created, modified)) {
+            continue;
+        }
+
+        auto file = std::make_shared<std::ifstream>(path, std::ios::binary);
+        if (not file->is_open()) {
+            continue;
+        }
+
+        entry.name = prefix + "/" + path.lexically_relative(root).generic_string();
+        entry.size = info.stx_size;
+        entry.modification_time = info.stx_mtime.tv_sec;
+        entry.read = [file](std::uint8_t* data, std::size_t length) {
+            file->read(reinterpret_cast<char*>(data), length);
+            return static_cast<std::size_t>(file->gcount());
+        };
+        return true;
+    }
+    return false;
+}
+
+ChunkedSource::ChunkedSource(std::string prefix_, std::unique_ptr<ByteStream> stream_, std::size_t chunk_size) :
+    prefix(std::move(prefix_)), stream(std::move(stream_)), chunk(chunk_size) {
+}
+
+bool ChunkedSource::next(Entry& entry) {
+    if (ended) {
+        return false;
+    }
+
+    std::size_t size = 0;
+    while (size < chunk.size()) {
+        const auto read = stream->read(&chunk[size], chunk.size() - size);
+        if (read == 0) {
+            ended = true;
+            break;
+        }
+        size += read;
+    }
+    if (size == 0) {
+        return false;
+    }
+
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), ".%03zu", chunk_index++);
+    entry.name = prefix + suffix;
+    entry.size = size;
+    entry.modification_time = std::time(nullptr);
+    // the chunk stays valid until the next entry is requested
+    entry.read = [this, position = std::size_t{0}, size](std::uint8_t* data, std::size_t length) mutable {
+        const auto count = std::min(size - position, length);
+        std::memcpy(data, &chunk[position], count);
+        position += count;
+        return count;
+    };
+    return true;
+}
+
+std::unique_ptr<ByteStream> make_command_stream(const std::string& command) {
+    return std::make_unique<CommandStream>(command);
+}
+
+std::string make_journal_command(const TimeWindow& window) {
+    std::string command = "journalctl --no-pager --quiet --output=short-iso-precise";
+    if (window.oldest.has_value()) {
+        command += " --since=@" + std::to_string(to_epoch_s(window.oldest.value()));
+    }
+    if (window.latest.has_value()) {
+        command += " --until=@" + std::to_string(to_epoch_s(window.latest.value()));
+    }
+    return command + " 2>/dev/null";
+}
+
+std::unique_ptr<ByteStream> make_error_history_stream(const std::filesystem::path& database_path,
+                                                      const TimeWindow& window) {
+    return std::make_unique<ErrorHistoryStream>(database_path, window);
+}
+
+} // namespace diagnostics
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef DIAGNOSTICS_SOURCES_HPP
+#define DIAGNOSTICS_SOURCES_HPP
+
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "bundle.hpp"
+
+namespace diagnostics {
+
+// the time range a bundle is requested for, open ended if a limit is missing
+struct TimeWindow {
+    std::optional<std::chrono::system_clock::time_point> oldest;
+    std::optional<std::chrono::system_clock::time_point> latest;
+
+    // true if something that covers [begin, end] has any part in the window
+    bool overlaps(std::chrono::system_clock::time_point begin, std::chrono::system_clock::time_point end) const;
+};
+
+// The regular files below a directory that were written during the time window. A file covers the time from its
+// creation (if the file system records it) to its last modification.
+class DirectorySource : public Source {
+public:
+    DirectorySource(std::filesystem::path root, std::string prefix, TimeWindow window);
+
+    bool next(Entry& entry) override;
+
+private:
+    const std::filesystem::path root;
+    const std::string prefix;
+    const TimeWindow window;
+    std::optional<std::filesystem::recursive_directory_iterator> iterator;
+};
+
+// Splits a stream of unknown length, like the output of a command, into entries of at most the chunk size:
+// <prefix>.000, <prefix>.001 and so on. A tar entry needs its size up front, so one chunk is held in memory.
+class ChunkedSource : public Source {
+public:
+    ChunkedSource(std::string prefix, std::unique_ptr<ByteStream> stream, std::size_t chunk_size);
+
+    bool next(Entry& entry) override;
+
+private:
+    const std::string prefix;
+    std::unique_ptr<ByteStream> stream;
+    std::vector<std::uint8_t> chunk;
+    std::size_t chunk_index{0};
+    bool ended{false};
+};
+
+// standard output of a command run by the shell, e.g. journalctl
+std::unique_ptr<ByteStream> make_command_stream(const std::string& command);
+
+// the journalctl command for the time window
+std::string make_journal_command(const TimeWindow& window);
+
+// the errors of the time window from the database of the ErrorHistory module, as csv, read with the timestamp index
+std::unique_ptr<ByteStream> make_error_history_stream(const std::filesystem::path& database_path,
+                                                      const TimeWindow& window);
+
+} // namespace diagnostics
+
+#endif // DIAGNOSTICS_SOURCES_HPP
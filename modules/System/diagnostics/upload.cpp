@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "upload.hpp"
+
+#include <exception>
+#include <mutex>
+
+#include <curl/curl.h>
+
+namespace diagnostics {
+
+namespace {
+// a transfer that is slower than 1 byte/s for this long has failed
+const long STALLED_TRANSFER_TIMEOUT_S = 60;
+
+struct CurlUpload {
+    ByteStream& stream;
+    const std::atomic<bool>& interrupt;
+    std::uint64_t& uploaded_bytes;
+    bool cancelled{false};
+    std::string stream_error;
+};
+
+size_t read_callback(char* data, size_t size, size_t count, void* user_data) {
+    auto& upload = *static_cast<CurlUpload*>(user_data);
+    if (upload.interrupt) {
+        upload.cancelled = true;
+        return CURL_READFUNC_ABORT;
+    }
+
+    try {
+        const auto length = upload.stream.read(reinterpret_cast<std::uint8_t*>(data), size * count);
+        upload.uploaded_bytes += length;
+        return length;
+    } catch (const std::exception& e) {
+        // must not unwind through libcurl
+        upload.stream_error = e.what();
+        return CURL_READFUNC_ABORT;
+    }
+}
+
+// interrupts uploads that wait for the server as well
+int progress_callback(void* user_data, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    auto& upload = *static_cast<CurlUpload*>(user_data);
+    if (upload.interrupt) {
+        upload.cancelled = true;
+        return 1;
+    }
+    return 0;
+}
+
+UploadResult to_upload_result(CURLcode code) {
+    switch (code) {
+    case CURLE_OK:
+        return UploadResult::Uploaded;
+    case CURLE_REMOTE_ACCESS_DENIED:
+    case CURLE_SSL_CONNECT_ERROR:
+    case CURLE_LOGIN_DENIED:
+    case CURLE_TFTP_PERM:
+        return UploadResult::PermissionDenied;
+    case CURLE_URL_MALFORMAT:
+    case CURLE_COULDNT_RESOLVE_HOST:
+    case CURLE_FTP_ACCEPT_FAILED:
+    case CURLE_FTP_BAD_FILE_LIST:
+        return UploadResult::BadMessage;
+    case CURLE_UNSUPPORTED_PROTOCOL:
+        return UploadResult::NotSupportedOperation;
+    default:
+        return UploadResult::UploadFailure;
+    }
+}
+
+std::once_flag curl_initialized;
+} // namespace
+
+Upload::Upload(std::string location, const std::string& file_name, std::chrono::seconds connect_timeout_) :
+    url(std::move(location)), connect_timeout(connect_timeout_) {
+    if (not url.empty() and url.back() == '/') {
+        url += file_name;
+    }
+    std::call_once(curl_initialized, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+}
+
+UploadResult Upload::run(ByteStream& stream, const std::atomic<bool>& interrupt) {
+    error.clear();
+    uploaded_bytes = 0;
+
+    CURL* curl = curl_easy_init();
+    if (curl == nullptr) {
+        error = "Could not initialize libcurl";
+        return UploadResult::UploadFailure;
+    }
+
+    CurlUpload upload{stream, interrupt, uploaded_bytes, false, {}};
+    char error_buffer[CURL_ERROR_SIZE] = {0};
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+    // the size is unknown until the stream has ended, http uses chunked transfer encoding
+    curl_easy_setopt(curl, CURLOPT_READFUNCTION, read_callback);
+    curl_easy_setopt(curl, CURLOPT_READDATA, &upload);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progress_callback);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &upload);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, error_buffer);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, static_cast<long>(connect_timeout.count()));
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1L);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, STALLED_TRANSFER_TIMEOUT_S);
+
+    const auto code = curl_easy_perform(curl);
+    long response_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+    curl_easy_cleanup(curl);
+
+    if (upload.cancelled) {
+        return UploadResult::Cancelled;
+    }
+    if (not upload.stream_error.empty()) {
+        error = "Could not create bundle: " + upload.stream_error;
+        return UploadResult::UploadFailure;
+    }
+    if (code == CURLE_HTTP_RETURNED_ERROR and (response_code == 401 or response_code == 403)) {
+        error = "Server responded with " + std::to_string(response_code);
+        return UploadResult::PermissionDenied;
+    }
+    if (code != CURLE_OK) {
+        error = (error_buffer[0] != '\0') ? error_buffer : curl_easy_strerror(code);
+        return to_upload_result(code);
+    }
+    return UploadResult::Uploaded;
+}
+
+} // namespace diagnostics
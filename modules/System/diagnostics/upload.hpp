@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef DIAGNOSTICS_UPLOAD_HPP
+#define DIAGNOSTICS_UPLOAD_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "bundle.hpp"
+
+namespace diagnostics {
+
+// the outcomes the curl based upload script used to report
+enum class UploadResult {
+    Uploaded,
+    PermissionDenied,
+    BadMessage,
+    NotSupportedOperation,
+    UploadFailure,
+    Cancelled,
+};
+
+// Uploads a stream to everything libcurl can upload to (http(s) PUT, ftp, file and so on) while it is produced, so the
+// bundle is never stored in full. A location ending with '/' is a directory the file name is appended to.
+class Upload {
+public:
+    Upload(std::string location, const std::string& file_name, std::chrono::seconds connect_timeout);
+
+    // the stream is read from the beginning, a retry needs a new one
+    UploadResult run(ByteStream& stream, const std::atomic<bool>& interrupt);
+
+    const std::string& get_error() const {
+        return error;
+    }
+
+    std::uint64_t get_uploaded_bytes() const {
+        return uploaded_bytes;
+    }
+
+private:
+    std::string url;
+    std::chrono::seconds connect_timeout;
+    std::string error;
+    std::uint64_t uploaded_bytes{0};
+};
+
+} // namespace diagnostics
+
+#endif // DIAGNOSTICS_UPLOAD_HPP
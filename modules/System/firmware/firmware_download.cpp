@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "firmware_download.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace firmware {
+
+FirmwareDownload::FirmwareDownload(std::unique_ptr<Transport> transport_, std::unique_ptr<SignatureVerifier> verifier_,
+                                   std::filesystem::path destination_) :
+    transport(std::move(transport_)), verifier(std::move(verifier_)), destination(std::move(destination_)) {
+}
+
+FirmwareDownload::~FirmwareDownload() {
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+DownloadResult FirmwareDownload::run(const std::atomic<bool>& interrupt, const ProgressHandler& on_progress,
+                                     std::chrono::milliseconds progress_interval) {
+    if (not open_destination()) {
+        return DownloadResult::Failed;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto start_time = Clock::now();
+    auto last_progress = start_time;
+    std::uint64_t attempt_bytes = 0;
+    std::optional<std::uint64_t> total_size;
+    bool write_failed = false;
+
+    const auto report_progress = [&](Clock::time_point now) {
+        const auto seconds = std::chrono::duration<double>(now - start_time).count();
+        on_progress({bytes, total_size, seconds > 0 ? attempt_bytes / seconds : 0.0});
+        last_progress = now;
+    };
+
+    const auto on_start = [&](std::uint64_t offset, std::optional<std::uint64_t> size) {
+        total_size = size;
+        if (offset != bytes) {
+            // the source cannot resume, start over
+            verifier->reset();
+            bytes = 0;
+        }
+        write_failed = not rewind_destination(bytes);
+    };
+
+    const auto on_data = [&](const std::uint8_t* data, std::size_t length) {
+        if (interrupt or write_failed) {
+            return false;
+        }
+        if (not write_destination(data, length)) {
+            write_failed = true;
+            return false;
+        }
+        verifier->update(data, length);
+        bytes += length;
+        attempt_bytes += length;
+
+        const auto now = Clock::now();
+        if (now - last_progress >= progress_interval) {
+            report_progress(now);
+        }
+        return true;
+    };
+
+    const auto result = transport->fetch(bytes, on_start, on_data);
+    report_progress(Clock::now());
+
+    if (write_failed) {
+        return DownloadResult::Failed;
+    }
+    if (result == TransferResult::Cancelled) {
+        return DownloadResult::Cancelled;
+    }
+    if (result == TransferResult::Failed) {
+        error = transport->get_error();
+        return DownloadResult::Failed;
+    }
+
+    if (fsync(fd) != 0) {
+        error = "Could not sync " + destination.string() + ": " + std::strerror(errno);
+        return DownloadResult::Failed;
+    }
+
+    return verifier->verify() ? DownloadResult::SignatureVerified : DownloadResult::InvalidSignature;
+}
+
+bool FirmwareDownload::open_destination() {
+    if (fd != -1) {
+        return true;
+    }
+
+    fd = open(destination.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        error = "Could not open " + destination.string() + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat info;
+    regular_file = fstat(fd, &info) == 0 and S_ISREG(info.st_mode);
+    return true;
+}
+
+bool FirmwareDownload::rewind_destination(std::uint64_t offset) {
+    // a longer file left behind would look like part of the image
+    if (regular_file and ftruncate(fd, offset) != 0) {
+        error = "Could not truncate " + destination.string() + ": " + std::strerror(errno);
+        return false;
+    }
+    if (lseek(fd, offset, SEEK_SET) == -1) {
+        error = "Could not seek in " + destination.string() + ": " + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool FirmwareDownload::write_destination(const std::uint8_t* data, std::size_t length) {
+    while (length > 0) {
+        const auto written = write(fd, data, length);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = "Could not write " + destination.string() + ": " + std::strerror(errno);
+            return false;
+        }
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+} // namespace firmware
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef FIRMWARE_FIRMWARE_DOWNLOAD_HPP
+#define FIRMWARE_FIRMWARE_DOWNLOAD_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "signature_verifier.hpp"
+#include "transport.hpp"
+
+namespace firmware {
+
+enum class DownloadResult {
+    SignatureVerified,
+    InvalidSignature,
+    Failed,
+    Cancelled,
+};
+
+struct DownloadProgress {
+    std::uint64_t bytes;
+    std::optional<std::uint64_t> total_size;
+    // of the current attempt
+    double bytes_per_second;
+};
+
+// Downloads a firmware image straight to where it is installed from and verifies its signature on the way, so the
+// image is read from the network once and written to the flash once.
+//
+// The destination is a regular file or a device, e.g. the inactive partition of an A/B system. It is only written,
+// activating the image is up to the installer, after the signature has been verified. If an attempt fails, the next
+// run() continues where it stopped, if the transport can resume.
+class FirmwareDownload {
+public:
+    using ProgressHandler = std::function<void(const DownloadProgress& progress)>;
+
+    FirmwareDownload(std::unique_ptr<Transport> transport, std::unique_ptr<SignatureVerifier> verifier,
+                     std::filesystem::path destination);
+    ~FirmwareDownload();
+
+    FirmwareDownload(const FirmwareDownload&) = delete;
+    FirmwareDownload& operator=(const FirmwareDownload&) = delete;
+
+    // on_progress is called at most every progress_interval and once at the end of the attempt
+    DownloadResult run(const std::atomic<bool>& interrupt, const ProgressHandler& on_progress,
+                       std::chrono::milliseconds progress_interval = std::chrono::seconds(5));
+
+    std::uint64_t get_bytes() const {
+        return bytes;
+    }
+
+    const std::string& get_error() const {
+        return error;
+    }
+
+private:
+    bool open_destination();
+    bool rewind_destination(std::uint64_t offset);
+    bool write_destination(const std::uint8_t* data, std::size_t length);
+
+    std::unique_ptr<Transport> transport;
+    std::unique_ptr<SignatureVerifier> verifier;
+    const std::filesystem::path destination;
+    int fd{-1};
+    bool regular_file{false};
+
+    // written to the destination and passed to the verifier
+    std::uint64_t bytes{0};
+    std::string error;
+};
+
+} // namespace firmware
+
+#endif // FIRMWARE_FIRMWARE_DOWNLOAD_HPP
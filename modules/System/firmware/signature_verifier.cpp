@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "signature_verifier.hpp"
+
+#include <memory>
+#include <stdexcept>
+
+#include <openssl/bio.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+
+namespace firmware {
+
+namespace {
+std::vector<std::uint8_t> decode_base64(const std::string& encoded) {
+    std::vector<std::uint8_t> decoded(3 * (encoded.size() + 3) / 4);
+
+    // unlike EVP_DecodeBlock this skips line breaks and doesn't count the padding
+    std::unique_ptr<EVP_ENCODE_CTX, decltype(&EVP_ENCODE_CTX_free)> context(EVP_ENCODE_CTX_new(), EVP_ENCODE_CTX_free);
+    EVP_DecodeInit(context.get());
+    int length = 0;
+    int final_length = 0;
+    if (EVP_DecodeUpdate(context.get(), decoded.data(), &length,
+                         reinterpret_cast<const unsigned char*>(encoded.data()), encoded.size()) < 0 or
+        EVP_DecodeFinal(context.get(), decoded.data() + length, &final_length) < 0) {
+        throw std::runtime_error("Signature is not valid base64");
+    }
+
+    decoded.resize(length + final_length);
+    return decoded;
+}
+} // namespace
+
+SignatureVerifier::SignatureVerifier(const std::string& certificate_pem, const std::string& signature_base64) :
+    signature(decode_base64(signature_base64)) {
+    std::unique_ptr<BIO, decltype(&BIO_free)> bio(BIO_new_mem_buf(certificate_pem.data(), certificate_pem.size()),
+                                                 BIO_free);
+    std::unique_ptr<X509, decltype(&X509_free)> certificate(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr),
+                                                            X509_free);
+    if (certificate == nullptr) {
+        throw std::runtime_error("Could not parse signing certificate");
+    }
+
+    public_key = X509_get_pubkey(certificate.get());
+    if (public_key == nullptr) {
+        throw std::runtime_error("Could not get the public key of the signing certificate");
+    }
+
+    context = EVP_MD_CTX_new();
+    reset();
+}
+
+SignatureVerifier::~SignatureVerifier() {
+    EVP_MD_CTX_free(context);
+    EVP_PKEY_free(public_key);
+}
+
+void SignatureVerifier::reset() {
+    EVP_MD_CTX_reset(context);
+    EVP_DigestVerifyInit(context, nullptr, EVP_sha256(), nullptr, public_key);
+}
+
+void SignatureVerifier::update(const std::uint8_t* data, std::size_t length) {
+    EVP_DigestVerifyUpdate(context, data, length);
+}
+
+bool SignatureVerifier::verify() {
+    return EVP_DigestVerifyFinal(context, signature.data(), signature.size()) == 1;
+}
+
+} // namespace firmware
@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef FIRMWARE_SIGNATURE_VERIFIER_HPP
+#define FIRMWARE_SIGNATURE_VERIFIER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// forward declare
+typedef struct evp_pkey_st EVP_PKEY;
+typedef struct evp_md_ctx_st EVP_MD_CTX;
+
+namespace firmware {
+
+// Verifies a SHA-256 signature of a firmware image while its data arrives, like
+// openssl dgst -sha256 -verify <public key of certificate> -signature <signature> <firmware>
+class SignatureVerifier {
+public:
+    // throws std::runtime_error if the certificate or the signature cannot be parsed
+    SignatureVerifier(const std::string& certificate_pem, const std::string& signature_base64);
+    ~SignatureVerifier();
+
+    SignatureVerifier(const SignatureVerifier&) = delete;
+    SignatureVerifier& operator=(const SignatureVerifier&) = delete;
+
+    // starts over with the first byte of the image
+    void reset();
+    void update(const std::uint8_t* data, std::size_t length);
+    // true if the data passed since the last reset matches the signature
+    bool verify();
+
+private:
+    EVP_PKEY* public_key{nullptr};
+    EVP_MD_CTX* context{nullptr};
+    std::vector<std::uint8_t> signature;
+};
+
+} // namespace firmware
+
+#endif // FIRMWARE_SIGNATURE_VERIFIER_HPP
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "transport.hpp"
+
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#include <curl/curl.h>
+
+namespace firmware {
+
+namespace {
+const std::string FILE_SCHEME = "file://";
+// large chunks mean few writes to the flash
+const std::size_t CHUNK_SIZE = 256 * 1024;
+// a transfer that is slower than 1 byte/s for this long has failed
+const long STALLED_TRANSFER_TIMEOUT_S = 60;
+
+bool is_http(const std::string& url) {
+    return url.rfind("http://", 0) == 0 or url.rfind("https://", 0) == 0;
+}
+
+struct CurlTransfer {
+    const Transport::StartHandler& on_start;
+    const Transport::DataHandler& on_data;
+    CURL* curl;
+    std::uint64_t offset;
+    bool http;
+    bool started{false};
+    bool cancelled{false};
+
+    void start() {
+        started = true;
+
+        auto start_offset = offset;
+        if (http) {
+            long response_code = 0;
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+            // anything but partial content is the whole file
+            if (response_code != 206) {
+                start_offset = 0;
+            }
+        }
+
+        curl_off_t length = -1;
+        curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+        std::optional<std::uint64_t> total_size;
+        if (length >= 0) {
+            total_size = start_offset + static_cast<std::uint64_t>(length);
+        }
+
+        on_start(start_offset, total_size);
+    }
+};
+
+size_t write_callback(char* data, size_t size, size_t count, void* user_data) {
+    auto& transfer = *static_cast<CurlTransfer*>(user_data);
+    if (not transfer.started) {
+        transfer.start();
+    }
+
+    const auto length = size * count;
+    if (not transfer.on_data(reinterpret_cast<const std::uint8_t*>(data), length)) {
+        transfer.cancelled = true;
+        // makes libcurl abort the transfer
+        return 0;
+    }
+    return length;
+}
+
+std::once_flag curl_initialized;
+} // namespace
+
+FileTransport::FileTransport(std::filesystem::path path_) : path(std::move(path_)) {
+}
+
+TransferResult FileTransport::fetch(std::uint64_t offset, const StartHandler& on_start, const DataHandler& on_data) {
+    std::ifstream file(path, std::ios::binary);
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (not file.is_open() or ec) {
+        error = "Could not open " + path.string();
+        return TransferResult::Failed;
+    }
+
+    if (offset > size) {
+        offset = 0;
+    }
+    file.seekg(offset);
+    on_start(offset, size);
+
+    std::vector<char> buffer(CHUNK_SIZE);
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        const auto length = static_cast<std::size_t>(file.gcount());
+        if (length > 0 and not on_data(reinterpret_cast<const std::uint8_t*>(buffer.data()), length)) {
+            return TransferResult::Cancelled;
+        }
+    }
+
+    if (file.bad()) {
+        error = "Error reading " + path.string();
+        return TransferResult::Failed;
+    }
+    return TransferResult::Completed;
+}
+
+CurlTransport::CurlTransport(std::string url_, std::chrono::seconds connect_timeout_) :
+    url(std::move(url_)), connect_timeout(connect_timeout_) {
+    std::call_once(curl_initialized, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+}
+
+TransferResult CurlTransport::fetch(std::uint64_t offset, const StartHandler& on_start, const DataHandler& on_data) {
+    CURL* curl = curl_easy_init();
+    if (curl == nullptr) {
+        error = "Could not initialize libcurl";
+        return TransferResult::Failed;
+    }
+
+    CurlTransfer transfer{on_start, on_data, curl, offset, is_http(url)};
+    char error_buffer[CURL_ERROR_SIZE] = {0};
+    const auto range = std::to_string(offset) + "-";
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, error_buffer);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, static_cast<long>(connect_timeout.count()));
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1L);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, STALLED_TRANSFER_TIMEOUT_S);
+    curl_easy_setopt(curl, CURLOPT_BUFFERSIZE, static_cast<long>(CHUNK_SIZE));
+    if (offset > 0) {
+        if (transfer.http) {
+            // unlike CURLOPT_RESUME_FROM_LARGE this doesn't fail if the server ignores the range
+            curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
+        } else {
+            curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, static_cast<curl_off_t>(offset));
+        }
+    }
+
+    const auto code = curl_easy_perform(curl);
+    if (code == CURLE_OK and not transfer.started) {
+        // empty file
+        transfer.start();
+    }
+    curl_easy_cleanup(curl);
+
+    if (transfer.cancelled) {
+        return TransferResult::Cancelled;
+    }
+    if (code != CURLE_OK) {
+        error = (error_buffer[0] != '\0') ? error_buffer : curl_easy_strerror(code);
+        return TransferResult::Failed;
+    }
+    return TransferResult::Completed;
+}
+
+std::unique_ptr<Transport> make_transport(const std::string& location, std::chrono::seconds connect_timeout) {
+    if (location.rfind(FILE_SCHEME, 0) == 0) {
+        return std::make_unique<FileTransport>(location.substr(FILE_SCHEME.size()));
+    }
+    return std::make_unique<CurlTransport>(location, connect_timeout);
+}
+
+} // namespace firmware
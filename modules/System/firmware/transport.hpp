@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef FIRMWARE_TRANSPORT_HPP
+#define FIRMWARE_TRANSPORT_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace firmware {
+
+enum class TransferResult {
+    Completed,
+    Failed,
+    Cancelled,
+};
+
+// Streams a remote file in chunks, optionally starting somewhere in the middle of it.
+class Transport {
+public:
+    // called before the first chunk with the offset the data starts at, which is 0 if the source cannot resume, and
+    // the size of the whole file if it is known
+    using StartHandler = std::function<void(std::uint64_t offset, std::optional<std::uint64_t> total_size)>;
+    // returns false to cancel the transfer
+    using DataHandler = std::function<bool(const std::uint8_t* data, std::size_t length)>;
+
+    virtual ~Transport() = default;
+
+    virtual TransferResult fetch(std::uint64_t offset, const StartHandler& on_start, const DataHandler& on_data) = 0;
+
+    const std::string& get_error() const {
+        return error;
+    }
+
+protected:
+    std::string error;
+};
+
+// file:// locations, read directly from the file system
+class FileTransport : public Transport {
+public:
+    explicit FileTransport(std::filesystem::path path);
+
+    TransferResult fetch(std::uint64_t offset, const StartHandler& on_start, const DataHandler& on_data) override;
+
+private:
+    std::filesystem::path path;
+};
+
+// everything libcurl supports, e.g. http(s) and ftp. http servers resume with a Range request if they support it,
+// otherwise the file is sent from the beginning
+class CurlTransport : public Transport {
+public:
+    CurlTransport(std::string url, std::chrono::seconds connect_timeout);
+
+    TransferResult fetch(std::uint64_t offset, const StartHandler& on_start, const DataHandler& on_data) override;
+
+private:
+    std::string url;
+    std::chrono::seconds connect_timeout;
+};
+
+std::unique_ptr<Transport> make_transport(const std::string& location, std::chrono::seconds connect_timeout);
+
+} // namespace firmware
+
+#endif // FIRMWARE_TRANSPORT_HPP
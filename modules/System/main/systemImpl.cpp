@@ -6,6 +6,7 @@
 #include <chrono>
 #include <cstdlib>
 #include <fstream>
+#include <sstream>
 #include <thread>
 #include <vector>
 
@@ -14,15 +15,23 @@
 #include <utils/date.hpp>
 
 #include <boost/process.hpp>
+#include <fmt/core.h>
+
+#include <firmware_download.hpp>
+#include <sources.hpp>
+#include <upload.hpp>
 
 namespace module {
 namespace main {
 
 const std::string CONSTANTS = "constants.env";
-const std::string DIAGNOSTICS_UPLOADER = "diagnostics_uploader.sh";
 const std::string FIRMWARE_UPDATER = "firmware_updater.sh";
-const std::string SIGNED_FIRMWARE_DOWNLOADER = "signed_firmware_downloader.sh";
 const std::string SIGNED_FIRMWARE_INSTALLER = "signed_firmware_installer.sh";
+const auto CONNECTION_TIMEOUT = std::chrono::seconds(20);
+// fast enough not to slow down the upload on small devices
+const int DIAGNOSTICS_COMPRESSION_LEVEL = 3;
+// the journal is split into entries of this size, which are held in memory one at a time
+const std::size_t DIAGNOSTICS_CHUNK_SIZE = 1024 * 1024;
 
 namespace fs = std::filesystem;
 
@@ -46,6 +55,60 @@ fs::path create_temp_file(const fs::path& dir, const std::string& prefix) {
     return fn_template_buffer.data();
 }
 
+std::optional<std::chrono::system_clock::time_point> parse_time_limit(const std::optional<std::string>& timestamp) {
+    if (not timestamp.has_value()) {
+        return std::nullopt;
+    }
+    try {
+        return date::clock_cast<std::chrono::system_clock>(Everest::Date::from_rfc3339(timestamp.value()));
+    } catch (const std::exception& e) {
+        EVLOG_warning << "Ignoring invalid log timestamp " << timestamp.value() << ": " << e.what();
+        return std::nullopt;
+    }
+}
+
+// the contents of the diagnostics bundle, log files are only opened once the bundle reaches them
+std::vector<std::unique_ptr<diagnostics::Source>> make_diagnostics_sources(const module::Conf& config,
+                                                                           const diagnostics::TimeWindow& window) {
+    std::vector<std::unique_ptr<diagnostics::Source>> sources;
+
+    std::stringstream log_paths(config.DiagnosticsLogPaths);
+    std::string log_path;
+    while (std::getline(log_paths, log_path, ',')) {
+        log_path.erase(log_path.find_last_not_of(' ') + 1);
+        log_path.erase(0, log_path.find_first_not_of(' '));
+        if (log_path.empty()) {
+            continue;
+        }
+        const fs::path root(log_path);
+        const auto prefix = root.filename().empty() ? root.parent_path().filename() : root.filename();
+        sources.push_back(std::make_unique<diagnostics::DirectorySource>(root, "logs/" + prefix.string(), window));
+    }
+
+    if (config.DiagnosticsJournal) {
+        try {
+            sources.push_back(std::make_unique<diagnostics::ChunkedSource>(
+                "journal/journal.log", diagnostics::make_command_stream(diagnostics::make_journal_command(window)),
+                DIAGNOSTICS_CHUNK_SIZE));
+        } catch (const std::exception& e) {
+            EVLOG_warning << "Diagnostics without journal: " << e.what();
+        }
+    }
+
+    if (not config.DiagnosticsErrorDatabase.empty()) {
+        try {
+            sources.push_back(std::make_unique<diagnostics::ChunkedSource>(
+                "errors/errors.csv",
+                diagnostics::make_error_history_stream(config.DiagnosticsErrorDatabase, window),
+                DIAGNOSTICS_CHUNK_SIZE));
+        } catch (const std::exception& e) {
+            EVLOG_warning << "Diagnostics without error history: " << e.what();
+        }
+    }
+
+    return sources;
+}
+
 void systemImpl::init() {
     this->scripts_path = mod->info.paths.libexec;
     this->log_upload_running = false;
@@ -211,47 +274,90 @@ void systemImpl::download_signed_firmware(const types::system::FirmwareUpdateReq
     this->interrupt_firmware_download.exchange(false);
     this->firmware_download_running = true;
 
-    // // create temporary file
-    const auto date_time = Everest::Date::to_rfc3339(date::utc_clock::now());
-    const auto firmware_file_path = create_temp_file(fs::temp_directory_path(), "signed_firmware-" + date_time);
+    types::system::FirmwareUpdateStatus firmware_status;
+    firmware_status.request_id = firmware_update_request.request_id;
+    firmware_status.firmware_update_status = types::system::FirmwareUpdateStatusEnum::DownloadFailed;
 
-    const auto firmware_downloader = this->scripts_path / SIGNED_FIRMWARE_DOWNLOADER;
-    const auto constants = this->scripts_path / CONSTANTS;
+    // the image is downloaded straight to the install target if there is one
+    auto firmware_file_path = fs::path(this->mod->config.SignedFirmwareInstallTarget);
+    if (firmware_file_path.empty()) {
+        const auto date_time = Everest::Date::to_rfc3339(date::utc_clock::now());
+        firmware_file_path = create_temp_file(fs::temp_directory_path(), "signed_firmware-" + date_time);
+    }
+
+    std::unique_ptr<firmware::FirmwareDownload> download;
+    try {
+        download = std::make_unique<firmware::FirmwareDownload>(
+            firmware::make_transport(firmware_update_request.location, CONNECTION_TIMEOUT),
+            std::make_unique<firmware::SignatureVerifier>(firmware_update_request.signing_certificate.value(),
+                                                          firmware_update_request.signature.value()),
+            firmware_file_path);
+    } catch (const std::runtime_error& e) {
+        EVLOG_warning << "Cannot verify firmware: " << e.what();
+        firmware_status.firmware_update_status = types::system::FirmwareUpdateStatusEnum::InvalidSignature;
+        this->publish_firmware_update_status(firmware_status);
+        this->firmware_download_running = false;
+        this->firmware_update_cv.notify_one();
+        return;
+    }
+
+    const auto log_progress = [](const firmware::DownloadProgress& progress) {
+        constexpr double MiB = 1024 * 1024;
+        if (progress.total_size.has_value() and progress.total_size.value() > 0) {
+            EVLOG_info << fmt::format("Firmware download: {:.1f} of {:.1f} MiB ({:.0f}%), {:.2f} MiB/s",
+                                      progress.bytes / MiB, progress.total_size.value() / MiB,
+                                      100.0 * progress.bytes / progress.total_size.value(),
+                                      progress.bytes_per_second / MiB);
+        } else {
+            EVLOG_info << fmt::format("Firmware download: {:.1f} MiB, {:.2f} MiB/s", progress.bytes / MiB,
+                                      progress.bytes_per_second / MiB);
+        }
+    };
 
-    const std::vector<std::string> download_args = {
-        constants.string(), firmware_update_request.location, firmware_file_path.string(),
-        firmware_update_request.signature.value(), firmware_update_request.signing_certificate.value()};
     int32_t retries = 0;
     const auto total_retries = firmware_update_request.retries.value_or(this->mod->config.DefaultRetries);
     const auto retry_interval =
         firmware_update_request.retry_interval_s.value_or(this->mod->config.DefaultRetryInterval);
 
-    auto firmware_status_enum = types::system::FirmwareUpdateStatusEnum::DownloadFailed;
-    types::system::FirmwareUpdateStatus firmware_status;
-    firmware_status.request_id = firmware_update_request.request_id;
-    firmware_status.firmware_update_status = firmware_status_enum;
-
     while (firmware_status.firmware_update_status == types::system::FirmwareUpdateStatusEnum::DownloadFailed &&
            retries <= total_retries && !this->interrupt_firmware_download) {
-        boost::process::ipstream download_stream;
-        boost::process::child download_cmd(firmware_downloader.string(), boost::process::args(download_args),
-                                           boost::process::std_out > download_stream);
-        std::string temp;
         retries += 1;
-        while (std::getline(download_stream, temp) && !this->interrupt_firmware_download) {
-            firmware_status.firmware_update_status = types::system::string_to_firmware_update_status_enum(temp);
+        firmware_status.firmware_update_status = types::system::FirmwareUpdateStatusEnum::Downloading;
+        this->publish_firmware_update_status(firmware_status);
+
+        // a retry continues where the previous attempt stopped
+        const auto result = download->run(this->interrupt_firmware_download, log_progress);
+        switch (result) {
+        case firmware::DownloadResult::SignatureVerified:
+            firmware_status.firmware_update_status = types::system::FirmwareUpdateStatusEnum::Downloaded;
             this->publish_firmware_update_status(firmware_status);
+            firmware_status.firmware_update_status = types::system::FirmwareUpdateStatusEnum::SignatureVerified;
+            break;
+        case firmware::DownloadResult::InvalidSignature:
+            firmware_status.firmware_update_status = types::system::FirmwareUpdateStatusEnum::Downloaded;
+            this->publish_firmware_update_status(firmware_status);
+            firmware_status.firmware_update_status = types::system::FirmwareUpdateStatusEnum::InvalidSignature;
+            break;
+        case firmware::DownloadResult::Failed:
+            EVLOG_warning << "Firmware download failed: " << download->get_error();
+            firmware_status.firmware_update_status = types::system::FirmwareUpdateStatusEnum::DownloadFailed;
+            break;
+        case firmware::DownloadResult::Cancelled:
+            EVLOG_info << "Updating firmware was interrupted, requestId: " << firmware_status.request_id;
+            break;
         }
-        if (this->interrupt_firmware_download) {
-            EVLOG_info << "Updating firmware was interrupted, terminating firmware update script, requestId: "
-                       << firmware_status.request_id;
-            download_cmd.terminate();
+        if (result == firmware::DownloadResult::Cancelled) {
+            break;
         }
+        this->publish_firmware_update_status(firmware_status);
+
         if (firmware_status.firmware_update_status == types::system::FirmwareUpdateStatusEnum::DownloadFailed &&
             retries <= total_retries) {
             std::this_thread::sleep_for(std::chrono::seconds(retry_interval));
         }
     }
+    download.reset();
+
     if (firmware_status.firmware_update_status == types::system::FirmwareUpdateStatusEnum::SignatureVerified) {
         this->initialize_firmware_installation(firmware_update_request, firmware_file_path);
     }
@@ -296,7 +402,7 @@ void systemImpl::install_signed_firmware(const types::system::FirmwareUpdateRequ
         boost::process::ipstream install_stream;
         const auto firmware_installer = this->scripts_path / SIGNED_FIRMWARE_INSTALLER;
         const auto constants = this->scripts_path / CONSTANTS;
-        const std::vector<std::string> install_args = {constants.string()};
+        const std::vector<std::string> install_args = {constants.string(), firmware_file_path.string()};
         boost::process::child install_cmd(firmware_installer.string(), boost::process::args(install_args),
                                           boost::process::std_out > install_stream);
         std::string temp;
@@ -335,17 +441,15 @@ systemImpl::handle_upload_logs(types::system::UploadLogsRequest& upload_logs_req
     }
 
     const auto date_time = Everest::Date::to_rfc3339(date::utc_clock::now());
-    // TODO(piet): consider start time and end time
-    const auto diagnostics_file_path = create_temp_file(fs::temp_directory_path(), "diagnostics-" + date_time);
-    const auto diagnostics_file_name = diagnostics_file_path.filename().string();
+    const auto diagnostics_file_name = "diagnostics-" + date_time + ".tar.zst";
 
     response.file_name = diagnostics_file_name;
 
-    const auto fake_diagnostics_file = json({{"diagnostics", {{"key", "value"}}}});
-    std::ofstream diagnostics_file(diagnostics_file_path.c_str());
-    diagnostics_file << fake_diagnostics_file.dump();
+    diagnostics::TimeWindow window;
+    window.oldest = parse_time_limit(upload_logs_request.oldest_timestamp);
+    window.latest = parse_time_limit(upload_logs_request.latest_timestamp);
 
-    this->upload_logs_thread = std::thread([this, upload_logs_request, diagnostics_file_name, diagnostics_file_path]() {
+    this->upload_logs_thread = std::thread([this, upload_logs_request, diagnostics_file_name, window]() {
         if (this->log_upload_running) {
             EVLOG_info << "Received Log upload request and log upload already running - cancelling current upload";
             this->interrupt_log_upload.exchange(true);
@@ -359,11 +463,8 @@ systemImpl::handle_upload_logs(types::system::UploadLogsRequest& upload_logs_req
         EVLOG_info << "Starting upload of log file";
         this->interrupt_log_upload.exchange(false);
         this->log_upload_running = true;
-        const auto diagnostics_uploader = this->scripts_path / DIAGNOSTICS_UPLOADER;
-        const auto constants = this->scripts_path / CONSTANTS;
 
-        std::vector<std::string> args = {constants.string(), upload_logs_request.location, diagnostics_file_name,
-                                         diagnostics_file_path.string()};
+        diagnostics::Upload upload(upload_logs_request.location, diagnostics_file_name, CONNECTION_TIMEOUT);
         bool uploaded = false;
         int32_t retries = 0;
         const auto total_retries = upload_logs_request.retries.value_or(this->mod->config.DefaultRetries);
@@ -371,39 +472,36 @@ systemImpl::handle_upload_logs(types::system::UploadLogsRequest& upload_logs_req
             upload_logs_request.retry_interval_s.value_or(this->mod->config.DefaultRetryInterval);
 
         types::system::LogStatus log_status;
+        log_status.request_id = upload_logs_request.request_id.value_or(-1);
         while (!uploaded && retries <= total_retries && !this->interrupt_log_upload) {
-
-            boost::process::ipstream stream;
-            boost::process::child cmd(diagnostics_uploader.string(), boost::process::args(args),
-                                      boost::process::std_out > stream);
-            std::string temp;
             retries += 1;
-            log_status.request_id = upload_logs_request.request_id.value_or(-1);
-            while (std::getline(stream, temp) && !this->interrupt_log_upload) {
-                if (temp == "Uploaded") {
-                    log_status.log_status = types::system::string_to_log_status_enum(temp);
-                } else if (temp == "UploadFailure" || temp == "PermissionDenied" || temp == "BadMessage" ||
-                           temp == "NotSupportedOperation") {
-                    log_status.log_status = types::system::LogStatusEnum::UploadFailure;
-                } else {
-                    log_status.log_status = types::system::LogStatusEnum::Uploading;
-                }
-                this->publish_log_status(log_status);
-            }
-            if (this->interrupt_log_upload) {
-                EVLOG_info << "Uploading Logs was interrupted, terminating upload script, requestId: "
-                           << log_status.request_id;
+            log_status.log_status = types::system::LogStatusEnum::Uploading;
+            this->publish_log_status(log_status);
+
+            // the bundle is created while it is uploaded, every attempt starts from scratch
+            diagnostics::TarStream bundle(make_diagnostics_sources(this->mod->config, window));
+            diagnostics::ZstdStream compressed_bundle(bundle, DIAGNOSTICS_COMPRESSION_LEVEL);
+            const auto result = upload.run(compressed_bundle, this->interrupt_log_upload);
+
+            if (result == diagnostics::UploadResult::Cancelled) {
+                EVLOG_info << "Uploading Logs was interrupted, requestId: " << log_status.request_id;
                 // N01.FR.20
                 log_status.log_status = types::system::LogStatusEnum::AcceptedCanceled;
                 this->publish_log_status(log_status);
-                cmd.terminate();
-            } else if (log_status.log_status != types::system::LogStatusEnum::Uploaded && retries <= total_retries) {
-                // command finished, but neither interrupted nor uploaded
-                std::this_thread::sleep_for(std::chrono::seconds(retry_interval));
-            } else {
+            } else if (result == diagnostics::UploadResult::Uploaded) {
+                EVLOG_info << fmt::format("Uploaded {} files in {} bytes", bundle.get_entry_count(),
+                                          upload.get_uploaded_bytes());
+                log_status.log_status = types::system::LogStatusEnum::Uploaded;
+                this->publish_log_status(log_status);
                 uploaded = true;
+            } else {
+                EVLOG_warning << "Uploading Logs failed: " << upload.get_error();
+                log_status.log_status = types::system::LogStatusEnum::UploadFailure;
+                this->publish_log_status(log_status);
+                if (retries <= total_retries) {
+                    std::this_thread::sleep_for(std::chrono::seconds(retry_interval));
+                }
             }
-            cmd.wait();
         }
         this->log_upload_running = false;
         this->log_upload_cv.notify_one();
@@ -2,6 +2,8 @@
 
 . "${1}"
 
+# ${2}: the downloaded image, its signature has been verified already
+
 echo "$INSTALLING"
 sleep 2
 echo "$INSTALLED"
@@ -0,0 +1,271 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <zstd.h>
+
+#include <sources.hpp>
+#include <upload.hpp>
+
+namespace {
+
+using namespace diagnostics;
+namespace fs = std::filesystem;
+using Files = std::map<std::string, std::string>;
+
+std::chrono::system_clock::time_point from_epoch_s(std::int64_t seconds) {
+    return std::chrono::system_clock::time_point(std::chrono::seconds(seconds));
+}
+
+void write_file(const fs::path& path, const std::string& content, std::int64_t modification_time) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << content;
+    const struct timeval times[2] = {{modification_time, 0}, {modification_time, 0}};
+    utimes(path.c_str(), times);
+}
+
+std::string read_file(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+// reads the stream in odd sized pieces to cross all block boundaries
+std::string read_all(ByteStream& stream) {
+    std::string result;
+    std::uint8_t buffer[777];
+    std::size_t length;
+    while ((length = stream.read(buffer, sizeof(buffer))) > 0) {
+        result.append(reinterpret_cast<const char*>(buffer), length);
+    }
+    return result;
+}
+
+// the names and contents of the entries of a tar archive
+Files parse_tar(const std::string& archive) {
+    Files files;
+    std::string long_name;
+    std::size_t position = 0;
+    while (position + 512 <= archive.size()) {
+        const auto header = archive.substr(position, 512);
+        position += 512;
+        if (header == std::string(512, '\0')) {
+            break;
+        }
+        const auto size = std::stoull(header.substr(124, 12), nullptr, 8);
+        const auto content = archive.substr(position, size);
+        position += (size + 511) / 512 * 512;
+
+        if (header[156] == 'L') {
+            long_name = content.substr(0, content.find('\0'));
+            continue;
+        }
+        auto name = long_name.empty() ? header.substr(0, header.find('\0')).substr(0, 100) : long_name;
+        long_name.clear();
+        files[name] = content;
+    }
+    return files;
+}
+
+std::string decompress(const std::string& frame) {
+    std::string result;
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(ZSTD_createDCtx(), ZSTD_freeDCtx);
+    std::vector<char> buffer(ZSTD_DStreamOutSize());
+    ZSTD_inBuffer in{frame.data(), frame.size(), 0};
+    while (in.pos < in.size) {
+        ZSTD_outBuffer out{buffer.data(), buffer.size(), 0};
+        const auto left = ZSTD_decompressStream(context.get(), &out, &in);
+        if (ZSTD_isError(left)) {
+            throw std::runtime_error(ZSTD_getErrorName(left));
+        }
+        result.append(buffer.data(), out.pos);
+    }
+    return result;
+}
+
+class StringStream : public ByteStream {
+public:
+    explicit StringStream(std::string data_) : data(std::move(data_)) {
+    }
+
+    std::size_t read(std::uint8_t* buffer, std::size_t length) override {
+        const auto count = std::min(length, data.size() - position);
+        std::memcpy(buffer, data.data() + position, count);
+        position += count;
+        return count;
+    }
+
+private:
+    std::string data;
+    std::size_t position{0};
+};
+
+std::vector<std::unique_ptr<Source>> make_sources(std::unique_ptr<Source> source) {
+    std::vector<std::unique_ptr<Source>> sources;
+    sources.push_back(std::move(source));
+    return sources;
+}
+
+class DiagnosticsBundleTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory = fs::temp_directory_path() /
+                    ("diagnostics_bundle_test_" + std::to_string(getpid()) + "_" +
+                     ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::create_directories(directory);
+    }
+
+    void TearDown() override {
+        fs::remove_all(directory);
+    }
+
+    Files bundle_directory(const TimeWindow& window) {
+        TarStream tar(make_sources(std::make_unique<DirectorySource>(directory / "logs", "logs", window)));
+        return parse_tar(read_all(tar));
+    }
+
+    fs::path directory;
+};
+
+TEST_F(DiagnosticsBundleTest, directory_entries) {
+    const std::string long_name = std::string(120, 'x') + ".log";
+    write_file(directory / "logs" / "everest.log", "everest", 1700000000);
+    write_file(directory / "logs" / "sessions" / "session.yaml", std::string(5000, 's'), 1700000000);
+    write_file(directory / "logs" / long_name, "long", 1700000000);
+
+    TarStream tar(make_sources(std::make_unique<DirectorySource>(directory / "logs", "logs", TimeWindow{})));
+    const auto files = parse_tar(read_all(tar));
+
+    EXPECT_EQ(tar.get_entry_count(), 3u);
+    EXPECT_EQ(files, (Files{{"logs/everest.log", "everest"},
+                            {"logs/sessions/session.yaml", std::string(5000, 's')},
+                            {"logs/" + long_name, "long"}}));
+}
+
+TEST_F(DiagnosticsBundleTest, directory_symlinked_file) {
+    const std::string content(3000, 'l');
+    write_file(directory / "rotated" / "everest.log.1", content, 1700000000);
+    fs::create_directories(directory / "logs");
+    fs::create_symlink(directory / "rotated" / "everest.log.1", directory / "logs" / "everest.log");
+
+    EXPECT_EQ(bundle_directory(TimeWindow{}), (Files{{"logs/everest.log", content}}));
+}
+
+TEST_F(DiagnosticsBundleTest, directory_time_window) {
+    write_file(directory / "logs" / "old.log", "old", 1600000000);
+    write_file(directory / "logs" / "new.log", "new", 1700000000);
+
+    TimeWindow recent;
+    recent.oldest = from_epoch_s(1650000000);
+    EXPECT_EQ(bundle_directory(recent), (Files{{"logs/new.log", "new"}}));
+
+    TimeWindow early;
+    early.latest = from_epoch_s(1650000000);
+    EXPECT_EQ(bundle_directory(early), (Files{{"logs/old.log", "old"}}));
+
+    TimeWindow both{from_epoch_s(1500000000), from_epoch_s(1800000000)};
+    EXPECT_EQ(bundle_directory(both).size(), 2u);
+
+    TimeWindow none{from_epoch_s(1800000000), std::nullopt};
+    EXPECT_TRUE(bundle_directory(none).empty());
+}
+
+TEST_F(DiagnosticsBundleTest, missing_directory_is_empty) {
+    EXPECT_TRUE(bundle_directory(TimeWindow{}).empty());
+}
+
+TEST_F(DiagnosticsBundleTest, chunked_source) {
+    const auto data = std::string(1000, 'a') + std::string(1000, 'b') + std::string(500, 'c');
+    std::vector<std::unique_ptr<Source>> sources;
+    sources.push_back(std::make_unique<ChunkedSource>("journal.log", std::make_unique<StringStream>(data), 1000));
+    sources.push_back(std::make_unique<ChunkedSource>("empty.log", std::make_unique<StringStream>(""), 1000));
+    TarStream tar(std::move(sources));
+
+    EXPECT_EQ(parse_tar(read_all(tar)), (Files{{"journal.log.000", std::string(1000, 'a')},
+                                               {"journal.log.001", std::string(1000, 'b')},
+                                               {"journal.log.002", std::string(500, 'c')}}));
+}
+
+TEST_F(DiagnosticsBundleTest, command_stream) {
+    std::vector<std::unique_ptr<Source>> sources;
+    sources.push_back(std::make_unique<ChunkedSource>("echo", make_command_stream("echo hello"), 1024));
+    TarStream tar(std::move(sources));
+
+    EXPECT_EQ(parse_tar(read_all(tar)), (Files{{"echo.000", "hello\n"}}));
+}
+
+TEST_F(DiagnosticsBundleTest, journal_command) {
+    EXPECT_EQ(make_journal_command(TimeWindow{}).find("--since"), std::string::npos);
+    const auto command = make_journal_command(TimeWindow{from_epoch_s(1600000000), from_epoch_s(1700000000)});
+    EXPECT_NE(command.find("--since=@1600000000"), std::string::npos);
+    EXPECT_NE(command.find("--until=@1700000000"), std::string::npos);
+}
+
+TEST_F(DiagnosticsBundleTest, error_history) {
+    const auto database_path = directory / "errors.db";
+    {
+        SQLite::Database database(database_path.string(), SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+        database.exec("CREATE TABLE errors (uuid TEXT PRIMARY KEY, type TEXT, description TEXT, message TEXT, "
+                      "origin_module TEXT, origin_implementation TEXT, timestamp INTEGER, severity TEXT, state TEXT, "
+                      "sub_type TEXT, vendor_id TEXT);"
+                      "INSERT INTO errors VALUES ('1', 'evse/Fault', 'd', 'early', 'm', 'i', 1000, 'High', 'Active', "
+                      "'', 'v');"
+                      "INSERT INTO errors VALUES ('2', 'evse/Fault', 'd', 'one, \"two\"', 'm', 'i', 2000, 'High', "
+                      "'Active', '', 'v');"
+                      "INSERT INTO errors VALUES ('3', 'evse/Fault', 'd', 'late', 'm', 'i', 3000, 'High', 'Active', "
+                      "'', 'v');");
+    }
+
+    TimeWindow window{std::chrono::system_clock::time_point(std::chrono::milliseconds(1500)),
+                      std::chrono::system_clock::time_point(std::chrono::milliseconds(2500))};
+    auto stream = make_error_history_stream(database_path, window);
+    const auto csv = read_all(*stream);
+
+    EXPECT_EQ(csv, "timestamp,type,sub_type,severity,state,origin_module,origin_implementation,message,description,"
+                   "vendor_id,uuid\n"
+                   "1970-01-01T00:00:02.000Z,evse/Fault,,High,Active,m,i,\"one, \"\"two\"\"\",d,v,2\n");
+}
+
+TEST_F(DiagnosticsBundleTest, upload_compressed_bundle) {
+    write_file(directory / "logs" / "everest.log", std::string(200000, 'e'), 1700000000);
+    TarStream tar(make_sources(std::make_unique<DirectorySource>(directory / "logs", "logs", TimeWindow{})));
+    ZstdStream compressed(tar, 3);
+
+    Upload upload("file://" + (directory / "upload").string() + "/", "bundle.tar.zst", std::chrono::seconds(1));
+    fs::create_directories(directory / "upload");
+    std::atomic<bool> interrupt{false};
+    EXPECT_EQ(upload.run(compressed, interrupt), UploadResult::Uploaded);
+
+    const auto uploaded = read_file(directory / "upload" / "bundle.tar.zst");
+    EXPECT_EQ(uploaded.size(), upload.get_uploaded_bytes());
+    EXPECT_LT(uploaded.size(), 10000u);
+    EXPECT_EQ(parse_tar(decompress(uploaded)), (Files{{"logs/everest.log", std::string(200000, 'e')}}));
+}
+
+TEST_F(DiagnosticsBundleTest, interrupt_cancels_upload) {
+    StringStream stream("data");
+    Upload upload("file://" + (directory / "bundle").string(), "bundle", std::chrono::seconds(1));
+    std::atomic<bool> interrupt{true};
+    EXPECT_EQ(upload.run(stream, interrupt), UploadResult::Cancelled);
+}
+
+TEST_F(DiagnosticsBundleTest, unsupported_location) {
+    StringStream stream("data");
+    Upload upload("unknown://location", "bundle", std::chrono::seconds(1));
+    std::atomic<bool> interrupt{false};
+    EXPECT_EQ(upload.run(stream, interrupt), UploadResult::NotSupportedOperation);
+}
+
+} // namespace
@@ -0,0 +1,295 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+
+#include <firmware_download.hpp>
+
+namespace {
+
+using namespace firmware;
+namespace fs = std::filesystem;
+
+// self signed certificate with an EC key, signs images like the backend of a firmware update would
+class Signer {
+public:
+    Signer() {
+        std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> key_context(
+            EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr), EVP_PKEY_CTX_free);
+        EVP_PKEY_keygen_init(key_context.get());
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_context.get(), NID_X9_62_prime256v1);
+        EVP_PKEY_keygen(key_context.get(), &key);
+
+        std::unique_ptr<X509, decltype(&X509_free)> certificate(X509_new(), X509_free);
+        X509_set_version(certificate.get(), 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(certificate.get()), 1);
+        X509_gmtime_adj(X509_getm_notBefore(certificate.get()), 0);
+        X509_gmtime_adj(X509_getm_notAfter(certificate.get()), 3600);
+        X509_set_pubkey(certificate.get(), key);
+        X509_sign(certificate.get(), key, EVP_sha256());
+
+        std::unique_ptr<BIO, decltype(&BIO_free)> bio(BIO_new(BIO_s_mem()), BIO_free);
+        PEM_write_bio_X509(bio.get(), certificate.get());
+        char* pem_data = nullptr;
+        const auto pem_length = BIO_get_mem_data(bio.get(), &pem_data);
+        certificate_pem.assign(pem_data, pem_length);
+    }
+
+    ~Signer() {
+        EVP_PKEY_free(key);
+    }
+
+    std::string sign(const std::string& image) const {
+        std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> context(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+        EVP_DigestSignInit(context.get(), nullptr, EVP_sha256(), nullptr, key);
+        EVP_DigestSignUpdate(context.get(), image.data(), image.size());
+        std::size_t length = 0;
+        EVP_DigestSignFinal(context.get(), nullptr, &length);
+        std::vector<unsigned char> signature(length);
+        EVP_DigestSignFinal(context.get(), signature.data(), &length);
+
+        std::vector<unsigned char> encoded(4 * ((length + 2) / 3) + 1);
+        const auto encoded_length = EVP_EncodeBlock(encoded.data(), signature.data(), length);
+        return std::string(reinterpret_cast<const char*>(encoded.data()), encoded_length);
+    }
+
+    std::unique_ptr<SignatureVerifier> verifier(const std::string& image) const {
+        return std::make_unique<SignatureVerifier>(certificate_pem, sign(image));
+    }
+
+    std::string certificate_pem;
+
+private:
+    EVP_PKEY* key{nullptr};
+};
+
+// serves one file over HTTP/1.0 style connections, optionally honouring Range requests
+class HttpServer {
+public:
+    HttpServer(std::string body_, bool support_range_) : body(std::move(body_)), support_range(support_range_) {
+        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        socklen_t address_length = sizeof(address);
+        getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_length);
+        port = ntohs(address.sin_port);
+        listen(listen_fd, 4);
+        thread = std::thread(&HttpServer::serve, this);
+    }
+
+    ~HttpServer() {
+        shutdown(listen_fd, SHUT_RDWR);
+        close(listen_fd);
+        thread.join();
+    }
+
+    std::string url() const {
+        return "http://127.0.0.1:" + std::to_string(port) + "/firmware.bin";
+    }
+
+    // the next response is cut off after this many bytes of the body
+    std::atomic<std::size_t> drop_after{0};
+
+    std::vector<std::string> get_ranges() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ranges;
+    }
+
+private:
+    void serve() {
+        while (true) {
+            const auto fd = accept(listen_fd, nullptr, nullptr);
+            if (fd == -1) {
+                return;
+            }
+
+            std::string request;
+            char buffer[1024];
+            while (request.find("\r\n\r\n") == std::string::npos) {
+                const auto length = read(fd, buffer, sizeof(buffer));
+                if (length <= 0) {
+                    break;
+                }
+                request.append(buffer, length);
+            }
+
+            std::size_t offset = 0;
+            const auto range = request.find("Range: bytes=");
+            if (range != std::string::npos) {
+                const auto value = request.substr(range + 13, request.find("\r\n", range) - range - 13);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    ranges.push_back(value);
+                }
+                if (support_range) {
+                    offset = std::stoull(value);
+                }
+            }
+
+            std::string response;
+            if (offset > 0) {
+                response = "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " + std::to_string(offset) + "-" +
+                           std::to_string(body.size() - 1) + "/" + std::to_string(body.size()) + "\r\n";
+            } else {
+                response = "HTTP/1.1 200 OK\r\n";
+            }
+            response += "Content-Length: " + std::to_string(body.size() - offset) + "\r\nConnection: close\r\n\r\n";
+
+            auto content_length = body.size() - offset;
+            if (const auto drop = drop_after.exchange(0); drop > 0) {
+                content_length = drop;
+            }
+            response.append(body, offset, content_length);
+            send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+            close(fd);
+        }
+    }
+
+    const std::string body;
+    const bool support_range;
+    int listen_fd{-1};
+    int port{0};
+    std::mutex mutex;
+    std::vector<std::string> ranges;
+    std::thread thread;
+};
+
+std::string make_image(std::size_t size) {
+    std::string image(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) {
+        image[i] = static_cast<char>((i * 7919) >> 3);
+    }
+    return image;
+}
+
+std::string read_file(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+class FirmwareDownloadTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory = fs::temp_directory_path() /
+                    ("firmware_download_test_" + std::to_string(getpid()) + "_" +
+                     ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::create_directories(directory);
+    }
+
+    void TearDown() override {
+        fs::remove_all(directory);
+    }
+
+    DownloadResult run(FirmwareDownload& download) {
+        return download.run(interrupt, [this](const DownloadProgress& progress) { reports.push_back(progress); },
+                            std::chrono::milliseconds(0));
+    }
+
+    Signer signer;
+    fs::path directory;
+    std::atomic<bool> interrupt{false};
+    std::vector<DownloadProgress> reports;
+};
+
+TEST_F(FirmwareDownloadTest, file_transport) {
+    const auto image = make_image(1024 * 1024 + 17);
+    const auto source = directory / "firmware.bin";
+    std::ofstream(source, std::ios::binary) << image;
+
+    FirmwareDownload download(make_transport("file://" + source.string(), std::chrono::seconds(1)),
+                              signer.verifier(image), directory / "installed.bin");
+    EXPECT_EQ(run(download), DownloadResult::SignatureVerified);
+    EXPECT_EQ(read_file(directory / "installed.bin"), image);
+
+    ASSERT_FALSE(reports.empty());
+    EXPECT_EQ(reports.back().bytes, image.size());
+    EXPECT_EQ(reports.back().total_size, image.size());
+}
+
+TEST_F(FirmwareDownloadTest, tampered_image_is_rejected) {
+    const auto image = make_image(64 * 1024);
+    auto tampered = image;
+    tampered[1000] ^= 1;
+    const auto source = directory / "firmware.bin";
+    std::ofstream(source, std::ios::binary) << tampered;
+
+    FirmwareDownload download(make_transport("file://" + source.string(), std::chrono::seconds(1)),
+                              signer.verifier(image), directory / "installed.bin");
+    EXPECT_EQ(run(download), DownloadResult::InvalidSignature);
+}
+
+TEST_F(FirmwareDownloadTest, invalid_certificate_throws) {
+    EXPECT_THROW(SignatureVerifier("not a certificate", signer.sign("image")), std::runtime_error);
+}
+
+TEST_F(FirmwareDownloadTest, http_transport) {
+    const auto image = make_image(3 * 1024 * 1024 + 5);
+    HttpServer server(image, true);
+
+    FirmwareDownload download(make_transport(server.url(), std::chrono::seconds(1)), signer.verifier(image),
+                              directory / "installed.bin");
+    EXPECT_EQ(run(download), DownloadResult::SignatureVerified);
+    EXPECT_EQ(read_file(directory / "installed.bin"), image);
+    EXPECT_EQ(reports.back().total_size, image.size());
+    EXPECT_GT(reports.back().bytes_per_second, 0.0);
+}
+
+TEST_F(FirmwareDownloadTest, resumes_with_range_request) {
+    const auto image = make_image(2 * 1024 * 1024);
+    HttpServer server(image, true);
+    server.drop_after = 700 * 1024;
+
+    FirmwareDownload download(make_transport(server.url(), std::chrono::seconds(1)), signer.verifier(image),
+                              directory / "installed.bin");
+    EXPECT_EQ(run(download), DownloadResult::Failed);
+    EXPECT_FALSE(download.get_error().empty());
+    EXPECT_EQ(download.get_bytes(), 700 * 1024);
+
+    EXPECT_EQ(run(download), DownloadResult::SignatureVerified);
+    EXPECT_EQ(server.get_ranges(), std::vector<std::string>{std::to_string(700 * 1024) + "-"});
+    EXPECT_EQ(read_file(directory / "installed.bin"), image);
+}
+
+TEST_F(FirmwareDownloadTest, starts_over_without_range_support) {
+    const auto image = make_image(2 * 1024 * 1024);
+    HttpServer server(image, false);
+    server.drop_after = 700 * 1024;
+
+    FirmwareDownload download(make_transport(server.url(), std::chrono::seconds(1)), signer.verifier(image),
+                              directory / "installed.bin");
+    EXPECT_EQ(run(download), DownloadResult::Failed);
+    EXPECT_EQ(run(download), DownloadResult::SignatureVerified);
+    EXPECT_EQ(read_file(directory / "installed.bin"), image);
+}
+
+TEST_F(FirmwareDownloadTest, interrupt_cancels) {
+    const auto image = make_image(2 * 1024 * 1024);
+    HttpServer server(image, true);
+
+    FirmwareDownload download(make_transport(server.url(), std::chrono::seconds(1)), signer.verifier(image),
+                              directory / "installed.bin");
+    interrupt = true;
+    EXPECT_EQ(run(download), DownloadResult::Cancelled);
+}
+
+} // namespace
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "TimeSeries.hpp"
+
+#include <date/date.h>
+#include <date/tz.h>
+
+namespace module {
+
+namespace {
+std::int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(date::utc_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
+void TimeSeries::init() {
+    ::timeseries::StoreConfig store_config;
+    store_config.directory = this->config.storage_path;
+    if (store_config.directory.is_relative()) {
+        store_config.directory = this->info.paths.share / store_config.directory;
+    }
+    EVLOG_info << "Time series storage: " << store_config.directory.string();
+    store_config.segment_duration = std::chrono::minutes(this->config.segment_duration_min);
+    store_config.retention = std::chrono::hours(this->config.retention_hours);
+    store_config.compact_after = std::chrono::hours(this->config.compact_after_hours);
+    store_config.compacted_resolution = std::chrono::seconds(this->config.compacted_resolution_s);
+    store_config.block_size = static_cast<std::size_t>(this->config.block_size);
+    this->store = std::make_unique<::timeseries::SegmentStore>(store_config);
+
+    invoke_init(*p_main);
+
+    for (const auto& evse_manager : this->r_evse_manager) {
+        const std::string prefix = evse_manager->module_id + "/";
+        evse_manager->subscribe_powermeter([this, prefix](const types::powermeter::Powermeter& powermeter) {
+            this->record_powermeter(prefix, powermeter);
+        });
+        evse_manager->subscribe_limits([this, prefix](const types::evse_manager::Limits& limits) {
+            this->record(prefix + "max_current_A", limits.max_current);
+            this->record(prefix + "nr_of_phases_available", limits.nr_of_phases_available);
+        });
+        evse_manager->subscribe_telemetry([this, prefix](const types::evse_board_support::Telemetry& telemetry) {
+            this->record(prefix + "evse_temperature_C", telemetry.evse_temperature_C);
+            if (telemetry.plug_temperature_C.has_value()) {
+                this->record(prefix + "plug_temperature_C", telemetry.plug_temperature_C.value());
+            }
+            this->record(prefix + "fan_rpm", telemetry.fan_rpm);
+            this->record(prefix + "supply_voltage_12V", telemetry.supply_voltage_12V);
+            this->record(prefix + "supply_voltage_minus_12V", telemetry.supply_voltage_minus_12V);
+            this->record(prefix + "relais_on", telemetry.relais_on ? 1 : 0);
+        });
+    }
+
+    for (const auto& powermeter : this->r_powermeter) {
+        const std::string prefix = powermeter->module_id + "/";
+        powermeter->subscribe_powermeter([this, prefix](const types::powermeter::Powermeter& powermeter) {
+            this->record_powermeter(prefix, powermeter);
+        });
+    }
+}
+
+void TimeSeries::ready() {
+    invoke_ready(*p_main);
+
+    this->maintenance_thread = std::thread([this]() { this->maintenance_loop(); });
+}
+
+TimeSeries::~TimeSeries() {
+    {
+        std::lock_guard<std::mutex> lock(this->maintenance_mutex);
+        this->shutting_down = true;
+    }
+    this->maintenance_cv.notify_all();
+    if (this->maintenance_thread.joinable()) {
+        this->maintenance_thread.join();
+    }
+}
+
+void TimeSeries::record(const std::string& series, double value) {
+    try {
+        this->store->append(series, now_ms(), value);
+    } catch (const std::exception& e) {
+        EVLOG_error << "Could not store sample of " << series << ": " << e.what();
+    }
+}
+
+void TimeSeries::record_powermeter(const std::string& prefix, const types::powermeter::Powermeter& powermeter) {
+    this->record(prefix + "energy_Wh_import", powermeter.energy_Wh_import.total);
+    if (powermeter.energy_Wh_export.has_value()) {
+        this->record(prefix + "energy_Wh_export", powermeter.energy_Wh_export->total);
+    }
+    if (powermeter.power_W.has_value()) {
+        this->record(prefix + "power_W", powermeter.power_W->total);
+    }
+    if (powermeter.voltage_V.has_value()) {
+        const auto& voltage = powermeter.voltage_V.value();
+        if (voltage.L1.has_value()) {
+            this->record(prefix + "voltage_V_L1", voltage.L1.value());
+        }
+        if (voltage.L2.has_value()) {
+            this->record(prefix + "voltage_V_L2", voltage.L2.value());
+        }
+        if (voltage.L3.has_value()) {
+            this->record(prefix + "voltage_V_L3", voltage.L3.value());
+        }
+        if (voltage.DC.has_value()) {
+            this->record(prefix + "voltage_V_DC", voltage.DC.value());
+        }
+    }
+    if (powermeter.current_A.has_value()) {
+        const auto& current = powermeter.current_A.value();
+        if (current.L1.has_value()) {
+            this->record(prefix + "current_A_L1", current.L1.value());
+        }
+        if (current.L2.has_value()) {
+            this->record(prefix + "current_A_L2", current.L2.value());
+        }
+        if (current.L3.has_value()) {
+            this->record(prefix + "current_A_L3", current.L3.value());
+        }
+        if (current.DC.has_value()) {
+            this->record(prefix + "current_A_DC", current.DC.value());
+        }
+    }
+    if (powermeter.frequency_Hz.has_value()) {
+        this->record(prefix + "frequency_Hz", powermeter.frequency_Hz->L1);
+    }
+}
+
+void TimeSeries::maintenance_loop() {
+    const auto interval = std::chrono::seconds(this->config.maintenance_interval_s);
+    std::unique_lock<std::mutex> lock(this->maintenance_mutex);
+    while (!this->maintenance_cv.wait_for(lock, interval, [this]() { return this->shutting_down; })) {
+        try {
+            this->store->flush();
+            this->store->maintain(now_ms());
+        } catch (const std::exception& e) {
+            EVLOG_error << "Time series maintenance failed: " << e.what();
+        }
+    }
+}
+
+} // namespace module
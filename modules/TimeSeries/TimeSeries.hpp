@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef TIME_SERIES_HPP
+#define TIME_SERIES_HPP
+
+//
+// AUTO GENERATED - MARKED REGIONS WILL BE KEPT
+// template version 2
+//
+
+#include "ld-ev.hpp"
+
+// headers for provided interface implementations
+#include <generated/interfaces/timeseries/Implementation.hpp>
+
+// headers for required interface implementations
+#include <generated/interfaces/evse_manager/Interface.hpp>
+#include <generated/interfaces/powermeter/Interface.hpp>
+
+// ev@4bf81b14-a215-475c-a1d3-0a484ae48918:v1
+// insert your custom include headers here
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <segment_store.hpp>
+// ev@4bf81b14-a215-475c-a1d3-0a484ae48918:v1
+
+namespace module {
+
+struct Conf {
+    std::string storage_path;
+    int segment_duration_min;
+    int retention_hours;
+    int compact_after_hours;
+    int compacted_resolution_s;
+    int block_size;
+    int maintenance_interval_s;
+};
+
+class TimeSeries : public Everest::ModuleBase {
+public:
+    TimeSeries() = delete;
+    TimeSeries(const ModuleInfo& info, std::unique_ptr<timeseriesImplBase> p_main,
+               std::vector<std::unique_ptr<evse_managerIntf>> r_evse_manager,
+               std::vector<std::unique_ptr<powermeterIntf>> r_powermeter, Conf& config) :
+        ModuleBase(info),
+        p_main(std::move(p_main)),
+        r_evse_manager(std::move(r_evse_manager)),
+        r_powermeter(std::move(r_powermeter)),
+        config(config){};
+
+    const std::unique_ptr<timeseriesImplBase> p_main;
+    const std::vector<std::unique_ptr<evse_managerIntf>> r_evse_manager;
+    const std::vector<std::unique_ptr<powermeterIntf>> r_powermeter;
+    const Conf& config;
+
+    // ev@1fce4c5e-0ab8-41bb-90f7-14277703d2ac:v1
+    // insert your public definitions here
+    ~TimeSeries();
+
+    std::unique_ptr<::timeseries::SegmentStore> store;
+    // ev@1fce4c5e-0ab8-41bb-90f7-14277703d2ac:v1
+
+protected:
+    // ev@4714b2ab-a24f-4b95-ab81-36439e1478de:v1
+    // insert your protected definitions here
+    // ev@4714b2ab-a24f-4b95-ab81-36439e1478de:v1
+
+private:
+    friend class LdEverest;
+    void init();
+    void ready();
+
+    // ev@211cfdbe-f69a-4cd6-a4ec-f8aaa3d1b6c8:v1
+    // insert your private definitions here
+    void record(const std::string& series, double value);
+    void record_powermeter(const std::string& prefix, const types::powermeter::Powermeter& powermeter);
+    void maintenance_loop();
+
+    std::thread maintenance_thread;
+    std::mutex maintenance_mutex;
+    std::condition_variable maintenance_cv;
+    bool shutting_down{false};
+    // ev@211cfdbe-f69a-4cd6-a4ec-f8aaa3d1b6c8:v1
+};
+
+// ev@087e516b-124c-48df-94fb-109508c7cda9:v1
+// insert other definitions here
+// ev@087e516b-124c-48df-94fb-109508c7cda9:v1
+
+} // namespace module
+
+#endif // TIME_SERIES_HPP
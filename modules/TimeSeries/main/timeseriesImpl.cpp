@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "timeseriesImpl.hpp"
+
+#include <utils/date.hpp>
+
+namespace module {
+namespace main {
+
+namespace {
+std::int64_t to_epoch_ms(const std::string& rfc3339) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               Everest::Date::from_rfc3339(rfc3339).time_since_epoch())
+        .count();
+}
+
+date::utc_clock::time_point from_epoch_ms(std::int64_t epoch_ms) {
+    return date::utc_clock::time_point(std::chrono::milliseconds(epoch_ms));
+}
+} // namespace
+
+void timeseriesImpl::init() {
+}
+
+void timeseriesImpl::ready() {
+}
+
+Array timeseriesImpl::handle_list_series() {
+    Array series;
+    try {
+        for (const auto& name : mod->store->series_names()) {
+            series.push_back(name);
+        }
+    } catch (const std::exception& e) {
+        EVLOG_error << "Could not list time series: " << e.what();
+    }
+    return series;
+}
+
+std::vector<types::timeseries::DataPoint> timeseriesImpl::handle_query(std::string& series, std::string& from,
+                                                                       std::string& to, int& resolution_s) {
+    std::vector<types::timeseries::DataPoint> result;
+    std::int64_t from_ms = 0;
+    std::int64_t to_ms = 0;
+    try {
+        from_ms = to_epoch_ms(from);
+        to_ms = to_epoch_ms(to);
+    } catch (const std::exception& e) {
+        EVLOG_warning << "Invalid time range for time series query: " << e.what();
+        return result;
+    }
+
+    std::vector<::timeseries::Aggregate> aggregates;
+    try {
+        aggregates = mod->store->query(series, from_ms, to_ms, static_cast<std::int64_t>(resolution_s) * 1000);
+    } catch (const std::exception& e) {
+        // e.g. an unreadable segment file, the query is answered with an empty result
+        EVLOG_error << "Could not query time series " << series << ": " << e.what();
+        return result;
+    }
+    result.reserve(aggregates.size());
+    for (const auto& aggregate : aggregates) {
+        types::timeseries::DataPoint data_point;
+        data_point.timestamp = Everest::Date::to_rfc3339(from_epoch_ms(aggregate.timestamp_ms));
+        data_point.value = aggregate.avg;
+        data_point.min = aggregate.min;
+        data_point.max = aggregate.max;
+        data_point.count = static_cast<int>(aggregate.count);
+        result.push_back(data_point);
+    }
+    return result;
+}
+
+} // namespace main
+} // namespace module
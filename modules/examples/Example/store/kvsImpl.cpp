@@ -28,5 +28,13 @@ bool kvsImpl::handle_exists(std::string& key) {
     return mod->r_kvs->call_exists(key);
 };
 
+void kvsImpl::handle_store_many(Object& entries, int& ttl_s) {
+    mod->r_kvs->call_store_many(entries, ttl_s);
+};
+
+Object kvsImpl::handle_load_many(Array& keys) {
+    return mod->r_kvs->call_load_many(keys);
+};
+
 } // namespace store
 } // namespace module
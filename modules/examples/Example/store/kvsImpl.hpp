@@ -40,6 +40,8 @@ protected:
     handle_load(std::string& key) override;
     virtual void handle_delete(std::string& key) override;
     virtual bool handle_exists(std::string& key) override;
+    virtual void handle_store_many(Object& entries, int& ttl_s) override;
+    virtual Object handle_load_many(Array& keys) override;
 
     // ev@d2d1847a-7b88-41dd-ad07-92785f06f5c4:v1
     // insert your protected definitions here
@@ -33,6 +33,23 @@ impl KvsServiceSubscriber for OneClass {
     fn exists(&self, context: &Context, key: String) -> ::everestrs::Result<bool> {
         context.publisher.their_store.exists(key)
     }
+
+    fn store_many(
+        &self,
+        context: &Context,
+        entries: serde_json::Value,
+        ttl_s: i64,
+    ) -> ::everestrs::Result<()> {
+        context.publisher.their_store.store_many(entries, ttl_s)
+    }
+
+    fn load_many(
+        &self,
+        context: &Context,
+        keys: Vec<String>,
+    ) -> ::everestrs::Result<serde_json::Value> {
+        context.publisher.their_store.load_many(keys)
+    }
 }
 
 impl ExampleServiceSubscriber for OneClass {
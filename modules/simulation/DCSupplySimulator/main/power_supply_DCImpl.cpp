@@ -5,6 +5,8 @@
 #include <chrono>
 #include <mutex>
 
+#include <virtual_clock.hpp>
+
 #include "power_supply_DCImpl.hpp"
 
 namespace module {
@@ -141,7 +143,7 @@ void power_supply_DCImpl::power_supply_worker(void) {
         }
 
         // set interval for publishing
-        std::this_thread::sleep_for(std::chrono::milliseconds(LOOP_SLEEP_MS));
+        virtual_clock::sleep_for(std::chrono::milliseconds(LOOP_SLEEP_MS));
 
         std::scoped_lock access_lock(power_supply_values_mutex);
         voltage_current.voltage_V = static_cast<float>(connector_voltage);
@@ -4,6 +4,7 @@
 #include "isolation_monitorImpl.hpp"
 #include <chrono>
 #include <thread>
+#include <virtual_clock.hpp>
 namespace module {
 namespace main {
 
@@ -38,7 +39,7 @@ void isolation_monitorImpl::isolation_measurement_worker() {
         if (this->isolation_monitoring_active == true) {
             this->mod->p_main->publish_isolation_measurement(this->isolation_measurement);
             EVLOG_debug << "Simulated isolation measurement finished";
-            std::this_thread::sleep_for(std::chrono::milliseconds(this->config_interval - this->LOOP_SLEEP_MS));
+            virtual_clock::sleep_for(std::chrono::milliseconds(this->config_interval - this->LOOP_SLEEP_MS));
         }
 
         if (this->selftest_running_countdown > 0) {
@@ -48,7 +49,7 @@ void isolation_monitorImpl::isolation_measurement_worker() {
             }
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(this->LOOP_SLEEP_MS));
+        virtual_clock::sleep_for(std::chrono::milliseconds(this->LOOP_SLEEP_MS));
     }
 }
 
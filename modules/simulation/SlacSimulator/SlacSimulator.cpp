@@ -4,6 +4,8 @@
 #include "ev/ev_slacImpl.hpp"
 #include "evse/slacImpl.hpp"
 
+#include <virtual_clock.hpp>
+
 namespace module {
 
 using util::State;
@@ -29,7 +31,7 @@ void SlacSimulator::run() {
             ev.set_state_matched();
             evse.set_state_matched();
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(loop_interval_ms));
+        virtual_clock::sleep_for(std::chrono::milliseconds(loop_interval_ms));
     }
 };
 
@@ -0,0 +1,324 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "YetiSimulator.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include <fmt/core.h>
+#include <utils/date.hpp>
+
+namespace module {
+
+namespace {
+
+types::board_support_common::Event to_everest(yeti_simulation::BspEvent event) {
+    using types::board_support_common::Event;
+    switch (event) {
+    case yeti_simulation::BspEvent::A:
+        return Event::A;
+    case yeti_simulation::BspEvent::B:
+        return Event::B;
+    case yeti_simulation::BspEvent::C:
+        return Event::C;
+    case yeti_simulation::BspEvent::D:
+        return Event::D;
+    case yeti_simulation::BspEvent::E:
+        return Event::E;
+    case yeti_simulation::BspEvent::F:
+        return Event::F;
+    case yeti_simulation::BspEvent::PowerOn:
+        return Event::PowerOn;
+    case yeti_simulation::BspEvent::PowerOff:
+        return Event::PowerOff;
+    }
+    return Event::F;
+}
+
+std::string cp_state_to_string(const yeti_simulation::Telemetry& t) {
+    const auto pwm = t.pwm_running ? "2" : "1";
+    switch (t.cp_state) {
+    case yeti_simulation::CpState::Disabled:
+        return "Disabled";
+    case yeti_simulation::CpState::A:
+        return std::string("A") + pwm;
+    case yeti_simulation::CpState::B:
+        return std::string("B") + pwm;
+    case yeti_simulation::CpState::C:
+        return std::string("C") + pwm;
+    case yeti_simulation::CpState::D:
+        return std::string("D") + pwm;
+    case yeti_simulation::CpState::E:
+        return "E";
+    case yeti_simulation::CpState::F:
+        return "F";
+    }
+    return "";
+}
+
+types::powermeter::Powermeter to_everest(const yeti_simulation::PowermeterReading& p) {
+    types::powermeter::Powermeter j;
+
+    j.timestamp = Everest::Date::to_rfc3339(date::utc_clock::now());
+    j.meter_id = "YETI_POWERMETER";
+    j.phase_seq_error = false;
+
+    j.energy_Wh_import.total = p.energy_Wh_import_total;
+    j.energy_Wh_import.L1 = p.energy_Wh_import.L1;
+    j.energy_Wh_import.L2 = p.energy_Wh_import.L2;
+    j.energy_Wh_import.L3 = p.energy_Wh_import.L3;
+
+    types::units::Power pwr;
+    pwr.total = p.power_W.L1 + p.power_W.L2 + p.power_W.L3;
+    pwr.L1 = p.power_W.L1;
+    pwr.L2 = p.power_W.L2;
+    pwr.L3 = p.power_W.L3;
+    j.power_W = pwr;
+
+    types::units::Voltage volt;
+    volt.L1 = p.voltage_V.L1;
+    volt.L2 = p.voltage_V.L2;
+    volt.L3 = p.voltage_V.L3;
+    j.voltage_V = volt;
+
+    types::units::Current amp;
+    amp.L1 = p.current_A.L1;
+    amp.L2 = p.current_A.L2;
+    amp.L3 = p.current_A.L3;
+    amp.N = p.current_N_A;
+    j.current_A = amp;
+
+    types::units::Frequency freq;
+    freq.L1 = p.frequency_Hz.L1;
+    freq.L2 = p.frequency_Hz.L2;
+    freq.L3 = p.frequency_Hz.L3;
+    j.frequency_Hz = freq;
+
+    return j;
+}
+
+// errors that can be injected from node-red, the error_type in the request carries the prefix of the implementation
+const std::array<const char*, 22> BOARD_SUPPORT_ERRORS = {
+    "DiodeFault",
+    "BrownOut",
+    "EnergyManagement",
+    "PermanentFault",
+    "MREC2GroundFailure",
+    "MREC3HighTemperature",
+    "MREC4OverCurrentFailure",
+    "MREC5OverVoltage",
+    "MREC6UnderVoltage",
+    "MREC8EmergencyStop",
+    "MREC10InvalidVehicleMode",
+    "MREC14PilotFault",
+    "MREC15PowerLoss",
+    "MREC17EVSEContactorFault",
+    "MREC18CableOverTempDerate",
+    "MREC19CableOverTempStop",
+    "MREC20PartialInsertion",
+    "MREC23ProximityFault",
+    "MREC24ConnectorVoltageHigh",
+    "MREC25BrokenLatch",
+    "MREC26CutCable",
+    "VentilationNotAvailable",
+};
+const std::array<const char*, 5> RCD_ERRORS = {"MREC2GroundFailure", "VendorError", "Selftest", "AC", "DC"};
+const std::array<const char*, 7> CONNECTOR_LOCK_ERRORS = {
+    "ConnectorLockCapNotCharged", "ConnectorLockUnexpectedOpen", "ConnectorLockUnexpectedClose",
+    "ConnectorLockFailedLock",    "ConnectorLockFailedUnlock",   "MREC1ConnectorLockFailure",
+    "VendorError",
+};
+
+template <typename ErrorList> bool contains(const ErrorList& list, const std::string& error_type) {
+    return std::find(list.begin(), list.end(), error_type) != list.end();
+}
+
+template <typename Impl> void raise_or_clear(Impl& impl, const std::string& type, bool raise) {
+    if (raise) {
+        impl.raise_error(
+            impl.error_factory->create_error(type, "", "Simulated fault event", Everest::error::Severity::High));
+    } else if (impl.error_state_monitor->is_error_active(type, "")) {
+        impl.clear_error(type);
+    }
+}
+
+class YetiSimulatorPublisher : public yeti_simulation::Listener {
+public:
+    explicit YetiSimulatorPublisher(YetiSimulator& mod) : mod(mod) {
+    }
+
+    void on_event(yeti_simulation::BspEvent event) override {
+        types::board_support_common::BspEvent bsp_event;
+        bsp_event.event = to_everest(event);
+        mod.p_board_support->publish_event(bsp_event);
+
+        if (event == yeti_simulation::BspEvent::A) {
+            // errors that clear on disconnection of the vehicle, other errors need to be cleared explicitly
+            raise_or_clear(*mod.p_board_support, "evse_board_support/DiodeFault", false);
+        }
+    }
+
+    void on_diode_fault(bool raised) override {
+        raise_or_clear(*mod.p_board_support, "evse_board_support/DiodeFault", raised);
+    }
+
+    void on_rcd_dc_error(bool raised) override {
+        raise_or_clear(*mod.p_board_support, "ac_rcd/DC", raised);
+    }
+
+    void on_rcd_current(double current_mA) override {
+        mod.p_rcd->publish_rcd_current_mA(current_mA);
+    }
+
+    void on_ev_measurement(const yeti_simulation::EvMeasurement& measurement) override {
+        types::board_support_common::BspMeasurement m;
+        m.cp_pwm_duty_cycle = measurement.cp_pwm_duty_cycle;
+        m.rcd_current_mA = measurement.rcd_current_mA;
+        m.proximity_pilot.ampacity = to_everest(measurement.pp_ampacity);
+        mod.p_ev_board_support->publish_bsp_measurement(m);
+    }
+
+    void on_powermeter(const yeti_simulation::PowermeterReading& reading) override {
+        mod.p_powermeter->publish_powermeter(to_everest(reading));
+    }
+
+    void on_telemetry(const yeti_simulation::Telemetry& t) override {
+        types::evse_board_support::Telemetry telemetry;
+        telemetry.evse_temperature_C = t.temperature_C;
+        telemetry.fan_rpm = 1500.0;
+        telemetry.supply_voltage_12V = 12.01;
+        telemetry.supply_voltage_minus_12V = -11.8;
+        telemetry.relais_on = t.relais_on;
+        mod.p_board_support->publish_telemetry(telemetry);
+
+        if (not mod.info.telemetry_enabled) {
+            return;
+        }
+
+        const auto timestamp = Everest::Date::to_rfc3339(date::utc_clock::now());
+        if (telemetry_count++ % TELEMETRY_VERSION_INTERVAL_S == 0) {
+            mod.telemetry.publish("livedata", "power_path_controller_version",
+                                  {{"timestamp", timestamp},
+                                   {"type", "power_path_controller_version"},
+                                   {"hardware_version", 3},
+                                   {"software_version", "1.01"},
+                                   {"date_manufactured", "20220304"},
+                                   {"operating_time_h", 2330},
+                                   {"operating_time_h_warning", 5000},
+                                   {"operating_time_h_error", 6000},
+                                   {"error", false}});
+        }
+
+        mod.telemetry.publish("livedata", "power_path_controller",
+                              {{"timestamp", timestamp},
+                               {"type", "power_path_controller"},
+                               {"cp_voltage_high", t.cp_voltage_high},
+                               {"cp_voltage_low", t.cp_voltage_low},
+                               {"cp_pwm_duty_cycle", t.cp_pwm_duty_cycle},
+                               {"cp_state", cp_state_to_string(t)},
+                               {"pp_ohm", 220.1},
+                               {"supply_voltage_12V", 12.1},
+                               {"supply_voltage_minus_12V", -11.9},
+                               {"temperature_controller", t.temperature_C},
+                               {"temperature_car_connector", t.temperature_C * 2.0},
+                               {"watchdog_reset_count", 0},
+                               {"error", false}});
+        mod.telemetry.publish("livedata", "power_switch",
+                              {{"timestamp", timestamp},
+                               {"type", "power_switch"},
+                               {"switching_count", t.switching_count},
+                               {"switching_count_warning", 30000},
+                               {"switching_count_error", 50000},
+                               {"is_on", t.relais_on},
+                               {"time_to_switch_on_ms", 110},
+                               {"time_to_switch_off_ms", 100},
+                               {"temperature_C", 20},
+                               {"error", false},
+                               {"error_over_current", false}});
+        mod.telemetry.publish("livedata", "rcd",
+                              {{"timestamp", timestamp},
+                               {"type", "rcd"},
+                               {"enabled", true},
+                               {"current_mA", t.rcd_current_mA},
+                               {"triggered", false},
+                               {"error", false}});
+    }
+
+private:
+    static constexpr uint32_t TELEMETRY_VERSION_INTERVAL_S = 15;
+
+    YetiSimulator& mod;
+    uint32_t telemetry_count{0};
+};
+
+} // namespace
+
+types::board_support_common::Ampacity to_everest(yeti_simulation::Ampacity ampacity) {
+    using types::board_support_common::Ampacity;
+    switch (ampacity) {
+    case yeti_simulation::Ampacity::A_13:
+        return Ampacity::A_13;
+    case yeti_simulation::Ampacity::A_20:
+        return Ampacity::A_20;
+    case yeti_simulation::Ampacity::A_32:
+        return Ampacity::A_32;
+    case yeti_simulation::Ampacity::A_63:
+        return Ampacity::A_63_3ph_70_1ph;
+    case yeti_simulation::Ampacity::None:
+        break;
+    }
+    return Ampacity::None;
+}
+
+void YetiSimulator::init() {
+    publisher = std::make_unique<YetiSimulatorPublisher>(*this);
+    scheduler = std::make_unique<yeti_simulation::TickScheduler>(std::chrono::milliseconds(config.tick_interval_ms));
+    connector = &scheduler->add_connector(config.connector_id, *publisher);
+
+    invoke_init(*p_powermeter);
+    invoke_init(*p_board_support);
+    invoke_init(*p_ev_board_support);
+    invoke_init(*p_rcd);
+    invoke_init(*p_connector_lock);
+
+    mqtt.subscribe(fmt::format("everest_external/nodered/{}/carsim/error", config.connector_id),
+                   [this](const std::string& data) { handle_error_injection(data); });
+}
+
+void YetiSimulator::ready() {
+    invoke_ready(*p_powermeter);
+    invoke_ready(*p_board_support);
+    invoke_ready(*p_ev_board_support);
+    invoke_ready(*p_rcd);
+    invoke_ready(*p_connector_lock);
+
+    scheduler->start();
+}
+
+void YetiSimulator::handle_error_injection(const std::string& data) {
+    std::string error_type;
+    bool raise = false;
+    try {
+        const auto e = Everest::json::parse(data);
+        error_type = e.at("error_type");
+        raise = e.at("raise") == "true";
+    } catch (const std::exception& e) {
+        EVLOG_error << "Invalid error injection request: " << e.what();
+        return;
+    }
+
+    const std::string rcd_prefix = "ac_rcd_";
+    const std::string lock_prefix = "lock_";
+    if (error_type.rfind(rcd_prefix, 0) == 0 and contains(RCD_ERRORS, error_type.substr(rcd_prefix.size()))) {
+        raise_or_clear(*p_rcd, "ac_rcd/" + error_type.substr(rcd_prefix.size()), raise);
+    } else if (error_type.rfind(lock_prefix, 0) == 0 and
+               contains(CONNECTOR_LOCK_ERRORS, error_type.substr(lock_prefix.size()))) {
+        raise_or_clear(*p_connector_lock, "connector_lock/" + error_type.substr(lock_prefix.size()), raise);
+    } else if (contains(BOARD_SUPPORT_ERRORS, error_type)) {
+        raise_or_clear(*p_board_support, "evse_board_support/" + error_type, raise);
+    } else {
+        EVLOG_error << "Unknown error raised via MQTT: " << error_type;
+    }
+}
+
+} // namespace module
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "evse_board_supportImpl.hpp"
+
+namespace module {
+namespace board_support {
+
+void evse_board_supportImpl::init() {
+}
+
+void evse_board_supportImpl::ready() {
+    types::evse_board_support::HardwareCapabilities caps;
+    caps.max_current_A_import = 32.0;
+    caps.min_current_A_import = 6.0;
+    caps.max_phase_count_import = 3;
+    caps.min_phase_count_import = 1;
+    caps.max_current_A_export = 16.0;
+    caps.min_current_A_export = 0.0;
+    caps.max_phase_count_export = 3;
+    caps.min_phase_count_export = 1;
+    caps.supports_changing_phases_during_charging = true;
+    caps.connector_type = types::evse_board_support::Connector_type::IEC62196Type2Cable;
+    publish_capabilities(caps);
+}
+
+void evse_board_supportImpl::handle_enable(bool& value) {
+    mod->connector->enable(value);
+}
+
+void evse_board_supportImpl::handle_pwm_on(double& value) {
+    mod->connector->pwm_on(value);
+}
+
+void evse_board_supportImpl::handle_pwm_off() {
+    mod->connector->pwm_off();
+}
+
+void evse_board_supportImpl::handle_pwm_F() {
+    mod->connector->pwm_F();
+}
+
+void evse_board_supportImpl::handle_allow_power_on(types::evse_board_support::PowerOnOff& value) {
+    mod->connector->allow_power_on(value.allow_power_on);
+}
+
+void evse_board_supportImpl::handle_ac_switch_three_phases_while_charging(bool& value) {
+    mod->connector->switch_three_phases(value);
+}
+
+void evse_board_supportImpl::handle_evse_replug(int& value) {
+    EVLOG_error << "Replugging not supported";
+}
+
+types::board_support_common::ProximityPilot evse_board_supportImpl::handle_ac_read_pp_ampacity() {
+    types::board_support_common::ProximityPilot pp;
+    pp.ampacity = to_everest(mod->connector->pp_ampacity());
+    return pp;
+}
+
+void evse_board_supportImpl::handle_ac_set_overcurrent_limit_A(double& value) {
+    // the simulated hardware has no over current shutdown
+}
+
+} // namespace board_support
+} // namespace module
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "ev_board_supportImpl.hpp"
+
+namespace module {
+namespace ev_board_support {
+
+void ev_board_supportImpl::init() {
+}
+
+void ev_board_supportImpl::ready() {
+}
+
+void ev_board_supportImpl::handle_enable(bool& value) {
+    mod->connector->enable_simulation(value);
+}
+
+void ev_board_supportImpl::handle_set_cp_state(types::ev_board_support::EvCpState& cp_state) {
+    switch (cp_state) {
+    case types::ev_board_support::EvCpState::A:
+        mod->connector->set_cp_state(yeti_simulation::EvCpState::A);
+        break;
+    case types::ev_board_support::EvCpState::B:
+        mod->connector->set_cp_state(yeti_simulation::EvCpState::B);
+        break;
+    case types::ev_board_support::EvCpState::C:
+        mod->connector->set_cp_state(yeti_simulation::EvCpState::C);
+        break;
+    case types::ev_board_support::EvCpState::D:
+        mod->connector->set_cp_state(yeti_simulation::EvCpState::D);
+        break;
+    case types::ev_board_support::EvCpState::E:
+        mod->connector->set_cp_state(yeti_simulation::EvCpState::E);
+        break;
+    }
+}
+
+void ev_board_supportImpl::handle_allow_power_on(bool& value) {
+    // the simulation has no option to control a DC powermeter on the EV side
+    EVLOG_debug << "EV Power On: " << value;
+}
+
+void ev_board_supportImpl::handle_diode_fail(bool& value) {
+    mod->connector->set_diode_fail(value);
+}
+
+void ev_board_supportImpl::handle_set_ac_max_current(double& current) {
+    mod->connector->set_ev_max_current(current);
+}
+
+void ev_board_supportImpl::handle_set_three_phases(bool& three_phases) {
+    mod->connector->set_ev_three_phases(three_phases);
+}
+
+void ev_board_supportImpl::handle_set_rcd_error(double& rcd_current_mA) {
+    mod->connector->set_rcd_current(rcd_current_mA);
+}
+
+} // namespace ev_board_support
+} // namespace module
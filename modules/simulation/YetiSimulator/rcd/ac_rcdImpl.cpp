@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include "ac_rcdImpl.hpp"
+
+namespace module {
+namespace rcd {
+
+void ac_rcdImpl::init() {
+}
+
+void ac_rcdImpl::ready() {
+}
+
+void ac_rcdImpl::handle_self_test() {
+    // the simulated RCD always passes, a failing self test can be injected as ac_rcd_Selftest error
+}
+
+bool ac_rcdImpl::handle_reset() {
+    return true;
+}
+
+} // namespace rcd
+} // namespace module
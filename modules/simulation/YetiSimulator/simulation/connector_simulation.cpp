@@ -0,0 +1,520 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "connector_simulation.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace yeti_simulation {
+
+namespace {
+
+// checks if voltage is within center+-interval
+bool is_voltage_in_range(double voltage, double center) {
+    constexpr double interval = 1.1;
+    return voltage > center - interval and voltage < center + interval;
+}
+
+// IEC61851 Table A.8
+double duty_cycle_to_amps(double dc) {
+    if (dc < 8.0 / 100.0) {
+        return 0;
+    }
+    if (dc < 85.0 / 100.0) {
+        return dc * 100.0 * 0.6;
+    }
+    if (dc < 96.0 / 100.0) {
+        return (dc * 100.0 - 64) * 2.5;
+    }
+    if (dc < 97.0 / 100.0) {
+        return 80;
+    }
+    return 0;
+}
+
+BspEvent state_to_event(CpState state) {
+    switch (state) {
+    case CpState::A:
+        return BspEvent::A;
+    case CpState::B:
+        return BspEvent::B;
+    case CpState::C:
+        return BspEvent::C;
+    case CpState::D:
+        return BspEvent::D;
+    case CpState::E:
+        return BspEvent::E;
+    case CpState::F:
+    case CpState::Disabled:
+        break;
+    }
+    return BspEvent::F;
+}
+
+} // namespace
+
+ConnectorSimulation::ConnectorSimulation(int connector_id_, std::chrono::milliseconds tick_interval_,
+                                         Listener& listener_) :
+    connector_id(connector_id_),
+    tick_interval(tick_interval_),
+    ticks_per_second(std::max<uint32_t>(1, std::chrono::milliseconds(std::chrono::seconds(1)) / tick_interval_)),
+    listener(listener_),
+    noise_generator(static_cast<std::minstd_rand::result_type>(connector_id_) + 1) {
+    clear_data();
+}
+
+void ConnectorSimulation::enable(bool value) {
+    post(CommandType::Enable, value);
+}
+
+void ConnectorSimulation::pwm_on(double duty_cycle) {
+    post(CommandType::PwmOn, duty_cycle);
+}
+
+void ConnectorSimulation::pwm_off() {
+    post(CommandType::PwmOff);
+}
+
+void ConnectorSimulation::pwm_F() {
+    post(CommandType::PwmF);
+}
+
+void ConnectorSimulation::allow_power_on(bool value) {
+    post(CommandType::AllowPowerOn, value);
+}
+
+void ConnectorSimulation::switch_three_phases(bool value) {
+    post(CommandType::SwitchThreePhases, value);
+}
+
+void ConnectorSimulation::enable_simulation(bool value) {
+    post(CommandType::EnableSimulation, value);
+}
+
+void ConnectorSimulation::set_cp_state(EvCpState cp_state) {
+    post(CommandType::SetCpState, static_cast<double>(cp_state));
+}
+
+void ConnectorSimulation::set_diode_fail(bool value) {
+    post(CommandType::SetDiodeFail, value);
+}
+
+void ConnectorSimulation::set_ev_max_current(double current_A) {
+    post(CommandType::SetEvMaxCurrent, current_A);
+}
+
+void ConnectorSimulation::set_ev_three_phases(bool value) {
+    post(CommandType::SetEvThreePhases, value);
+}
+
+void ConnectorSimulation::set_rcd_current(double current_mA) {
+    post(CommandType::SetRcdCurrent, current_mA);
+}
+
+void ConnectorSimulation::post(CommandType type, double value) {
+    std::lock_guard<std::mutex> lock(commands_mutex);
+    commands.push_back({type, value});
+}
+
+void ConnectorSimulation::apply(const Command& command) {
+    const bool flag = command.value != 0.0;
+
+    switch (command.type) {
+    case CommandType::Enable:
+        if (not flag) {
+            current_state = CpState::Disabled;
+        } else if (current_state == CpState::Disabled) {
+            current_state = CpState::A;
+        }
+        break;
+    case CommandType::PwmOn:
+        pwm_on_internal(command.value / 100.0);
+        break;
+    case CommandType::PwmOff:
+        pwm_off_internal();
+        break;
+    case CommandType::PwmF:
+        pwm_duty_cycle = 1.0;
+        pwm_running = false;
+        pwm_error_f = true;
+        break;
+    case CommandType::AllowPowerOn:
+        power_on_allowed = flag;
+        break;
+    case CommandType::SwitchThreePhases:
+        use_three_phases = flag;
+        use_three_phases_confirmed = flag;
+        break;
+    case CommandType::EnableSimulation:
+        if (simulation_enabled and not flag) {
+            listener.on_event(BspEvent::A);
+            clear_data();
+        }
+        simulation_enabled = flag;
+        break;
+    case CommandType::SetCpState:
+        switch (static_cast<EvCpState>(command.value)) {
+        case EvCpState::A:
+            setting.cp_voltage = 12.0;
+            break;
+        case EvCpState::B:
+            setting.cp_voltage = 9.0;
+            break;
+        case EvCpState::C:
+            setting.cp_voltage = 6.0;
+            break;
+        case EvCpState::D:
+            setting.cp_voltage = 3.0;
+            break;
+        case EvCpState::E:
+            setting.error_e = true;
+            break;
+        }
+        break;
+    case CommandType::SetDiodeFail:
+        setting.diode_fail = flag;
+        break;
+    case CommandType::SetEvMaxCurrent:
+        ev_max_current = command.value;
+        break;
+    case CommandType::SetEvThreePhases:
+        ev_phases = flag ? 3 : 1;
+        break;
+    case CommandType::SetRcdCurrent:
+        setting.rcd_current = command.value;
+        break;
+    }
+}
+
+void ConnectorSimulation::clear_data() {
+    setting = Setting{};
+    simulated = Setting{};
+
+    simulation_enabled = false;
+    power_on_allowed = false;
+    relais_on = false;
+    current_state = CpState::Disabled;
+    last_state = CpState::Disabled;
+    use_three_phases = true;
+    use_three_phases_confirmed = true;
+
+    pwm_duty_cycle = 0.0;
+    pwm_running = false;
+    pwm_error_f = false;
+    pwm_voltage_hi = 12.1;
+    pwm_voltage_lo = 12.1;
+
+    ev_max_current = 0.0;
+    ev_phases = 3;
+
+    energy_Wh = Phases{};
+    switching_count = 0;
+    powermeter = PowermeterReading{};
+    powermeter.voltage_V = {230.0, 230.0, 230.0};
+    powermeter.frequency_Hz = {50.0, 50.0, 50.0};
+}
+
+void ConnectorSimulation::tick() {
+    {
+        std::lock_guard<std::mutex> lock(commands_mutex);
+        commands_to_apply.swap(commands);
+    }
+    for (const auto& command : commands_to_apply) {
+        apply(command);
+    }
+    commands_to_apply.clear();
+
+    if (simulation_enabled) {
+        check_error_rcd();
+        read_from_car();
+        run_state_machine();
+        add_noise();
+        simulate_powermeter();
+
+        const auto pp_ampacity = read_pp_ampacity();
+        last_pp_ampacity = pp_ampacity;
+        listener.on_ev_measurement({pwm_duty_cycle * 100.0, simulated.rcd_current, pp_ampacity});
+    }
+
+    if (tick_count % ticks_per_second == 0) {
+        listener.on_powermeter(powermeter);
+
+        Telemetry telemetry;
+        telemetry.cp_voltage_high = pwm_voltage_hi;
+        telemetry.cp_voltage_low = pwm_voltage_lo;
+        telemetry.cp_pwm_duty_cycle = pwm_duty_cycle * 100.0;
+        telemetry.cp_state = current_state;
+        telemetry.pwm_running = pwm_running;
+        telemetry.relais_on = relais_on;
+        telemetry.switching_count = switching_count;
+        telemetry.temperature_C =
+            25.0 + (powermeter.power_W.L1 + powermeter.power_W.L2 + powermeter.power_W.L3) * 0.003;
+        telemetry.rcd_current_mA = simulated.rcd_current;
+        listener.on_telemetry(telemetry);
+    }
+
+    tick_count++;
+}
+
+void ConnectorSimulation::check_error_rcd() {
+    if (simulated.rcd_current > 5.0) {
+        if (not rcd_error_reported) {
+            listener.on_rcd_dc_error(true);
+            rcd_error_reported = true;
+        }
+    } else {
+        if (rcd_error_reported) {
+            listener.on_rcd_dc_error(false);
+        }
+        rcd_error_reported = false;
+    }
+    listener.on_rcd_current(simulated.rcd_current);
+}
+
+// Translate ADC readings for lo and hi part of PWM to IEC61851 states.
+void ConnectorSimulation::read_from_car() {
+    const bool hlc_active = pwm_duty_cycle >= 0.03 and pwm_duty_cycle <= 0.07;
+
+    auto amps = duty_cycle_to_amps(pwm_duty_cycle);
+    if (amps > ev_max_current or hlc_active) {
+        amps = ev_max_current;
+    }
+
+    const double amps1 = (relais_on and ev_phases > 0) ? amps : 0.0;
+    const double amps2 = (relais_on and ev_phases > 1 and use_three_phases_confirmed) ? amps : 0.0;
+    const double amps3 = (relais_on and ev_phases > 2 and use_three_phases_confirmed) ? amps : 0.0;
+
+    pwm_voltage_hi = simulated.cp_voltage;
+    pwm_voltage_lo = pwm_running ? -12.0 : pwm_voltage_hi;
+
+    if (pwm_error_f) {
+        pwm_voltage_hi = -12.0;
+        pwm_voltage_lo = -12.0;
+    }
+    if (simulated.error_e) {
+        pwm_voltage_hi = 0.0;
+        pwm_voltage_lo = 0.0;
+    }
+    if (simulated.diode_fail) {
+        pwm_voltage_lo = -pwm_voltage_hi;
+    }
+
+    const auto cp_lo = pwm_voltage_lo;
+    const auto cp_hi = pwm_voltage_hi;
+
+    // sth is wrong with negative signal
+    if (pwm_running and not is_voltage_in_range(cp_lo, -12.0)) {
+        if (is_voltage_in_range(cp_lo, 0.0) and is_voltage_in_range(cp_hi, 0.0)) {
+            // CP-PE short or signal somehow gone
+            current_state = CpState::E;
+            draw_power(0, 0, 0, 0);
+        } else if (is_voltage_in_range(cp_hi + cp_lo, 0.0)) {
+            // Diode fault
+            if (not diode_fault_raised) {
+                listener.on_diode_fault(true);
+                diode_fault_raised = true;
+            }
+            draw_power(0, 0, 0, 0);
+        }
+    } else if (is_voltage_in_range(cp_hi, 12.0)) {
+        // +12V State A IDLE (open circuit), clear all errors that clear on disconnection
+        if (diode_fault_raised) {
+            listener.on_diode_fault(false);
+            diode_fault_raised = false;
+        }
+        current_state = CpState::A;
+        draw_power(0, 0, 0, 0);
+    } else if (is_voltage_in_range(cp_hi, 9.0)) {
+        current_state = CpState::B;
+        draw_power(0, 0, 0, 0);
+    } else if (is_voltage_in_range(cp_hi, 6.0)) {
+        current_state = CpState::C;
+        draw_power(amps1, amps2, amps3, 0.2);
+    } else if (is_voltage_in_range(cp_hi, 3.0)) {
+        current_state = CpState::D;
+        draw_power(amps1, amps2, amps3, 0.2);
+    } else if (is_voltage_in_range(cp_hi, -12.0)) {
+        current_state = CpState::F;
+        draw_power(0, 0, 0, 0);
+    }
+}
+
+// state machine for the evse
+void ConnectorSimulation::run_state_machine() {
+    if (last_state != current_state) {
+        listener.on_event(state_to_event(current_state));
+    }
+
+    switch (current_state) {
+    case CpState::Disabled:
+        power_off();
+        power_on_allowed = false;
+        break;
+
+    case CpState::A:
+        use_three_phases_confirmed = use_three_phases;
+        pwm_off_internal();
+        energy_Wh = Phases{};
+
+        if (last_state != CpState::A and last_state != CpState::Disabled and last_state != CpState::F) {
+            power_off();
+            // If car was unplugged, reset RCD flag.
+            setting.rcd_current = 0.1;
+        }
+        break;
+
+    case CpState::B:
+        // Table A.6: Sequence 7 EV stops charging
+        // Table A.6: Sequence 8.2 EV supply equipment responds to EV opens S2 (w/o PWM)
+        if (last_state != CpState::A and last_state != CpState::B) {
+            // Need to switch off according to Table A.6 Sequence 8.1 within
+            power_off();
+        }
+        break;
+
+    case CpState::C:
+        if (not pwm_running) {
+            // C1
+            // Table A.6 Sequence 10.2: EV does not stop drawing power even if PWM stops. Stop within 6 seconds
+            // (E.g. Kona1!) This is implemented in EvseManager
+            if (not power_on_allowed) {
+                power_off();
+            }
+        } else if (power_on_allowed) {
+            // C2
+            // Table A.6: Sequence 4 EV ready to charge. Must enable power within 3 seconds.
+            power_on();
+        }
+        break;
+
+    case CpState::D:
+        // the simulated hardware has no ventilation, so power is never switched on in D
+        if (not pwm_running) {
+            // force power off under load
+            power_off();
+        }
+        break;
+
+    case CpState::E:
+        power_off();
+        pwm_off_internal();
+        break;
+
+    case CpState::F:
+        power_off();
+        break;
+    }
+
+    last_state = current_state;
+}
+
+double ConnectorSimulation::noise_factor(double spread) {
+    const auto random = static_cast<double>(noise_generator() - std::minstd_rand::min()) /
+                        static_cast<double>(std::minstd_rand::max() - std::minstd_rand::min());
+    return 1.0 + (random - 0.5) * spread;
+}
+
+void ConnectorSimulation::add_noise() {
+    const auto noise = noise_factor(0.02);
+    const auto lo_noise = noise_factor(0.005);
+    const auto impedance = setting.impedance / 1000.0;
+
+    simulated.currents.L1 = setting.currents.L1 * noise;
+    simulated.currents.L2 = setting.currents.L2 * noise;
+    simulated.currents.L3 = setting.currents.L3 * noise;
+    simulated.current_N = setting.current_N * noise;
+
+    simulated.voltages.L1 = setting.voltages.L1 * noise - impedance * simulated.currents.L1;
+    simulated.voltages.L2 = setting.voltages.L2 * noise - impedance * simulated.currents.L2;
+    simulated.voltages.L3 = setting.voltages.L3 * noise - impedance * simulated.currents.L3;
+
+    simulated.frequencies.L1 = setting.frequencies.L1 * lo_noise;
+    simulated.frequencies.L2 = setting.frequencies.L2 * lo_noise;
+    simulated.frequencies.L3 = setting.frequencies.L3 * lo_noise;
+
+    simulated.cp_voltage = setting.cp_voltage * noise;
+    simulated.rcd_current = setting.rcd_current * noise;
+    simulated.pp_resistor = setting.pp_resistor * noise;
+
+    simulated.diode_fail = setting.diode_fail;
+    simulated.error_e = setting.error_e;
+}
+
+void ConnectorSimulation::simulate_powermeter() {
+    const double hours = std::chrono::duration<double, std::ratio<3600>>(tick_interval).count();
+    const bool three_phases = relais_on and use_three_phases_confirmed;
+
+    const auto watt_L1 = relais_on ? simulated.voltages.L1 * simulated.currents.L1 : 0.0;
+    const auto watt_L2 = three_phases ? simulated.voltages.L2 * simulated.currents.L2 : 0.0;
+    const auto watt_L3 = three_phases ? simulated.voltages.L3 * simulated.currents.L3 : 0.0;
+
+    energy_Wh.L1 += watt_L1 * hours;
+    energy_Wh.L2 += watt_L2 * hours;
+    energy_Wh.L3 += watt_L3 * hours;
+
+    powermeter.energy_Wh_import = {std::round(energy_Wh.L1), std::round(energy_Wh.L2), std::round(energy_Wh.L3)};
+    powermeter.energy_Wh_import_total = std::round(energy_Wh.L1 + energy_Wh.L2 + energy_Wh.L3);
+    powermeter.power_W = {std::round(watt_L1), std::round(watt_L2), std::round(watt_L3)};
+    powermeter.voltage_V = simulated.voltages;
+    powermeter.current_A = simulated.currents;
+    powermeter.current_N_A = simulated.current_N;
+    powermeter.frequency_Hz = simulated.frequencies;
+}
+
+void ConnectorSimulation::pwm_on_internal(double duty_cycle) {
+    if (duty_cycle > 0.0) {
+        pwm_duty_cycle = duty_cycle;
+        pwm_running = true;
+        pwm_error_f = false;
+    } else {
+        pwm_off_internal();
+    }
+}
+
+void ConnectorSimulation::pwm_off_internal() {
+    pwm_duty_cycle = 1.0;
+    pwm_running = false;
+    pwm_error_f = false;
+}
+
+void ConnectorSimulation::power_on() {
+    if (not relais_on) {
+        listener.on_event(BspEvent::PowerOn);
+        relais_on = true;
+        switching_count++;
+    }
+}
+
+void ConnectorSimulation::power_off() {
+    if (relais_on) {
+        listener.on_event(BspEvent::PowerOff);
+        relais_on = false;
+        switching_count++;
+    }
+}
+
+void ConnectorSimulation::draw_power(double l1, double l2, double l3, double n) {
+    setting.currents = {l1, l2, l3};
+    setting.current_N = n;
+}
+
+Ampacity ConnectorSimulation::read_pp_ampacity() const {
+    const auto pp_resistor = simulated.pp_resistor;
+
+    // PP resistor value in spec, use a conservative interpretation of the resistance ranges
+    if (pp_resistor > 936.0 and pp_resistor <= 2460.0) {
+        return Ampacity::A_13;
+    }
+    if (pp_resistor > 308.0 and pp_resistor <= 936.0) {
+        return Ampacity::A_20;
+    }
+    if (pp_resistor > 140.0 and pp_resistor <= 308.0) {
+        return Ampacity::A_32;
+    }
+    if (pp_resistor > 80.0 and pp_resistor <= 140.0) {
+        return Ampacity::A_63;
+    }
+    return Ampacity::None;
+}
+
+} // namespace yeti_simulation
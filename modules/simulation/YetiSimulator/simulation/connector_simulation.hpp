@@ -0,0 +1,252 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef YETI_SIMULATION_CONNECTOR_SIMULATION_HPP
+#define YETI_SIMULATION_CONNECTOR_SIMULATION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace yeti_simulation {
+
+enum class CpState {
+    Disabled,
+    A,
+    B,
+    C,
+    D,
+    E,
+    F,
+};
+
+enum class BspEvent {
+    A,
+    B,
+    C,
+    D,
+    E,
+    F,
+    PowerOn,
+    PowerOff,
+};
+
+enum class EvCpState {
+    A,
+    B,
+    C,
+    D,
+    E,
+};
+
+enum class Ampacity {
+    None,
+    A_13,
+    A_20,
+    A_32,
+    A_63,
+};
+
+struct Phases {
+    double L1{0.0};
+    double L2{0.0};
+    double L3{0.0};
+};
+
+struct PowermeterReading {
+    Phases energy_Wh_import;
+    double energy_Wh_import_total{0.0};
+    Phases power_W;
+    Phases voltage_V;
+    Phases current_A;
+    double current_N_A{0.0};
+    Phases frequency_Hz;
+};
+
+struct EvMeasurement {
+    // in percent
+    double cp_pwm_duty_cycle{0.0};
+    double rcd_current_mA{0.0};
+    Ampacity pp_ampacity{Ampacity::None};
+};
+
+struct Telemetry {
+    double cp_voltage_high{0.0};
+    double cp_voltage_low{0.0};
+    // in percent
+    double cp_pwm_duty_cycle{0.0};
+    CpState cp_state{CpState::Disabled};
+    bool pwm_running{false};
+    bool relais_on{false};
+    int switching_count{0};
+    double temperature_C{25.0};
+    double rcd_current_mA{0.0};
+};
+
+/// \brief Receives the output of one simulated connector.
+///
+/// All functions are called from the thread that ticks the connector. They may post commands to any connector, those
+/// take effect on the next tick.
+class Listener {
+public:
+    virtual ~Listener() = default;
+
+    virtual void on_event(BspEvent /*event*/) {
+    }
+    virtual void on_diode_fault(bool /*raised*/) {
+    }
+    virtual void on_rcd_dc_error(bool /*raised*/) {
+    }
+    virtual void on_rcd_current(double /*current_mA*/) {
+    }
+    /// every tick while the simulation is enabled
+    virtual void on_ev_measurement(const EvMeasurement& /*measurement*/) {
+    }
+    /// once per simulated second
+    virtual void on_powermeter(const PowermeterReading& /*reading*/) {
+    }
+    /// once per simulated second
+    virtual void on_telemetry(const Telemetry& /*telemetry*/) {
+    }
+};
+
+/// \brief CP/PP, relais, RCD and powermeter simulation of one Yeti connector, including the EV side.
+///
+/// Commands can be posted from any thread, they are queued and applied in order at the beginning of the next tick.
+/// Everything else only runs in tick(), so a connector is advanced by exactly one thread and without locking beyond
+/// the command queue. The measurement noise comes from a generator seeded with the connector id and time only
+/// advances by the tick interval, so the same commands at the same ticks always yield the same output.
+class ConnectorSimulation {
+public:
+    ConnectorSimulation(int connector_id, std::chrono::milliseconds tick_interval, Listener& listener);
+
+    ConnectorSimulation(const ConnectorSimulation&) = delete;
+    ConnectorSimulation& operator=(const ConnectorSimulation&) = delete;
+
+    // evse_board_support commands
+    void enable(bool value);
+    /// \param duty_cycle in percent
+    void pwm_on(double duty_cycle);
+    void pwm_off();
+    void pwm_F();
+    void allow_power_on(bool value);
+    void switch_three_phases(bool value);
+
+    // ev_board_support commands
+    void enable_simulation(bool value);
+    void set_cp_state(EvCpState cp_state);
+    void set_diode_fail(bool value);
+    void set_ev_max_current(double current_A);
+    void set_ev_three_phases(bool value);
+    void set_rcd_current(double current_mA);
+
+    /// PP ampacity as of the last tick, can be read from any thread
+    Ampacity pp_ampacity() const {
+        return last_pp_ampacity.load();
+    }
+
+    int get_connector_id() const {
+        return connector_id;
+    }
+
+    void tick();
+
+private:
+    enum class CommandType {
+        Enable,
+        PwmOn,
+        PwmOff,
+        PwmF,
+        AllowPowerOn,
+        SwitchThreePhases,
+        EnableSimulation,
+        SetCpState,
+        SetDiodeFail,
+        SetEvMaxCurrent,
+        SetEvThreePhases,
+        SetRcdCurrent,
+    };
+
+    struct Command {
+        CommandType type;
+        double value{0.0};
+    };
+
+    // what the EV side sets up, before noise is added
+    struct Setting {
+        double cp_voltage{12.0};
+        double pp_resistor{220.1};
+        double impedance{500.0};
+        double rcd_current{0.1};
+        Phases voltages{230.0, 230.0, 230.0};
+        Phases currents;
+        double current_N{0.0};
+        Phases frequencies{50.0, 50.0, 50.0};
+        bool diode_fail{false};
+        bool error_e{false};
+    };
+
+    void post(CommandType type, double value = 0.0);
+    void apply(const Command& command);
+    void clear_data();
+
+    void check_error_rcd();
+    void read_from_car();
+    void run_state_machine();
+    void add_noise();
+    void simulate_powermeter();
+
+    void pwm_on_internal(double duty_cycle);
+    void pwm_off_internal();
+    void power_on();
+    void power_off();
+    void draw_power(double l1, double l2, double l3, double n);
+    Ampacity read_pp_ampacity() const;
+    double noise_factor(double spread);
+
+    const int connector_id;
+    const std::chrono::milliseconds tick_interval;
+    const uint32_t ticks_per_second;
+    Listener& listener;
+
+    std::mutex commands_mutex;
+    std::vector<Command> commands;
+    // only used by tick(), kept to not allocate on every tick
+    std::vector<Command> commands_to_apply;
+
+    std::minstd_rand noise_generator;
+    std::atomic<Ampacity> last_pp_ampacity{Ampacity::None};
+    uint64_t tick_count{0};
+
+    Setting setting;
+    Setting simulated;
+
+    bool simulation_enabled{false};
+    bool power_on_allowed{false};
+    bool relais_on{false};
+    CpState current_state{CpState::Disabled};
+    CpState last_state{CpState::Disabled};
+    bool use_three_phases{true};
+    bool use_three_phases_confirmed{true};
+    bool rcd_error_reported{false};
+    bool diode_fault_raised{false};
+
+    double pwm_duty_cycle{0.0};
+    bool pwm_running{false};
+    bool pwm_error_f{false};
+    double pwm_voltage_hi{12.1};
+    double pwm_voltage_lo{12.1};
+
+    double ev_max_current{0.0};
+    int ev_phases{3};
+
+    Phases energy_Wh;
+    PowermeterReading powermeter;
+    int switching_count{0};
+};
+
+} // namespace yeti_simulation
+
+#endif // YETI_SIMULATION_CONNECTOR_SIMULATION_HPP
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#include "tick_scheduler.hpp"
+
+#include <stdexcept>
+
+#include <virtual_clock.hpp>
+
+namespace yeti_simulation {
+
+TickScheduler::TickScheduler(std::chrono::milliseconds tick_interval_) : tick_interval(tick_interval_) {
+    if (tick_interval <= std::chrono::milliseconds::zero()) {
+        throw std::invalid_argument("Tick interval needs to be positive");
+    }
+}
+
+TickScheduler::~TickScheduler() {
+    stop();
+}
+
+ConnectorSimulation& TickScheduler::add_connector(int connector_id, Listener& listener) {
+    connectors.push_back(std::make_unique<ConnectorSimulation>(connector_id, tick_interval, listener));
+    return *connectors.back();
+}
+
+void TickScheduler::step() {
+    for (auto& connector : connectors) {
+        connector->tick();
+    }
+    ticks++;
+}
+
+void TickScheduler::start() {
+    if (running.exchange(true)) {
+        return;
+    }
+    thread = std::thread(&TickScheduler::run, this);
+}
+
+void TickScheduler::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void TickScheduler::run() {
+    auto deadline = virtual_clock::now();
+    while (running) {
+        step();
+
+        deadline += tick_interval;
+        const auto now = virtual_clock::now();
+        if (now > deadline) {
+            overruns++;
+            deadline = now;
+            continue;
+        }
+        virtual_clock::sleep_until(deadline);
+    }
+}
+
+} // namespace yeti_simulation
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+#ifndef YETI_SIMULATION_TICK_SCHEDULER_HPP
+#define YETI_SIMULATION_TICK_SCHEDULER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "connector_simulation.hpp"
+
+namespace yeti_simulation {
+
+/// \brief Ticks any number of simulated connectors from a single thread.
+///
+/// Every tick advances all connectors once, in the order they were added. The thread started by start() ticks on
+/// absolute deadlines of the virtual clock, so it neither drifts nor depends on how long a tick took, as long as a
+/// tick fits into the interval. Ticks that end after the following deadline are counted as overruns and the schedule
+/// restarts from the current time instead of trying to catch up.
+class TickScheduler {
+public:
+    static constexpr auto DEFAULT_TICK_INTERVAL = std::chrono::milliseconds(250);
+
+    explicit TickScheduler(std::chrono::milliseconds tick_interval = DEFAULT_TICK_INTERVAL);
+    ~TickScheduler();
+
+    TickScheduler(const TickScheduler&) = delete;
+    TickScheduler& operator=(const TickScheduler&) = delete;
+
+    /// \brief Adds a connector, must not be called while the scheduler thread runs
+    ConnectorSimulation& add_connector(int connector_id, Listener& listener);
+
+    /// \brief Ticks all connectors once in the calling thread
+    void step();
+
+    void start();
+    void stop();
+
+    std::size_t size() const {
+        return connectors.size();
+    }
+
+    std::chrono::milliseconds get_tick_interval() const {
+        return tick_interval;
+    }
+
+    uint64_t get_ticks() const {
+        return ticks;
+    }
+
+    uint64_t get_overruns() const {
+        return overruns;
+    }
+
+private:
+    void run();
+
+    const std::chrono::milliseconds tick_interval;
+    std::vector<std::unique_ptr<ConnectorSimulation>> connectors;
+
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<uint64_t> overruns{0};
+    std::atomic_bool running{false};
+    std::thread thread;
+};
+
+} // namespace yeti_simulation
+
+#endif // YETI_SIMULATION_TICK_SCHEDULER_HPP
@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <connector_simulation.hpp>
+#include <tick_scheduler.hpp>
+
+namespace {
+
+using namespace yeti_simulation;
+using namespace std::chrono_literals;
+
+struct RecordingListener : public Listener {
+    void on_event(BspEvent event) override {
+        events.push_back(event);
+    }
+    void on_diode_fault(bool raised) override {
+        diode_fault = raised;
+    }
+    void on_rcd_dc_error(bool raised) override {
+        rcd_dc_error = raised;
+    }
+    void on_powermeter(const PowermeterReading& reading) override {
+        readings.push_back(reading);
+    }
+
+    std::vector<BspEvent> events;
+    std::vector<PowermeterReading> readings;
+    bool diode_fault{false};
+    bool rcd_dc_error{false};
+};
+
+class ConnectorSimulationTest : public ::testing::Test {
+protected:
+    void tick(int count = 1) {
+        for (int i = 0; i < count; ++i) {
+            connector.tick();
+        }
+    }
+
+    void plug_in_and_charge() {
+        connector.enable_simulation(true);
+        connector.enable(true);
+        connector.set_ev_max_current(16.0);
+        tick();
+        // the EV side changes show up in the measurements of the following tick
+        connector.set_cp_state(EvCpState::B);
+        tick(2);
+        connector.pwm_on(26.7);
+        connector.allow_power_on(true);
+        connector.set_cp_state(EvCpState::C);
+        tick(2);
+    }
+
+    RecordingListener listener;
+    ConnectorSimulation connector{1, 250ms, listener};
+};
+
+TEST_F(ConnectorSimulationTest, nothing_happens_before_simulation_is_enabled) {
+    tick(8);
+    EXPECT_TRUE(listener.events.empty());
+    // the powermeter is published once per second regardless
+    EXPECT_EQ(listener.readings.size(), 2);
+}
+
+TEST_F(ConnectorSimulationTest, plug_in_charge_and_unplug) {
+    plug_in_and_charge();
+    EXPECT_EQ(listener.events, (std::vector<BspEvent>{BspEvent::A, BspEvent::B, BspEvent::C, BspEvent::PowerOn}));
+
+    // charge for one minute, three phases with 16 A at about 230 V minus the drop on the simulated 0.5 Ohm impedance
+    tick(240);
+    const auto& reading = listener.readings.back();
+    EXPECT_NEAR(reading.current_A.L1, 16.0, 0.2);
+    EXPECT_NEAR(reading.voltage_V.L1, 222.0, 3.0);
+    EXPECT_NEAR(reading.energy_Wh_import_total, 3 * 16.0 * 222.0 / 60.0, 5.0);
+
+    connector.set_cp_state(EvCpState::B);
+    tick(2);
+    connector.set_cp_state(EvCpState::A);
+    tick(2);
+    EXPECT_EQ(listener.events, (std::vector<BspEvent>{BspEvent::A, BspEvent::B, BspEvent::C, BspEvent::PowerOn,
+                                                      BspEvent::B, BspEvent::PowerOff, BspEvent::A}));
+}
+
+TEST_F(ConnectorSimulationTest, commands_are_applied_on_tick) {
+    connector.enable_simulation(true);
+    EXPECT_EQ(connector.pp_ampacity(), Ampacity::None);
+    tick();
+    EXPECT_EQ(connector.pp_ampacity(), Ampacity::A_32);
+    EXPECT_EQ(listener.events, (std::vector<BspEvent>{BspEvent::A}));
+
+    connector.set_cp_state(EvCpState::B);
+    tick();
+    EXPECT_EQ(listener.events, (std::vector<BspEvent>{BspEvent::A}));
+    tick();
+    EXPECT_EQ(listener.events, (std::vector<BspEvent>{BspEvent::A, BspEvent::B}));
+}
+
+TEST_F(ConnectorSimulationTest, single_phase_ev) {
+    connector.set_ev_three_phases(false);
+    plug_in_and_charge();
+    tick(4);
+    const auto& reading = listener.readings.back();
+    EXPECT_GT(reading.power_W.L1, 3000.0);
+    EXPECT_EQ(reading.power_W.L2, 0.0);
+    EXPECT_EQ(reading.power_W.L3, 0.0);
+}
+
+TEST_F(ConnectorSimulationTest, diode_fault_clears_on_unplug) {
+    plug_in_and_charge();
+    connector.set_diode_fail(true);
+    tick(2);
+    EXPECT_TRUE(listener.diode_fault);
+
+    connector.set_diode_fail(false);
+    connector.set_cp_state(EvCpState::A);
+    tick(2);
+    EXPECT_FALSE(listener.diode_fault);
+}
+
+TEST_F(ConnectorSimulationTest, rcd_error) {
+    plug_in_and_charge();
+    connector.set_rcd_current(30.0);
+    // the RCD current is checked before the noise is added on the tick
+    tick(2);
+    EXPECT_TRUE(listener.rcd_dc_error);
+
+    connector.set_cp_state(EvCpState::A);
+    tick(3);
+    EXPECT_FALSE(listener.rcd_dc_error);
+}
+
+TEST(ConnectorSimulation, deterministic) {
+    RecordingListener listener_a;
+    RecordingListener listener_b;
+    TickScheduler scheduler_a;
+    TickScheduler scheduler_b;
+    auto& a = scheduler_a.add_connector(7, listener_a);
+    auto& b = scheduler_b.add_connector(7, listener_b);
+
+    const auto step = [&](int count) {
+        for (int i = 0; i < count; ++i) {
+            scheduler_a.step();
+            scheduler_b.step();
+        }
+    };
+
+    for (auto* connector : {&a, &b}) {
+        connector->enable_simulation(true);
+        connector->set_ev_max_current(10.0);
+        connector->set_cp_state(EvCpState::B);
+    }
+    step(3);
+    for (auto* connector : {&a, &b}) {
+        connector->pwm_on(16.7);
+        connector->allow_power_on(true);
+        connector->set_cp_state(EvCpState::C);
+    }
+    step(100);
+
+    ASSERT_EQ(listener_a.readings.size(), listener_b.readings.size());
+    for (std::size_t i = 0; i < listener_a.readings.size(); ++i) {
+        EXPECT_EQ(listener_a.readings[i].voltage_V.L1, listener_b.readings[i].voltage_V.L1);
+        EXPECT_EQ(listener_a.readings[i].energy_Wh_import_total, listener_b.readings[i].energy_Wh_import_total);
+    }
+    EXPECT_GT(listener_a.readings.back().energy_Wh_import_total, 0.0);
+}
+
+TEST(TickScheduler, ticks_all_connectors) {
+    std::vector<RecordingListener> listeners(10);
+    TickScheduler scheduler(10ms);
+    for (std::size_t i = 0; i < listeners.size(); ++i) {
+        scheduler.add_connector(i, listeners[i]).enable_simulation(true);
+    }
+
+    scheduler.start();
+    while (scheduler.get_ticks() < 5) {
+        std::this_thread::sleep_for(1ms);
+    }
+    scheduler.stop();
+
+    for (const auto& listener : listeners) {
+        EXPECT_EQ(listener.events, std::vector<BspEvent>{BspEvent::A});
+    }
+}
+
+} // namespace
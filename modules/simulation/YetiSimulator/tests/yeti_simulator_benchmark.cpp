@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Pionix GmbH and Contributors to EVerest
+
+// Simulates a growing number of connectors in one TickScheduler, each with an EV that plugs in, charges and unplugs
+// again, and a minimal EvseManager stand in that answers the CP events with PWM and allow_power_on. Reports the time a
+// tick of all connectors takes and how many connectors fit into the tick interval of the YetiSimulator module. The
+// publishing of the module (MQTT and JSON) is not part of the measurement.
+//   yeti_simulator_benchmark [maximum number of connectors]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <connector_simulation.hpp>
+#include <tick_scheduler.hpp>
+
+using Clock = std::chrono::steady_clock;
+using namespace yeti_simulation;
+
+namespace {
+
+// one simulated minute of charging per session, with a short break in between
+constexpr int SESSION_TICKS = 240;
+constexpr int IDLE_TICKS = 40;
+
+class SimulatedSession : public Listener {
+public:
+    void attach(ConnectorSimulation& connector_, int offset_) {
+        connector = &connector_;
+        offset = offset_;
+        connector->enable_simulation(true);
+        connector->enable(true);
+        connector->set_ev_max_current(16.0);
+    }
+
+    // EV side, posted before the tick
+    void drive_ev(int tick) {
+        const auto phase = (tick + offset) % (SESSION_TICKS + IDLE_TICKS);
+        if (phase == 0) {
+            connector->set_cp_state(EvCpState::B);
+        } else if (phase == 8) {
+            connector->set_cp_state(EvCpState::C);
+        } else if (phase == SESSION_TICKS) {
+            connector->set_cp_state(EvCpState::B);
+        } else if (phase == SESSION_TICKS + 4) {
+            connector->set_cp_state(EvCpState::A);
+        }
+    }
+
+    // EVSE side, reacting from within the tick
+    void on_event(BspEvent event) override {
+        events++;
+        if (event == BspEvent::B) {
+            connector->pwm_on(26.7);
+            connector->allow_power_on(true);
+        } else if (event == BspEvent::A) {
+            connector->pwm_off();
+            connector->allow_power_on(false);
+        } else if (event == BspEvent::PowerOn) {
+            power_ons++;
+        }
+    }
+
+    void on_powermeter(const PowermeterReading& reading) override {
+        energy_Wh = std::max(energy_Wh, reading.energy_Wh_import_total);
+    }
+
+    int events{0};
+    int power_ons{0};
+    double energy_Wh{0.0};
+
+private:
+    ConnectorSimulation* connector{nullptr};
+    int offset{0};
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int max_connectors = (argc > 1) ? std::atoi(argv[1]) : 10000;
+    const int ticks = 2 * (SESSION_TICKS + IDLE_TICKS);
+
+    double sustainable = 0.0;
+    printf("%10s %14s %14s %10s\n", "connectors", "mean tick [us]", "max tick [us]", "load [%]");
+    for (int connectors = 1; connectors <= max_connectors; connectors *= 10) {
+        TickScheduler scheduler;
+        std::vector<std::unique_ptr<SimulatedSession>> sessions;
+        sessions.reserve(connectors);
+        for (int i = 0; i < connectors; ++i) {
+            sessions.push_back(std::make_unique<SimulatedSession>());
+            // spread the plug ins over the session length, so all phases of a session are part of every tick
+            sessions.back()->attach(scheduler.add_connector(i, *sessions.back()), i % (SESSION_TICKS + IDLE_TICKS));
+        }
+
+        Clock::duration total{0};
+        Clock::duration longest{0};
+        for (int tick = 0; tick < ticks; ++tick) {
+            for (auto& session : sessions) {
+                session->drive_ev(tick);
+            }
+            const auto start = Clock::now();
+            scheduler.step();
+            const auto duration = Clock::now() - start;
+            total += duration;
+            longest = std::max(longest, duration);
+        }
+
+        int power_ons = 0;
+        for (const auto& session : sessions) {
+            power_ons += session->power_ons;
+        }
+        if (power_ons < connectors) {
+            printf("only %d power ons for %d connectors\n", power_ons, connectors);
+            return EXIT_FAILURE;
+        }
+
+        const auto mean_us = std::chrono::duration<double, std::micro>(total).count() / ticks;
+        const auto max_us = std::chrono::duration<double, std::micro>(longest).count();
+        const auto interval_us = std::chrono::duration<double, std::micro>(scheduler.get_tick_interval()).count();
+        printf("%10d %14.1f %14.1f %10.3f\n", connectors, mean_us, max_us, 100.0 * mean_us / interval_us);
+        sustainable = connectors * interval_us / mean_us;
+    }
+
+    // extrapolated from the largest run
+    printf("one core sustains about %.0f connectors at a %lld ms tick interval\n", sustainable,
+           static_cast<long long>(TickScheduler::DEFAULT_TICK_INTERVAL.count()));
+    return EXIT_SUCCESS;
+}
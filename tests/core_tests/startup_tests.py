@@ -84,11 +84,7 @@ class ProbeModule:
         return True
 
 
-@pytest.mark.everest_core_config('config-sil.yaml')
-@pytest.mark.asyncio
-async def test_001_start_test_module(everest_core: EverestCore):
-    logging.info(">>>>>>>>> test_001_start_test_module <<<<<<<<<")
-
+def run_probe_session(everest_core: EverestCore) -> bool:
     test_connections = {
         'test_control': [Requirement('ev_manager', 'main')],
         'connector_1': [Requirement('connector_1', 'evse')]
@@ -105,4 +101,19 @@ async def test_001_start_test_module(everest_core: EverestCore):
         everest_core.all_modules_started_event.set()
         logging.info("set all modules started event...")
 
-    assert probe.test(20)
+    return probe.test(20)
+
+
+@pytest.mark.everest_core_config('config-sil.yaml')
+@pytest.mark.asyncio
+async def test_001_start_test_module(everest_core: EverestCore):
+    logging.info(">>>>>>>>> test_001_start_test_module <<<<<<<<<")
+    assert run_probe_session(everest_core)
+
+
+# only uses simulators that follow EVEREST_VIRTUAL_CLOCK, see "Run in virtual time" in tests/README.md
+@pytest.mark.everest_core_config('config-sil-virtual-time.yaml')
+@pytest.mark.asyncio
+async def test_002_start_test_module_virtual_time(everest_core: EverestCore):
+    logging.info(">>>>>>>>> test_002_start_test_module_virtual_time <<<<<<<<<")
+    assert run_probe_session(everest_core)